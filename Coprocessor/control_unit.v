@@ -149,8 +149,8 @@ coprocessor coprocessor (
     .matrix_size(matrix_size),      // Tamanho da matriz (2x2 a 5x5)
     .pixel_data(pixel_flat),        // Matriz de pixels linearizada
     .kernel_data(kernel_flat),      // Kernel linearizado
-    .process_Done(done_signal),     // Indica que o processamento foi concluído
-    .result_final(matrix_out)       // Resultado linearizado da operação
+    .processing_done(done_signal),  // Indica que o processamento foi concluído
+    .final_result(matrix_out)       // Resultado linearizado da operação
 );
 
 endmodule
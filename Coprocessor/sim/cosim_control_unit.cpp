@@ -0,0 +1,169 @@
+// Co-simulação do control_unit.v (com coprocessor.v e convolution.v) compilado pelo Verilator.
+//
+// Mapeia o mesmo arquivo que o driver em C (PBL3_FPGA_DISPOSITIVO=ARQUIVO) e serve os registradores
+// data_in/data_out com o RTL. O clock só avança depois de uma escrita do HPS: por pelo menos
+// CICLOS_ACOMODACAO ciclos e até o ack em data_out igualar o bit 31 de data_in. Só então data_out
+// é publicado, como se cada acesso do HPS pela ponte levasse esse mínimo de ciclos (sem ele, o HPS
+// veria o ack antigo ainda na cadeia de sincronização de hps_ready). Os ciclos contados são os que
+// o RTL leva para responder; o total é publicado na página (FPGA_PALAVRA_CICLOS_SIM) e o programa
+// o soma por imagem.
+//
+// Os pulsos de reset e start chegam pela sequência em FPGA_PALAVRA_PULSOS: o driver mantém o pulso
+// em data_in até o simulador aplicá-lo e confirmar em FPGA_PALAVRA_PULSOS_ACK. Só esses pulsos
+// chegam ao RTL, exatamente como o host os enviou.
+//
+// Se o RTL não der o ack de uma escrita em CICLOS_MAX_RESPOSTA ciclos (o host subiu o bit 31 em
+// IDLE, ou a FSM travou), o clock para e o erro vai para FPGA_PALAVRA_ERRO_SIM, onde o driver o
+// vê e devolve a falha ao programa. O próximo pulso de reset limpa o erro.
+
+#include <cstdio>
+#include <cstdint>
+#include <csignal>
+#include <cstring>
+#include <chrono>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <verilated.h>
+#include "Vcontrol_unit.h"
+#include "driver_mmio.h"
+
+#define LEITURAS_CEDER 64                // Leituras ociosas da página antes de ceder o processador.
+#define LEITURAS_DORMIR (1 << 16)        // ... e antes de dormir entre as leituras.
+#define FREQUENCIA_CLOCK_50 50000000.0   // CLOCK_50 da DE1-SoC.
+#define CICLOS_ACOMODACAO 8              // Mínimo por escrita: sincronizador (3) + fpga_wait + data_out, com folga.
+#define CICLOS_MAX_RESPOSTA (1u << 20)   // Máximo por escrita até o ack; o RTL responde em dezenas de ciclos.
+
+static volatile std::sig_atomic_t encerrando = 0;
+
+static void tratar_sinal(int) { encerrando = 1; }
+
+// Uma borda de subida do clock com o data_in já aplicado.
+static void avancar_ciclo(Vcontrol_unit *unidade, uint64_t *ciclos) {
+    unidade->clk = 0;
+    unidade->eval();
+    unidade->clk = 1;
+    unidade->eval();
+    ++*ciclos;
+}
+
+// Um pulso (reset e/ou start) mantido em data_in por uma borda de clock, depois retirado.
+static void aplicar_pulso(Vcontrol_unit *unidade, uint32_t entrada, uint64_t *ciclos) {
+    unidade->data_in = entrada;
+    avancar_ciclo(unidade, ciclos);
+    unidade->data_in = entrada & ~(FPGA_BIT_RESET | FPGA_BIT_START);
+}
+
+int main(int argc, char **argv) {
+    Verilated::commandArgs(argc, argv);
+    if (argc < 2) {
+        std::fprintf(stderr, "Uso: %s ARQUIVO\n  Depois: PBL3_FPGA_DISPOSITIVO=ARQUIVO ./main (compilado com make DRIVER=c)\n", argv[0]);
+        return 1;
+    }
+
+    int descritor = open(argv[1], O_RDWR | O_CREAT, 0666);
+    if (descritor < 0 || ftruncate(descritor, FPGA_PONTE_LW_TAMANHO) != 0) {
+        std::perror(argv[1]);
+        return 1;
+    }
+    void *base = mmap(nullptr, FPGA_PONTE_LW_TAMANHO, PROT_READ | PROT_WRITE, MAP_SHARED, descritor, 0);
+    if (base == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+    volatile uint32_t *regiao = static_cast<volatile uint32_t *>(base);
+    uint64_t *ciclos_publicados = reinterpret_cast<uint64_t *>(static_cast<uint32_t *>(base) + FPGA_PALAVRA_CICLOS_SIM);
+    uint32_t *sequencia_pulsos = static_cast<uint32_t *>(base) + FPGA_PALAVRA_PULSOS;
+    uint32_t *confirmacao_pulsos = static_cast<uint32_t *>(base) + FPGA_PALAVRA_PULSOS_ACK;
+    uint32_t *erro_simulacao = static_cast<uint32_t *>(base) + FPGA_PALAVRA_ERRO_SIM;
+    regiao[FPGA_PALAVRA_DATA_IN] = 0;
+    regiao[FPGA_PALAVRA_DATA_OUT] = 0;
+    __atomic_store_n(ciclos_publicados, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(sequencia_pulsos, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(erro_simulacao, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(confirmacao_pulsos, 0, __ATOMIC_RELEASE);
+
+    std::signal(SIGINT, tratar_sinal);
+    std::signal(SIGTERM, tratar_sinal);
+
+    Vcontrol_unit *unidade = new Vcontrol_unit;
+    uint64_t ciclos = 0, ultimos_ciclos_publicados = 0, transacoes = 0, escritas_sem_resposta = 0;
+    uint32_t pulsos_aplicados = 0, entrada_aplicada = 0, saida_publicada = 0;
+    unsigned leituras_ociosas = 0, ciclos_desde_escrita = CICLOS_ACOMODACAO;
+    unidade->clk = 0;
+    unidade->data_in = 0;
+    unidade->eval();
+    aplicar_pulso(unidade, FPGA_BIT_RESET, &ciclos); // Reset de power-on (a FPGA recém-configurada).
+    for (int ciclo = 0; ciclo < CICLOS_ACOMODACAO; ciclo++) avancar_ciclo(unidade, &ciclos);
+    ciclos = 0;
+
+    std::fprintf(stderr, "Co-simulação do control_unit servindo '%s' (Ctrl+C encerra)\n", argv[1]);
+    auto instante_inicio = std::chrono::steady_clock::now();
+    while (!encerrando) {
+        // Pulso pendente: o driver o mantém em data_in até a confirmação.
+        uint32_t sequencia = __atomic_load_n(sequencia_pulsos, __ATOMIC_ACQUIRE);
+        if (sequencia != pulsos_aplicados) {
+            uint32_t pulso = regiao[FPGA_PALAVRA_DATA_IN];
+            if (pulso & FPGA_BIT_RESET) __atomic_store_n(erro_simulacao, 0, __ATOMIC_RELEASE); // Antes da confirmação.
+            aplicar_pulso(unidade, pulso, &ciclos);
+            if (pulso & FPGA_BIT_START) transacoes++;
+            entrada_aplicada = unidade->data_in;
+            ciclos_desde_escrita = 0;
+            pulsos_aplicados = sequencia;
+            __atomic_store_n(confirmacao_pulsos, sequencia, __ATOMIC_RELEASE);
+        }
+
+        // Os bits de reset e start só chegam ao RTL pelos pulsos confirmados acima.
+        uint32_t entrada = regiao[FPGA_PALAVRA_DATA_IN];
+        uint32_t pronto = entrada & FPGA_BIT_PRONTO;
+        if ((entrada & ~(FPGA_BIT_RESET | FPGA_BIT_START)) != entrada_aplicada) {
+            entrada_aplicada = entrada & ~(FPGA_BIT_RESET | FPGA_BIT_START);
+            unidade->data_in = entrada_aplicada;
+            ciclos_desde_escrita = 0;
+        }
+
+        // Depois de uma escrita, o clock avança até o RTL acomodar e responder ao bit 31 do HPS,
+        // por no máximo CICLOS_MAX_RESPOSTA ciclos.
+        bool aguardando_rtl = ciclos_desde_escrita < CICLOS_ACOMODACAO || pronto != (unidade->data_out & FPGA_BIT_PRONTO);
+        if (aguardando_rtl && ciclos_desde_escrita < CICLOS_MAX_RESPOSTA) {
+            avancar_ciclo(unidade, &ciclos);
+            ciclos_desde_escrita++;
+            leituras_ociosas = 0;
+            continue;
+        }
+        if (aguardando_rtl && ciclos_desde_escrita == CICLOS_MAX_RESPOSTA) {
+            std::fprintf(stderr, "RTL sem ack para data_in=0x%08x após %u ciclos; erro publicado para o driver\n",
+                         entrada_aplicada | pronto, CICLOS_MAX_RESPOSTA);
+            __atomic_store_n(erro_simulacao, FPGA_ERRO_SIM_SEM_RESPOSTA, __ATOMIC_RELEASE);
+            escritas_sem_resposta++;
+            ciclos_desde_escrita++; // Avisa uma vez por escrita; o clock fica parado até a próxima.
+        }
+        if (ciclos != ultimos_ciclos_publicados) {
+            __atomic_store_n(ciclos_publicados, ciclos, __ATOMIC_RELEASE); // Antes do ack que o HPS espera.
+            ultimos_ciclos_publicados = ciclos;
+        }
+        if (unidade->data_out != saida_publicada) {
+            saida_publicada = unidade->data_out;
+            regiao[FPGA_PALAVRA_DATA_OUT] = saida_publicada;
+        }
+
+        if (++leituras_ociosas >= LEITURAS_DORMIR) usleep(50);
+        else if (leituras_ociosas % LEITURAS_CEDER == 0) sched_yield();
+    }
+
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - instante_inicio).count();
+    std::fprintf(stderr, "\nCiclos simulados: %llu em %llu transações (%.1f ciclos/transação)\n",
+                 (unsigned long long)ciclos, (unsigned long long)transacoes, transacoes ? (double)ciclos / transacoes : 0.0);
+    if (escritas_sem_resposta > 0) {
+        std::fprintf(stderr, "Escritas sem ack do RTL: %llu\n", (unsigned long long)escritas_sem_resposta);
+    }
+    std::fprintf(stderr, "Tempo da FPGA a 50 MHz: %.3f ms | simulação: %.0f ciclos/s\n",
+                 ciclos / FREQUENCIA_CLOCK_50 * 1e3, segundos > 0 ? ciclos / segundos : 0.0);
+
+    unidade->final();
+    delete unidade;
+    munmap(base, FPGA_PONTE_LW_TAMANHO);
+    close(descritor);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Fuzzing diferencial do coprocessor.v/convolution.v compilados pelo Verilator contra o modelo
+// bit a bit do programa (Library/modelo_rtl.c).
+//
+// As entradas são combinacionais: cada vetor aplica pixel_data, kernel_data, matrix_size e
+// op_code, avalia o RTL e compara os 200 bits de final_result (e processing_done) com o modelo.
+// As janelas vêm de sortear_janela_rtl, o mesmo gerador do `fuzz_rtl --modo fpga`; uma parte dos
+// vetores usa outro op_code, que deve deixar processing_done e final_result em zero.
+//
+// Uso: fuzz_convolution [+iteracoes=N] [+semente=N]
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <verilated.h>
+#include "Vcoprocessor.h"
+#include "modelo_rtl.h"
+
+#define ITERACOES_PADRAO 1000000
+#define MAXIMO_DIVERGENCIAS_MOSTRADAS 5
+#define OPCODE_CONVOLUCAO 7
+
+static const char *nomes_sorteios[TOTAL_SORTEIOS_RTL] = { "uniforme", "pequeno", "extremos", "fronteira" };
+
+// Lê um plusarg numérico (+nome=valor); devolve `padrao` se ausente.
+static uint64_t ler_plusarg(int argc, char **argv, const char *nome, uint64_t padrao) {
+    size_t tamanho = std::strlen(nome);
+    for (int indice = 1; indice < argc; indice++) {
+        if (argv[indice][0] == '+' && std::strncmp(argv[indice] + 1, nome, tamanho) == 0 && argv[indice][tamanho + 1] == '=') {
+            return std::strtoull(argv[indice] + tamanho + 2, nullptr, 10);
+        }
+    }
+    return padrao;
+}
+
+// Copia 25 bytes para um barramento de 200 bits (byte i nos bits 8i+7:8i, 4 bytes por palavra).
+template <typename T>
+static void aplicar_barramento(T &barramento, const uint8_t bytes[25]) {
+    for (int palavra = 0; palavra < 7; palavra++) barramento[palavra] = 0;
+    for (int indice = 0; indice < 25; indice++) barramento[indice / 4] |= (uint32_t)bytes[indice] << (8 * (indice % 4));
+}
+
+template <typename T>
+static void ler_barramento(const T &barramento, uint8_t bytes[25]) {
+    for (int indice = 0; indice < 25; indice++) bytes[indice] = (uint8_t)(barramento[indice / 4] >> (8 * (indice % 4)));
+}
+
+int main(int argc, char **argv) {
+    Verilated::commandArgs(argc, argv);
+    uint64_t iteracoes = ler_plusarg(argc, argv, "iteracoes", ITERACOES_PADRAO);
+    uint64_t semente = ler_plusarg(argc, argv, "semente", 1), estado = semente;
+    uint64_t vetores_por_sorteio[TOTAL_SORTEIOS_RTL] = {};
+    uint64_t em_faixa = 0, saturados = 0, com_volta = 0, outros_opcodes = 0, divergencias = 0;
+    Vcoprocessor *coprocessador = new Vcoprocessor;
+
+    auto inicio = std::chrono::steady_clock::now();
+    for (uint64_t iteracao = 0; iteracao < iteracoes; iteracao++) {
+        uint8_t pixels[25], pesos[25], lido[25], esperado[25];
+        unsigned codigo_tamanho;
+        tipo_sorteio_rtl sorteio = sortear_janela_rtl(&estado, pixels, (int8_t *)pesos, &codigo_tamanho);
+        // Um vetor em oito com um op_code sem operação (0 a 6).
+        unsigned opcode = (proximo_aleatorio_rtl(&estado) % 8 == 0) ? (unsigned)(proximo_aleatorio_rtl(&estado) % 7) : OPCODE_CONVOLUCAO;
+
+        aplicar_barramento(coprocessador->pixel_data, pixels);
+        aplicar_barramento(coprocessador->kernel_data, pesos);
+        coprocessador->matrix_size = codigo_tamanho;
+        coprocessador->op_code = opcode;
+        coprocessador->eval();
+        ler_barramento(coprocessador->final_result, lido);
+
+        if (opcode == OPCODE_CONVOLUCAO) {
+            resultado_control_unit_rtl(pixels, (const int8_t *)pesos, codigo_tamanho, esperado);
+            int32_t soma = soma_produtos_rtl(pixels, (const int8_t *)pesos, codigo_tamanho);
+            vetores_por_sorteio[sorteio]++;
+            if (soma != (int16_t)(uint16_t)soma) com_volta++;
+            if (convolucao_rtl(pixels, (const int8_t *)pesos, codigo_tamanho) == 255) saturados++; else em_faixa++;
+        } else {
+            std::memset(esperado, 0, sizeof(esperado));
+            outros_opcodes++;
+        }
+        if (std::memcmp(lido, esperado, 25) == 0 && coprocessador->processing_done == (opcode == OPCODE_CONVOLUCAO)) continue;
+
+        if (++divergencias <= MAXIMO_DIVERGENCIAS_MOSTRADAS) {
+            std::printf("Divergência no vetor %llu (%s, op_code %u, %ux%u, processing_done %u):\n  pixels:",
+                        (unsigned long long)iteracao, nomes_sorteios[sorteio], opcode, codigo_tamanho + 2, codigo_tamanho + 2,
+                        (unsigned)coprocessador->processing_done);
+            for (int indice = 0; indice < 25; indice++) std::printf(" %u", pixels[indice]);
+            std::printf("\n  pesos:");
+            for (int indice = 0; indice < 25; indice++) std::printf(" %d", (int8_t)pesos[indice]);
+            std::printf("\n  lido:");
+            for (int indice = 0; indice < 25; indice++) std::printf(" %02x", lido[indice]);
+            std::printf("\n  esperado:");
+            for (int indice = 0; indice < 25; indice++) std::printf(" %02x", esperado[indice]);
+            std::printf("\n");
+        }
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    std::printf("coprocessor.v contra o modelo (%llu vetores, semente %llu, %.0f vetores/s):\n",
+                (unsigned long long)iteracoes, (unsigned long long)semente, segundos > 0 ? iteracoes / segundos : 0.0);
+    for (int indice = 0; indice < TOTAL_SORTEIOS_RTL; indice++) {
+        std::printf("  %-10s %10llu vetores\n", nomes_sorteios[indice], (unsigned long long)vetores_por_sorteio[indice]);
+    }
+    std::printf("  resultados: %llu em [-128, 127], %llu saturados em 255, %llu com estouro do acumulador de 16 bits\n",
+                (unsigned long long)em_faixa, (unsigned long long)saturados, (unsigned long long)com_volta);
+    std::printf("  outros op_codes: %llu\n", (unsigned long long)outros_opcodes);
+
+    coprocessador->final();
+    delete coprocessador;
+    if (divergencias) {
+        std::printf("FALHOU: %llu divergências\n", (unsigned long long)divergencias);
+        return 1;
+    }
+    std::printf("PASSOU\n");
+    return 0;
+}
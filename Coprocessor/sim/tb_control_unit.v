@@ -0,0 +1,242 @@
+`timescale 1ns / 1ps
+
+// Testbench de vazão do control_unit: um HPS modelado envia janelas aleatórias com a mesma
+// sequência do driver (lib.s/driver_mmio.c), confere os 25 bytes de cada resultado contra um
+// modelo de referência e mede ciclos por janela e por handshake.
+//
+// Parâmetros em tempo de execução (plusargs):
+//   +janelas=N            Janelas aleatórias (padrão 2000)
+//   +semente=N            Semente do $random (padrão 1)
+//   +latencia=N           Ciclos de cada acesso do HPS pela ponte, leitura e escrita (padrão 8)
+//   +latencia_escrita=N   Ciclos até uma escrita do HPS chegar a data_in (sobrepõe +latencia)
+//   +latencia_leitura=N   Ciclos de uma leitura de data_out pelo HPS (sobrepõe +latencia)
+module tb_control_unit;
+
+localparam PERIODO_CLOCK_NS = 20;          // CLOCK_50
+localparam FREQUENCIA_CLOCK = 50000000.0;
+localparam LIMITE_LEITURAS  = 10000;       // Leituras sem ack antes de declarar o handshake travado
+
+// Bits de controle de data_in/data_out (os mesmos de driver_mmio.h)
+localparam [31:0] BIT_RESET  = 32'h2000_0000,
+                  BIT_START  = 32'h4000_0000,
+                  BIT_PRONTO = 32'h8000_0000;
+localparam [2:0]  OPCODE_CONVOLUCAO = 3'b111;
+
+reg         clk = 1'b0;
+reg  [31:0] data_in = 32'b0;
+wire [31:0] data_out;
+
+control_unit dut (
+    .clk(clk),
+    .data_in(data_in),
+    .data_out(data_out)
+);
+
+always #(PERIODO_CLOCK_NS / 2) clk = ~clk;
+
+// Contador de ciclos: as medições são diferenças dele, tomadas nas bordas de descida
+reg [63:0] ciclo = 64'd0;
+always @(posedge clk) ciclo <= ciclo + 64'd1;
+
+// Configuração
+integer janelas, semente, latencia, latencia_escrita, latencia_leitura;
+
+// Janela atual
+reg [7:0] janela_pixel  [0:24];
+reg [7:0] janela_kernel [0:24];
+reg [7:0] resultado     [0:24];
+reg [1:0] tamanho;
+
+// Estatísticas
+reg [63:0] ciclos_pulsos, ciclos_envio, ciclos_recepcao, total_leituras_envio, total_leituras_recepcao;
+reg [63:0] inicio_janela, inicio_fase, ciclos_janela, menor_janela, maior_janela;
+integer leituras, maior_leituras_handshake, erros, janela, indice;
+reg [31:0] palavra_lida;
+
+// Referência: soma inteira dos produtos na janela lado × lado, truncada para 16 bits como o
+// acumulador de convolution.v; fora de [-128, 127] o resultado vira 255. Só os dois primeiros
+// bytes (parte baixa e alta) são diferentes de zero.
+function [7:0] byte_referencia;
+    input integer posicao;
+    integer linha, coluna, lado, soma;
+    reg signed [15:0] soma_16;
+    reg [15:0] valor;
+    begin
+        lado = tamanho + 2;
+        soma = 0;
+        for (linha = 0; linha < lado; linha = linha + 1)
+            for (coluna = 0; coluna < lado; coluna = coluna + 1)
+                soma = soma + $signed({1'b0, janela_pixel[linha * 5 + coluna]}) * $signed(janela_kernel[linha * 5 + coluna]);
+        soma_16 = soma[15:0];
+        valor = (soma_16 > 127 || soma_16 < -128) ? 16'd255 : soma_16;
+        byte_referencia = (posicao == 0) ? valor[7:0] : (posicao == 1) ? valor[15:8] : 8'd0;
+    end
+endfunction
+
+// Escrita do HPS: data_in muda `latencia_escrita` ciclos depois (bordas de descida, sem corrida com o RTL)
+task escrever;
+    input [31:0] valor;
+    begin
+        repeat (latencia_escrita) @(negedge clk);
+        data_in = valor;
+    end
+endtask
+
+// Leitura do HPS: o valor de data_out ao fim de `latencia_leitura` ciclos
+task ler;
+    output [31:0] valor;
+    begin
+        repeat (latencia_leitura) @(negedge clk);
+        valor = data_out;
+    end
+endtask
+
+// Espera o ack (bit 31 de data_out) chegar a `esperado`, como esperar_ack do driver
+task esperar_ack;
+    input esperado;
+    begin
+        ler(palavra_lida);
+        leituras = leituras + 1;
+        while (palavra_lida[31] !== esperado) begin
+            if (leituras > LIMITE_LEITURAS) begin
+                $display("FALHOU: handshake sem ack na janela %0d (data_out = %h)", janela, data_out);
+                $fatal(1, "control_unit travado");
+            end
+            ler(palavra_lida);
+            leituras = leituras + 1;
+        end
+    end
+endtask
+
+// Um handshake completo: palavra com o bit 31 ligado, ack em 1, bit 31 desligado, ack em 0.
+// Devolve o byte de data_out visto junto com o ack em 1.
+task handshake;
+    input  [31:0] palavra;
+    output [7:0]  byte_lido;
+    begin
+        leituras = 0;
+        escrever(palavra | BIT_PRONTO);
+        esperar_ack(1'b1);
+        byte_lido = palavra_lida[7:0];
+        escrever(32'b0);
+        esperar_ack(1'b0);
+        if (leituras > maior_leituras_handshake) maior_leituras_handshake = leituras;
+    end
+endtask
+
+// Sorteia uma janela. Metade tem pixels e kernel pequenos, para que a soma caia em [-128, 127]
+// (inclusive negativa) e os dois bytes do resultado sejam conferidos; a outra metade, valores
+// quaisquer, quase sempre saturados em 255. Posições fora do lado também recebem valores.
+task sortear_janela;
+    begin
+        tamanho = $random(semente);
+        for (indice = 0; indice < 25; indice = indice + 1) begin
+            if (janela % 2) begin
+                janela_pixel[indice]  = $random(semente) & 8'h1f;
+                janela_kernel[indice] = ($random(semente) & 1) ? (($random(semente) & 1) ? 8'h01 : 8'hff) : 8'h00;
+            end else begin
+                janela_pixel[indice]  = $random(semente);
+                janela_kernel[indice] = $random(semente);
+            end
+        end
+    end
+endtask
+
+// Uma transação completa, na ordem do driver: pulsos de reset e start, 25 envios e 25 leituras
+task processar_janela;
+    reg [7:0] descartado;
+    begin
+        inicio_janela = ciclo;
+        escrever(BIT_RESET);
+        escrever(32'b0);
+        escrever(BIT_START);
+        escrever(32'b0);
+        ciclos_pulsos = ciclos_pulsos + (ciclo - inicio_janela);
+
+        inicio_fase = ciclo;
+        for (indice = 0; indice < 25; indice = indice + 1) begin
+            handshake({11'b0, tamanho, OPCODE_CONVOLUCAO, janela_kernel[indice], janela_pixel[indice]}, descartado);
+            total_leituras_envio = total_leituras_envio + leituras;
+        end
+        ciclos_envio = ciclos_envio + (ciclo - inicio_fase);
+
+        inicio_fase = ciclo;
+        for (indice = 0; indice < 25; indice = indice + 1) begin
+            handshake(32'b0, resultado[indice]);
+            total_leituras_recepcao = total_leituras_recepcao + leituras;
+        end
+        ciclos_recepcao = ciclos_recepcao + (ciclo - inicio_fase);
+
+        ciclos_janela = ciclo - inicio_janela;
+        if (ciclos_janela < menor_janela) menor_janela = ciclos_janela;
+        if (ciclos_janela > maior_janela) maior_janela = ciclos_janela;
+    end
+endtask
+
+// Confere os 25 bytes; mostra as primeiras divergências
+task conferir_resultado;
+    integer posicao, divergente;
+    begin
+        divergente = 0;
+        for (posicao = 0; posicao < 25; posicao = posicao + 1)
+            if (resultado[posicao] !== byte_referencia(posicao)) divergente = 1;
+        if (divergente) begin
+            erros = erros + 1;
+            if (erros <= 5) begin
+                $display("Divergência na janela %0d (tamanho %0dx%0d):", janela, tamanho + 2, tamanho + 2);
+                for (posicao = 0; posicao < 25; posicao = posicao + 1)
+                    if (resultado[posicao] !== byte_referencia(posicao))
+                        $display("  byte %0d: lido %h, esperado %h", posicao, resultado[posicao], byte_referencia(posicao));
+            end
+        end
+    end
+endtask
+
+real ciclos_por_janela, handshakes;
+
+initial begin
+    if (!$value$plusargs("janelas=%d", janelas)) janelas = 2000;
+    if (!$value$plusargs("semente=%d", semente)) semente = 1;
+    if (!$value$plusargs("latencia=%d", latencia)) latencia = 8;
+    if (!$value$plusargs("latencia_escrita=%d", latencia_escrita)) latencia_escrita = latencia;
+    if (!$value$plusargs("latencia_leitura=%d", latencia_leitura)) latencia_leitura = latencia;
+    if (latencia_escrita < 1) latencia_escrita = 1; // Uma escrita por ciclo no máximo, como na ponte
+    if (latencia_leitura < 1) latencia_leitura = 1;
+
+    ciclos_pulsos = 0; ciclos_envio = 0; ciclos_recepcao = 0;
+    total_leituras_envio = 0; total_leituras_recepcao = 0;
+    menor_janela = {64{1'b1}}; maior_janela = 0;
+    maior_leituras_handshake = 0; erros = 0;
+
+    for (janela = 0; janela < janelas; janela = janela + 1) begin
+        sortear_janela;
+        processar_janela;
+        conferir_resultado;
+    end
+
+    handshakes = 25.0 * janelas;
+    ciclos_por_janela = (ciclos_pulsos + ciclos_envio + ciclos_recepcao) * 1.0 / janelas;
+    $display("Janelas: %0d (semente %0d), latência da ponte: escrita %0d, leitura %0d ciclos",
+             janelas, semente, latencia_escrita, latencia_leitura);
+    $display("Ciclos por janela: %0.1f (mín. %0d, máx. %0d)", ciclos_por_janela, menor_janela, maior_janela);
+    $display("  pulsos reset/start: %0.1f", ciclos_pulsos * 1.0 / janelas);
+    $display("  envio: %0.1f por janela, %0.2f por handshake, %0.2f leituras de data_out por handshake",
+             ciclos_envio * 1.0 / janelas, ciclos_envio / handshakes, total_leituras_envio / handshakes);
+    $display("  recepção: %0.1f por janela, %0.2f por handshake, %0.2f leituras de data_out por handshake",
+             ciclos_recepcao * 1.0 / janelas, ciclos_recepcao / handshakes, total_leituras_recepcao / handshakes);
+    $display("  máx. de leituras num handshake: %0d", maior_leituras_handshake);
+    $display("Janelas por segundo a %0.0f MHz: %0.0f (%0.2f us por janela)",
+             FREQUENCIA_CLOCK / 1.0e6, FREQUENCIA_CLOCK / ciclos_por_janela, ciclos_por_janela * 1.0e6 / FREQUENCIA_CLOCK);
+    $display("resumo latencia_escrita=%0d latencia_leitura=%0d ciclos_janela=%0.1f ciclos_handshake=%0.2f janelas_s=%0.0f erros=%0d",
+             latencia_escrita, latencia_leitura, ciclos_por_janela, (ciclos_envio + ciclos_recepcao) / (2.0 * handshakes),
+             FREQUENCIA_CLOCK / ciclos_por_janela, erros);
+
+    if (erros != 0) begin
+        $display("FALHOU: %0d de %0d janelas divergentes", erros, janelas);
+        $fatal(1, "resultados divergentes");
+    end
+    $display("PASSOU");
+    $finish;
+end
+
+endmodule
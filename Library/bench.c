@@ -0,0 +1,405 @@
+#include <stdio.h>    // Para a tabela de resultados e leitura da imagem de entrada (printf, fopen, fread).
+#include <stdlib.h>   // Para malloc, free, qsort e atoi.
+#include <string.h>   // Para strcmp e memcpy.
+#include <time.h>     // Para clock_gettime (relógio monotônico).
+#include "stb_image/stb_image.h"       // Decodificação (implementação em imagem.c).
+#include "stb_image/stb_image_write.h" // Codificação PNG em memória (implementação em imagem.c).
+#include "imagem.h"
+#include "filtros.h"
+#include "paralelo.h"
+
+// Definida por stb_image_write.h só na implementação (imagem.c); declarada aqui para a codificação em memória.
+unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len);
+
+/*
+ * Benchmark por etapa do pipeline (alvo `make bench`).
+ *
+ * Cada etapa é medida isoladamente: algumas iterações de aquecimento (caches, páginas e
+ * preditores) e depois N iterações cronometradas uma a uma com CLOCK_MONOTONIC. A tabela
+ * mostra a mediana, o p99 e a vazão em pixels por segundo calculada pela mediana. Só usa
+ * os motores de CPU, então roda em qualquer máquina (x86 inclusive), sem FPGA nem lib.s.
+ */
+
+#define ITERACOES_PADRAO   200
+#define AQUECIMENTO_PADRAO 20
+#define LARGURA_SINTETICA  640  // Imagem sintética: o dobro do tamanho padrão, para exercitar o redimensionamento.
+#define ALTURA_SINTETICA   480
+
+// Uma etapa medida: rotina chamada a cada iteração e pixels processados por chamada.
+typedef struct {
+    char nome[64];
+    void (*executar)(void *contexto);
+    void *contexto;
+    long pixels;
+} tipo_etapa_bench;
+
+// Configuração do benchmark, preenchida a partir dos argumentos.
+typedef struct {
+    int iteracoes;
+    int aquecimento;
+    int total_threads;
+    const char *arquivo_imagem;   // NULL: imagem sintética.
+    const char *arquivo_filtros;  // NULL: filtros embutidos.
+    const char *somente;          // Prefixo do nome das etapas a medir (NULL: todas).
+} tipo_configuracao_bench;
+
+// Buffers compartilhados pelas etapas (`static` para evitar estouro de pilha).
+static unsigned char *imagem_codificada;        // PNG/JPEG de entrada, em memória.
+static int tamanho_imagem_codificada;
+static unsigned char *imagem_decodificada;      // RGB decodificado (largura_origem x altura_origem x 3).
+static int largura_origem, altura_origem;
+static unsigned char imagem_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3];
+static unsigned char imagem_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG];
+static tipo_resultado_conv gradiente_x[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+static tipo_resultado_conv gradiente_y[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+static unsigned char resultado[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+
+// Contexto das etapas de convolução: uma cópia do kernel com o motor forçado.
+typedef struct {
+    tipo_kernel_analisado kernel;
+    tipo_resultado_conv *saida;
+} tipo_contexto_convolucao;
+
+// Contexto da etapa de extração de janelas.
+typedef struct {
+    uint32_t codigo_tamanho;
+} tipo_contexto_janela;
+
+/**
+ * @brief Tempo do relógio monotônico, em nanossegundos.
+ */
+static uint64_t agora_ns(void) {
+    struct timespec instante;
+    clock_gettime(CLOCK_MONOTONIC, &instante);
+    return (uint64_t)instante.tv_sec * 1000000000ull + (uint64_t)instante.tv_nsec;
+}
+
+static int comparar_tempos(const void *a, const void *b) {
+    uint64_t tempo_a = *(const uint64_t *)a, tempo_b = *(const uint64_t *)b;
+    return (tempo_a > tempo_b) - (tempo_a < tempo_b);
+}
+
+/* ---------- Etapas ---------- */
+
+static void etapa_decodificar(void *contexto) {
+    int largura, altura, canais;
+    (void)contexto;
+    unsigned char *dados = stbi_load_from_memory(imagem_codificada, tamanho_imagem_codificada, &largura, &altura, &canais, 3);
+    stbi_image_free(dados);
+}
+
+static void etapa_redimensionar(void *contexto) {
+    (void)contexto;
+    redimensionar_imagem_rgb(imagem_decodificada, largura_origem, altura_origem, imagem_rgb);
+}
+
+static void etapa_converter_cinza(void *contexto) {
+    (void)contexto;
+    converter_rgb_para_cinza(imagem_rgb, imagem_cinza);
+}
+
+/**
+ * @brief Extrai a janela de cada pixel do quadro, como o caminho da FPGA faz antes de cada envio.
+ */
+static void etapa_extrair_janelas(void *contexto) {
+    const tipo_contexto_janela *janela = (const tipo_contexto_janela *)contexto;
+    int coord_x, coord_y;
+    for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
+        for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
+            extrair_janela_vizinhanca_linear(imagem_cinza, coord_x, coord_y, janela->codigo_tamanho);
+        }
+    }
+}
+
+/**
+ * @brief Convolui uma faixa de linhas (rotina de `executar_em_faixas`).
+ */
+static void convolver_faixa(int linha_inicio, int linha_fim, void *argumento) {
+    const tipo_contexto_convolucao *convolucao = (const tipo_contexto_convolucao *)argumento;
+    convolver_regiao_cpu(&convolucao->kernel, &imagem_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                         0, linha_inicio, LARGURA_PADRAO_IMG, linha_fim, convolucao->saida);
+}
+
+static void etapa_convolver(void *contexto) {
+    executar_em_faixas(ALTURA_PADRAO_IMG, LADO_BLOCO_PLANO, convolver_faixa, contexto);
+}
+
+static void etapa_magnitude(void *contexto) {
+    (void)contexto;
+    calcular_magnitude_plano(gradiente_x, gradiente_y, ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG, resultado, NULL);
+}
+
+static void etapa_codificar_png(void *contexto) {
+    int tamanho;
+    (void)contexto;
+    unsigned char *png = stbi_write_png_to_mem(resultado, LARGURA_PADRAO_IMG, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, 1, &tamanho);
+    free(png);
+}
+
+/* ---------- Preparação ---------- */
+
+/**
+ * @brief Gera uma cena sintética determinística (degradês, retângulos, um disco e ruído) e a codifica em PNG.
+ *
+ * A cena tem bordas em várias orientações e regiões planas, para que os motores e o codificador
+ * trabalhem com dados parecidos com uma foto, e não com um quadro constante.
+ *
+ * @return 0 em caso de sucesso, -1 se faltar memória.
+ */
+static int gerar_imagem_sintetica(void) {
+    unsigned char *pixels = malloc((size_t)LARGURA_SINTETICA * ALTURA_SINTETICA * 3);
+    uint32_t semente = 12345u; // Gerador congruente linear: a mesma imagem em toda execução.
+    int coord_x, coord_y, canal;
+
+    if (pixels == NULL) return -1;
+    for (coord_y = 0; coord_y < ALTURA_SINTETICA; coord_y++) {
+        for (coord_x = 0; coord_x < LARGURA_SINTETICA; coord_x++) {
+            int delta_x = coord_x - LARGURA_SINTETICA / 2, delta_y = coord_y - ALTURA_SINTETICA / 2;
+            int dentro_disco = delta_x * delta_x + delta_y * delta_y < 120 * 120;
+            int dentro_retangulo = ((coord_x / 80) + (coord_y / 60)) % 2 == 0;
+            for (canal = 0; canal < 3; canal++) {
+                int valor = (coord_x * (canal + 1) / 5 + coord_y / (canal + 2)) & 0xFF;
+                if (dentro_retangulo) valor = 255 - valor;
+                if (dentro_disco) valor = 40 + 60 * canal;
+                semente = semente * 1664525u + 1013904223u;
+                valor += (int)(semente >> 28) - 8; // Ruído de ±8 níveis.
+                pixels[(coord_y * LARGURA_SINTETICA + coord_x) * 3 + canal] = (unsigned char)(valor < 0 ? 0 : valor > 255 ? 255 : valor);
+            }
+        }
+    }
+    imagem_codificada = stbi_write_png_to_mem(pixels, LARGURA_SINTETICA * 3, LARGURA_SINTETICA, ALTURA_SINTETICA, 3,
+                                              &tamanho_imagem_codificada);
+    free(pixels);
+    return (imagem_codificada != NULL) ? 0 : -1;
+}
+
+/**
+ * @brief Lê um arquivo de imagem inteiro para a memória (a decodificação é medida sem E/S de disco).
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro.
+ */
+static int ler_imagem_arquivo(const char *caminho) {
+    FILE *arquivo = fopen(caminho, "rb");
+    long tamanho;
+
+    if (arquivo == NULL) {
+        perror("Erro ao abrir a imagem do benchmark");
+        return -1;
+    }
+    fseek(arquivo, 0, SEEK_END);
+    tamanho = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+    imagem_codificada = (tamanho > 0) ? malloc((size_t)tamanho) : NULL;
+    if (imagem_codificada == NULL || fread(imagem_codificada, 1, (size_t)tamanho, arquivo) != (size_t)tamanho) {
+        fprintf(stderr, "Erro ao ler '%s'\n", caminho);
+        fclose(arquivo);
+        return -1;
+    }
+    fclose(arquivo);
+    tamanho_imagem_codificada = (int)tamanho;
+    return 0;
+}
+
+/**
+ * @brief Mede uma etapa e imprime uma linha da tabela.
+ *
+ * @return 0 em caso de sucesso, -1 se faltar memória para os tempos.
+ */
+static int medir_etapa(const tipo_etapa_bench *etapa, const tipo_configuracao_bench *configuracao) {
+    uint64_t *tempos = malloc((size_t)configuracao->iteracoes * sizeof(uint64_t));
+    int iteracao;
+
+    if (tempos == NULL) return -1;
+    for (iteracao = 0; iteracao < configuracao->aquecimento; iteracao++) etapa->executar(etapa->contexto);
+    for (iteracao = 0; iteracao < configuracao->iteracoes; iteracao++) {
+        uint64_t inicio = agora_ns();
+        etapa->executar(etapa->contexto);
+        tempos[iteracao] = agora_ns() - inicio;
+    }
+    qsort(tempos, (size_t)configuracao->iteracoes, sizeof(uint64_t), comparar_tempos);
+
+    uint64_t mediana = tempos[configuracao->iteracoes / 2];
+    uint64_t p99 = tempos[(configuracao->iteracoes * 99) / 100 < configuracao->iteracoes ? (configuracao->iteracoes * 99) / 100
+                                                                                         : configuracao->iteracoes - 1];
+    double pixels_por_segundo = (mediana > 0) ? etapa->pixels * 1e9 / (double)mediana : 0.0;
+    printf("%-38s %12.1f %12.1f %10.2f\n", etapa->nome, mediana / 1000.0, p99 / 1000.0, pixels_por_segundo / 1e6);
+    free(tempos);
+    return 0;
+}
+
+static void imprimir_uso_bench(const char *nome_programa) {
+    printf("Uso: %s [opções]\n", nome_programa);
+    printf("  --iteracoes N        Iterações medidas por etapa (padrão: %d)\n", ITERACOES_PADRAO);
+    printf("  --aquecimento N      Iterações descartadas antes da medição (padrão: %d)\n", AQUECIMENTO_PADRAO);
+    printf("  --threads N          Threads das etapas de convolução (padrão: 1; 0 = uma por processador)\n");
+    printf("  --imagem arquivo     Imagem de entrada (padrão: cena sintética %dx%d)\n", LARGURA_SINTETICA, ALTURA_SINTETICA);
+    printf("  --filtros arquivo    Registro de filtros (padrão: filtros embutidos)\n");
+    printf("  --somente prefixo    Mede só as etapas cujo nome começa com o prefixo (ex.: conv)\n");
+}
+
+/**
+ * @brief Interpreta os argumentos do benchmark.
+ *
+ * @return 0 para continuar, 1 se a ajuda foi exibida, -1 em caso de erro.
+ */
+static int interpretar_argumentos_bench(int argc, char *argv[], tipo_configuracao_bench *configuracao) {
+    int indice_argumento;
+
+    for (indice_argumento = 1; indice_argumento < argc; indice_argumento++) {
+        const char *argumento = argv[indice_argumento];
+        const char *valor = (indice_argumento + 1 < argc) ? argv[indice_argumento + 1] : NULL;
+
+        if (strcmp(argumento, "--ajuda") == 0) {
+            imprimir_uso_bench(argv[0]);
+            return 1;
+        } else if (strcmp(argumento, "--iteracoes") == 0 && valor != NULL) {
+            configuracao->iteracoes = atoi(valor);
+            indice_argumento++;
+        } else if (strcmp(argumento, "--aquecimento") == 0 && valor != NULL) {
+            configuracao->aquecimento = atoi(valor);
+            indice_argumento++;
+        } else if (strcmp(argumento, "--threads") == 0 && valor != NULL) {
+            configuracao->total_threads = atoi(valor);
+            indice_argumento++;
+        } else if (strcmp(argumento, "--imagem") == 0 && valor != NULL) {
+            configuracao->arquivo_imagem = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--filtros") == 0 && valor != NULL) {
+            configuracao->arquivo_filtros = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--somente") == 0 && valor != NULL) {
+            configuracao->somente = valor;
+            indice_argumento++;
+        } else {
+            fprintf(stderr, "Argumento inválido: '%s'\n", argumento);
+            imprimir_uso_bench(argv[0]);
+            return -1;
+        }
+    }
+    if (configuracao->iteracoes < 1 || configuracao->aquecimento < 0 || configuracao->total_threads < 0) {
+        fprintf(stderr, "Iterações, aquecimento ou threads inválidos\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    tipo_configuracao_bench configuracao = { ITERACOES_PADRAO, AQUECIMENTO_PADRAO, 1, NULL, NULL, NULL };
+    // Etapas fixas + extração (3 tamanhos) + até 5 motores por kernel de cada filtro.
+    static tipo_etapa_bench etapas[8 + MAX_FILTROS_REGISTRADOS * 2 * 5];
+    static tipo_contexto_convolucao contextos_convolucao[MAX_FILTROS_REGISTRADOS * 2 * 5];
+    static const tipo_contexto_janela contextos_janela[3] = { { 0 }, { 1 }, { 3 } };
+    static const char *nomes_janela[3] = { "2x2", "3x3", "5x5" };
+    int total_etapas = 0, total_convolucoes = 0;
+    int indice, indice_filtro, indice_kernel, motor, canais;
+    const long pixels_quadro = (long)LARGURA_PADRAO_IMG * ALTURA_PADRAO_IMG;
+
+    int resultado_argumentos = interpretar_argumentos_bench(argc, argv, &configuracao);
+    if (resultado_argumentos != 0) return (resultado_argumentos > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if (configuracao.arquivo_filtros == NULL || carregar_registro_filtros(configuracao.arquivo_filtros) < 0) {
+        if (configuracao.arquivo_filtros != NULL) {
+            printf("Arquivo de filtros '%s' indisponível ou inválido. Usando filtros embutidos.\n", configuracao.arquivo_filtros);
+        }
+        registrar_filtros_padrao();
+    }
+
+    // Entrada: codificada em memória, decodificada uma vez e levada ao tamanho padrão.
+    if ((configuracao.arquivo_imagem != NULL ? ler_imagem_arquivo(configuracao.arquivo_imagem) : gerar_imagem_sintetica()) != 0) {
+        fprintf(stderr, "Não foi possível preparar a imagem de entrada\n");
+        return EXIT_FAILURE;
+    }
+    imagem_decodificada = stbi_load_from_memory(imagem_codificada, tamanho_imagem_codificada, &largura_origem, &altura_origem, &canais, 3);
+    if (imagem_decodificada == NULL) {
+        fprintf(stderr, "Imagem de entrada inválida: %s\n", stbi_failure_reason());
+        return EXIT_FAILURE;
+    }
+    redimensionar_imagem_rgb(imagem_decodificada, largura_origem, altura_origem, imagem_rgb);
+    converter_rgb_para_cinza(imagem_rgb, imagem_cinza);
+    iniciar_grupo_threads(configuracao.total_threads);
+
+    // --- Etapas de entrada e conversão ---
+    tipo_etapa_bench *etapa = &etapas[total_etapas++];
+    snprintf(etapa->nome, sizeof(etapa->nome), "decodificar %dx%d", largura_origem, altura_origem);
+    etapa->executar = etapa_decodificar;
+    etapa->pixels = (long)largura_origem * altura_origem;
+
+    etapa = &etapas[total_etapas++];
+    snprintf(etapa->nome, sizeof(etapa->nome), "redimensionar -> %dx%d", LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG);
+    etapa->executar = etapa_redimensionar;
+    etapa->pixels = pixels_quadro;
+
+    etapa = &etapas[total_etapas++];
+    snprintf(etapa->nome, sizeof(etapa->nome), "converter_rgb_para_cinza");
+    etapa->executar = etapa_converter_cinza;
+    etapa->pixels = pixels_quadro;
+
+    for (indice = 0; indice < 3; indice++) {
+        etapa = &etapas[total_etapas++];
+        snprintf(etapa->nome, sizeof(etapa->nome), "extrair_janela %s", nomes_janela[indice]);
+        etapa->executar = etapa_extrair_janelas;
+        etapa->contexto = (void *)&contextos_janela[indice];
+        etapa->pixels = pixels_quadro;
+    }
+
+    // --- Convolução: cada motor aplicável a cada kernel de cada filtro ---
+    for (indice_filtro = 0; indice_filtro < total_filtros_registrados; indice_filtro++) {
+        const tipo_filtro_borda *filtro = &filtros_registrados[indice_filtro];
+        for (indice_kernel = 0; indice_kernel < (filtro->possui_gy ? 2 : 1); indice_kernel++) {
+            const tipo_kernel_analisado *kernel = (indice_kernel == 0) ? &filtro->kernel_gx : &filtro->kernel_gy;
+            for (motor = MOTOR_ESPECIALIZADO; motor <= MOTOR_GENERICO; motor++) {
+                if (!motor_aplicavel_kernel(kernel, (tipo_motor_kernel)motor)) continue;
+                tipo_contexto_convolucao *convolucao = &contextos_convolucao[total_convolucoes++];
+                memcpy(&convolucao->kernel, kernel, sizeof(*kernel));
+                convolucao->kernel.motor = (tipo_motor_kernel)motor;
+                convolucao->saida = (indice_kernel == 0) ? gradiente_x : gradiente_y;
+
+                etapa = &etapas[total_etapas++];
+                snprintf(etapa->nome, sizeof(etapa->nome), "conv %.31s/%s %s%s", filtro->nome, indice_kernel ? "gy" : "gx",
+                         nome_motor_kernel((tipo_motor_kernel)motor), (motor == (int)kernel->motor) ? " *" : "");
+                etapa->executar = etapa_convolver;
+                etapa->contexto = convolucao;
+                etapa->pixels = pixels_quadro;
+            }
+        }
+    }
+
+    // --- Magnitude e codificação (sobre os gradientes do primeiro filtro com Gy) ---
+    for (indice_filtro = 0; indice_filtro < total_filtros_registrados; indice_filtro++) {
+        const tipo_filtro_borda *filtro = &filtros_registrados[indice_filtro];
+        if (!filtro->possui_gy) continue;
+        convolver_regiao_cpu(&filtro->kernel_gx, &imagem_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                             0, 0, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, gradiente_x);
+        convolver_regiao_cpu(&filtro->kernel_gy, &imagem_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                             0, 0, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, gradiente_y);
+        break;
+    }
+    calcular_magnitude_plano(gradiente_x, gradiente_y, (int)pixels_quadro, resultado, NULL);
+
+    etapa = &etapas[total_etapas++];
+    snprintf(etapa->nome, sizeof(etapa->nome), "magnitude");
+    etapa->executar = etapa_magnitude;
+    etapa->pixels = pixels_quadro;
+
+    etapa = &etapas[total_etapas++];
+    snprintf(etapa->nome, sizeof(etapa->nome), "codificar PNG");
+    etapa->executar = etapa_codificar_png;
+    etapa->pixels = pixels_quadro;
+
+    printf("Benchmark: %d iterações (+%d de aquecimento) por etapa, %d thread(s) nas convoluções.\n",
+           configuracao.iteracoes, configuracao.aquecimento, total_threads_grupo());
+    printf("Motor marcado com * é o escolhido pela análise do kernel.\n\n");
+    printf("%-38s %12s %12s %10s\n", "etapa", "mediana(us)", "p99(us)", "Mpx/s");
+    for (indice = 0; indice < total_etapas; indice++) {
+        if (configuracao.somente != NULL && strncmp(etapas[indice].nome, configuracao.somente, strlen(configuracao.somente)) != 0) continue;
+        if (medir_etapa(&etapas[indice], &configuracao) != 0) {
+            fprintf(stderr, "Memória insuficiente para os tempos do benchmark\n");
+            break;
+        }
+    }
+
+    encerrar_grupo_threads();
+    stbi_image_free(imagem_decodificada);
+    free(imagem_codificada);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,447 @@
+#include <stdio.h>        // Para o CSV e as mensagens.
+#include <stdlib.h>       // Para malloc, free, qsort, atoi e strtod.
+#include <string.h>       // Para strcmp, strtok, strncpy e strrchr.
+#include <strings.h>      // Para strcasecmp (extensões das imagens).
+#include <time.h>         // Para clock_gettime (relógio monotônico).
+#include <dirent.h>       // Para contar as imagens do corpus.
+#include <unistd.h>       // Para fork, pipe, dup2 e execv.
+#include <fcntl.h>        // Para abrir /dev/null.
+#include <signal.h>       // Para ignorar SIGPIPE se o programa terminar antes de ler o menu.
+#include <sys/wait.h>     // Para waitpid e o estado de saída.
+#include <sys/resource.h> // Para wait4/struct rusage (pico de memória residente).
+#include "filtros.h"      // Nomes dos filtros do menu (mesmo registro carregado pelo programa).
+#include "paralelo.h"     // Para MAX_THREADS_GRUPO.
+
+/*
+ * Benchmark de ponta a ponta sobre o corpus sintético (`make bench-corpus`).
+ *
+ * Para cada motor, filtro e quantidade de threads, executa o programa inteiro sobre o
+ * diretório do corpus, escolhendo o filtro pelo menu (stdin) e fechando a entrada em seguida,
+ * o que encerra o programa. Mede o tempo de parede de cada execução e o pico de memória
+ * residente do processo (wait4), repete a medição e grava a mediana em CSV. O fator de
+ * aceleração é relativo à primeira quantidade de threads da lista, então cada combinação de
+ * motor e filtro forma uma curva de escalabilidade.
+ */
+
+#define MAX_ITENS_LISTA     16
+#define MAX_LINHAS_CSV      1024
+#define REPETICOES_PADRAO   3
+#define TOLERANCIA_PADRAO   10.0  // Regressão: piora maior que esta porcentagem em relação à baseline.
+
+// Uma linha de resultado (também o formato de uma linha da baseline).
+typedef struct {
+    char motor[8];
+    char filtro[TAMANHO_NOME_FILTRO];
+    int threads;
+    int imagens;
+    double ms_total;
+    double imagens_por_segundo;
+    long rss_pico_kb;
+} tipo_resultado_corpus;
+
+// Configuração do benchmark, preenchida a partir dos argumentos.
+typedef struct {
+    const char *programa;
+    const char *diretorio_corpus;
+    const char *diretorio_saida;
+    const char *arquivo_filtros;
+    const char *arquivo_csv;
+    const char *arquivo_baseline;
+    char motores[MAX_ITENS_LISTA][8];
+    int total_motores;
+    int indices_filtros[MAX_ITENS_LISTA];  // Índices no registro (0 = primeira opção do menu).
+    int total_filtros;
+    int threads[MAX_ITENS_LISTA];
+    int total_threads;
+    int repeticoes;
+    double tolerancia;
+} tipo_configuracao_corpus;
+
+static uint64_t agora_ns(void) {
+    struct timespec instante;
+    clock_gettime(CLOCK_MONOTONIC, &instante);
+    return (uint64_t)instante.tv_sec * 1000000000ull + (uint64_t)instante.tv_nsec;
+}
+
+static int comparar_double(const void *a, const void *b) {
+    double valor_a = *(const double *)a, valor_b = *(const double *)b;
+    return (valor_a > valor_b) - (valor_a < valor_b);
+}
+
+/**
+ * @brief Conta as imagens que o programa processa no diretório (mesmas extensões de `verificar_arquivo_imagem_valido`).
+ */
+static int contar_imagens_corpus(const char *diretorio) {
+    static const char *extensoes[] = { ".png", ".jpg", ".jpeg", ".bmp" };
+    DIR *ponteiro_diretorio = opendir(diretorio);
+    struct dirent *entrada;
+    int total = 0;
+    size_t indice;
+
+    if (ponteiro_diretorio == NULL) return -1;
+    while ((entrada = readdir(ponteiro_diretorio)) != NULL) {
+        const char *extensao = strrchr(entrada->d_name, '.');
+        if (extensao == NULL) continue;
+        for (indice = 0; indice < sizeof(extensoes) / sizeof(extensoes[0]); indice++) {
+            if (strcasecmp(extensao, extensoes[indice]) == 0) {
+                total++;
+                break;
+            }
+        }
+    }
+    closedir(ponteiro_diretorio);
+    return total;
+}
+
+/**
+ * @brief Executa o programa uma vez sobre o corpus e mede o tempo de parede e o pico de RSS.
+ *
+ * O filtro é escolhido escrevendo a opção do menu na entrada do programa; a entrada é fechada
+ * logo depois, e o fim da entrada encerra o menu.
+ *
+ * @param opcao_menu Opção do menu (1 = primeiro filtro registrado).
+ * @param ms_total Saída: tempo de parede da execução, em milissegundos.
+ * @param rss_pico_kb Saída: pico de memória residente do processo, em KiB.
+ * @return 0 em caso de sucesso, -1 se o programa não pôde ser executado ou terminou com erro.
+ */
+static int executar_programa(const tipo_configuracao_corpus *configuracao, const char *motor, int opcao_menu, int threads,
+                             double *ms_total, long *rss_pico_kb) {
+    char texto_threads[16], texto_opcao[16];
+    const char *argumentos[16];
+    int total_argumentos = 0, canal_entrada[2], estado;
+    struct rusage uso;
+
+    snprintf(texto_threads, sizeof(texto_threads), "%d", threads);
+    snprintf(texto_opcao, sizeof(texto_opcao), "%d\n", opcao_menu);
+    argumentos[total_argumentos++] = configuracao->programa;
+    if (strcmp(motor, "cpu") == 0) {
+        argumentos[total_argumentos++] = "--motor";
+        argumentos[total_argumentos++] = "cpu";
+    }
+    argumentos[total_argumentos++] = "--threads";
+    argumentos[total_argumentos++] = texto_threads;
+    argumentos[total_argumentos++] = "--entrada";
+    argumentos[total_argumentos++] = configuracao->diretorio_corpus;
+    argumentos[total_argumentos++] = "--saida";
+    argumentos[total_argumentos++] = configuracao->diretorio_saida;
+    if (configuracao->arquivo_filtros != NULL) {
+        argumentos[total_argumentos++] = "--filtros";
+        argumentos[total_argumentos++] = configuracao->arquivo_filtros;
+    }
+    argumentos[total_argumentos] = NULL;
+
+    if (pipe(canal_entrada) != 0) {
+        perror("pipe");
+        return -1;
+    }
+    uint64_t inicio = agora_ns();
+    pid_t processo = fork();
+    if (processo < 0) {
+        perror("fork");
+        close(canal_entrada[0]);
+        close(canal_entrada[1]);
+        return -1;
+    }
+    if (processo == 0) {
+        // Processo filho: menu pela entrada padrão, saída descartada (o log não faz parte da medição).
+        int nulo = open("/dev/null", O_WRONLY);
+        dup2(canal_entrada[0], STDIN_FILENO);
+        if (nulo >= 0) {
+            dup2(nulo, STDOUT_FILENO);
+            dup2(nulo, STDERR_FILENO);
+        }
+        close(canal_entrada[0]);
+        close(canal_entrada[1]);
+        execv(configuracao->programa, (char *const *)argumentos);
+        _exit(127);
+    }
+
+    close(canal_entrada[0]);
+    if (write(canal_entrada[1], texto_opcao, strlen(texto_opcao)) < 0) {
+        // O programa terminou antes de ler o menu; o estado de saída mostra o motivo.
+    }
+    close(canal_entrada[1]);
+    if (wait4(processo, &estado, 0, &uso) < 0) {
+        perror("wait4");
+        return -1;
+    }
+    *ms_total = (agora_ns() - inicio) / 1e6;
+    *rss_pico_kb = uso.ru_maxrss; // Em KiB no Linux.
+
+    if (!WIFEXITED(estado) || WEXITSTATUS(estado) != 0) {
+        fprintf(stderr, "'%s' terminou com erro (estado %d) para motor %s, opção %d, %d thread(s)\n", configuracao->programa,
+                WIFEXITED(estado) ? WEXITSTATUS(estado) : -1, motor, opcao_menu, threads);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Lê uma baseline (CSV gravado por uma execução anterior).
+ *
+ * @return Quantidade de linhas lidas, ou -1 se o arquivo não puder ser aberto.
+ */
+static int ler_baseline(const char *caminho, tipo_resultado_corpus *linhas) {
+    FILE *arquivo = fopen(caminho, "r");
+    char linha[512];
+    int total = 0;
+
+    if (arquivo == NULL) return -1;
+    while (total < MAX_LINHAS_CSV && fgets(linha, sizeof(linha), arquivo) != NULL) {
+        tipo_resultado_corpus *resultado = &linhas[total];
+        double ms_por_imagem, aceleracao;
+        // motor,filtro,threads,imagens,ms_total,ms_por_imagem,imagens_por_s,rss_pico_kb,aceleracao
+        if (sscanf(linha, "%7[^,],%31[^,],%d,%d,%lf,%lf,%lf,%ld,%lf", resultado->motor, resultado->filtro, &resultado->threads,
+                   &resultado->imagens, &resultado->ms_total, &ms_por_imagem, &resultado->imagens_por_segundo,
+                   &resultado->rss_pico_kb, &aceleracao) == 9) {
+            total++; // O cabeçalho não casa com o formato e é ignorado.
+        }
+    }
+    fclose(arquivo);
+    return total;
+}
+
+/**
+ * @brief Compara os resultados com a baseline e imprime as regressões.
+ *
+ * Uma configuração regrediu se a vazão (imagens/s) caiu, ou o pico de RSS subiu, mais que
+ * `tolerancia` por cento. Configurações ausentes da baseline só são listadas.
+ *
+ * @return Quantidade de regressões.
+ */
+static int comparar_com_baseline(const tipo_resultado_corpus *resultados, int total_resultados,
+                                 const tipo_resultado_corpus *baseline, int total_baseline, double tolerancia) {
+    int indice, indice_baseline, regressoes = 0;
+
+    printf("\nComparação com a baseline (tolerância %.1f%%):\n", tolerancia);
+    for (indice = 0; indice < total_resultados; indice++) {
+        const tipo_resultado_corpus *atual = &resultados[indice];
+        const tipo_resultado_corpus *referencia = NULL;
+        for (indice_baseline = 0; indice_baseline < total_baseline; indice_baseline++) {
+            if (strcmp(baseline[indice_baseline].motor, atual->motor) == 0 && strcmp(baseline[indice_baseline].filtro, atual->filtro) == 0 &&
+                baseline[indice_baseline].threads == atual->threads) {
+                referencia = &baseline[indice_baseline];
+                break;
+            }
+        }
+        if (referencia == NULL) {
+            printf("  %-4s %-16s %2d thread(s): sem baseline\n", atual->motor, atual->filtro, atual->threads);
+            continue;
+        }
+        double variacao_vazao = 100.0 * (atual->imagens_por_segundo - referencia->imagens_por_segundo) / referencia->imagens_por_segundo;
+        double variacao_rss = (referencia->rss_pico_kb > 0)
+                                  ? 100.0 * (double)(atual->rss_pico_kb - referencia->rss_pico_kb) / (double)referencia->rss_pico_kb : 0.0;
+        int regrediu = variacao_vazao < -tolerancia || variacao_rss > tolerancia;
+        printf("  %-4s %-16s %2d thread(s): %+6.1f%% imagens/s, %+6.1f%% RSS%s\n", atual->motor, atual->filtro, atual->threads,
+               variacao_vazao, variacao_rss, regrediu ? "  <-- REGRESSÃO" : "");
+        regressoes += regrediu;
+    }
+    return regressoes;
+}
+
+/**
+ * @brief Lê uma lista separada por vírgulas, chamando `tratar_item` para cada item.
+ *
+ * @return Quantidade de itens, ou -1 se algum item for inválido ou a lista for longa demais.
+ */
+static int ler_lista(const char *texto, int (*tratar_item)(const char *item, int posicao, tipo_configuracao_corpus *configuracao),
+                     tipo_configuracao_corpus *configuracao) {
+    char copia[256];
+    int total = 0;
+    strncpy(copia, texto, sizeof(copia) - 1);
+    copia[sizeof(copia) - 1] = '\0';
+    for (char *item = strtok(copia, ","); item != NULL; item = strtok(NULL, ",")) {
+        if (total == MAX_ITENS_LISTA || tratar_item(item, total, configuracao) != 0) return -1;
+        total++;
+    }
+    return total;
+}
+
+static int tratar_motor(const char *item, int posicao, tipo_configuracao_corpus *configuracao) {
+    if (strcmp(item, "cpu") != 0 && strcmp(item, "fpga") != 0) return -1;
+    strncpy(configuracao->motores[posicao], item, sizeof(configuracao->motores[posicao]) - 1);
+    return 0;
+}
+
+static int tratar_threads(const char *item, int posicao, tipo_configuracao_corpus *configuracao) {
+    int threads = atoi(item);
+    if (threads < 1 || threads > MAX_THREADS_GRUPO) return -1;
+    configuracao->threads[posicao] = threads;
+    return 0;
+}
+
+static int tratar_filtro(const char *item, int posicao, tipo_configuracao_corpus *configuracao) {
+    int indice;
+    for (indice = 0; indice < total_filtros_registrados; indice++) {
+        if (strcmp(filtros_registrados[indice].nome, item) == 0) {
+            configuracao->indices_filtros[posicao] = indice;
+            return 0;
+        }
+    }
+    fprintf(stderr, "Filtro desconhecido: '%s'\n", item);
+    return -1;
+}
+
+static void imprimir_uso_corpus(const char *nome_programa) {
+    printf("Uso: %s [opções]\n", nome_programa);
+    printf("  --programa CAMINHO   Executável a medir (padrão: ./main)\n");
+    printf("  --corpus DIR         Diretório com as imagens (padrão: corpus)\n");
+    printf("  --saida DIR          Diretório de saída do programa (padrão: corpus_saida)\n");
+    printf("  --filtros ARQUIVO    Registro de filtros passado ao programa (padrão: o do programa)\n");
+    printf("  --selecao a,b,...    Filtros medidos, por nome (padrão: todos os registrados)\n");
+    printf("  --motores cpu,fpga   Motores medidos (padrão: cpu)\n");
+    printf("  --threads 1,2,4      Quantidades de threads (padrão: 1,2,4)\n");
+    printf("  --repeticoes N       Execuções por configuração; vale a mediana (padrão: %d)\n", REPETICOES_PADRAO);
+    printf("  --csv ARQUIVO        CSV com as curvas (padrão: bench_corpus.csv)\n");
+    printf("  --baseline ARQUIVO   Compara com um CSV anterior e falha se houver regressão\n");
+    printf("  --tolerancia P       Regressão tolerada, em %% (padrão: %.0f)\n", TOLERANCIA_PADRAO);
+}
+
+int main(int argc, char *argv[]) {
+    tipo_configuracao_corpus configuracao = { "./main", "corpus", "corpus_saida", NULL, "bench_corpus.csv", NULL,
+                                              { "cpu" }, 1, { 0 }, 0, { 1, 2, 4 }, 3, REPETICOES_PADRAO, TOLERANCIA_PADRAO };
+    static tipo_resultado_corpus resultados[MAX_LINHAS_CSV], baseline[MAX_LINHAS_CSV];
+    const char *selecao = NULL;
+    int indice_argumento, total_resultados = 0, total_falhas = 0, indice_motor, indice_filtro, indice_threads, repeticao;
+
+    for (indice_argumento = 1; indice_argumento < argc; indice_argumento++) {
+        const char *argumento = argv[indice_argumento];
+        const char *valor = (indice_argumento + 1 < argc) ? argv[indice_argumento + 1] : NULL;
+        int invalido = 0;
+
+        if (strcmp(argumento, "--ajuda") == 0) {
+            imprimir_uso_corpus(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (valor == NULL) {
+            invalido = 1;
+        } else if (strcmp(argumento, "--programa") == 0) {
+            configuracao.programa = valor;
+        } else if (strcmp(argumento, "--corpus") == 0) {
+            configuracao.diretorio_corpus = valor;
+        } else if (strcmp(argumento, "--saida") == 0) {
+            configuracao.diretorio_saida = valor;
+        } else if (strcmp(argumento, "--filtros") == 0) {
+            configuracao.arquivo_filtros = valor;
+        } else if (strcmp(argumento, "--selecao") == 0) {
+            selecao = valor;
+        } else if (strcmp(argumento, "--motores") == 0) {
+            invalido = (configuracao.total_motores = ler_lista(valor, tratar_motor, &configuracao)) <= 0;
+        } else if (strcmp(argumento, "--threads") == 0) {
+            invalido = (configuracao.total_threads = ler_lista(valor, tratar_threads, &configuracao)) <= 0;
+        } else if (strcmp(argumento, "--repeticoes") == 0) {
+            invalido = (configuracao.repeticoes = atoi(valor)) < 1;
+        } else if (strcmp(argumento, "--csv") == 0) {
+            configuracao.arquivo_csv = valor;
+        } else if (strcmp(argumento, "--baseline") == 0) {
+            configuracao.arquivo_baseline = valor;
+        } else if (strcmp(argumento, "--tolerancia") == 0) {
+            configuracao.tolerancia = strtod(valor, NULL);
+            invalido = configuracao.tolerancia < 0.0;
+        } else {
+            invalido = 1;
+        }
+        if (invalido) {
+            fprintf(stderr, "Argumento inválido: '%s'\n", argumento);
+            imprimir_uso_corpus(argv[0]);
+            return EXIT_FAILURE;
+        }
+        indice_argumento++;
+    }
+
+    // Mesmo registro que o programa vai carregar, para associar as opções do menu aos nomes.
+    if (carregar_registro_filtros(configuracao.arquivo_filtros != NULL ? configuracao.arquivo_filtros : ARQUIVO_FILTROS_PADRAO) < 0) {
+        registrar_filtros_padrao();
+    }
+    if (selecao != NULL) {
+        configuracao.total_filtros = ler_lista(selecao, tratar_filtro, &configuracao);
+        if (configuracao.total_filtros <= 0) return EXIT_FAILURE;
+    } else {
+        for (indice_filtro = 0; indice_filtro < total_filtros_registrados && indice_filtro < MAX_ITENS_LISTA; indice_filtro++) {
+            configuracao.indices_filtros[configuracao.total_filtros++] = indice_filtro;
+        }
+    }
+
+    int total_imagens = contar_imagens_corpus(configuracao.diretorio_corpus);
+    if (total_imagens <= 0) {
+        fprintf(stderr, "Nenhuma imagem em '%s' (gere o corpus com `make corpus`)\n", configuracao.diretorio_corpus);
+        return EXIT_FAILURE;
+    }
+
+    FILE *csv = fopen(configuracao.arquivo_csv, "w");
+    if (csv == NULL) {
+        perror("Erro ao criar o CSV");
+        return EXIT_FAILURE;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    fprintf(csv, "motor,filtro,threads,imagens,ms_total,ms_por_imagem,imagens_por_s,rss_pico_kb,aceleracao\n");
+    printf("Corpus '%s': %d imagens, %d repetição(ões) por configuração.\n\n", configuracao.diretorio_corpus, total_imagens,
+           configuracao.repeticoes);
+    printf("%-4s %-16s %7s %10s %10s %10s %9s\n", "motor", "filtro", "threads", "ms/imagem", "imagens/s", "RSS (KiB)", "acel.");
+
+    for (indice_motor = 0; indice_motor < configuracao.total_motores; indice_motor++) {
+        for (indice_filtro = 0; indice_filtro < configuracao.total_filtros; indice_filtro++) {
+            int indice_registro = configuracao.indices_filtros[indice_filtro];
+            double vazao_referencia = 0.0;
+            for (indice_threads = 0; indice_threads < configuracao.total_threads && total_resultados < MAX_LINHAS_CSV; indice_threads++) {
+                tipo_resultado_corpus *resultado = &resultados[total_resultados];
+                double tempos[64];
+                long rss_maximo = 0;
+                int repeticoes = configuracao.repeticoes < 64 ? configuracao.repeticoes : 64, falhou = 0;
+
+                for (repeticao = 0; repeticao < repeticoes; repeticao++) {
+                    long rss_pico_kb;
+                    if (executar_programa(&configuracao, configuracao.motores[indice_motor], indice_registro + 1,
+                                          configuracao.threads[indice_threads], &tempos[repeticao], &rss_pico_kb) != 0) {
+                        falhou = 1;
+                        break;
+                    }
+                    if (rss_pico_kb > rss_maximo) rss_maximo = rss_pico_kb;
+                }
+                if (falhou) {
+                    total_falhas++;
+                    continue;
+                }
+                qsort(tempos, (size_t)repeticoes, sizeof(double), comparar_double);
+
+                strncpy(resultado->motor, configuracao.motores[indice_motor], sizeof(resultado->motor) - 1);
+                strncpy(resultado->filtro, filtros_registrados[indice_registro].nome, sizeof(resultado->filtro) - 1);
+                resultado->threads = configuracao.threads[indice_threads];
+                resultado->imagens = total_imagens;
+                resultado->ms_total = tempos[repeticoes / 2];
+                resultado->imagens_por_segundo = total_imagens * 1000.0 / resultado->ms_total;
+                resultado->rss_pico_kb = rss_maximo;
+                if (vazao_referencia == 0.0) vazao_referencia = resultado->imagens_por_segundo;
+                double aceleracao = resultado->imagens_por_segundo / vazao_referencia;
+
+                fprintf(csv, "%s,%s,%d,%d,%.3f,%.3f,%.3f,%ld,%.3f\n", resultado->motor, resultado->filtro, resultado->threads,
+                        resultado->imagens, resultado->ms_total, resultado->ms_total / total_imagens, resultado->imagens_por_segundo,
+                        resultado->rss_pico_kb, aceleracao);
+                fflush(csv);
+                printf("%-4s %-16s %7d %10.2f %10.2f %10ld %8.2fx\n", resultado->motor, resultado->filtro, resultado->threads,
+                       resultado->ms_total / total_imagens, resultado->imagens_por_segundo, resultado->rss_pico_kb, aceleracao);
+                total_resultados++;
+            }
+        }
+    }
+    fclose(csv);
+    printf("\nCurvas gravadas em '%s'.\n", configuracao.arquivo_csv);
+    if (total_falhas > 0) {
+        fprintf(stderr, "%d configuração(ões) não puderam ser medidas\n", total_falhas);
+        return EXIT_FAILURE;
+    }
+
+    if (configuracao.arquivo_baseline != NULL) {
+        int total_baseline = ler_baseline(configuracao.arquivo_baseline, baseline);
+        if (total_baseline < 0) {
+            fprintf(stderr, "Baseline '%s' indisponível\n", configuracao.arquivo_baseline);
+            return EXIT_FAILURE;
+        }
+        int regressoes = comparar_com_baseline(resultados, total_resultados, baseline, total_baseline, configuracao.tolerancia);
+        if (regressoes > 0) {
+            printf("%d regressão(ões) acima de %.1f%%.\n", regressoes, configuracao.tolerancia);
+            return EXIT_FAILURE;
+        }
+        printf("Nenhuma regressão acima de %.1f%%.\n", configuracao.tolerancia);
+    }
+    return EXIT_SUCCESS;
+}
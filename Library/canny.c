@@ -0,0 +1,217 @@
+#include <stdlib.h>   // Para abs.
+#include "canny.h"
+#include "paralelo.h" // Para dividir a supressão de não máximos e a histerese em faixas de linhas.
+
+// Linhas por faixa processada de uma vez por uma thread.
+#define LINHAS_FAIXA_CANNY 32
+// Capacidade da pilha de seguimento de bordas; ao encher, os pixels ficam pendentes para outra varredura.
+#define CAPACIDADE_PILHA_CANNY 1024
+
+// tan(22,5°) e tan(67,5°) em ponto fixo (x256), limites dos setores de direção do gradiente.
+#define TANGENTE_22_5_Q8 106
+#define TANGENTE_67_5_Q8 618
+
+// Dados compartilhados pelas faixas de `aplicar_canny`.
+typedef struct {
+    const int16_t *gradiente_x;
+    const int16_t *gradiente_y;
+    int largura, altura;
+    int limiar_baixo, limiar_alto;
+    uint8_t *classe;
+} tipo_contexto_canny;
+
+/**
+ * @brief Quadrado da magnitude do gradiente na coluna x de uma linha; zero fora da imagem (linha NULL).
+ *
+ * Os gradientes brutos ficam em ±32767, então a soma dos quadrados (até 2 * 32767²) cabe em int32.
+ */
+static inline int32_t magnitude_quadrada(const int16_t *linha_x, const int16_t *linha_y, int largura, int x) {
+    if (linha_x == NULL || x < 0 || x >= largura) return 0;
+    return (int32_t)linha_x[x] * linha_x[x] + (int32_t)linha_y[x] * linha_y[x];
+}
+
+/**
+ * @brief Segue as bordas a partir dos pixels fortes, promovendo os fracos conectados (8-vizinhança).
+ *
+ * Só visita as linhas [y_inicio, y_fim). A pilha tem capacidade fixa: quando enche, o vizinho é
+ * marcado como forte não visitado e a região é varrida de novo até não restar nenhum pendente.
+ *
+ * @param classe Mapa de classes (CANNY_*), largura x altura.
+ * @param largura Largura do mapa.
+ * @param y_inicio Primeira linha da região (inclusive).
+ * @param y_fim Última linha da região (exclusive).
+ */
+static void seguir_bordas_regiao(uint8_t *classe, int largura, int y_inicio, int y_fim) {
+    int pilha[CAPACIDADE_PILHA_CANNY];
+    int topo, pendentes, indice;
+
+    do {
+        pendentes = 0;
+        for (indice = y_inicio * largura; indice < y_fim * largura; indice++) {
+            if (classe[indice] != CANNY_BORDA_FORTE) continue;
+            classe[indice] = CANNY_BORDA_VISITADA;
+            topo = 0;
+            pilha[topo++] = indice;
+
+            while (topo > 0) {
+                int atual = pilha[--topo];
+                int coord_y = atual / largura, coord_x = atual % largura;
+                int desloc_y, desloc_x;
+                for (desloc_y = -1; desloc_y <= 1; desloc_y++) {
+                    int vizinho_y = coord_y + desloc_y;
+                    if (vizinho_y < y_inicio || vizinho_y >= y_fim) continue;
+                    for (desloc_x = -1; desloc_x <= 1; desloc_x++) {
+                        int vizinho_x = coord_x + desloc_x;
+                        if (vizinho_x < 0 || vizinho_x >= largura) continue;
+                        int vizinho = vizinho_y * largura + vizinho_x;
+                        if (classe[vizinho] != CANNY_BORDA_FRACA) continue;
+                        if (topo < CAPACIDADE_PILHA_CANNY) {
+                            classe[vizinho] = CANNY_BORDA_VISITADA;
+                            pilha[topo++] = vizinho;
+                        } else {
+                            classe[vizinho] = CANNY_BORDA_FORTE; // Fica para a próxima varredura.
+                            pendentes = 1;
+                        }
+                    }
+                }
+            }
+        }
+    } while (pendentes);
+}
+
+/**
+ * @brief Supressão de não máximos, limiar duplo e histerese dentro de uma faixa de linhas.
+ *
+ * A direção do gradiente é quantizada em 4 setores (0°, 45°, 90°, 135°) só com inteiros. Um pixel
+ * sobrevive se sua magnitude não for menor que a do vizinho anterior nem menor ou igual à do
+ * vizinho seguinte na direção do gradiente (desempate que evita bordas de 2 pixels em platôs).
+ *
+ * Só as linhas [linha_inicio, linha_fim) dos gradientes e de `classe` são usadas, além das linhas
+ * vizinhas da supressão: as de `halo`, quando dadas (a faixa vizinha ainda está sendo calculada por
+ * outra thread), ou as dos próprios buffers. A histerese fica restrita à faixa; as conexões entre
+ * faixas são resolvidas depois por `ligar_faixas_canny`.
+ *
+ * @param halo Gx/Gy das linhas linha_inicio - 1 e linha_fim, ou NULL para lê-las dos buffers.
+ * @param classe Mapa de classes (CANNY_*), largura x altura.
+ */
+void classificar_faixa_canny(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                             int linha_inicio, int linha_fim, const tipo_halo_canny *halo,
+                             int limiar_baixo, int limiar_alto, uint8_t *classe) {
+    int32_t limiar_baixo_quadrado = (int32_t)limiar_baixo * limiar_baixo;
+    int32_t limiar_alto_quadrado = (int32_t)limiar_alto * limiar_alto;
+    int coord_x, coord_y;
+
+    for (coord_y = linha_inicio; coord_y < linha_fim; coord_y++) {
+        // Linhas da vizinhança 3x3 (NULL fora da imagem).
+        const int16_t *linha_x = gradiente_x + coord_y * largura, *linha_y = gradiente_y + coord_y * largura;
+        const int16_t *acima_x = NULL, *acima_y = NULL, *abaixo_x = NULL, *abaixo_y = NULL;
+        if (coord_y > 0) {
+            int usar_halo = coord_y == linha_inicio && halo != NULL && halo->gradiente_x_acima != NULL;
+            acima_x = usar_halo ? halo->gradiente_x_acima : linha_x - largura;
+            acima_y = usar_halo ? halo->gradiente_y_acima : linha_y - largura;
+        }
+        if (coord_y + 1 < altura) {
+            int usar_halo = coord_y == linha_fim - 1 && halo != NULL && halo->gradiente_x_abaixo != NULL;
+            abaixo_x = usar_halo ? halo->gradiente_x_abaixo : linha_x + largura;
+            abaixo_y = usar_halo ? halo->gradiente_y_abaixo : linha_y + largura;
+        }
+
+        for (coord_x = 0; coord_x < largura; coord_x++) {
+            int indice = coord_y * largura + coord_x;
+            int32_t valor_gx = linha_x[coord_x];
+            int32_t valor_gy = linha_y[coord_x];
+            int32_t magnitude = valor_gx * valor_gx + valor_gy * valor_gy;
+            int32_t absoluto_gx = abs(valor_gx), absoluto_gy = abs(valor_gy);
+            int32_t anterior, seguinte;
+
+            if (magnitude < limiar_baixo_quadrado) {
+                classe[indice] = CANNY_NAO_BORDA;
+                continue;
+            }
+
+            // Vizinhos ao longo da direção do gradiente (eixo y cresce para baixo).
+            if (absoluto_gy * 256 <= absoluto_gx * TANGENTE_22_5_Q8) {
+                anterior = magnitude_quadrada(linha_x, linha_y, largura, coord_x - 1);
+                seguinte = magnitude_quadrada(linha_x, linha_y, largura, coord_x + 1);
+            } else if (absoluto_gy * 256 >= absoluto_gx * TANGENTE_67_5_Q8) {
+                anterior = magnitude_quadrada(acima_x, acima_y, largura, coord_x);
+                seguinte = magnitude_quadrada(abaixo_x, abaixo_y, largura, coord_x);
+            } else if ((valor_gx > 0) == (valor_gy > 0)) {
+                anterior = magnitude_quadrada(acima_x, acima_y, largura, coord_x - 1);
+                seguinte = magnitude_quadrada(abaixo_x, abaixo_y, largura, coord_x + 1);
+            } else {
+                anterior = magnitude_quadrada(acima_x, acima_y, largura, coord_x + 1);
+                seguinte = magnitude_quadrada(abaixo_x, abaixo_y, largura, coord_x - 1);
+            }
+
+            if (magnitude < anterior || magnitude <= seguinte) {
+                classe[indice] = CANNY_NAO_BORDA;
+            } else {
+                classe[indice] = (magnitude >= limiar_alto_quadrado) ? CANNY_BORDA_FORTE : CANNY_BORDA_FRACA;
+            }
+        }
+    }
+
+    seguir_bordas_regiao(classe, largura, linha_inicio, linha_fim);
+}
+
+/**
+ * @brief Liga as bordas que atravessam as faixas de `classificar_faixa_canny` e gera a imagem binária.
+ *
+ * As linhas vizinhas a cada fronteira entre faixas são reabertas e uma última passada de seguimento
+ * percorre a imagem inteira; o resultado não depende da ordem em que as faixas foram processadas.
+ *
+ * @param classe Mapa de classes, substituído pela imagem binária (0 ou 255).
+ * @param linhas_faixa Altura das faixas classificadas (fronteiras nos múltiplos dela).
+ */
+void ligar_faixas_canny(uint8_t *classe, int largura, int altura, int linhas_faixa) {
+    int coord_x, linha_fronteira, indice;
+
+    if (altura > linhas_faixa) {
+        for (linha_fronteira = linhas_faixa; linha_fronteira < altura; linha_fronteira += linhas_faixa) {
+            for (coord_x = 0; coord_x < largura; coord_x++) {
+                uint8_t *acima = &classe[(linha_fronteira - 1) * largura + coord_x];
+                uint8_t *abaixo = &classe[linha_fronteira * largura + coord_x];
+                if (*acima == CANNY_BORDA_VISITADA) *acima = CANNY_BORDA_FORTE;
+                if (*abaixo == CANNY_BORDA_VISITADA) *abaixo = CANNY_BORDA_FORTE;
+            }
+        }
+        seguir_bordas_regiao(classe, largura, 0, altura);
+    }
+
+    for (indice = 0; indice < largura * altura; indice++) {
+        classe[indice] = (classe[indice] >= CANNY_BORDA_FORTE) ? 255 : 0;
+    }
+}
+
+/**
+ * @brief Rotina de `executar_em_faixas` de `aplicar_canny`: os gradientes já estão completos.
+ */
+static void processar_faixa_canny(int linha_inicio, int linha_fim, void *argumento) {
+    tipo_contexto_canny *contexto = (tipo_contexto_canny *)argumento;
+    classificar_faixa_canny(contexto->gradiente_x, contexto->gradiente_y, contexto->largura, contexto->altura,
+                            linha_inicio, linha_fim, NULL, contexto->limiar_baixo, contexto->limiar_alto, contexto->classe);
+}
+
+/**
+ * @brief Detector de bordas de Canny a partir de gradientes já calculados (Gx/Gy brutos do filtro).
+ *
+ * Supressão de não máximos, limiar duplo e histerese são feitos por faixas de linhas no grupo de
+ * threads (`executar_em_faixas`); depois, `ligar_faixas_canny` propaga as bordas que atravessam faixas.
+ * O caminho de escala de cinza faz o mesmo faixa a faixa, junto com os gradientes (ver `aplicar_filtro_plano`).
+ *
+ * @param gradiente_x Resposta do kernel Gx (largura x altura).
+ * @param gradiente_y Resposta do kernel Gy (largura x altura).
+ * @param largura Largura da imagem.
+ * @param altura Altura da imagem.
+ * @param limiar_baixo Magnitude mínima de uma borda fraca.
+ * @param limiar_alto Magnitude mínima de uma borda forte.
+ * @param saida Imagem binária (0 ou 255), largura x altura.
+ */
+void aplicar_canny(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                   int limiar_baixo, int limiar_alto, uint8_t *saida) {
+    tipo_contexto_canny contexto = { gradiente_x, gradiente_y, largura, altura, limiar_baixo, limiar_alto, saida };
+
+    executar_em_faixas(altura, LINHAS_FAIXA_CANNY, processar_faixa_canny, &contexto);
+    ligar_faixas_canny(saida, largura, altura, LINHAS_FAIXA_CANNY);
+}
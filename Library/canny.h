@@ -0,0 +1,30 @@
+#ifndef CANNY_H
+#define CANNY_H
+#include <stdint.h>
+
+/* Limiares Padrão (magnitude do gradiente bruto, sem a saturação da FPGA) */
+#define CANNY_LIMIAR_BAIXO_PADRAO 40
+#define CANNY_LIMIAR_ALTO_PADRAO  100
+
+/* Classes de Pixel Usadas Durante a Histerese */
+#define CANNY_NAO_BORDA      0
+#define CANNY_BORDA_FRACA    1
+#define CANNY_BORDA_FORTE    2   // Borda confirmada cujos vizinhos ainda não foram visitados.
+#define CANNY_BORDA_VISITADA 3   // Borda confirmada cujos vizinhos já foram visitados.
+
+/* Canny por Faixas (junto com o cálculo dos gradientes) */
+// Gx/Gy das linhas logo acima e logo abaixo de uma faixa; NULL: lidas dos buffers da imagem.
+typedef struct {
+    const int16_t *gradiente_x_acima, *gradiente_y_acima;
+    const int16_t *gradiente_x_abaixo, *gradiente_y_abaixo;
+} tipo_halo_canny;
+
+void classificar_faixa_canny(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                             int linha_inicio, int linha_fim, const tipo_halo_canny *halo,
+                             int limiar_baixo, int limiar_alto, uint8_t *classe);
+void ligar_faixas_canny(uint8_t *classe, int largura, int altura, int linhas_faixa);
+
+void aplicar_canny(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                   int limiar_baixo, int limiar_alto, uint8_t *saida);
+
+#endif
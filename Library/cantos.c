@@ -0,0 +1,212 @@
+#include <stdio.h>    // Para escrita da lista de cantos (fopen, fprintf).
+#include <stdlib.h>   // Para malloc, realloc, free e qsort.
+#include <string.h>   // Para memset.
+#include <math.h>     // Para sqrt (resposta de Shi-Tomasi).
+#include "cantos.h"
+
+/**
+ * @brief Retorna o nome legível de um método de detecção de cantos.
+ */
+const char *nome_metodo_cantos(tipo_metodo_cantos metodo) {
+    switch (metodo) {
+        case CANTOS_HARRIS:     return "harris";
+        case CANTOS_SHI_TOMASI: return "shi-tomasi";
+        case CANTOS_DESATIVADO: break;
+    }
+    return "desativado";
+}
+
+/**
+ * @brief Soma (sinal = 1) ou subtrai (sinal = -1) os produtos Gx², Gy² e GxGy de uma linha nas somas por coluna.
+ *
+ * Laço sem desvios sobre vetores int64, vetorizável pelo compilador.
+ */
+static void acumular_linha_tensor(const int16_t *linha_gx, const int16_t *linha_gy, int largura, int64_t sinal,
+                                  int64_t *coluna_xx, int64_t *coluna_yy, int64_t *coluna_xy) {
+    int coord_x;
+    for (coord_x = 0; coord_x < largura; coord_x++) {
+        int64_t valor_gx = linha_gx[coord_x], valor_gy = linha_gy[coord_x];
+        coluna_xx[coord_x] += sinal * (valor_gx * valor_gx);
+        coluna_yy[coord_x] += sinal * (valor_gy * valor_gy);
+        coluna_xy[coord_x] += sinal * (valor_gx * valor_gy);
+    }
+}
+
+/**
+ * @brief Calcula a resposta de canto de cada pixel.
+ *
+ * O tensor de estrutura M = [Sxx Sxy; Sxy Syy] é somado em uma janela (2r+1)x(2r+1) por somas
+ * corridas: as somas por coluna ganham a linha que entra e perdem a que sai, e a soma horizontal
+ * corre sobre elas. Os gradientes brutos vão até ±32767, então as somas são int64 (25 * 32767² < 2^35);
+ * o determinante, que passaria de 2^63, e a resposta final são calculados em ponto flutuante.
+ */
+static void calcular_resposta_cantos(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                                     tipo_metodo_cantos metodo, int64_t *colunas, float *resposta) {
+    int64_t *coluna_xx = colunas, *coluna_yy = colunas + largura, *coluna_xy = colunas + 2 * largura;
+    int coord_x, coord_y, linha;
+
+    memset(colunas, 0, 3 * (size_t)largura * sizeof(int64_t));
+    for (linha = 0; linha < RAIO_JANELA_CANTOS && linha < altura; linha++) {
+        acumular_linha_tensor(gradiente_x + linha * largura, gradiente_y + linha * largura, largura, 1, coluna_xx, coluna_yy, coluna_xy);
+    }
+
+    for (coord_y = 0; coord_y < altura; coord_y++) {
+        int linha_entra = coord_y + RAIO_JANELA_CANTOS, linha_sai = coord_y - RAIO_JANELA_CANTOS - 1;
+        if (linha_entra < altura) {
+            acumular_linha_tensor(gradiente_x + linha_entra * largura, gradiente_y + linha_entra * largura, largura, 1, coluna_xx, coluna_yy, coluna_xy);
+        }
+        if (linha_sai >= 0) {
+            acumular_linha_tensor(gradiente_x + linha_sai * largura, gradiente_y + linha_sai * largura, largura, -1, coluna_xx, coluna_yy, coluna_xy);
+        }
+
+        int64_t soma_xx = 0, soma_yy = 0, soma_xy = 0;
+        for (coord_x = 0; coord_x < RAIO_JANELA_CANTOS && coord_x < largura; coord_x++) {
+            soma_xx += coluna_xx[coord_x];
+            soma_yy += coluna_yy[coord_x];
+            soma_xy += coluna_xy[coord_x];
+        }
+        for (coord_x = 0; coord_x < largura; coord_x++) {
+            int coluna_entra = coord_x + RAIO_JANELA_CANTOS, coluna_sai = coord_x - RAIO_JANELA_CANTOS - 1;
+            if (coluna_entra < largura) {
+                soma_xx += coluna_xx[coluna_entra];
+                soma_yy += coluna_yy[coluna_entra];
+                soma_xy += coluna_xy[coluna_entra];
+            }
+            if (coluna_sai >= 0) {
+                soma_xx -= coluna_xx[coluna_sai];
+                soma_yy -= coluna_yy[coluna_sai];
+                soma_xy -= coluna_xy[coluna_sai];
+            }
+
+            double determinante = (double)soma_xx * soma_yy - (double)soma_xy * soma_xy;
+            int64_t traco = soma_xx + soma_yy;
+            float valor;
+            if (metodo == CANTOS_HARRIS) {
+                valor = (float)(determinante - CONSTANTE_HARRIS * (double)traco * (double)traco);
+            } else {
+                double diferenca = (double)soma_xx - soma_yy;
+                valor = (float)(0.5 * ((double)traco - sqrt(diferenca * diferenca + 4.0 * (double)soma_xy * soma_xy)));
+            }
+            resposta[coord_y * largura + coord_x] = valor;
+        }
+    }
+}
+
+/**
+ * @brief Verifica se o pixel é o máximo da vizinhança de supressão (empates ficam com o primeiro na varredura).
+ */
+static int eh_maximo_local(const float *resposta, int largura, int altura, int coord_x, int coord_y) {
+    float valor = resposta[coord_y * largura + coord_x];
+    int desloc_x, desloc_y;
+    for (desloc_y = -RAIO_SUPRESSAO_CANTOS; desloc_y <= RAIO_SUPRESSAO_CANTOS; desloc_y++) {
+        int vizinho_y = coord_y + desloc_y;
+        if (vizinho_y < 0 || vizinho_y >= altura) continue;
+        for (desloc_x = -RAIO_SUPRESSAO_CANTOS; desloc_x <= RAIO_SUPRESSAO_CANTOS; desloc_x++) {
+            int vizinho_x = coord_x + desloc_x;
+            if (vizinho_x < 0 || vizinho_x >= largura || (desloc_x == 0 && desloc_y == 0)) continue;
+            float vizinho = resposta[vizinho_y * largura + vizinho_x];
+            if (vizinho > valor) return 0;
+            if (vizinho == valor && (desloc_y < 0 || (desloc_y == 0 && desloc_x < 0))) return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Ordena cantos pela resposta (decrescente), depois por posição, para uma saída determinística.
+ */
+static int comparar_cantos(const void *primeiro, const void *segundo) {
+    const tipo_ponto_canto *canto_a = (const tipo_ponto_canto *)primeiro, *canto_b = (const tipo_ponto_canto *)segundo;
+    if (canto_a->resposta != canto_b->resposta) return (canto_a->resposta < canto_b->resposta) ? 1 : -1;
+    if (canto_a->y != canto_b->y) return canto_a->y - canto_b->y;
+    return canto_a->x - canto_b->x;
+}
+
+/**
+ * @brief Detecta os cantos mais fortes a partir dos gradientes Gx/Gy (Harris ou Shi-Tomasi).
+ *
+ * Gx/Gy devem ser os do modo bruto (`convolver_regiao_cpu_bruto`): nos valores da FPGA, uma
+ * resposta fora de [-128, 127] vira +255 e o sinal de GxGy se perde justamente nas bordas fortes.
+ *
+ * Calcula a resposta por pixel, mantém os máximos locais (vizinhança RAIO_SUPRESSAO_CANTOS) com
+ * resposta positiva e de pelo menos QUALIDADE_MINIMA_CANTOS da maior resposta, e devolve os
+ * `max_cantos` mais fortes.
+ *
+ * @param gradiente_x Resposta bruta do kernel Gx (largura x altura).
+ * @param gradiente_y Resposta bruta do kernel Gy (largura x altura).
+ * @param largura Largura da imagem.
+ * @param altura Altura da imagem.
+ * @param metodo CANTOS_HARRIS ou CANTOS_SHI_TOMASI.
+ * @param cantos Saída com até `max_cantos` cantos, do mais forte para o mais fraco.
+ * @param max_cantos Capacidade de `cantos`.
+ * @return Quantidade de cantos devolvidos, ou -1 em caso de falta de memória.
+ */
+int detectar_cantos(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                    tipo_metodo_cantos metodo, tipo_ponto_canto *cantos, int max_cantos) {
+    int total_pixels = largura * altura, indice, coord_x, coord_y;
+    int total_candidatos = 0, capacidade_candidatos = 256;
+    float maior_resposta = 0.0f;
+
+    int64_t *colunas = malloc(3 * (size_t)largura * sizeof(int64_t));
+    float *resposta = malloc((size_t)total_pixels * sizeof(float));
+    tipo_ponto_canto *candidatos = malloc((size_t)capacidade_candidatos * sizeof(tipo_ponto_canto));
+    if (colunas == NULL || resposta == NULL || candidatos == NULL) {
+        free(colunas);
+        free(resposta);
+        free(candidatos);
+        return -1;
+    }
+
+    calcular_resposta_cantos(gradiente_x, gradiente_y, largura, altura, metodo, colunas, resposta);
+    for (indice = 0; indice < total_pixels; indice++) {
+        if (resposta[indice] > maior_resposta) maior_resposta = resposta[indice];
+    }
+
+    float limiar = QUALIDADE_MINIMA_CANTOS * maior_resposta;
+    for (coord_y = 0; coord_y < altura && maior_resposta > 0.0f; coord_y++) {
+        for (coord_x = 0; coord_x < largura; coord_x++) {
+            float valor = resposta[coord_y * largura + coord_x];
+            if (valor <= 0.0f || valor < limiar || !eh_maximo_local(resposta, largura, altura, coord_x, coord_y)) continue;
+            if (total_candidatos == capacidade_candidatos) {
+                tipo_ponto_canto *ampliado = realloc(candidatos, 2 * (size_t)capacidade_candidatos * sizeof(tipo_ponto_canto));
+                if (ampliado == NULL) break;
+                candidatos = ampliado;
+                capacidade_candidatos *= 2;
+            }
+            candidatos[total_candidatos].x = coord_x;
+            candidatos[total_candidatos].y = coord_y;
+            candidatos[total_candidatos].resposta = valor;
+            total_candidatos++;
+        }
+    }
+
+    qsort(candidatos, (size_t)total_candidatos, sizeof(tipo_ponto_canto), comparar_cantos);
+    if (total_candidatos > max_cantos) total_candidatos = max_cantos;
+    memcpy(cantos, candidatos, (size_t)total_candidatos * sizeof(tipo_ponto_canto));
+
+    free(colunas);
+    free(resposta);
+    free(candidatos);
+    return total_candidatos;
+}
+
+/**
+ * @brief Salva a lista de cantos em texto: uma linha "x y resposta" por canto.
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro.
+ */
+int salvar_cantos(const char *caminho_arquivo, tipo_metodo_cantos metodo, const tipo_ponto_canto *cantos, int total_cantos) {
+    int indice;
+    FILE *arquivo = fopen(caminho_arquivo, "w");
+    if (arquivo == NULL) {
+        perror("Erro ao criar arquivo de cantos");
+        return -1;
+    }
+    fprintf(arquivo, "# metodo %s, %d cantos\n# x y resposta\n", nome_metodo_cantos(metodo), total_cantos);
+    for (indice = 0; indice < total_cantos; indice++) {
+        fprintf(arquivo, "%d %d %.6g\n", cantos[indice].x, cantos[indice].y, cantos[indice].resposta);
+    }
+    if (fclose(arquivo) != 0) return -1;
+    printf("Cantos salvos: %s (%d)\n", caminho_arquivo, total_cantos);
+    return 0;
+}
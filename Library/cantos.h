@@ -0,0 +1,29 @@
+#ifndef CANTOS_H
+#define CANTOS_H
+#include <stdint.h>
+
+/* Parâmetros do Detector de Cantos */
+#define RAIO_JANELA_CANTOS       2     // Janela 5x5 da soma do tensor de estrutura.
+#define RAIO_SUPRESSAO_CANTOS    2     // Vizinhança 5x5 da supressão de não máximos.
+#define CONSTANTE_HARRIS         0.04f // k em R = det(M) - k * traço(M)^2.
+#define QUALIDADE_MINIMA_CANTOS  0.01f // Resposta mínima, relativa à maior resposta da imagem.
+#define MAX_CANTOS_PADRAO        100
+
+typedef enum {
+    CANTOS_DESATIVADO = 0,
+    CANTOS_HARRIS,       // det(M) - k * traço(M)^2.
+    CANTOS_SHI_TOMASI    // Menor autovalor de M.
+} tipo_metodo_cantos;
+
+// Canto detectado: posição e resposta.
+typedef struct {
+    int x, y;
+    float resposta;
+} tipo_ponto_canto;
+
+const char *nome_metodo_cantos(tipo_metodo_cantos metodo);
+int detectar_cantos(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                    tipo_metodo_cantos metodo, tipo_ponto_canto *cantos, int max_cantos);
+int salvar_cantos(const char *caminho_arquivo, tipo_metodo_cantos metodo, const tipo_ponto_canto *cantos, int total_cantos);
+
+#endif
@@ -0,0 +1,128 @@
+#include <stdio.h>              // Para a mensagem de contadores indisponíveis.
+#include <string.h>             // Para memset e strerror.
+#include <errno.h>              // Para o motivo da falha de perf_event_open.
+#include <unistd.h>             // Para syscall, read e close.
+#include <sys/syscall.h>        // Para __NR_perf_event_open (a glibc não tem wrapper).
+#include <linux/perf_event.h>   // Para struct perf_event_attr e os códigos dos eventos.
+#include "contadores_hw.h"
+
+int contadores_hw_ativos = 0;
+
+const char *const nomes_contadores_hw[TOTAL_CONTADORES_HW] = {
+    "ciclos", "instrucoes", "falhas_l1d", "falhas_llc", "falhas_desvio"
+};
+
+// Tipo e configuração de cada evento no perf_event_open (mesma ordem de `tipo_contador_hw`).
+#define CACHE_LEITURA_FALHA(cache) ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+static const struct { uint32_t tipo; uint64_t configuracao; } eventos_hw[TOTAL_CONTADORES_HW] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, CACHE_LEITURA_FALHA(PERF_COUNT_HW_CACHE_L1D) },
+    { PERF_TYPE_HW_CACHE, CACHE_LEITURA_FALHA(PERF_COUNT_HW_CACHE_LL) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+// Grupo da thread atual: os contadores do perf_event_open com pid = 0 medem só a thread que os abriu.
+static _Thread_local int estado_grupo = 0;                        // 0: não aberto; 1: aberto; -1: falhou.
+static _Thread_local int descritores_grupo[TOTAL_CONTADORES_HW];   // -1 para eventos indisponíveis.
+static _Thread_local int posicao_leitura[TOTAL_CONTADORES_HW];     // Posição do evento na leitura do grupo (-1: fora).
+static _Thread_local int descritor_lider = -1;
+static _Thread_local int total_eventos_grupo = 0;
+
+/**
+ * @brief Abre um evento da thread atual (só modo usuário), como líder (`descritor_lider_grupo` = -1) ou membro.
+ */
+static int abrir_evento_hw(tipo_contador_hw contador, int descritor_lider_grupo) {
+    struct perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.size = sizeof(atributos);
+    atributos.type = eventos_hw[contador].tipo;
+    atributos.config = eventos_hw[contador].configuracao;
+    atributos.exclude_kernel = 1; // Permitido com perf_event_paranoid <= 2.
+    atributos.exclude_hv = 1;
+    atributos.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(__NR_perf_event_open, &atributos, 0, -1, descritor_lider_grupo, 0);
+}
+
+/**
+ * @brief Abre o grupo de eventos da thread atual; o primeiro evento disponível é o líder.
+ *
+ * @return Quantidade de eventos no grupo (0 se nenhum estiver disponível).
+ */
+static int abrir_grupo_thread(void) {
+    int indice;
+    total_eventos_grupo = 0;
+    descritor_lider = -1;
+    for (indice = 0; indice < TOTAL_CONTADORES_HW; indice++) {
+        descritores_grupo[indice] = abrir_evento_hw((tipo_contador_hw)indice, descritor_lider);
+        posicao_leitura[indice] = -1;
+        if (descritores_grupo[indice] < 0) continue;
+        if (descritor_lider < 0) descritor_lider = descritores_grupo[indice];
+        posicao_leitura[indice] = total_eventos_grupo++;
+    }
+    estado_grupo = (total_eventos_grupo > 0) ? 1 : -1;
+    return total_eventos_grupo;
+}
+
+/**
+ * @brief Ativa os contadores (`--contadores-hw`), abrindo o grupo da thread que chama.
+ *
+ * Sem PMU exposta pelo kernel, sem permissão (perf_event_paranoid) ou em máquina virtual, os
+ * contadores ficam desativados e a execução segue normalmente.
+ *
+ * @return Quantidade de eventos disponíveis (0: contadores desativados).
+ */
+int iniciar_contadores_hw(void) {
+    int total_disponiveis = abrir_grupo_thread();
+    if (total_disponiveis == 0) {
+        fprintf(stderr, "Contadores de desempenho indisponíveis (%s); seguindo sem eles.\n", strerror(errno));
+        return 0;
+    }
+    contadores_hw_ativos = 1;
+    return total_disponiveis;
+}
+
+/**
+ * @brief Lê o grupo da thread atual (aberto na primeira leitura de cada thread).
+ *
+ * Se o kernel multiplexou o grupo (mais eventos que contadores físicos), os valores são
+ * escalados pela fração do tempo em que o grupo esteve contando.
+ *
+ * @param valores Recebe os valores acumulados desde a abertura; CONTADOR_HW_INDISPONIVEL nos eventos ausentes.
+ * @return 0 em caso de sucesso, -1 se os contadores estiverem desativados ou a leitura falhar.
+ */
+int ler_contadores_hw(uint64_t valores[TOTAL_CONTADORES_HW]) {
+    uint64_t leitura[3 + TOTAL_CONTADORES_HW]; // nr, tempo habilitado, tempo contando, valores.
+    int indice;
+
+    if (!contadores_hw_ativos) return -1;
+    if (estado_grupo == 0) abrir_grupo_thread();
+    if (estado_grupo < 0) return -1;
+    if (read(descritor_lider, leitura, sizeof(leitura)) < (ssize_t)((3 + total_eventos_grupo) * sizeof(uint64_t))) return -1;
+
+    uint64_t tempo_habilitado = leitura[1], tempo_contando = leitura[2];
+    for (indice = 0; indice < TOTAL_CONTADORES_HW; indice++) {
+        if (posicao_leitura[indice] < 0) {
+            valores[indice] = CONTADOR_HW_INDISPONIVEL;
+            continue;
+        }
+        uint64_t valor = leitura[3 + posicao_leitura[indice]];
+        if (tempo_contando > 0 && tempo_contando < tempo_habilitado) {
+            valor = (uint64_t)((double)valor * tempo_habilitado / tempo_contando);
+        }
+        valores[indice] = valor;
+    }
+    return 0;
+}
+
+/**
+ * @brief Fecha o grupo da thread atual (chamada pela thread que o abriu, antes de terminar).
+ */
+void encerrar_contadores_hw_thread(void) {
+    int indice;
+    if (estado_grupo <= 0) return;
+    for (indice = 0; indice < TOTAL_CONTADORES_HW; indice++) {
+        if (descritores_grupo[indice] >= 0) close(descritores_grupo[indice]);
+    }
+    estado_grupo = 0;
+}
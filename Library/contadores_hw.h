@@ -0,0 +1,27 @@
+#ifndef CONTADORES_HW_H
+#define CONTADORES_HW_H
+#include <stdint.h>
+
+/* Contadores de Desempenho do Processador (perf_event_open) */
+// Eventos lidos em grupo (mesma janela de tempo para todos), na ordem das chaves do JSON.
+typedef enum {
+    CONTADOR_HW_CICLOS = 0,
+    CONTADOR_HW_INSTRUCOES,
+    CONTADOR_HW_FALHAS_L1D,        // Falhas de leitura na cache de dados L1.
+    CONTADOR_HW_FALHAS_LLC,        // Falhas de leitura na cache de último nível.
+    CONTADOR_HW_FALHAS_DESVIO,     // Desvios previstos errado.
+    TOTAL_CONTADORES_HW
+} tipo_contador_hw;
+
+#define CONTADOR_HW_INDISPONIVEL UINT64_MAX  // Evento que o núcleo/kernel não oferece.
+
+extern const char *const nomes_contadores_hw[TOTAL_CONTADORES_HW];
+
+// 1 quando `--contadores-hw` está ativo e ao menos um evento abriu.
+extern int contadores_hw_ativos;
+
+int iniciar_contadores_hw(void);
+int ler_contadores_hw(uint64_t valores[TOTAL_CONTADORES_HW]);
+void encerrar_contadores_hw_thread(void);
+
+#endif
@@ -0,0 +1,465 @@
+#include <stdlib.h>     // Para malloc e free.
+#include <string.h>     // Para memcpy.
+#include "cor.h"
+#include "paralelo.h"   // Para dividir as linhas em faixas.
+
+// Linhas por faixa da separação dos canais e da convolução colorida.
+#define LINHAS_FAIXA_COR 16
+// Pixels por iteração da separação dos canais (seis vetores de 16 bytes).
+#define PIXELS_SEPARACAO 32
+// Pixels por iteração da combinação dos canais: 8 respostas de 16 bits, em duas metades de 4 floats.
+#define PIXELS_COMBINACAO 8
+
+// Vetores de 16 bytes (extensões vetoriais do GCC: SSE2 no x86, NEON no ARM).
+typedef uint8_t tipo_vetor_u8 __attribute__((vector_size(16)));
+typedef int16_t tipo_vetor_i16 __attribute__((vector_size(16)));
+typedef int32_t tipo_vetor_i32 __attribute__((vector_size(16)));
+typedef float tipo_vetor_f32 __attribute__((vector_size(16)));
+
+// Dados compartilhados pelas faixas de `aplicar_filtro_cor`.
+typedef struct {
+    const tipo_filtro_borda *filtro;
+    const uint8_t *imagem_rgb;
+    int largura, altura;
+    tipo_combinacao_cor combinacao;
+    int bruto;                                  // Respostas dos canais sem a semântica da FPGA (`convolver_regiao_cpu_bruto`).
+    uint8_t *canais[3];                         // Planos R, G e B (largura x altura).
+    tipo_resultado_conv *respostas_x[3];        // Gx de cada canal.
+    tipo_resultado_conv *respostas_y[3];        // Gy de cada canal (NULL se o filtro não tiver Gy).
+    tipo_resultado_conv *gradiente_x;
+    tipo_resultado_conv *gradiente_y;
+    uint8_t *saida;
+} tipo_contexto_cor;
+
+/**
+ * @brief Retorna o nome legível de uma combinação de canais.
+ */
+const char *nome_combinacao_cor(tipo_combinacao_cor combinacao) {
+    switch (combinacao) {
+        case COR_MAXIMO_CANAL: return "max";
+        case COR_DI_ZENZO:     return "dizenzo";
+        case COR_DESATIVADA:   break;
+    }
+    return "desativada";
+}
+
+/**
+ * @brief Separa as linhas [linha_inicio, linha_fim) da imagem intercalada nos planos R, G e B
+ *        (rotina de `executar_em_faixas`).
+ *
+ * Cada iteração carrega 96 bytes (32 pixels) em seis vetores e aplica cinco rodadas de intercalação
+ * das metades baixa e alta de pares de vetores (`punpcklbw`/`punpckhbw` no SSE2, `zip` no NEON):
+ * cada rodada é um embaralhamento perfeito dos 96 bytes e, depois de cinco, cada vetor contém 16
+ * pixels seguidos de um só canal. Não depende de embaralhamento arbitrário de bytes (SSSE3).
+ */
+static void separar_canais_faixa(int linha_inicio, int linha_fim, void *argumento) {
+    const tipo_vetor_u8 baixa = { 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23 };
+    const tipo_vetor_u8 alta = { 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31 };
+    const tipo_contexto_cor *contexto = (const tipo_contexto_cor *)argumento;
+    int inicio = linha_inicio * contexto->largura, fim = linha_fim * contexto->largura, indice = inicio, rodada, vetor;
+    const uint8_t *origem = contexto->imagem_rgb;
+    uint8_t *vermelho = contexto->canais[0], *verde = contexto->canais[1], *azul = contexto->canais[2];
+
+    for (; indice + PIXELS_SEPARACAO <= fim; indice += PIXELS_SEPARACAO) {
+        tipo_vetor_u8 blocos[6], intercalados[6];
+        memcpy(blocos, origem + 3 * indice, sizeof(blocos)); // Cargas sem exigência de alinhamento.
+        for (rodada = 0; rodada < 5; rodada++) {
+            for (vetor = 0; vetor < 3; vetor++) {
+                intercalados[2 * vetor] = __builtin_shuffle(blocos[vetor], blocos[vetor + 3], baixa);
+                intercalados[2 * vetor + 1] = __builtin_shuffle(blocos[vetor], blocos[vetor + 3], alta);
+            }
+            memcpy(blocos, intercalados, sizeof(blocos));
+        }
+        // Ordem final: R dos pixels 0-15 e 16-31, G idem, B idem.
+        memcpy(vermelho + indice, &blocos[0], 2 * sizeof(tipo_vetor_u8));
+        memcpy(verde + indice, &blocos[2], 2 * sizeof(tipo_vetor_u8));
+        memcpy(azul + indice, &blocos[4], 2 * sizeof(tipo_vetor_u8));
+    }
+    for (; indice < fim; indice++) {
+        vermelho[indice] = origem[3 * indice];
+        verde[indice] = origem[3 * indice + 1];
+        azul[indice] = origem[3 * indice + 2];
+    }
+}
+
+#if !defined(__SSE__)
+/**
+ * @brief Raiz quadrada de cada lane (x >= 0) sem instrução de raiz vetorial (o NEON do ARMv7 não tem):
+ *        estimativa de 1/sqrt(x) pelos bits do float e `iteracoes` passos de Newton, só com multiplicações.
+ *
+ * Cada passo eleva ao quadrado o erro relativo: ~3,4% na estimativa, ~1,7e-3 com um passo e perto da
+ * precisão do float com três. Para x = 0 a inversa fica finita, então a raiz dá 0.
+ */
+static inline tipo_vetor_f32 raiz_newton_vetor(tipo_vetor_f32 valor, int iteracoes) {
+    tipo_vetor_f32 metade = 0.5f * valor, inversa = (tipo_vetor_f32)(0x5F375A86 - ((tipo_vetor_i32)valor >> 1));
+    int iteracao;
+    for (iteracao = 0; iteracao < iteracoes; iteracao++) inversa = inversa * (1.5f - metade * inversa * inversa);
+    return valor * inversa;
+}
+#endif
+
+/**
+ * @brief Raiz quadrada de cada lane (x >= 0) com a precisão do float. No x86 é a instrução `sqrtps`
+ *        do SSE (presente em todo x86-64), sem sqrt escalar por pixel.
+ */
+static inline tipo_vetor_f32 raiz_quadrada_vetor(tipo_vetor_f32 valor) {
+#if defined(__SSE__)
+    return __builtin_ia32_sqrtps(valor);
+#else
+    return raiz_newton_vetor(valor, 3);
+#endif
+}
+
+/**
+ * @brief Raiz quadrada com erro absoluto abaixo de 0,5 para x <= 255² (um passo de Newton basta).
+ */
+static inline tipo_vetor_f32 raiz_aproximada_vetor(tipo_vetor_f32 valor) {
+#if defined(__SSE__)
+    return __builtin_ia32_sqrtps(valor);
+#else
+    return raiz_newton_vetor(valor, 1);
+#endif
+}
+
+/**
+ * @brief Escolhe, lane a lane, `se_verdadeiro` onde a máscara de comparação vale -1 e `se_falso` onde vale 0.
+ */
+static inline tipo_vetor_f32 selecionar_f32(tipo_vetor_i32 mascara, tipo_vetor_f32 se_verdadeiro, tipo_vetor_f32 se_falso) {
+    return (tipo_vetor_f32)(((tipo_vetor_i32)se_verdadeiro & mascara) | ((tipo_vetor_i32)se_falso & ~mascara));
+}
+
+/**
+ * @brief Limita cada lane a ±32767, para que a conversão para 16 bits não dê a volta.
+ *
+ * Só atua no modo bruto: com a semântica da FPGA, Gx/Gy combinados ficam bem abaixo desse limite.
+ */
+static inline tipo_vetor_f32 limitar_16_bits(tipo_vetor_f32 valor) {
+    const tipo_vetor_f32 limite = { 32767.0f, 32767.0f, 32767.0f, 32767.0f };
+    valor = selecionar_f32(valor > limite, limite, valor);
+    return selecionar_f32(valor < -limite, -limite, valor);
+}
+
+/**
+ * @brief Magnitude de saída: parte inteira de sqrt(quadrado), saturada em 255.
+ *
+ * Com a raiz aproximada (erro abaixo de 0,5 até 255²), a parte inteira fica no máximo uma unidade
+ * abaixo ou acima da exata, e a comparação com o próprio quadrado a corrige.
+ */
+static inline tipo_vetor_f32 magnitude_saturada(tipo_vetor_f32 quadrado) {
+    const tipo_vetor_f32 um = { 1.0f, 1.0f, 1.0f, 1.0f }, zero = { 0.0f }, teto = { 65025.0f, 65025.0f, 65025.0f, 65025.0f };
+    tipo_vetor_f32 limitado = selecionar_f32(quadrado > teto, teto, quadrado);   // 255²: acima disso a saída satura.
+    tipo_vetor_f32 raiz = __builtin_convertvector(__builtin_convertvector(raiz_aproximada_vetor(limitado), tipo_vetor_i32), tipo_vetor_f32);
+    raiz += selecionar_f32((raiz + 1.0f) * (raiz + 1.0f) <= limitado, um, zero);
+    return raiz - selecionar_f32(raiz * raiz > limitado, um, zero);
+}
+
+/**
+ * @brief Carrega PIXELS_COMBINACAO respostas de 16 bits como dois vetores de floats (exatos).
+ *
+ * A extensão de sinal é feita duplicando cada valor de 16 bits e deslocando 16 bits à direita,
+ * o que o SSE2 faz em duas instruções.
+ */
+static inline void carregar_respostas(const tipo_resultado_conv *respostas, int indice, tipo_vetor_f32 *baixa, tipo_vetor_f32 *alta) {
+    const tipo_vetor_i16 duplicar_baixa = { 0, 0, 1, 1, 2, 2, 3, 3 }, duplicar_alta = { 4, 4, 5, 5, 6, 6, 7, 7 };
+    tipo_vetor_i16 valores;
+    memcpy(&valores, respostas + indice, sizeof(valores)); // Carga sem exigência de alinhamento.
+    *baixa = __builtin_convertvector((tipo_vetor_i32)__builtin_shuffle(valores, duplicar_baixa) >> 16, tipo_vetor_f32);
+    *alta = __builtin_convertvector((tipo_vetor_i32)__builtin_shuffle(valores, duplicar_alta) >> 16, tipo_vetor_f32);
+}
+
+/**
+ * @brief Junta dois vetores de floats inteiros na faixa de 16 bits em PIXELS_COMBINACAO valores de 16 bits.
+ */
+static inline tipo_vetor_i16 juntar_metades(tipo_vetor_f32 baixa, tipo_vetor_f32 alta) {
+    const tipo_vetor_i16 pares = { 0, 2, 4, 6, 8, 10, 12, 14 };   // Metade baixa de cada lane de 32 bits.
+    return __builtin_shuffle((tipo_vetor_i16)__builtin_convertvector(baixa, tipo_vetor_i32),
+                             (tipo_vetor_i16)__builtin_convertvector(alta, tipo_vetor_i32), pares);
+}
+
+/**
+ * @brief Máximo por canal: Gx/Gy do canal de maior Gx² + Gy² (empates ficam com o primeiro canal).
+ *
+ * Os quadrados dos canais (até 2 * 255²) são exatos em float; a magnitude é a raiz inteira exata.
+ */
+static inline void combinar_maximo_canal(tipo_vetor_f32 vermelho_x, tipo_vetor_f32 vermelho_y, tipo_vetor_f32 verde_x,
+                                         tipo_vetor_f32 verde_y, tipo_vetor_f32 azul_x, tipo_vetor_f32 azul_y,
+                                         tipo_vetor_f32 *componente_x, tipo_vetor_f32 *componente_y, tipo_vetor_f32 *magnitude) {
+    tipo_vetor_f32 quadrado_vermelho = vermelho_x * vermelho_x + vermelho_y * vermelho_y;
+    tipo_vetor_f32 quadrado_verde = verde_x * verde_x + verde_y * verde_y;
+    tipo_vetor_f32 quadrado_azul = azul_x * azul_x + azul_y * azul_y;
+
+    tipo_vetor_i32 maior = quadrado_verde > quadrado_vermelho;
+    tipo_vetor_f32 melhor_quadrado = selecionar_f32(maior, quadrado_verde, quadrado_vermelho);
+    tipo_vetor_f32 melhor_x = selecionar_f32(maior, verde_x, vermelho_x), melhor_y = selecionar_f32(maior, verde_y, vermelho_y);
+    maior = quadrado_azul > melhor_quadrado;
+    *componente_x = selecionar_f32(maior, azul_x, melhor_x);
+    *componente_y = selecionar_f32(maior, azul_y, melhor_y);
+    *magnitude = magnitude_saturada(selecionar_f32(maior, quadrado_azul, melhor_quadrado));
+}
+
+/**
+ * @brief Di Zenzo: magnitude = sqrt(maior autovalor de [Σgx² Σgxgy; Σgxgy Σgy²]) e Gx/Gy na direção
+ *        do autovetor, com o sentido da soma dos gradientes dos canais.
+ *
+ * Com a semântica da FPGA as somas são exatas em float; o autovalor tem o erro de arredondamento do
+ * float, então a magnitude pode diferir em uma unidade do cálculo em double quando a raiz cai muito
+ * perto de um inteiro.
+ */
+static inline void combinar_di_zenzo(tipo_vetor_f32 vermelho_x, tipo_vetor_f32 vermelho_y, tipo_vetor_f32 verde_x,
+                                     tipo_vetor_f32 verde_y, tipo_vetor_f32 azul_x, tipo_vetor_f32 azul_y,
+                                     tipo_vetor_f32 *componente_x, tipo_vetor_f32 *componente_y, tipo_vetor_f32 *magnitude) {
+    const tipo_vetor_f32 zero = { 0.0f }, meio = { 0.5f, 0.5f, 0.5f, 0.5f };
+    tipo_vetor_f32 soma_xx = vermelho_x * vermelho_x + verde_x * verde_x + azul_x * azul_x;
+    tipo_vetor_f32 soma_yy = vermelho_y * vermelho_y + verde_y * verde_y + azul_y * azul_y;
+    tipo_vetor_f32 soma_xy = vermelho_x * vermelho_y + verde_x * verde_y + azul_x * azul_y;
+    tipo_vetor_f32 soma_gx = vermelho_x + verde_x + azul_x, soma_gy = vermelho_y + verde_y + azul_y;
+
+    tipo_vetor_f32 diferenca = soma_xx - soma_yy;
+    tipo_vetor_f32 autovalor = 0.5f * (soma_xx + soma_yy + raiz_quadrada_vetor(diferenca * diferenca + 4.0f * soma_xy * soma_xy));
+
+    // Autovetor de `autovalor`: (λ - Syy, Sxy) se Sxx >= Syy, senão (Sxy, λ - Sxx) (o melhor condicionado).
+    tipo_vetor_i32 primeiro = diferenca >= 0.0f;
+    tipo_vetor_f32 direcao_x = selecionar_f32(primeiro, autovalor - soma_yy, soma_xy);
+    tipo_vetor_f32 direcao_y = selecionar_f32(primeiro, soma_xy, autovalor - soma_xx);
+    tipo_vetor_f32 norma_quadrada = direcao_x * direcao_x + direcao_y * direcao_y;
+    tipo_vetor_i32 nulo = norma_quadrada == 0.0f;   // Tensor nulo: sem borda.
+
+    // sqrt(λ) / |direção| = sqrt(λ / |direção|²), com o sentido da soma dos gradientes dos canais;
+    // zero nas lanes nulas.
+    tipo_vetor_f32 escala = selecionar_f32(nulo, zero, raiz_quadrada_vetor(autovalor / norma_quadrada));
+    escala = selecionar_f32(direcao_x * soma_gx + direcao_y * soma_gy < 0.0f, -escala, escala);
+
+    // Arredonda para o mais próximo e limita a 16 bits (no modo bruto, sqrt(λ) passa de 32767).
+    tipo_vetor_f32 arredondado_x = escala * direcao_x, arredondado_y = escala * direcao_y;
+    *componente_x = limitar_16_bits(arredondado_x + selecionar_f32(arredondado_x >= 0.0f, meio, -meio));
+    *componente_y = limitar_16_bits(arredondado_y + selecionar_f32(arredondado_y >= 0.0f, meio, -meio));
+    *magnitude = selecionar_f32(nulo, zero, magnitude_saturada(autovalor));
+}
+
+/**
+ * @brief Grava Gx, Gy e a magnitude de PIXELS_COMBINACAO pixels; a magnitude (0-255) vem em lanes de 16 bits.
+ */
+static inline void gravar_bloco(tipo_resultado_conv *gradiente_x, tipo_resultado_conv *gradiente_y, uint8_t *saida, int indice,
+                                tipo_vetor_i16 componente_x, tipo_vetor_i16 componente_y, tipo_vetor_i16 magnitude) {
+    const tipo_vetor_u8 pares = { 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30 };
+    tipo_vetor_u8 bytes = __builtin_shuffle((tipo_vetor_u8)magnitude, (tipo_vetor_u8)magnitude, pares); // 8 primeiros: o bloco.
+    memcpy(gradiente_x + indice, &componente_x, sizeof(componente_x));
+    memcpy(gradiente_y + indice, &componente_y, sizeof(componente_y));
+    memcpy(saida + indice, &bytes, PIXELS_COMBINACAO);
+}
+
+/**
+ * @brief Combina as respostas dos canais nos pixels [inicio, fim), um múltiplo de PIXELS_COMBINACAO.
+ *
+ * Cada bloco de 8 pixels é combinado em duas metades de 4 lanes float; Gx/Gy voltam para 16 bits
+ * e a magnitude para 8 bits por embaralhamentos de pares (`pand` + `packuswb` no SSE2).
+ */
+static void combinar_blocos(tipo_combinacao_cor combinacao, const tipo_resultado_conv *const respostas_x[3],
+                            const tipo_resultado_conv *const respostas_y[3], int inicio, int fim, tipo_resultado_conv *gradiente_x,
+                            tipo_resultado_conv *gradiente_y, uint8_t *saida) {
+    const tipo_resultado_conv *vermelho_x = respostas_x[0], *verde_x = respostas_x[1], *azul_x = respostas_x[2];
+    const tipo_resultado_conv *vermelho_y = respostas_y[0], *verde_y = respostas_y[1], *azul_y = respostas_y[2];
+    int indice;
+
+    for (indice = inicio; indice < fim; indice += PIXELS_COMBINACAO) {
+        tipo_vetor_f32 rx[2], ry[2], gx[2], gy[2], bx[2], by[2], componente_x[2], componente_y[2], magnitude[2];
+        carregar_respostas(vermelho_x, indice, &rx[0], &rx[1]);
+        carregar_respostas(vermelho_y, indice, &ry[0], &ry[1]);
+        carregar_respostas(verde_x, indice, &gx[0], &gx[1]);
+        carregar_respostas(verde_y, indice, &gy[0], &gy[1]);
+        carregar_respostas(azul_x, indice, &bx[0], &bx[1]);
+        carregar_respostas(azul_y, indice, &by[0], &by[1]);
+
+        if (combinacao == COR_MAXIMO_CANAL) {
+            combinar_maximo_canal(rx[0], ry[0], gx[0], gy[0], bx[0], by[0], &componente_x[0], &componente_y[0], &magnitude[0]);
+            combinar_maximo_canal(rx[1], ry[1], gx[1], gy[1], bx[1], by[1], &componente_x[1], &componente_y[1], &magnitude[1]);
+        } else {
+            combinar_di_zenzo(rx[0], ry[0], gx[0], gy[0], bx[0], by[0], &componente_x[0], &componente_y[0], &magnitude[0]);
+            combinar_di_zenzo(rx[1], ry[1], gx[1], gy[1], bx[1], by[1], &componente_x[1], &componente_y[1], &magnitude[1]);
+        }
+        gravar_bloco(gradiente_x, gradiente_y, saida, indice, juntar_metades(componente_x[0], componente_x[1]),
+                     juntar_metades(componente_y[0], componente_y[1]), juntar_metades(magnitude[0], magnitude[1]));
+    }
+}
+
+/**
+ * @brief `combinar_blocos` para filtros sem kernel Gy (Gy = 0 em todos os canais).
+ *
+ * Máximo: a magnitude de cada canal é |Gx| (até 255), então tudo fica em lanes de 16 bits. Di Zenzo:
+ * o autovalor é Σgx² e o autovetor é o eixo x, então Gx = ±sqrt(Σgx²) com o sinal de Σgx.
+ */
+static void combinar_blocos_sem_gy(tipo_combinacao_cor combinacao, const tipo_resultado_conv *const respostas_x[3], int inicio, int fim,
+                                   tipo_resultado_conv *gradiente_x, tipo_resultado_conv *gradiente_y, uint8_t *saida) {
+    const tipo_vetor_i16 zeros = { 0 };
+    const tipo_vetor_f32 meio = { 0.5f, 0.5f, 0.5f, 0.5f };
+    int indice, metade;
+
+    for (indice = inicio; indice < fim; indice += PIXELS_COMBINACAO) {
+        tipo_vetor_i16 componente_x, magnitude;
+
+        if (combinacao == COR_MAXIMO_CANAL) {
+            tipo_vetor_i16 vermelho, verde, azul;
+            memcpy(&vermelho, respostas_x[0] + indice, sizeof(vermelho));
+            memcpy(&verde, respostas_x[1] + indice, sizeof(verde));
+            memcpy(&azul, respostas_x[2] + indice, sizeof(azul));
+            tipo_vetor_i16 negativo = vermelho < 0, absoluto_verde, absoluto_azul, maior;
+            magnitude = (vermelho & ~negativo) | (-vermelho & negativo);
+            negativo = verde < 0;
+            absoluto_verde = (verde & ~negativo) | (-verde & negativo);
+            negativo = azul < 0;
+            absoluto_azul = (azul & ~negativo) | (-azul & negativo);
+
+            maior = absoluto_verde > magnitude;
+            componente_x = (verde & maior) | (vermelho & ~maior);
+            magnitude = (absoluto_verde & maior) | (magnitude & ~maior);
+            maior = absoluto_azul > magnitude;
+            componente_x = (azul & maior) | (componente_x & ~maior);
+            magnitude = (absoluto_azul & maior) | (magnitude & ~maior);
+        } else {
+            tipo_vetor_f32 vermelho[2], verde[2], azul[2], componente[2], magnitudes[2];
+            carregar_respostas(respostas_x[0], indice, &vermelho[0], &vermelho[1]);
+            carregar_respostas(respostas_x[1], indice, &verde[0], &verde[1]);
+            carregar_respostas(respostas_x[2], indice, &azul[0], &azul[1]);
+            for (metade = 0; metade < 2; metade++) {
+                tipo_vetor_f32 autovalor = vermelho[metade] * vermelho[metade] + verde[metade] * verde[metade] + azul[metade] * azul[metade];
+                tipo_vetor_f32 raiz = limitar_16_bits(raiz_quadrada_vetor(autovalor) + meio);   // Arredonda para o mais próximo.
+                raiz = __builtin_convertvector(__builtin_convertvector(raiz, tipo_vetor_i32), tipo_vetor_f32);
+                componente[metade] = selecionar_f32(vermelho[metade] + verde[metade] + azul[metade] < 0.0f, -raiz, raiz);
+                magnitudes[metade] = magnitude_saturada(autovalor);
+            }
+            componente_x = juntar_metades(componente[0], componente[1]);
+            magnitude = juntar_metades(magnitudes[0], magnitudes[1]);
+        }
+        gravar_bloco(gradiente_x, gradiente_y, saida, indice, componente_x, zeros, magnitude);
+    }
+}
+
+/**
+ * @brief Combina as respostas dos canais nos pixels [inicio, fim).
+ *
+ * Os pixels que não completam um bloco no fim da imagem são combinados a partir de uma cópia
+ * local completada com zeros.
+ */
+static void combinar_canais(const tipo_contexto_cor *contexto, int inicio, int fim) {
+    const tipo_resultado_conv *const respostas_x[3] = { contexto->respostas_x[0], contexto->respostas_x[1], contexto->respostas_x[2] };
+    const tipo_resultado_conv *const respostas_y[3] = { contexto->respostas_y[0], contexto->respostas_y[1], contexto->respostas_y[2] };
+    int fim_blocos = inicio + (fim - inicio) / PIXELS_COMBINACAO * PIXELS_COMBINACAO, canal;
+
+    if (respostas_y[0] != NULL) {
+        combinar_blocos(contexto->combinacao, respostas_x, respostas_y, inicio, fim_blocos, contexto->gradiente_x,
+                        contexto->gradiente_y, contexto->saida);
+    } else {
+        combinar_blocos_sem_gy(contexto->combinacao, respostas_x, inicio, fim_blocos, contexto->gradiente_x, contexto->gradiente_y,
+                               contexto->saida);
+    }
+    if (fim_blocos == fim) return;
+
+    size_t total_resto = (size_t)(fim - fim_blocos);
+    tipo_resultado_conv resto_x[3][PIXELS_COMBINACAO] = { { 0 } }, resto_y[3][PIXELS_COMBINACAO] = { { 0 } };
+    tipo_resultado_conv resto_gx[PIXELS_COMBINACAO], resto_gy[PIXELS_COMBINACAO];
+    uint8_t resto_saida[PIXELS_COMBINACAO];
+    for (canal = 0; canal < 3; canal++) {
+        memcpy(resto_x[canal], respostas_x[canal] + fim_blocos, total_resto * sizeof(tipo_resultado_conv));
+        if (respostas_y[0] != NULL) memcpy(resto_y[canal], respostas_y[canal] + fim_blocos, total_resto * sizeof(tipo_resultado_conv));
+    }
+    const tipo_resultado_conv *const copias_x[3] = { resto_x[0], resto_x[1], resto_x[2] };
+    const tipo_resultado_conv *const copias_y[3] = { resto_y[0], resto_y[1], resto_y[2] };
+    combinar_blocos(contexto->combinacao, copias_x, copias_y, 0, PIXELS_COMBINACAO, resto_gx, resto_gy, resto_saida);
+    memcpy(contexto->gradiente_x + fim_blocos, resto_gx, total_resto * sizeof(tipo_resultado_conv));
+    memcpy(contexto->gradiente_y + fim_blocos, resto_gy, total_resto * sizeof(tipo_resultado_conv));
+    memcpy(contexto->saida + fim_blocos, resto_saida, total_resto);
+}
+
+/**
+ * @brief Aplica o filtro colorido a uma faixa de linhas (rotina de `executar_em_faixas`).
+ *
+ * Cada canal passa pelo motor de CPU do kernel (especializado, separável, ...), ou pelo modo bruto,
+ * e a combinação lê as respostas da faixa logo em seguida, ainda no cache.
+ */
+static void aplicar_filtro_cor_faixa(int linha_inicio, int linha_fim, void *argumento) {
+    const tipo_contexto_cor *contexto = (const tipo_contexto_cor *)argumento;
+    const tipo_filtro_borda *filtro = contexto->filtro;
+    int largura = contexto->largura, altura = contexto->altura, canal;
+    void (*convolver)(const tipo_kernel_analisado *, const uint8_t *, int, int, int, int, int, int, tipo_resultado_conv *) =
+        contexto->bruto ? convolver_regiao_cpu_bruto : convolver_regiao_cpu;
+
+    for (canal = 0; canal < 3; canal++) {
+        convolver(&filtro->kernel_gx, contexto->canais[canal], largura, altura, 0, linha_inicio, largura, linha_fim,
+                  contexto->respostas_x[canal]);
+        if (filtro->possui_gy) {
+            convolver(&filtro->kernel_gy, contexto->canais[canal], largura, altura, 0, linha_inicio, largura, linha_fim,
+                      contexto->respostas_y[canal]);
+        }
+    }
+    combinar_canais(contexto, linha_inicio * largura, linha_fim * largura);
+}
+
+/**
+ * @brief Separa os canais, aplica os kernels e combina as respostas (comum aos dois modos).
+ *
+ * Todos os buffers são alocados aqui, antes das faixas; sem `saida`, a magnitude vai para um
+ * plano temporário do mesmo bloco.
+ */
+static int filtrar_canais(const tipo_filtro_borda *filtro, const uint8_t *imagem_rgb, int largura, int altura,
+                          tipo_combinacao_cor combinacao, int bruto, tipo_resultado_conv *gradiente_x,
+                          tipo_resultado_conv *gradiente_y, uint8_t *saida) {
+    tipo_contexto_cor contexto = { filtro, imagem_rgb, largura, altura, combinacao, bruto, { NULL }, { NULL }, { NULL },
+                                   gradiente_x, gradiente_y, saida };
+    size_t total_pixels = (size_t)largura * altura;
+    int total_respostas = filtro->possui_gy ? 6 : 3, canal;
+
+    // Um bloco só: as respostas de 16 bits de cada canal, os três planos de 8 bits e, se preciso, a magnitude.
+    uint8_t *memoria = malloc(total_pixels * (total_respostas * sizeof(tipo_resultado_conv) + 3 + (saida == NULL)));
+    if (memoria == NULL) return -1;
+    tipo_resultado_conv *respostas = (tipo_resultado_conv *)memoria;
+    uint8_t *planos = memoria + total_respostas * total_pixels * sizeof(tipo_resultado_conv);
+    for (canal = 0; canal < 3; canal++) {
+        contexto.canais[canal] = planos + canal * total_pixels;
+        contexto.respostas_x[canal] = respostas + canal * total_pixels;
+        if (filtro->possui_gy) contexto.respostas_y[canal] = respostas + (3 + canal) * total_pixels;
+    }
+    if (saida == NULL) contexto.saida = planos + 3 * total_pixels;
+
+    executar_em_faixas(altura, LINHAS_FAIXA_COR, separar_canais_faixa, &contexto);
+    executar_em_faixas(altura, LINHAS_FAIXA_COR, aplicar_filtro_cor_faixa, &contexto);
+
+    free(memoria);
+    return 0;
+}
+
+/**
+ * @brief Detecção de bordas colorida: aplica os kernels do filtro a R, G e B e combina os canais.
+ *
+ * Primeiro a imagem intercalada é separada em planos R, G e B (`separar_canais_faixa`); depois, por
+ * faixas de linhas no grupo de threads, cada canal passa pelo mesmo motor de CPU do cinza e as
+ * respostas são combinadas em vetores. Os valores de cada canal seguem a semântica da FPGA, como
+ * nos motores em escala de cinza.
+ *
+ * @param filtro Filtro registrado.
+ * @param imagem_rgb Imagem intercalada (largura x altura x 3).
+ * @param largura Largura da imagem.
+ * @param altura Altura da imagem.
+ * @param combinacao COR_MAXIMO_CANAL ou COR_DI_ZENZO.
+ * @param gradiente_x Saída: Gx combinado (largura x altura).
+ * @param gradiente_y Saída: Gy combinado (largura x altura; zero se o filtro não tiver Gy).
+ * @param saida Saída: magnitude saturada em 0-255 (largura x altura).
+ * @return 0 em caso de sucesso, -1 em caso de falta de memória.
+ */
+int aplicar_filtro_cor(const tipo_filtro_borda *filtro, const uint8_t *imagem_rgb, int largura, int altura,
+                       tipo_combinacao_cor combinacao, tipo_resultado_conv *gradiente_x, tipo_resultado_conv *gradiente_y,
+                       uint8_t *saida) {
+    return filtrar_canais(filtro, imagem_rgb, largura, altura, combinacao, 0, gradiente_x, gradiente_y, saida);
+}
+
+/**
+ * @brief Gx/Gy coloridos sem a semântica da FPGA, para a exportação de gradientes.
+ *
+ * Igual a `aplicar_filtro_cor`, mas cada canal é convoluído no modo bruto (`convolver_regiao_cpu_bruto`)
+ * e os Gx/Gy combinados são limitados a ±32767.
+ *
+ * @return 0 em caso de sucesso, -1 em caso de falta de memória.
+ */
+int calcular_gradientes_cor_brutos(const tipo_filtro_borda *filtro, const uint8_t *imagem_rgb, int largura, int altura,
+                                   tipo_combinacao_cor combinacao, tipo_resultado_conv *gradiente_x, tipo_resultado_conv *gradiente_y) {
+    return filtrar_canais(filtro, imagem_rgb, largura, altura, combinacao, 1, gradiente_x, gradiente_y, NULL);
+}
@@ -0,0 +1,22 @@
+#ifndef COR_H
+#define COR_H
+#include <stdint.h>
+#include "filtros.h"
+
+/* Bordas Coloridas */
+
+// Como as respostas dos três canais são combinadas em uma só borda.
+typedef enum {
+    COR_DESATIVADA = 0,
+    COR_MAXIMO_CANAL,     // Gx/Gy do canal de maior magnitude.
+    COR_DI_ZENZO          // Maior autovalor do tensor de Di Zenzo (soma dos tensores dos canais).
+} tipo_combinacao_cor;
+
+const char *nome_combinacao_cor(tipo_combinacao_cor combinacao);
+int aplicar_filtro_cor(const tipo_filtro_borda *filtro, const uint8_t *imagem_rgb, int largura, int altura,
+                       tipo_combinacao_cor combinacao, tipo_resultado_conv *gradiente_x, tipo_resultado_conv *gradiente_y,
+                       uint8_t *saida);
+int calcular_gradientes_cor_brutos(const tipo_filtro_borda *filtro, const uint8_t *imagem_rgb, int largura, int altura,
+                                   tipo_combinacao_cor combinacao, tipo_resultado_conv *gradiente_x, tipo_resultado_conv *gradiente_y);
+
+#endif
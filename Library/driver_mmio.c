@@ -0,0 +1,316 @@
+#include <stdio.h>      // Para as mensagens de erro (fprintf).
+#include <stdlib.h>     // Para getenv.
+#include <string.h>     // Para strncmp, strcmp e strerror.
+#include <errno.h>      // Para errno.
+#include <fcntl.h>      // Para open.
+#include <unistd.h>     // Para close e ftruncate.
+#include <sys/mman.h>   // Para mmap e munmap.
+#include <sys/stat.h>   // Para fstat (tamanho do arquivo do emulador).
+#include <time.h>       // Para o relógio do perfil fora do ARM e do x86.
+#include <sched.h>      // Para sched_yield nas esperas longas.
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // Para __rdtsc (ciclos do perfil no x86).
+#endif
+#include "hps_0.h"
+#include "driver_mmio.h"
+#include "emulador_fpga.h"
+
+// Mesmos símbolos do lib.s (ver hps_0.h), para que o perfil funcione com qualquer driver.
+tipo_perfil_fpga perfil_fpga;
+int perfil_fpga_ativo = 0;
+
+// Estado do mapeamento aberto por `initiate_hardware`.
+static int descritor_mapeamento = -1;
+static void *base_mapeamento = NULL;
+static int usando_emulador = 0;
+static int usando_arquivo_compartilhado = 0;  // Região servida por outro processo (co-simulação).
+static volatile uint32_t *registrador_entrada = NULL;   // data_in (HPS → FPGA).
+static volatile uint32_t *registrador_saida = NULL;     // data_out (FPGA → HPS).
+static uint32_t *sequencia_pulsos = NULL;               // FPGA_PALAVRA_PULSOS, quando o simulador confirma os pulsos.
+static uint32_t *confirmacao_pulsos = NULL;             // FPGA_PALAVRA_PULSOS_ACK.
+static uint32_t *erro_simulacao = NULL;                 // FPGA_PALAVRA_ERRO_SIM, só na co-simulação.
+
+/**
+ * @brief Lê o contador de ciclos usado pelo perfil: PMCCNTR no ARM, TSC no x86 e nanossegundos nos demais.
+ */
+static inline uint32_t ler_ciclos(void) {
+#if defined(__arm__)
+    uint32_t ciclos;
+    __asm__ volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(ciclos));
+    return ciclos;
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    struct timespec instante;
+    clock_gettime(CLOCK_MONOTONIC, &instante);
+    return (uint32_t)(instante.tv_sec * 1000000000ull + instante.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Habilita o contador de ciclos e liga o perfil (mesmo contrato do lib.s).
+ *
+ * No ARM, exige PMUSERENR.EN = 1; caso contrário, gera SIGILL (capturado em `perfil_fpga.c`).
+ */
+int habilitar_perfil_fpga(void) {
+#if defined(__arm__)
+    uint32_t controle;
+    __asm__ volatile("mrc p15, 0, %0, c9, c12, 0" : "=r"(controle));
+    controle = (controle | 1u) & ~8u;   // E = 1; D = 0 (conta todo ciclo).
+    __asm__ volatile("mcr p15, 0, %0, c9, c12, 0" :: "r"(controle));
+    __asm__ volatile("mcr p15, 0, %0, c9, c12, 1" :: "r"(1u << 31)); // PMCNTENSET.C
+#endif
+    perfil_fpga_ativo = 1;
+    return 0;
+}
+
+/**
+ * @brief Espera o bit de ack de data_out chegar a `esperado`, contando as leituras.
+ *
+ * A cada FPGA_LEITURAS_CEDER leituras sem ack, cede o processador: a FPGA real responde bem antes
+ * disso, mas um emulador pode estar esperando o mesmo núcleo. Na co-simulação, também desiste se
+ * o simulador publicar que o RTL parou de responder (FPGA_PALAVRA_ERRO_SIM).
+ *
+ * @param leituras Acumula as leituras feitas (limitadas a FPGA_LIMITE_LEITURAS).
+ * @return A última palavra lida, com o bit PRONTO valendo `esperado`; 0 com `*leituras` acima do limite.
+ */
+static inline uint32_t esperar_ack(volatile const uint32_t *saida, uint32_t esperado, uint32_t *leituras) {
+    uint32_t palavra;
+    while (((palavra = *saida) & FPGA_BIT_PRONTO) != esperado) {
+        if ((++*leituras & (FPGA_LEITURAS_CEDER - 1)) == 0) {
+            if (erro_simulacao != NULL && __atomic_load_n(erro_simulacao, __ATOMIC_ACQUIRE) == FPGA_ERRO_SIM_SEM_RESPOSTA) {
+                fprintf(stderr, "Co-simulação: o RTL não respondeu ao handshake (ver a saída do simulador).\n");
+                *leituras = FPGA_LIMITE_LEITURAS + 1;
+            }
+            if (*leituras > FPGA_LIMITE_LEITURAS) return 0;
+            sched_yield();
+        }
+    }
+    ++*leituras;
+    return palavra;
+}
+
+/**
+ * @brief Envia um pulso de reset ou start em data_in.
+ *
+ * Na FPGA real, o pulso dura as poucas instruções entre as duas escritas. Um simulador que lê a
+ * página em laço poderia perdê-lo; por isso, no emulador e na co-simulação, o pulso fica em data_in até ser
+ * confirmado: o driver incrementa FPGA_PALAVRA_PULSOS e espera FPGA_PALAVRA_PULSOS_ACK chegar ao
+ * mesmo valor. Assim o simulador aplica exatamente os pulsos enviados, na ordem, sem deduzi-los.
+ *
+ * @return 0, ou -1 se o simulador não confirmar o pulso.
+ */
+static int enviar_pulso(volatile uint32_t *entrada, uint32_t bit) {
+    uint32_t leituras = 0;
+    *entrada = bit;
+    if (sequencia_pulsos != NULL) {
+        uint32_t sequencia = __atomic_load_n(sequencia_pulsos, __ATOMIC_RELAXED) + 1;
+        __atomic_store_n(sequencia_pulsos, sequencia, __ATOMIC_RELEASE); // Depois do pulso em data_in.
+        while (__atomic_load_n(confirmacao_pulsos, __ATOMIC_ACQUIRE) != sequencia) {
+            if ((++leituras & (FPGA_LEITURAS_CEDER - 1)) == 0) {
+                if (leituras > FPGA_LIMITE_LEITURAS) return -1;
+                sched_yield();
+            }
+        }
+    }
+    *entrada = 0;
+    return 0;
+}
+
+/**
+ * @brief Mapeia os registradores da FPGA.
+ *
+ * A origem vem da variável de ambiente PBL3_FPGA_DISPOSITIVO:
+ * - `/dev/mem` (padrão): a ponte LW em FPGA_PONTE_LW_BASE, como no lib.s;
+ * - `/dev/uioN`: a primeira região do dispositivo UIO (dispensa acesso a /dev/mem);
+ * - `emulador`: uma página anônima servida por uma thread de `emulador_fpga.c`;
+ * - qualquer outro caminho: um arquivo comum (criado se preciso) compartilhado com outro processo.
+ *
+ * Diferente do lib.s, que encerra o processo, uma falha é devolvida ao chamador.
+ *
+ * @return HW_SUCCESS, ou -1 se o dispositivo não puder ser aberto ou mapeado.
+ */
+int initiate_hardware(void) {
+    const char *caminho = getenv(FPGA_VARIAVEL_DISPOSITIVO);
+    off_t deslocamento = 0;
+    int flags = O_RDWR | O_SYNC;
+
+    if (caminho == NULL || caminho[0] == '\0') caminho = FPGA_DISPOSITIVO_PADRAO;
+    if (strcmp(caminho, FPGA_DISPOSITIVO_EMULADOR) == 0) {
+        base_mapeamento = mmap(NULL, FPGA_PONTE_LW_TAMANHO, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (base_mapeamento == MAP_FAILED) {
+            fprintf(stderr, "Não foi possível alocar a página do emulador: %s\n", strerror(errno));
+            base_mapeamento = NULL;
+            return -1;
+        }
+        registrador_entrada = (volatile uint32_t *)base_mapeamento + FPGA_PALAVRA_DATA_IN;
+        registrador_saida = (volatile uint32_t *)base_mapeamento + FPGA_PALAVRA_DATA_OUT;
+        sequencia_pulsos = (uint32_t *)base_mapeamento + FPGA_PALAVRA_PULSOS;
+        confirmacao_pulsos = (uint32_t *)base_mapeamento + FPGA_PALAVRA_PULSOS_ACK;
+        if (iniciar_emulador_fpga((volatile uint32_t *)base_mapeamento) != 0) {
+            terminate_hardware();
+            return -1;
+        }
+        usando_emulador = 1;
+        return HW_SUCCESS;
+    }
+    if (strcmp(caminho, "/dev/mem") == 0) {
+        deslocamento = FPGA_PONTE_LW_BASE;
+    } else if (strncmp(caminho, "/dev/uio", 8) != 0) {
+        flags = O_RDWR | O_CREAT; // Arquivo compartilhado com outro processo.
+        usando_arquivo_compartilhado = 1;
+    }
+
+    descritor_mapeamento = open(caminho, flags, 0666);
+    if (descritor_mapeamento < 0) {
+        fprintf(stderr, "Não foi possível abrir '%s': %s\n", caminho, strerror(errno));
+        return -1;
+    }
+
+    // O arquivo do emulador precisa cobrir a região inteira antes do mmap.
+    struct stat info_dispositivo;
+    if (fstat(descritor_mapeamento, &info_dispositivo) == 0 && S_ISREG(info_dispositivo.st_mode) &&
+        info_dispositivo.st_size < FPGA_PONTE_LW_TAMANHO && ftruncate(descritor_mapeamento, FPGA_PONTE_LW_TAMANHO) != 0) {
+        fprintf(stderr, "Não foi possível dimensionar '%s': %s\n", caminho, strerror(errno));
+        close(descritor_mapeamento);
+        descritor_mapeamento = -1;
+        return -1;
+    }
+
+    base_mapeamento = mmap(NULL, FPGA_PONTE_LW_TAMANHO, PROT_READ | PROT_WRITE, MAP_SHARED, descritor_mapeamento, deslocamento);
+    if (base_mapeamento == MAP_FAILED) {
+        fprintf(stderr, "Não foi possível mapear '%s': %s\n", caminho, strerror(errno));
+        base_mapeamento = NULL;
+        close(descritor_mapeamento);
+        descritor_mapeamento = -1;
+        return -1;
+    }
+
+    registrador_entrada = (volatile uint32_t *)base_mapeamento + FPGA_PALAVRA_DATA_IN;
+    registrador_saida = (volatile uint32_t *)base_mapeamento + FPGA_PALAVRA_DATA_OUT;
+    if (usando_arquivo_compartilhado) {
+        sequencia_pulsos = (uint32_t *)base_mapeamento + FPGA_PALAVRA_PULSOS;
+        confirmacao_pulsos = (uint32_t *)base_mapeamento + FPGA_PALAVRA_PULSOS_ACK;
+        erro_simulacao = (uint32_t *)base_mapeamento + FPGA_PALAVRA_ERRO_SIM;
+    }
+    return HW_SUCCESS;
+}
+
+/**
+ * @brief Para o emulador (se houver), desfaz o mapeamento e fecha o dispositivo.
+ */
+int terminate_hardware(void) {
+    if (usando_emulador) encerrar_emulador_fpga();
+    usando_emulador = 0;
+    if (base_mapeamento != NULL) munmap(base_mapeamento, FPGA_PONTE_LW_TAMANHO);
+    if (descritor_mapeamento >= 0) close(descritor_mapeamento);
+    base_mapeamento = NULL;
+    registrador_entrada = registrador_saida = NULL;
+    sequencia_pulsos = confirmacao_pulsos = erro_simulacao = NULL;
+    descritor_mapeamento = -1;
+    usando_arquivo_compartilhado = 0;
+    return HW_SUCCESS;
+}
+
+/**
+ * @brief Ciclos de clock simulados até agora pela co-simulação (`Coprocessor/sim`).
+ *
+ * @return O contador publicado em FPGA_PALAVRA_CICLOS_SIM, ou 0 com /dev/mem, UIO ou o emulador
+ *         (na ponte real, esse deslocamento pertence a outro periférico e não é lido).
+ */
+uint64_t ciclos_dispositivo_fpga(void) {
+    if (!usando_arquivo_compartilhado || base_mapeamento == NULL) return 0;
+    return __atomic_load_n((uint64_t *)((uint32_t *)base_mapeamento + FPGA_PALAVRA_CICLOS_SIM), __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Envia os 25 pares (pixel, kernel) à FPGA: pulsos de reset e start e um handshake por par.
+ *
+ * Os ponteiros dos registradores ficam em variáveis locais durante todo o laço. Cada palavra leva
+ * o pixel (bits 0-7), o kernel (8-15), o opcode (16-18), o tamanho (19+) e o bit 31 (pronto).
+ *
+ * @return HW_SUCCESS, ou HW_SEND_FAIL sem mapeamento ou se a FPGA (ou o simulador, nos pulsos) não responder.
+ */
+int transfer_data_to_fpga(const struct Params* p) {
+    volatile uint32_t *entrada = registrador_entrada;
+    volatile const uint32_t *saida = registrador_saida;
+    const uint32_t campos = (p->opcode << 16) | (p->size << 19);
+    uint32_t leituras_alto = 0, leituras_baixo = 0, maior_handshake = 0;
+    uint32_t instante = 0, instante_envio = 0;
+    int indice;
+
+    if (entrada == NULL) return HW_SEND_FAIL;
+    if (perfil_fpga_ativo) instante = ler_ciclos();
+
+    if (enviar_pulso(entrada, FPGA_BIT_RESET) != 0) return HW_SEND_FAIL;
+    for (volatile int espera = FPGA_CICLOS_ATRASO; espera > 0; espera--);
+    if (enviar_pulso(entrada, FPGA_BIT_START) != 0) return HW_SEND_FAIL;
+
+    if (perfil_fpga_ativo) {
+        instante_envio = ler_ciclos();
+        perfil_fpga.ciclos_pulsos += (uint32_t)(instante_envio - instante);
+    }
+
+    for (indice = 0; indice < MATRIX_SIZE; indice++) {
+        uint32_t alto = 0, baixo = 0;
+        *entrada = campos | p->a[indice] | ((uint32_t)(uint8_t)p->b[indice] << 8) | FPGA_BIT_PRONTO;
+        esperar_ack(saida, FPGA_BIT_PRONTO, &alto);
+        *entrada = 0;
+        esperar_ack(saida, 0, &baixo);
+        if (alto > FPGA_LIMITE_LEITURAS || baixo > FPGA_LIMITE_LEITURAS) return HW_SEND_FAIL;
+
+        leituras_alto += alto;
+        leituras_baixo += baixo;
+        if (alto + baixo > maior_handshake) maior_handshake = alto + baixo;
+    }
+
+    if (perfil_fpga_ativo) {
+        perfil_fpga.ciclos_envio += (uint32_t)(ler_ciclos() - instante_envio);
+        perfil_fpga.chamadas_envio++;
+        perfil_fpga.leituras_ack_alto_envio += leituras_alto;
+        perfil_fpga.leituras_ack_baixo_envio += leituras_baixo;
+        perfil_fpga.handshakes_envio += MATRIX_SIZE;
+        if (maior_handshake > perfil_fpga.max_leituras_handshake) perfil_fpga.max_leituras_handshake = maior_handshake;
+    }
+    return HW_SUCCESS;
+}
+
+/**
+ * @brief Lê os 25 bytes de resultado da FPGA, um handshake por byte.
+ *
+ * @return HW_SUCCESS, ou HW_SEND_FAIL sem mapeamento ou se a FPGA não responder a um handshake.
+ */
+int retrieve_fpga_results(uint8_t* result) {
+    volatile uint32_t *entrada = registrador_entrada;
+    volatile const uint32_t *saida = registrador_saida;
+    uint32_t leituras_alto = 0, leituras_baixo = 0, maior_handshake = 0;
+    uint32_t instante = 0;
+    int indice;
+
+    if (entrada == NULL) return HW_SEND_FAIL;
+    if (perfil_fpga_ativo) instante = ler_ciclos();
+
+    for (indice = 0; indice < MATRIX_SIZE; indice++) {
+        uint32_t alto = 0, baixo = 0;
+        *entrada = FPGA_BIT_PRONTO;
+        uint32_t palavra = esperar_ack(saida, FPGA_BIT_PRONTO, &alto);
+        result[indice] = (uint8_t)palavra;
+        *entrada = 0;
+        esperar_ack(saida, 0, &baixo);
+        if (alto > FPGA_LIMITE_LEITURAS || baixo > FPGA_LIMITE_LEITURAS) return HW_SEND_FAIL;
+
+        leituras_alto += alto;
+        leituras_baixo += baixo;
+        if (alto + baixo > maior_handshake) maior_handshake = alto + baixo;
+    }
+
+    if (perfil_fpga_ativo) {
+        perfil_fpga.ciclos_recepcao += (uint32_t)(ler_ciclos() - instante);
+        perfil_fpga.chamadas_recepcao++;
+        perfil_fpga.leituras_ack_alto_recepcao += leituras_alto;
+        perfil_fpga.leituras_ack_baixo_recepcao += leituras_baixo;
+        perfil_fpga.handshakes_recepcao += MATRIX_SIZE;
+        if (maior_handshake > perfil_fpga.max_leituras_handshake) perfil_fpga.max_leituras_handshake = maior_handshake;
+    }
+    return HW_SUCCESS;
+}
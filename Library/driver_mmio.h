@@ -0,0 +1,30 @@
+#ifndef DRIVER_MMIO_H
+#define DRIVER_MMIO_H
+
+/* Driver MMIO em C (alternativa ao lib.s: make DRIVER=c) */
+#define FPGA_VARIAVEL_DISPOSITIVO "PBL3_FPGA_DISPOSITIVO" // /dev/mem (padrão), /dev/uioN, emulador ou arquivo compartilhado.
+#define FPGA_DISPOSITIVO_PADRAO "/dev/mem"
+#define FPGA_DISPOSITIVO_EMULADOR "emulador"    // Página anônima servida pela thread de emulador_fpga.c.
+
+#define FPGA_PONTE_LW_BASE 0xff200000u      // Endereço físico da ponte LW (só com /dev/mem).
+#define FPGA_PONTE_LW_TAMANHO 0x1000u       // Região mapeada (uma página).
+#define FPGA_PALAVRA_DATA_IN 0              // Índice (em palavras de 32 bits) de data_in no mapeamento.
+#define FPGA_PALAVRA_DATA_OUT 4             // data_out fica em +0x10.
+#define FPGA_PALAVRA_CICLOS_SIM 8           // +0x20: ciclos simulados (64 bits), publicados pela co-simulação.
+#define FPGA_PALAVRA_PULSOS 10              // +0x28: pulsos de reset/start enviados pelo driver (só na simulação).
+#define FPGA_PALAVRA_PULSOS_ACK 11          // +0x2C: último pulso aplicado pelo simulador.
+#define FPGA_PALAVRA_ERRO_SIM 12            // +0x30: erro publicado pela co-simulação (0: nenhum; limpo no reset).
+
+/* Erros Publicados pela Co-simulação em FPGA_PALAVRA_ERRO_SIM */
+#define FPGA_ERRO_SIM_SEM_RESPOSTA 1        // O RTL não deu o ack de uma escrita dentro do limite de ciclos.
+
+/* Bits de Controle de data_in/data_out (control_unit.v) */
+#define FPGA_BIT_RESET (1u << 29)
+#define FPGA_BIT_START (1u << 30)
+#define FPGA_BIT_PRONTO (1u << 31)          // hps_ready em data_in, fpga_wait (ack) em data_out.
+
+#define FPGA_CICLOS_ATRASO 10               // Espera entre os pulsos de reset e start (DELAY_CYCLES do lib.s).
+#define FPGA_LIMITE_LEITURAS (1u << 24)     // Leituras de data_out sem ack antes de desistir do handshake.
+#define FPGA_LEITURAS_CEDER 64              // Leituras sem ack antes de ceder o processador (potência de 2).
+
+#endif
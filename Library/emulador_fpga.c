@@ -0,0 +1,170 @@
+#include <stdio.h>      // Para a mensagem de erro (fprintf).
+#include <string.h>     // Para memset.
+#include <pthread.h>    // Para a thread do emulador.
+#include <sched.h>      // Para sched_yield.
+#include <stdatomic.h>  // Para o pedido de encerramento.
+#include <unistd.h>     // Para usleep.
+#include "driver_mmio.h"
+#include "emulador_fpga.h"
+#include "modelo_rtl.h"
+
+#define EMULADOR_LEITURAS_CEDER 64        // Leituras sem mudança em data_in antes de ceder o processador.
+#define EMULADOR_LEITURAS_DORMIR (1 << 16) // ... e antes de passar a dormir entre as leituras (FPGA ociosa).
+
+// Estados da FSM de control_unit.v.
+typedef enum { ESTADO_IDLE, ESTADO_RECEIVING, ESTADO_PROCESSING, ESTADO_SENDING } tipo_estado_control_unit;
+
+// Registradores de control_unit.v que o protocolo observa.
+typedef struct {
+    tipo_estado_control_unit estado;
+    unsigned indice;
+    uint32_t pronto_anterior;         // hps_ready_prev: detecção da borda de subida do bit 31.
+    unsigned op_code, matrix_size;
+    uint8_t pixel[25];
+    int8_t kernel[25];
+    uint8_t matrix_result[25];
+} tipo_control_unit;
+
+static volatile uint32_t *regiao_emulador = NULL;
+static pthread_t thread_emulador;
+static atomic_int encerrando_emulador;
+
+/**
+ * @brief Volta a FSM ao estado de reset (reset assíncrono por data_in[29]).
+ */
+static void reiniciar_control_unit(tipo_control_unit *unidade) {
+    memset(unidade, 0, sizeof(*unidade));
+    unidade->estado = ESTADO_IDLE;
+}
+
+/**
+ * @brief Aplica um pulso confirmado pelo driver (FPGA_PALAVRA_PULSOS): reset e/ou start em data_in.
+ *
+ * O reset volta a FSM ao estado inicial; o start só tem efeito em IDLE, como em control_unit.v.
+ */
+static void aplicar_pulso_control_unit(tipo_control_unit *unidade, uint32_t data_in) {
+    if (data_in & FPGA_BIT_RESET) reiniciar_control_unit(unidade);
+    if ((data_in & FPGA_BIT_START) && unidade->estado == ESTADO_IDLE && !(data_in & FPGA_BIT_RESET)) {
+        unidade->estado = ESTADO_RECEIVING;
+        unidade->indice = 0;
+    }
+}
+
+/**
+ * @brief Avança a FSM para o valor atual de data_in e devolve o valor de data_out.
+ *
+ * Um ciclo do emulador corresponde a várias bordas de clock do RTL: a sincronização de hps_ready
+ * (3 registradores) e o registro de data_out são instantâneos aqui. Os bits de reset e start são
+ * ignorados: os pulsos chegam só por `aplicar_pulso_control_unit`. Em IDLE, bordas de hps_ready
+ * não fazem nada, como no RTL.
+ */
+static uint32_t avancar_control_unit(tipo_control_unit *unidade, uint32_t data_in) {
+    uint32_t pronto = data_in & FPGA_BIT_PRONTO;
+    int borda = pronto && !unidade->pronto_anterior;
+
+    unidade->pronto_anterior = pronto;
+    if (borda) {
+        if (unidade->estado == ESTADO_RECEIVING) {
+            unidade->op_code = (data_in >> 16) & 7;
+            unidade->matrix_size = (data_in >> 19) & 3;
+            unidade->pixel[unidade->indice] = (uint8_t)data_in;
+            unidade->kernel[unidade->indice] = (int8_t)(data_in >> 8);
+            if (++unidade->indice == 25) {
+                unidade->indice = 0;
+                unidade->estado = ESTADO_PROCESSING;
+            }
+        } else if (unidade->estado == ESTADO_SENDING) {
+            if (unidade->indice == 25) unidade->estado = ESTADO_IDLE; // Envio completo.
+            unidade->indice++;
+        }
+    }
+
+    // coprocessor.v: só a convolução (op_code 111) levanta process_Done; as demais ficam em PROCESSING.
+    if (unidade->estado == ESTADO_PROCESSING && unidade->op_code == FPGA_OPCODE_CONVOLUCAO) {
+        resultado_control_unit_rtl(unidade->pixel, unidade->kernel, unidade->matrix_size, unidade->matrix_result);
+        unidade->indice = 0;
+        unidade->estado = ESTADO_SENDING;
+    }
+
+    // data_out = { fpga_wait, 23'b0, matrix_result[index - 1] }.
+    uint32_t data_out = 0;
+    if ((unidade->estado == ESTADO_RECEIVING || unidade->estado == ESTADO_SENDING) && pronto) data_out |= FPGA_BIT_PRONTO;
+    if (unidade->estado == ESTADO_SENDING && unidade->indice >= 1 && unidade->indice <= 25) {
+        data_out |= unidade->matrix_result[unidade->indice - 1];
+    }
+    return data_out;
+}
+
+/**
+ * @brief Corpo da thread: aplica os pulsos, lê data_in, avança a FSM e publica data_out até o encerramento.
+ *
+ * Os pulsos de reset e start vêm pela sequência em FPGA_PALAVRA_PULSOS: o driver mantém o pulso em
+ * data_in até a confirmação em FPGA_PALAVRA_PULSOS_ACK, então cada pulso enviado é aplicado uma vez,
+ * na ordem. Sem mudanças em data_in, cede o processador e, com a FPGA ociosa por muito tempo, dorme
+ * entre as leituras, para não disputar o processador com o programa.
+ */
+static void *executar_emulador(void *argumento) {
+    volatile uint32_t *data_in = regiao_emulador + FPGA_PALAVRA_DATA_IN;
+    volatile uint32_t *data_out = regiao_emulador + FPGA_PALAVRA_DATA_OUT;
+    uint32_t *sequencia_pulsos = (uint32_t *)regiao_emulador + FPGA_PALAVRA_PULSOS;
+    uint32_t *confirmacao_pulsos = (uint32_t *)regiao_emulador + FPGA_PALAVRA_PULSOS_ACK;
+    tipo_control_unit unidade;
+    uint32_t entrada_anterior = 0, saida_anterior = 0, pulsos_aplicados = 0;
+    unsigned leituras_ociosas = 0;
+    (void)argumento;
+
+    reiniciar_control_unit(&unidade);
+    *data_out = 0;
+    while (!atomic_load_explicit(&encerrando_emulador, memory_order_relaxed)) {
+        uint32_t sequencia = __atomic_load_n(sequencia_pulsos, __ATOMIC_ACQUIRE);
+        if (sequencia != pulsos_aplicados) {
+            aplicar_pulso_control_unit(&unidade, *data_in);
+            pulsos_aplicados = sequencia;
+            __atomic_store_n(confirmacao_pulsos, sequencia, __ATOMIC_RELEASE);
+            entrada_anterior = ~0u; // Reavalia data_in com a FSM nova.
+        }
+
+        uint32_t entrada = *data_in;
+        if (entrada == entrada_anterior) {
+            if (++leituras_ociosas >= EMULADOR_LEITURAS_DORMIR) usleep(50);
+            else if (leituras_ociosas % EMULADOR_LEITURAS_CEDER == 0) sched_yield();
+            continue;
+        }
+        leituras_ociosas = 0;
+        entrada_anterior = entrada;
+
+        uint32_t saida = avancar_control_unit(&unidade, entrada);
+        if (saida != saida_anterior) {
+            *data_out = saida;
+            saida_anterior = saida;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Inicia a thread que emula a FPGA sobre `regiao` (mapeada pelo driver no lugar da ponte LW).
+ *
+ * @param regiao Página compartilhada com data_in em FPGA_PALAVRA_DATA_IN e data_out em FPGA_PALAVRA_DATA_OUT.
+ * @return 0 em caso de sucesso, -1 se a thread não puder ser criada.
+ */
+int iniciar_emulador_fpga(volatile uint32_t *regiao) {
+    regiao_emulador = regiao;
+    atomic_store(&encerrando_emulador, 0);
+    if (pthread_create(&thread_emulador, NULL, executar_emulador, NULL) != 0) {
+        fprintf(stderr, "Não foi possível criar a thread do emulador da FPGA\n");
+        regiao_emulador = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Para e aguarda a thread do emulador.
+ */
+void encerrar_emulador_fpga(void) {
+    if (regiao_emulador == NULL) return;
+    atomic_store(&encerrando_emulador, 1);
+    pthread_join(thread_emulador, NULL);
+    regiao_emulador = NULL;
+}
@@ -0,0 +1,11 @@
+#ifndef EMULADOR_FPGA_H
+#define EMULADOR_FPGA_H
+#include <stdint.h>
+
+/* Emulador do control_unit.v e da convolution.v (PBL3_FPGA_DISPOSITIVO=emulador) */
+#define FPGA_OPCODE_CONVOLUCAO 7    // Única operação do coprocessor.v; as demais nunca terminam.
+
+int iniciar_emulador_fpga(volatile uint32_t *regiao);
+void encerrar_emulador_fpga(void);
+
+#endif
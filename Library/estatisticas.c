@@ -0,0 +1,343 @@
+#include <stdio.h>        // Para a gravação do JSON (fopen, fprintf).
+#include <string.h>       // Para strcmp e memset.
+#include <time.h>         // Para clock_gettime (CLOCK_MONOTONIC).
+#include <pthread.h>      // Para o mutex dos totais da execução.
+#include <stdatomic.h>    // Para os contadores de alocação.
+#include <unistd.h>       // Para sysconf (tamanho da página).
+#include <sys/resource.h> // Para getrusage (pico de RSS).
+#include "estatisticas.h"
+#include "rastro.h"        // Eventos da linha do tempo (--rastro) e escrever_string_json.
+#include "contadores_hw.h" // Ciclos, instruções e falhas de cache/desvio por etapa (--contadores-hw).
+
+int estatisticas_ativas = 0;
+
+// Nomes das etapas e contadores nas chaves do JSON (mesma ordem dos enums).
+static const char *const nomes_etapas[TOTAL_ETAPAS] = {
+    "carregar", "redimensionar", "cinza", "gradiente_x", "gradiente_y", "magnitude", "salvar"
+};
+static const char *const nomes_contadores[TOTAL_CONTADORES] = { "pixels", "janelas", "transacoes_fpga", "ciclos_fpga" };
+
+// Registro da imagem em andamento. Cada thread tem o seu: no modo progressivo, os tempos e contadores
+// das imagens da thread de refinamento não se misturam aos da thread principal. As alocações não são
+// separadas por thread (ver `concluir_imagem_estatistica`).
+typedef struct {
+    int em_andamento;
+    char nome_arquivo[128];
+    char nome_filtro[32];
+    const char *modo;
+    uint64_t instante_inicio_ns;
+    uint64_t ns_etapa[TOTAL_ETAPAS];
+    uint64_t contadores[TOTAL_CONTADORES];
+    uint64_t hw_etapa[TOTAL_ETAPAS][TOTAL_CONTADORES_HW];
+    uint32_t mascara_hw_indisponivel;  // Bit k: o evento k faltou em alguma leitura.
+    uint64_t alocacoes_inicio, bytes_alocados_inicio;
+} tipo_registro_imagem;
+
+static _Thread_local tipo_registro_imagem registro_imagem;
+
+// Leitura dos contadores de hardware feita junto com o último `instante_estatistica_ns` da thread.
+// Uma etapa só recebe contadores se começou nesse instante (as etapas não se aninham).
+static _Thread_local uint64_t instante_amostra_hw_ns;
+static _Thread_local uint64_t amostra_hw[TOTAL_CONTADORES_HW];
+static _Thread_local int amostra_hw_valida;
+
+// Totais da execução, acumulados ao fim de cada imagem.
+static pthread_mutex_t mutex_estatisticas = PTHREAD_MUTEX_INITIALIZER;
+static FILE *arquivo_estatisticas = NULL;
+static const char *motor_estatisticas = "";
+static int threads_estatisticas = 1;
+static uint64_t instante_inicio_execucao_ns;
+static uint64_t total_imagens, total_falhas;
+static uint64_t total_ns_etapa[TOTAL_ETAPAS];
+static uint64_t total_contadores[TOTAL_CONTADORES];
+static uint64_t total_hw_etapa[TOTAL_ETAPAS][TOTAL_CONTADORES_HW];
+static uint32_t total_mascara_hw_indisponivel;
+
+/* ============ CONTAGEM DE ALOCAÇÕES ============ */
+
+// Com ESTATISTICAS_ALOCACOES, o Makefile liga o programa com `-Wl,--wrap=malloc,...`: as chamadas
+// de malloc/calloc/realloc/free do próprio programa (inclusive do stb_image) passam por aqui.
+static atomic_uint_fast64_t total_alocacoes, total_liberacoes, total_bytes_alocados;
+
+#ifdef ESTATISTICAS_ALOCACOES
+#include <stddef.h>
+
+void *__real_malloc(size_t tamanho);
+void *__real_calloc(size_t quantidade, size_t tamanho);
+void *__real_realloc(void *ponteiro, size_t tamanho);
+void __real_free(void *ponteiro);
+
+void *__wrap_malloc(size_t tamanho) {
+    atomic_fetch_add_explicit(&total_alocacoes, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&total_bytes_alocados, tamanho, memory_order_relaxed);
+    return __real_malloc(tamanho);
+}
+
+void *__wrap_calloc(size_t quantidade, size_t tamanho) {
+    atomic_fetch_add_explicit(&total_alocacoes, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&total_bytes_alocados, quantidade * tamanho, memory_order_relaxed);
+    return __real_calloc(quantidade, tamanho);
+}
+
+// Um realloc conta como uma nova alocação do tamanho pedido.
+void *__wrap_realloc(void *ponteiro, size_t tamanho) {
+    atomic_fetch_add_explicit(&total_alocacoes, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&total_bytes_alocados, tamanho, memory_order_relaxed);
+    return __real_realloc(ponteiro, tamanho);
+}
+
+void __wrap_free(void *ponteiro) {
+    if (ponteiro != NULL) atomic_fetch_add_explicit(&total_liberacoes, 1, memory_order_relaxed);
+    __real_free(ponteiro);
+}
+#endif
+
+/* ============ MEDIÇÕES ============ */
+
+/**
+ * @brief Instante atual do relógio monotônico, em nanossegundos.
+ */
+static uint64_t ler_relogio_ns(void) {
+    struct timespec instante;
+    clock_gettime(CLOCK_MONOTONIC, &instante);
+    return (uint64_t)instante.tv_sec * 1000000000ull + (uint64_t)instante.tv_nsec;
+}
+
+/**
+ * @brief Instante que marca o início de uma etapa (0 sem `--stats` e sem `--rastro`).
+ *
+ * Com `--contadores-hw`, também guarda a leitura dos contadores da thread nesse instante.
+ */
+uint64_t instante_estatistica_ns(void) {
+    if (!estatisticas_ativas && !rastro_ativo) return 0;
+    if (estatisticas_ativas && contadores_hw_ativos) {
+        amostra_hw_valida = (ler_contadores_hw(amostra_hw) == 0);
+        instante_amostra_hw_ns = ler_relogio_ns();
+        return instante_amostra_hw_ns;
+    }
+    return ler_relogio_ns();
+}
+
+/**
+ * @brief Pico de RSS do processo desde o início, em KiB (`ru_maxrss`).
+ */
+static long obter_rss_pico_kb(void) {
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return -1;
+    return uso.ru_maxrss;
+}
+
+/**
+ * @brief RSS atual do processo, em KiB (`/proc/self/statm`), ou -1 se indisponível.
+ */
+static long obter_rss_atual_kb(void) {
+    FILE *arquivo_statm = fopen("/proc/self/statm", "r");
+    long paginas_total, paginas_residentes;
+    if (arquivo_statm == NULL) return -1;
+    int lidos = fscanf(arquivo_statm, "%ld %ld", &paginas_total, &paginas_residentes);
+    fclose(arquivo_statm);
+    if (lidos != 2) return -1;
+    return paginas_residentes * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * @brief Grava o objeto "contadores_hw": por etapa, a soma de cada evento (null se o evento faltou).
+ */
+static void escrever_contadores_hw_json(FILE *arquivo, const uint64_t hw_etapa[TOTAL_ETAPAS][TOTAL_CONTADORES_HW],
+                                        uint32_t mascara_hw_indisponivel) {
+    int indice_etapa, indice_evento;
+
+    if (!contadores_hw_ativos) {
+        fprintf(arquivo, ",\"contadores_hw\":null");
+        return;
+    }
+    fprintf(arquivo, ",\"contadores_hw\":{");
+    for (indice_etapa = 0; indice_etapa < TOTAL_ETAPAS; indice_etapa++) {
+        fprintf(arquivo, "%s\"%s\":{", indice_etapa ? "," : "", nomes_etapas[indice_etapa]);
+        for (indice_evento = 0; indice_evento < TOTAL_CONTADORES_HW; indice_evento++) {
+            fprintf(arquivo, "%s\"%s\":", indice_evento ? "," : "", nomes_contadores_hw[indice_evento]);
+            if (mascara_hw_indisponivel & (1u << indice_evento)) fprintf(arquivo, "null");
+            else fprintf(arquivo, "%llu", (unsigned long long)hw_etapa[indice_etapa][indice_evento]);
+        }
+        fputc('}', arquivo);
+    }
+    fputc('}', arquivo);
+}
+
+/**
+ * @brief Grava os objetos "etapas_ms", "contadores" e "contadores_hw" e os campos de memória comuns às duas linhas.
+ *
+ * @param sufixo_alocacoes Sufixo das chaves "alocacoes" e "bytes_alocados" ("_processo" na linha da imagem).
+ */
+static void escrever_medicoes_json(FILE *arquivo, const uint64_t *ns_etapa, const uint64_t *contadores,
+                                   const uint64_t hw_etapa[TOTAL_ETAPAS][TOTAL_CONTADORES_HW], uint32_t mascara_hw_indisponivel,
+                                   const char *sufixo_alocacoes, uint64_t alocacoes, uint64_t bytes_alocados) {
+    int indice;
+
+    fprintf(arquivo, "\"etapas_ms\":{");
+    for (indice = 0; indice < TOTAL_ETAPAS; indice++) {
+        fprintf(arquivo, "%s\"%s\":%.3f", indice ? "," : "", nomes_etapas[indice], ns_etapa[indice] / 1e6);
+    }
+    fprintf(arquivo, "},\"contadores\":{");
+    for (indice = 0; indice < TOTAL_CONTADORES; indice++) {
+        fprintf(arquivo, "%s\"%s\":%llu", indice ? "," : "", nomes_contadores[indice], (unsigned long long)contadores[indice]);
+    }
+    fputc('}', arquivo);
+    escrever_contadores_hw_json(arquivo, hw_etapa, mascara_hw_indisponivel);
+    fprintf(arquivo, ",\"rss_pico_kb\":%ld,\"rss_atual_kb\":%ld", obter_rss_pico_kb(), obter_rss_atual_kb());
+#ifdef ESTATISTICAS_ALOCACOES
+    fprintf(arquivo, ",\"alocacoes%s\":%llu,\"bytes_alocados%s\":%llu", sufixo_alocacoes, (unsigned long long)alocacoes,
+            sufixo_alocacoes, (unsigned long long)bytes_alocados);
+#else
+    (void)alocacoes;
+    (void)bytes_alocados;
+    fprintf(arquivo, ",\"alocacoes%s\":null,\"bytes_alocados%s\":null", sufixo_alocacoes, sufixo_alocacoes);
+#endif
+}
+
+/* ============ CICLO DE VIDA ============ */
+
+/**
+ * @brief Ativa as estatísticas e abre o arquivo JSON Lines de saída.
+ *
+ * Cada imagem gera uma linha `{"tipo":"imagem",...}` e `encerrar_estatisticas` grava a linha
+ * `{"tipo":"execucao",...}` com os totais.
+ *
+ * @param caminho_arquivo Arquivo de saída; "-" grava na saída de erro (a saída padrão tem o menu).
+ * @param motor Nome do motor de convolução ("cpu" ou "fpga").
+ * @param total_threads Threads do grupo de CPU.
+ * @return 0 em caso de sucesso, -1 se o arquivo não puder ser criado.
+ */
+int iniciar_estatisticas(const char *caminho_arquivo, const char *motor, int total_threads) {
+    arquivo_estatisticas = (strcmp(caminho_arquivo, "-") == 0) ? stderr : fopen(caminho_arquivo, "w");
+    if (arquivo_estatisticas == NULL) return -1;
+    motor_estatisticas = motor;
+    threads_estatisticas = total_threads;
+    estatisticas_ativas = 1;
+    instante_inicio_execucao_ns = ler_relogio_ns();
+    return 0;
+}
+
+/**
+ * @brief Grava a linha com os totais da execução e fecha o arquivo.
+ */
+void encerrar_estatisticas(void) {
+    if (!estatisticas_ativas) return;
+
+    pthread_mutex_lock(&mutex_estatisticas);
+    uint64_t duracao_ns = ler_relogio_ns() - instante_inicio_execucao_ns;
+    fprintf(arquivo_estatisticas, "{\"tipo\":\"execucao\",\"motor\":\"%s\",\"threads\":%d,\"imagens\":%llu,\"falhas\":%llu,\"ms_total\":%.3f,",
+            motor_estatisticas, threads_estatisticas, (unsigned long long)total_imagens, (unsigned long long)total_falhas, duracao_ns / 1e6);
+    escrever_medicoes_json(arquivo_estatisticas, total_ns_etapa, total_contadores, total_hw_etapa, total_mascara_hw_indisponivel, "",
+                           atomic_load_explicit(&total_alocacoes, memory_order_relaxed),
+                           atomic_load_explicit(&total_bytes_alocados, memory_order_relaxed));
+#ifdef ESTATISTICAS_ALOCACOES
+    fprintf(arquivo_estatisticas, ",\"liberacoes\":%llu", (unsigned long long)atomic_load_explicit(&total_liberacoes, memory_order_relaxed));
+#endif
+    fprintf(arquivo_estatisticas, "}\n");
+    if (arquivo_estatisticas != stderr) fclose(arquivo_estatisticas);
+    arquivo_estatisticas = NULL;
+    estatisticas_ativas = 0;
+    pthread_mutex_unlock(&mutex_estatisticas);
+}
+
+/**
+ * @brief Começa o registro de uma imagem na thread atual (zera tempos e contadores).
+ *
+ * @param modo "completo", "previa", "refinamento" ou "piramide".
+ */
+void iniciar_imagem_estatistica(const char *nome_arquivo, const char *nome_filtro, const char *modo) {
+    if (!estatisticas_ativas && !rastro_ativo) return;
+    memset(&registro_imagem, 0, sizeof(registro_imagem));
+    snprintf(registro_imagem.nome_arquivo, sizeof(registro_imagem.nome_arquivo), "%s", nome_arquivo);
+    snprintf(registro_imagem.nome_filtro, sizeof(registro_imagem.nome_filtro), "%s", nome_filtro);
+    registro_imagem.modo = modo;
+    registro_imagem.alocacoes_inicio = atomic_load_explicit(&total_alocacoes, memory_order_relaxed);
+    registro_imagem.bytes_alocados_inicio = atomic_load_explicit(&total_bytes_alocados, memory_order_relaxed);
+    registro_imagem.instante_inicio_ns = ler_relogio_ns();
+    registro_imagem.em_andamento = 1;
+}
+
+/**
+ * @brief Soma à etapa o tempo decorrido desde `instante_inicio_ns` (de `instante_estatistica_ns`).
+ *
+ * Uma etapa pode ser registrada várias vezes por imagem (níveis da pirâmide, canais de cor).
+ * Com `--contadores-hw`, soma também a diferença dos contadores da thread desde o início da etapa.
+ * Com `--rastro`, o intervalo também vira um evento da categoria "etapa".
+ */
+void registrar_etapa_estatistica(tipo_etapa_estatistica etapa, uint64_t instante_inicio_ns) {
+    int indice;
+    if (!registro_imagem.em_andamento) return;
+
+    if (estatisticas_ativas && contadores_hw_ativos && amostra_hw_valida && instante_amostra_hw_ns == instante_inicio_ns) {
+        uint64_t leitura_fim[TOTAL_CONTADORES_HW];
+        if (ler_contadores_hw(leitura_fim) == 0) {
+            for (indice = 0; indice < TOTAL_CONTADORES_HW; indice++) {
+                if (leitura_fim[indice] == CONTADOR_HW_INDISPONIVEL) registro_imagem.mascara_hw_indisponivel |= 1u << indice;
+                else registro_imagem.hw_etapa[etapa][indice] += leitura_fim[indice] - amostra_hw[indice];
+            }
+        }
+        amostra_hw_valida = 0;
+    }
+    uint64_t instante_fim_ns = ler_relogio_ns();
+    registro_imagem.ns_etapa[etapa] += instante_fim_ns - instante_inicio_ns;
+    if (rastro_ativo) registrar_evento_rastro(nomes_etapas[etapa], "etapa", instante_inicio_ns, instante_fim_ns);
+}
+
+/**
+ * @brief Soma `quantidade` a um contador da imagem em andamento na thread atual.
+ */
+void contar_estatistica(tipo_contador_estatistica contador, uint64_t quantidade) {
+    if (!estatisticas_ativas || !registro_imagem.em_andamento) return;
+    registro_imagem.contadores[contador] += quantidade;
+}
+
+/**
+ * @brief Encerra o registro da imagem: grava sua linha JSON e acumula os totais da execução.
+ *
+ * As alocações da linha são a diferença dos contadores globais entre o início e o fim da imagem, por
+ * isso valem para o processo inteiro ("alocacoes_processo"): entram as das threads do grupo que
+ * trabalharam na imagem e as de qualquer outra thread no mesmo intervalo (as imagens não se sobrepõem,
+ * já que a thread principal espera a de refinamento antes de cada operação).
+ * Com `--rastro`, a imagem inteira vira um evento da categoria "imagem", com o nome do arquivo.
+ *
+ * @param sucesso 1 se a imagem foi processada e salva; 0 em caso de erro ou cancelamento.
+ */
+void concluir_imagem_estatistica(int sucesso) {
+    int indice;
+    if (!registro_imagem.em_andamento) return;
+    registro_imagem.em_andamento = 0;
+
+    uint64_t instante_fim_ns = ler_relogio_ns();
+    if (rastro_ativo) {
+        registrar_evento_rastro(registro_imagem.nome_arquivo, "imagem", registro_imagem.instante_inicio_ns, instante_fim_ns);
+    }
+    if (!estatisticas_ativas) return;
+
+    uint64_t duracao_ns = instante_fim_ns - registro_imagem.instante_inicio_ns;
+    uint64_t alocacoes = atomic_load_explicit(&total_alocacoes, memory_order_relaxed) - registro_imagem.alocacoes_inicio;
+    uint64_t bytes_alocados = atomic_load_explicit(&total_bytes_alocados, memory_order_relaxed) - registro_imagem.bytes_alocados_inicio;
+
+    pthread_mutex_lock(&mutex_estatisticas);
+    if (arquivo_estatisticas != NULL) {
+        fprintf(arquivo_estatisticas, "{\"tipo\":\"imagem\",\"arquivo\":");
+        escrever_string_json(arquivo_estatisticas, registro_imagem.nome_arquivo);
+        fprintf(arquivo_estatisticas, ",\"filtro\":");
+        escrever_string_json(arquivo_estatisticas, registro_imagem.nome_filtro);
+        fprintf(arquivo_estatisticas, ",\"modo\":\"%s\",\"sucesso\":%s,\"ms_total\":%.3f,",
+                registro_imagem.modo, sucesso ? "true" : "false", duracao_ns / 1e6);
+        escrever_medicoes_json(arquivo_estatisticas, registro_imagem.ns_etapa, registro_imagem.contadores, registro_imagem.hw_etapa,
+                               registro_imagem.mascara_hw_indisponivel, "_processo", alocacoes, bytes_alocados);
+        fprintf(arquivo_estatisticas, "}\n");
+        fflush(arquivo_estatisticas); // Uma execução interrompida mantém as linhas já gravadas.
+    }
+    if (sucesso) total_imagens++;
+    else total_falhas++;
+    for (indice = 0; indice < TOTAL_ETAPAS; indice++) total_ns_etapa[indice] += registro_imagem.ns_etapa[indice];
+    for (indice = 0; indice < TOTAL_CONTADORES; indice++) total_contadores[indice] += registro_imagem.contadores[indice];
+    for (indice = 0; indice < TOTAL_ETAPAS * TOTAL_CONTADORES_HW; indice++) {
+        (&total_hw_etapa[0][0])[indice] += (&registro_imagem.hw_etapa[0][0])[indice];
+    }
+    total_mascara_hw_indisponivel |= registro_imagem.mascara_hw_indisponivel;
+    pthread_mutex_unlock(&mutex_estatisticas);
+}
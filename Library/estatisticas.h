@@ -0,0 +1,39 @@
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+#include <stdint.h>
+
+/* Estatísticas de Execução (--stats) */
+// Etapas cronometradas de cada imagem (relógio monotônico, tempo somado por etapa).
+typedef enum {
+    ETAPA_CARREGAR = 0,   // Decodificação do arquivo (stb_image).
+    ETAPA_REDIMENSIONAR,  // Vizinho mais próximo para 320x240.
+    ETAPA_CINZA,          // Conversão RGB -> cinza.
+    ETAPA_GRADIENTE_X,    // Varredura do kernel Gx (com a pré-suavização e a pré-passada; com --cor, os três canais).
+    ETAPA_GRADIENTE_Y,    // Varredura do kernel Gy.
+    ETAPA_MAGNITUDE,      // Magnitude/|Gx| ou Canny.
+    ETAPA_SALVAR,         // Gravação do PNG, da máscara ou da exportação.
+    TOTAL_ETAPAS
+} tipo_etapa_estatistica;
+
+// Contadores por imagem.
+typedef enum {
+    CONTADOR_PIXELS = 0,        // Pixels dos planos filtrados (um por nível/prévia).
+    CONTADOR_JANELAS,           // Janelas calculadas pelos motores (blocos planos pulados não contam).
+    CONTADOR_TRANSACOES_FPGA,   // Pares transfer_data_to_fpga/retrieve_fpga_results.
+    CONTADOR_CICLOS_FPGA,       // Ciclos de clock do RTL na co-simulação (0 no hardware real).
+    TOTAL_CONTADORES
+} tipo_contador_estatistica;
+
+// 1 quando `--stats` está ativo; sem ele e sem `--rastro`, cada chamada abaixo retorna logo no início.
+extern int estatisticas_ativas;
+
+int iniciar_estatisticas(const char *caminho_arquivo, const char *motor, int total_threads);
+void encerrar_estatisticas(void);
+
+uint64_t instante_estatistica_ns(void);
+void iniciar_imagem_estatistica(const char *nome_arquivo, const char *nome_filtro, const char *modo);
+void registrar_etapa_estatistica(tipo_etapa_estatistica etapa, uint64_t instante_inicio_ns);
+void contar_estatistica(tipo_contador_estatistica contador, uint64_t quantidade);
+void concluir_imagem_estatistica(int sucesso);
+
+#endif
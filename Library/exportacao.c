@@ -0,0 +1,233 @@
+#include <stdio.h>    // Para escrita dos arquivos (fopen, fwrite) e mensagens.
+#include <stdlib.h>   // Para malloc, free e abs.
+#include <string.h>   // Para strlen e memset.
+#include "exportacao.h"
+
+// --- Tabela do arco tangente ---
+
+// atan(i / 128) para i = 0..128, em ângulo binário (65536 = 2π). Cobre o primeiro octante (0 a 45°);
+// os demais são obtidos por simetria em `atan2_tabela`, sem chamadas à libm.
+static const uint16_t tabela_arco_tangente[129] = {
+        0,    81,   163,   244,   326,   407,   489,   570,
+      651,   732,   813,   894,   975,  1056,  1136,  1217,
+     1297,  1377,  1457,  1537,  1617,  1696,  1775,  1854,
+     1933,  2012,  2090,  2168,  2246,  2324,  2401,  2478,
+     2555,  2632,  2708,  2784,  2860,  2935,  3010,  3085,
+     3159,  3233,  3307,  3380,  3453,  3526,  3599,  3670,
+     3742,  3813,  3884,  3955,  4025,  4095,  4164,  4233,
+     4302,  4370,  4438,  4505,  4572,  4639,  4705,  4771,
+     4836,  4901,  4966,  5030,  5094,  5157,  5220,  5282,
+     5344,  5406,  5467,  5528,  5589,  5649,  5708,  5768,
+     5826,  5885,  5943,  6000,  6058,  6114,  6171,  6227,
+     6282,  6337,  6392,  6446,  6500,  6554,  6607,  6660,
+     6712,  6764,  6815,  6867,  6917,  6968,  7018,  7068,
+     7117,  7166,  7214,  7262,  7310,  7358,  7405,  7451,
+     7498,  7544,  7589,  7635,  7679,  7724,  7768,  7812,
+     7856,  7899,  7942,  7984,  8026,  8068,  8110,  8151,
+     8192,
+};
+
+/**
+ * @brief Arco tangente de y/x no quadrante correto, por tabela com interpolação linear.
+ *
+ * O erro máximo é de cerca de 0,01°, bem abaixo da quantização usada na exportação (360/256 graus).
+ *
+ * @param y Componente vertical (Gy; o eixo y da imagem cresce para baixo).
+ * @param x Componente horizontal (Gx).
+ * @return Ângulo em [0, 65536), com 65536 = 2π; 0 quando x = y = 0.
+ */
+uint16_t atan2_tabela(int32_t y, int32_t x) {
+    uint32_t absoluto_x = (uint32_t)abs(x), absoluto_y = (uint32_t)abs(y);
+    uint32_t numerador, denominador, razao, angulo;
+
+    if (absoluto_x == 0 && absoluto_y == 0) return 0;
+
+    // Reduz ao primeiro octante: razão sempre em [0, 1].
+    numerador = (absoluto_y <= absoluto_x) ? absoluto_y : absoluto_x;
+    denominador = (absoluto_y <= absoluto_x) ? absoluto_x : absoluto_y;
+    razao = (numerador << 16) / denominador;          // Q16, de 0 a 65536.
+
+    uint32_t indice = razao >> 9;                     // 128 intervalos.
+    uint32_t fracao = razao & 511;
+    angulo = tabela_arco_tangente[indice];
+    if (indice < 128) {
+        angulo += ((tabela_arco_tangente[indice + 1] - tabela_arco_tangente[indice]) * fracao) >> 9;
+    }
+
+    if (absoluto_y > absoluto_x) angulo = VOLTA_COMPLETA_ATAN2 / 4 - angulo; // Segundo octante.
+    if (x < 0) angulo = VOLTA_COMPLETA_ATAN2 / 2 - angulo;                    // Segundo quadrante.
+    if (y < 0) angulo = VOLTA_COMPLETA_ATAN2 - angulo;                        // Terceiro e quarto quadrantes.
+    return (uint16_t)(angulo & (VOLTA_COMPLETA_ATAN2 - 1));
+}
+
+/**
+ * @brief Raiz quadrada inteira arredondada para baixo (método dígito a dígito, sem libm).
+ */
+uint16_t raiz_quadrada_inteira(uint32_t valor) {
+    uint32_t resultado = 0, bit = 1u << 30;
+    while (bit > valor) bit >>= 2;
+    while (bit != 0) {
+        if (valor >= resultado + bit) {
+            valor -= resultado + bit;
+            resultado = (resultado >> 1) + bit;
+        } else {
+            resultado >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)resultado;
+}
+
+/**
+ * @brief Retorna o tamanho em bytes de um elemento.
+ */
+static int bytes_por_elemento(tipo_elemento_matriz tipo_elemento) {
+    return (tipo_elemento == ELEMENTO_UINT8) ? 1 : 2;
+}
+
+/**
+ * @brief Escreve o cabeçalho .npy (versão 1.0) de uma matriz altura x largura.
+ *
+ * O dicionário é completado com espaços para que os dados comecem em um múltiplo de 64 bytes,
+ * como faz o próprio NumPy.
+ */
+static int escrever_cabecalho_npy(FILE *arquivo, tipo_elemento_matriz tipo_elemento, int largura, int altura) {
+    static const char *descricoes_tipo[] = { "|u1", "<i2", "<u2" };
+    char dicionario[128];
+    int tamanho_dicionario = snprintf(dicionario, sizeof(dicionario),
+                                      "{'descr': '%s', 'fortran_order': False, 'shape': (%d, %d), }",
+                                      descricoes_tipo[tipo_elemento], altura, largura);
+    int tamanho_cabecalho = 10 + tamanho_dicionario + 1;               // Prefixo fixo + dicionário + '\n'.
+    int preenchimento = (64 - tamanho_cabecalho % 64) % 64;
+    int tamanho_total_dicionario = tamanho_dicionario + preenchimento + 1;
+    unsigned char prefixo[10] = { 0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                  (unsigned char)(tamanho_total_dicionario & 0xFF),
+                                  (unsigned char)(tamanho_total_dicionario >> 8) };
+
+    if (fwrite(prefixo, 1, sizeof(prefixo), arquivo) != sizeof(prefixo)) return -1;
+    if (fwrite(dicionario, 1, (size_t)tamanho_dicionario, arquivo) != (size_t)tamanho_dicionario) return -1;
+    while (preenchimento-- > 0) fputc(' ', arquivo);
+    fputc('\n', arquivo);
+    return 0;
+}
+
+/**
+ * @brief Salva uma matriz (altura x largura) em .npy ou raw, sempre em little-endian.
+ *
+ * Os bytes de cada linha são montados explicitamente, então o arquivo é o mesmo em hosts
+ * little-endian (ARM do HPS, x86) e big-endian.
+ *
+ * @param caminho_base Caminho sem extensão (ex.: "output/imagem_sobel_3x3").
+ * @param nome_matriz Nome acrescentado ao caminho (ex.: "gx").
+ * @param dados Elementos da matriz, linha a linha.
+ * @param tipo_elemento Tipo dos elementos.
+ * @param largura Largura da matriz.
+ * @param altura Altura da matriz.
+ * @param formato EXPORTACAO_NPY ou EXPORTACAO_RAW.
+ * @return 0 em caso de sucesso, -1 em caso de erro.
+ */
+int salvar_matriz_binaria(const char *caminho_base, const char *nome_matriz, const void *dados,
+                          tipo_elemento_matriz tipo_elemento, int largura, int altura, tipo_formato_exportacao formato) {
+    static const char *sufixos_tipo[] = { "u8", "i16", "u16" };
+    char caminho_arquivo[300];
+    int tamanho_elemento = bytes_por_elemento(tipo_elemento);
+    int coord_x, coord_y, resultado = 0;
+
+    if (formato == EXPORTACAO_NPY) {
+        snprintf(caminho_arquivo, sizeof(caminho_arquivo), "%s_%s.npy", caminho_base, nome_matriz);
+    } else {
+        snprintf(caminho_arquivo, sizeof(caminho_arquivo), "%s_%s_%s_%dx%d.raw",
+                 caminho_base, nome_matriz, sufixos_tipo[tipo_elemento], largura, altura);
+    }
+
+    FILE *arquivo = fopen(caminho_arquivo, "wb");
+    if (arquivo == NULL) {
+        perror("Erro ao criar arquivo de exportação");
+        return -1;
+    }
+    unsigned char *linha_bytes = malloc((size_t)largura * tamanho_elemento);
+    if (linha_bytes == NULL) {
+        fclose(arquivo);
+        return -1;
+    }
+
+    if (formato == EXPORTACAO_NPY && escrever_cabecalho_npy(arquivo, tipo_elemento, largura, altura) != 0) resultado = -1;
+
+    for (coord_y = 0; coord_y < altura && resultado == 0; coord_y++) {
+        if (tipo_elemento == ELEMENTO_UINT8) {
+            memcpy(linha_bytes, (const uint8_t *)dados + (size_t)coord_y * largura, (size_t)largura);
+        } else {
+            const uint16_t *linha = (const uint16_t *)dados + (size_t)coord_y * largura;
+            for (coord_x = 0; coord_x < largura; coord_x++) {
+                linha_bytes[2 * coord_x] = (unsigned char)(linha[coord_x] & 0xFF);
+                linha_bytes[2 * coord_x + 1] = (unsigned char)(linha[coord_x] >> 8);
+            }
+        }
+        if (fwrite(linha_bytes, (size_t)tamanho_elemento, (size_t)largura, arquivo) != (size_t)largura) resultado = -1;
+    }
+
+    free(linha_bytes);
+    if (fclose(arquivo) != 0) resultado = -1;
+    if (resultado != 0) {
+        fprintf(stderr, "Erro ao escrever '%s'\n", caminho_arquivo);
+    } else {
+        printf("Matriz salva: %s\n", caminho_arquivo);
+    }
+    return resultado;
+}
+
+/**
+ * @brief Exporta Gx, Gy, magnitude e orientação de um plano a partir de gradientes sem saturação.
+ *
+ * Gx/Gy devem vir do modo bruto (`convolver_regiao_cpu_bruto`, limitado a ±32767), não dos valores
+ * da FPGA, cujo 255 de saturação não é um gradiente. A magnitude é sqrt(Gx² + Gy²) em uint16, que
+ * comporta o maior valor sem saturar. A orientação é atan2(Gy, Gx) quantizada em 256 direções
+ * (uint8, 0 = +x, 64 = +y, isto é, para baixo na imagem).
+ * Filtros sem Gy exportam só Gx e |Gx| como magnitude.
+ *
+ * @param caminho_base Caminho sem extensão dos arquivos de saída.
+ * @param gradiente_x Resposta do kernel Gx (largura x altura).
+ * @param gradiente_y Resposta do kernel Gy, ou NULL.
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param formato EXPORTACAO_NPY ou EXPORTACAO_RAW.
+ * @return 0 em caso de sucesso, -1 se algum arquivo falhou.
+ */
+int exportar_gradientes(const char *caminho_base, const int16_t *gradiente_x, const int16_t *gradiente_y,
+                        int largura, int altura, tipo_formato_exportacao formato) {
+    int total_pixels = largura * altura, indice, resultado = 0;
+    uint16_t *magnitude = malloc((size_t)total_pixels * sizeof(uint16_t));
+    uint8_t *orientacao = (gradiente_y != NULL) ? malloc((size_t)total_pixels) : NULL;
+
+    if (magnitude == NULL || (gradiente_y != NULL && orientacao == NULL)) {
+        fprintf(stderr, "Memória insuficiente para exportar gradientes\n");
+        free(magnitude);
+        free(orientacao);
+        return -1;
+    }
+
+    for (indice = 0; indice < total_pixels; indice++) {
+        int32_t valor_gx = gradiente_x[indice];
+        if (gradiente_y == NULL) {
+            magnitude[indice] = (uint16_t)abs(valor_gx);
+            continue;
+        }
+        int32_t valor_gy = gradiente_y[indice];
+        magnitude[indice] = raiz_quadrada_inteira((uint32_t)(valor_gx * valor_gx) + (uint32_t)(valor_gy * valor_gy));
+        // Arredonda para a direção quantizada mais próxima (256 direções).
+        orientacao[indice] = (uint8_t)((atan2_tabela(valor_gy, valor_gx) + 128) >> 8);
+    }
+
+    resultado |= salvar_matriz_binaria(caminho_base, "gx", gradiente_x, ELEMENTO_INT16, largura, altura, formato);
+    if (gradiente_y != NULL) {
+        resultado |= salvar_matriz_binaria(caminho_base, "gy", gradiente_y, ELEMENTO_INT16, largura, altura, formato);
+    }
+    resultado |= salvar_matriz_binaria(caminho_base, "magnitude", magnitude, ELEMENTO_UINT16, largura, altura, formato);
+    if (gradiente_y != NULL) {
+        resultado |= salvar_matriz_binaria(caminho_base, "orientacao", orientacao, ELEMENTO_UINT8, largura, altura, formato);
+    }
+
+    free(magnitude);
+    free(orientacao);
+    return resultado;
+}
@@ -0,0 +1,29 @@
+#ifndef EXPORTACAO_H
+#define EXPORTACAO_H
+#include <stdint.h>
+
+/* Formatos de Exportação de Matrizes */
+typedef enum {
+    EXPORTACAO_NENHUMA = 0,
+    EXPORTACAO_NPY,       // Arquivo .npy (NumPy 1.0): cabeçalho com tipo e forma + dados little-endian.
+    EXPORTACAO_RAW        // Dados little-endian sem cabeçalho; tipo e dimensões vão no nome do arquivo.
+} tipo_formato_exportacao;
+
+/* Tipos de Elemento */
+typedef enum {
+    ELEMENTO_UINT8 = 0,
+    ELEMENTO_INT16,
+    ELEMENTO_UINT16
+} tipo_elemento_matriz;
+
+// Ângulo binário: uma volta completa corresponde a 65536 (2π).
+#define VOLTA_COMPLETA_ATAN2 65536u
+
+uint16_t atan2_tabela(int32_t y, int32_t x);
+uint16_t raiz_quadrada_inteira(uint32_t valor);
+int salvar_matriz_binaria(const char *caminho_base, const char *nome_matriz, const void *dados,
+                          tipo_elemento_matriz tipo_elemento, int largura, int altura, tipo_formato_exportacao formato);
+int exportar_gradientes(const char *caminho_base, const int16_t *gradiente_x, const int16_t *gradiente_y,
+                        int largura, int altura, tipo_formato_exportacao formato);
+
+#endif
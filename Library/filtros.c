@@ -0,0 +1,909 @@
+#include <stdio.h>    // Para leitura do arquivo de filtros e mensagens (fopen, fgetc, printf).
+#include <stdlib.h>   // Para abs e strtol.
+#include <string.h>   // Para strcmp, strncpy e memset.
+#include <limits.h>   // Para INT_MAX (custo de motores não aplicáveis).
+#include "filtros.h"
+#include "filtros_especializados.h" // Rotinas desenroladas e tabela de despacho dos kernels embutidos.
+
+// --- Registro Global de Filtros ---
+
+// Vetor com todos os filtros disponíveis no menu, na ordem em que foram registrados.
+tipo_filtro_borda filtros_registrados[MAX_FILTROS_REGISTRADOS];
+// Quantidade de entradas válidas em `filtros_registrados`.
+int total_filtros_registrados = 0;
+
+/* ========== DEFINIÇÕES DOS KERNELS DOS FILTROS ========== */
+// Kernels pré-definidos para diferentes filtros de detecção de borda.
+// Todos são representados como matrizes lineares de `MATRIX_SIZE` (25) elementos `int8_t`,
+// mesmo que o kernel original seja menor (e.g., 3x3 ou 2x2). Os elementos não utilizados
+// são preenchidos com zero para compatibilidade com a interface da FPGA que espera uma matriz 5x5.
+// **NOTA:** Os nomes dos kernels foram mantidos para possível compatibilidade externa ou convenção.
+// Estes kernels são registrados por `registrar_filtros_padrao` quando o arquivo de filtros não existe.
+
+// --- Kernel Sobel 3x3 --- 
+int8_t sobel_gx_3x3[MATRIX_SIZE] = {
+     0,  0,  0,  0,  0,   // linha 0 (padding)
+     0, -1,  0,  1,  0,   // linha 1 (kernel original)
+     0, -2,  0,  2,  0,   // linha 2 (kernel original)
+     0, -1,  0,  1,  0,   // linha 3 (kernel original)
+     0,  0,  0,  0,  0    // linha 4 (padding)
+};
+int8_t sobel_gy_3x3[MATRIX_SIZE] = {
+     0,  0,  0,  0,  0,   // linha 0 (padding)
+     0, -1, -2, -1,  0,   // linha 1 (kernel original)
+     0,  0,  0,  0,  0,   // linha 2 (kernel original)
+     0,  1,  2,  1,  0,   // linha 3 (kernel original)
+     0,  0,  0,  0,  0    // linha 4 (padding)
+};
+
+// --- Kernel Sobel 5x5 --- 
+int8_t sobel_gx_5x5[MATRIX_SIZE] = {
+     2,  2,  4,  2,  2,   // linha 0
+     1,  1,  2,  1,  1,   // linha 1
+     0,  0,  0,  0,  0,   // linha 2
+    -1, -1, -2, -1, -1,   // linha 3
+    -2, -2, -4, -2, -2    // linha 4
+};
+int8_t sobel_gy_5x5[MATRIX_SIZE] = {
+     2,  1,  0, -1, -2,   // linha 0
+     2,  1,  0, -1, -2,   // linha 1
+     4,  2,  0, -2, -4,   // linha 2
+     2,  1,  0, -1, -2,   // linha 3
+     2,  1,  0, -1, -2,   // linha 4
+};
+
+// --- Kernel Prewitt 3x3 --- 
+int8_t prewitt_gx_3x3[MATRIX_SIZE] = {
+     0,  0,  0,  0,  0,   // linha 0 (padding)
+     0, -1,  0,  1,  0,   // linha 1 (kernel original)
+     0, -1,  0,  1,  0,   // linha 2 (kernel original)
+     0, -1,  0,  1,  0,   // linha 3 (kernel original)
+     0,  0,  0,  0,  0    // linha 4 (padding)
+};
+int8_t prewitt_gy_3x3[MATRIX_SIZE] = {
+     0,  0,  0,  0,  0,   // linha 0 (padding)
+     0, -1, -1, -1,  0,   // linha 1 (kernel original)
+     0,  0,  0,  0,  0,   // linha 2 (kernel original)
+     0,  1,  1,  1,  0,   // linha 3 (kernel original)
+     0,  0,  0,  0,  0    // linha 4 (padding)
+};
+
+// --- Kernel Roberts 2x2 --- 
+int8_t roberts_gx_2x2[MATRIX_SIZE] = {
+     1,  0,  0,  0,  0,   // linha 0 (kernel original)
+     0, -1,  0,  0,  0,   // linha 1 (kernel original)
+     0,  0,  0,  0,  0,   // linha 2 (padding)
+     0,  0,  0,  0,  0,   // linha 3 (padding)
+     0,  0,  0,  0,  0    // linha 4 (padding)
+};
+int8_t roberts_gy_2x2[MATRIX_SIZE] = {
+     0,  1,  0,  0,  0,   // linha 0 (kernel original)
+    -1,  0,  0,  0,  0,   // linha 1 (kernel original)
+     0,  0,  0,  0,  0,   // linha 2 (padding)
+     0,  0,  0,  0,  0,   // linha 3 (padding)
+     0,  0,  0,  0,  0    // linha 4 (padding)
+};
+
+// --- Kernel Laplaciano 5x5 --- 
+int8_t laplace_5x5[MATRIX_SIZE] = {
+     0,  0, -1,  0,  0,   // linha 0
+     0, -1, -2, -1,  0,   // linha 1
+    -1, -2, 16, -2, -1,   // linha 2
+     0, -1, -2, -1,  0,   // linha 3
+     0,  0, -1,  0,  0    // linha 4
+};
+
+/**
+ * @brief Retorna o nome legível de um motor de convolução.
+ *
+ * @param motor O motor a ser descrito.
+ * @return String constante com o nome do motor.
+ */
+const char *nome_motor_kernel(tipo_motor_kernel motor) {
+    switch (motor) {
+        case MOTOR_ESPECIALIZADO: return "especializado";
+        case MOTOR_SEPARAVEL: return "separavel";
+        case MOTOR_SIMETRICO: return "simetrico-dobrado";
+        case MOTOR_ESPARSO:   return "taps-esparsos";
+        case MOTOR_GENERICO:  return "generico";
+    }
+    return "desconhecido";
+}
+
+/**
+ * @brief Indica se um motor pode ser usado com o kernel (o especializado exige a rotina embutida etc.).
+ *
+ * Usada para forçar cada motor aplicável no benchmark e no fuzzing (`kernel->motor` trocado numa cópia).
+ */
+int motor_aplicavel_kernel(const tipo_kernel_analisado *kernel, tipo_motor_kernel motor) {
+    switch (motor) {
+        case MOTOR_ESPECIALIZADO: return kernel->rotina_especializada != NULL;
+        case MOTOR_SEPARAVEL:     return kernel->separavel;
+        case MOTOR_SIMETRICO:     return kernel->simetria_horizontal != 0 || kernel->simetria_vertical != 0;
+        case MOTOR_ESPARSO:       return kernel->taps_nulos != 0;
+        case MOTOR_GENERICO:      return kernel->taps_nulos == 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Lê o coeficiente na posição (linha, coluna) do layout 5x5 do kernel.
+ */
+static int coeficiente_kernel(const tipo_kernel_analisado *kernel, int linha, int coluna) {
+    return kernel->coeficientes[linha * LADO_JANELA_MAX + coluna];
+}
+
+/**
+ * @brief Calcula o máximo divisor comum de dois inteiros não negativos.
+ */
+static int mdc_inteiro(int a, int b) {
+    while (b != 0) {
+        int resto = a % b;
+        a = b;
+        b = resto;
+    }
+    return a;
+}
+
+/**
+ * @brief Verifica se o kernel é de posto 1 com fatores inteiros e, se for, preenche os fatores.
+ *
+ * O fator horizontal é a primeira linha não nula dividida pelo MDC dos seus elementos (vetor primitivo),
+ * o que garante que o fator vertical também seja inteiro. A fatoração só é aceita se reproduzir
+ * exatamente todos os coeficientes, preservando o resultado bit a bit em relação à FPGA.
+ *
+ * @param kernel Kernel já com a área útil calculada.
+ * @return 1 se separável, 0 caso contrário.
+ */
+static int fatorar_kernel_separavel(tipo_kernel_analisado *kernel) {
+    int linha, coluna;
+    int linha_base = -1, coluna_pivo = -1;
+
+    memset(kernel->fator_vertical, 0, sizeof(kernel->fator_vertical));
+    memset(kernel->fator_horizontal, 0, sizeof(kernel->fator_horizontal));
+
+    // Localiza a primeira linha com algum coeficiente não nulo e o primeiro pivô dessa linha.
+    for (linha = kernel->linha_min; linha <= kernel->linha_max && linha_base < 0; linha++) {
+        for (coluna = kernel->coluna_min; coluna <= kernel->coluna_max; coluna++) {
+            if (coeficiente_kernel(kernel, linha, coluna) != 0) {
+                linha_base = linha;
+                coluna_pivo = coluna;
+                break;
+            }
+        }
+    }
+    if (linha_base < 0) return 0; // Kernel nulo: não há o que fatorar.
+
+    // Fator horizontal primitivo (MDC 1), com o pivô positivo.
+    int divisor = 0;
+    for (coluna = kernel->coluna_min; coluna <= kernel->coluna_max; coluna++) {
+        divisor = mdc_inteiro(divisor, abs(coeficiente_kernel(kernel, linha_base, coluna)));
+    }
+    if (coeficiente_kernel(kernel, linha_base, coluna_pivo) < 0) divisor = -divisor;
+    for (coluna = kernel->coluna_min; coluna <= kernel->coluna_max; coluna++) {
+        kernel->fator_horizontal[coluna] = (int8_t)(coeficiente_kernel(kernel, linha_base, coluna) / divisor);
+    }
+
+    // Fator vertical: cada linha deve ser um múltiplo inteiro do fator horizontal.
+    int pivo_horizontal = kernel->fator_horizontal[coluna_pivo];
+    for (linha = kernel->linha_min; linha <= kernel->linha_max; linha++) {
+        int valor_pivo = coeficiente_kernel(kernel, linha, coluna_pivo);
+        if (valor_pivo % pivo_horizontal != 0) return 0;
+        kernel->fator_vertical[linha] = (int8_t)(valor_pivo / pivo_horizontal);
+    }
+
+    // Confirma que o produto externo reproduz o kernel inteiro.
+    for (linha = kernel->linha_min; linha <= kernel->linha_max; linha++) {
+        for (coluna = kernel->coluna_min; coluna <= kernel->coluna_max; coluna++) {
+            if (kernel->fator_vertical[linha] * kernel->fator_horizontal[coluna] != coeficiente_kernel(kernel, linha, coluna)) {
+                memset(kernel->fator_vertical, 0, sizeof(kernel->fator_vertical));
+                memset(kernel->fator_horizontal, 0, sizeof(kernel->fator_horizontal));
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Classifica a simetria do kernel em relação a um eixo da área útil.
+ *
+ * @param kernel Kernel já com a área útil calculada.
+ * @param eixo_vertical 1 para espelho esquerda/direita, 0 para espelho cima/baixo.
+ * @return 1 se simétrico, -1 se antissimétrico, 0 se nenhum dos dois.
+ */
+static int classificar_simetria(const tipo_kernel_analisado *kernel, int eixo_vertical) {
+    int simetrico = 1, antissimetrico = 1;
+    int linha, coluna;
+    for (linha = kernel->linha_min; linha <= kernel->linha_max; linha++) {
+        for (coluna = kernel->coluna_min; coluna <= kernel->coluna_max; coluna++) {
+            int linha_espelho = eixo_vertical ? linha : kernel->linha_min + kernel->linha_max - linha;
+            int coluna_espelho = eixo_vertical ? kernel->coluna_min + kernel->coluna_max - coluna : coluna;
+            int valor = coeficiente_kernel(kernel, linha, coluna);
+            int valor_espelho = coeficiente_kernel(kernel, linha_espelho, coluna_espelho);
+            if (valor != valor_espelho) simetrico = 0;
+            if (valor != -valor_espelho) antissimetrico = 0;
+        }
+    }
+    if (simetrico) return 1;
+    if (antissimetrico) return -1;
+    return 0;
+}
+
+/**
+ * @brief Agrupa os taps não nulos em órbitas de espelhamento para o motor simétrico.
+ *
+ * Cada grupo reúne um tap e suas imagens pelos eixos de simetria detectados. Como os pesos
+ * espelhados diferem apenas no sinal, o grupo é avaliado com uma única multiplicação.
+ */
+static void agrupar_taps_simetricos(tipo_kernel_analisado *kernel) {
+    int atribuido[MATRIX_SIZE] = {0};
+    int linha, coluna;
+
+    kernel->total_grupos = 0;
+    for (linha = kernel->linha_min; linha <= kernel->linha_max; linha++) {
+        for (coluna = kernel->coluna_min; coluna <= kernel->coluna_max; coluna++) {
+            int indice = linha * LADO_JANELA_MAX + coluna;
+            int peso = kernel->coeficientes[indice];
+            if (peso == 0 || atribuido[indice]) continue;
+
+            tipo_grupo_simetrico *grupo = &kernel->grupos[kernel->total_grupos++];
+            grupo->peso = (int8_t)peso;
+            grupo->quantidade = 0;
+
+            // Percorre as 4 combinações de espelhamento, usando apenas os eixos simétricos.
+            int espelho;
+            for (espelho = 0; espelho < 4; espelho++) {
+                int usa_horizontal = espelho & 1, usa_vertical = espelho >> 1;
+                if (usa_horizontal && kernel->simetria_horizontal == 0) continue;
+                if (usa_vertical && kernel->simetria_vertical == 0) continue;
+
+                int linha_membro = usa_vertical ? kernel->linha_min + kernel->linha_max - linha : linha;
+                int coluna_membro = usa_horizontal ? kernel->coluna_min + kernel->coluna_max - coluna : coluna;
+                int indice_membro = linha_membro * LADO_JANELA_MAX + coluna_membro;
+                if (atribuido[indice_membro]) continue; // Tap sobre o próprio eixo: já incluído.
+
+                int sinal = (usa_horizontal ? kernel->simetria_horizontal : 1) * (usa_vertical ? kernel->simetria_vertical : 1);
+                grupo->desloc_y[grupo->quantidade] = (int8_t)(linha_membro - kernel->ancora_linha);
+                grupo->desloc_x[grupo->quantidade] = (int8_t)(coluna_membro - kernel->ancora_coluna);
+                grupo->sinal[grupo->quantidade] = (int8_t)sinal;
+                grupo->quantidade++;
+                atribuido[indice_membro] = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Analisa a estrutura de um kernel 5x5 e escolhe o motor de convolução mais barato.
+ *
+ * Detecta a área útil real (bounding box dos taps não nulos), os taps nulos dentro dela,
+ * a separabilidade de posto 1, a (anti)simetria em relação aos dois eixos e monta as listas
+ * de taps e grupos usadas pelos motores. O custo de cada motor é estimado em operações
+ * (multiplicações + somas) por pixel; em caso de empate, vence o primeiro na ordem
+ * separável, simétrico, esparso/genérico.
+ *
+ * Os campos `coeficientes`, `ancora_linha` e `ancora_coluna` devem estar preenchidos.
+ *
+ * @param kernel Kernel a ser analisado (atualizado in-place).
+ */
+void analisar_kernel(tipo_kernel_analisado *kernel) {
+    int linha, coluna;
+
+    // --- Área útil e contagem de taps ---
+    kernel->linha_min = kernel->coluna_min = LADO_JANELA_MAX;
+    kernel->linha_max = kernel->coluna_max = -1;
+    kernel->taps_nao_nulos = 0;
+    kernel->soma_coeficientes = 0;
+    for (linha = 0; linha < LADO_JANELA_MAX; linha++) {
+        for (coluna = 0; coluna < LADO_JANELA_MAX; coluna++) {
+            int valor = coeficiente_kernel(kernel, linha, coluna);
+            kernel->soma_coeficientes += valor;
+            if (valor == 0) continue;
+            kernel->taps_nao_nulos++;
+            if (linha < kernel->linha_min) kernel->linha_min = linha;
+            if (linha > kernel->linha_max) kernel->linha_max = linha;
+            if (coluna < kernel->coluna_min) kernel->coluna_min = coluna;
+            if (coluna > kernel->coluna_max) kernel->coluna_max = coluna;
+        }
+    }
+    // Kernel totalmente nulo: área útil degenerada sobre a âncora.
+    if (kernel->taps_nao_nulos == 0) {
+        kernel->linha_min = kernel->linha_max = kernel->ancora_linha;
+        kernel->coluna_min = kernel->coluna_max = kernel->ancora_coluna;
+    }
+    int area_util = (kernel->linha_max - kernel->linha_min + 1) * (kernel->coluna_max - kernel->coluna_min + 1);
+    kernel->taps_nulos = area_util - kernel->taps_nao_nulos;
+
+    // --- Estrutura ---
+    kernel->separavel = fatorar_kernel_separavel(kernel);
+    kernel->simetria_horizontal = kernel->taps_nao_nulos ? classificar_simetria(kernel, 1) : 0;
+    kernel->simetria_vertical = kernel->taps_nao_nulos ? classificar_simetria(kernel, 0) : 0;
+
+    // Lista de taps: somente os não nulos (motor esparso) ou toda a área útil (motor genérico).
+    kernel->total_taps = 0;
+    for (linha = kernel->linha_min; linha <= kernel->linha_max; linha++) {
+        for (coluna = kernel->coluna_min; coluna <= kernel->coluna_max; coluna++) {
+            int valor = coeficiente_kernel(kernel, linha, coluna);
+            if (valor == 0) continue;
+            tipo_tap_kernel *tap = &kernel->taps[kernel->total_taps++];
+            tap->desloc_y = (int8_t)(linha - kernel->ancora_linha);
+            tap->desloc_x = (int8_t)(coluna - kernel->ancora_coluna);
+            tap->peso = (int8_t)valor;
+        }
+    }
+    agrupar_taps_simetricos(kernel);
+
+    // --- Escolha do motor por custo estimado ---
+    int custo_separavel = INT_MAX, custo_simetrico = INT_MAX;
+    int custo_taps = 2 * (kernel->taps_nulos ? kernel->taps_nao_nulos : area_util);
+    if (kernel->separavel) {
+        int fatores_nao_nulos = 0;
+        for (linha = 0; linha < LADO_JANELA_MAX; linha++) {
+            if (kernel->fator_vertical[linha] != 0) fatores_nao_nulos++;
+            if (kernel->fator_horizontal[linha] != 0) fatores_nao_nulos++;
+        }
+        custo_separavel = 2 * fatores_nao_nulos + 2; // +2: escrita e leitura do buffer intermediário.
+    }
+    if (kernel->simetria_horizontal != 0 || kernel->simetria_vertical != 0) {
+        custo_simetrico = kernel->taps_nao_nulos + kernel->total_grupos;
+    }
+
+    kernel->motor = kernel->taps_nulos ? MOTOR_ESPARSO : MOTOR_GENERICO;
+    int menor_custo = custo_taps;
+    if (custo_simetrico <= menor_custo) { kernel->motor = MOTOR_SIMETRICO; menor_custo = custo_simetrico; }
+    if (custo_separavel <= menor_custo) { kernel->motor = MOTOR_SEPARAVEL; menor_custo = custo_separavel; }
+}
+
+/**
+ * @brief Converte um kernel quadrado (2x2, 3x3 ou 5x5) para o layout 5x5 da FPGA e o analisa.
+ *
+ * Segue o mesmo posicionamento de `extrair_janela_vizinhanca_linear`: 2x2 no canto superior
+ * esquerdo (âncora no próprio canto), 3x3 centralizado e 5x5 ocupando toda a matriz.
+ *
+ * @param destino Kernel de destino.
+ * @param valores Coeficientes em ordem de linha, `tamanho` x `tamanho` elementos.
+ * @param tamanho Lado do kernel (2, 3 ou 5).
+ */
+static void montar_kernel(tipo_kernel_analisado *destino, const int *valores, int tamanho) {
+    int deslocamento = (tamanho == 2) ? 0 : (LADO_JANELA_MAX - tamanho) / 2;
+    int linha, coluna;
+
+    memset(destino, 0, sizeof(*destino));
+    for (linha = 0; linha < tamanho; linha++) {
+        for (coluna = 0; coluna < tamanho; coluna++) {
+            destino->coeficientes[(linha + deslocamento) * LADO_JANELA_MAX + coluna + deslocamento] = (int8_t)valores[linha * tamanho + coluna];
+        }
+    }
+    destino->ancora_linha = destino->ancora_coluna = (tamanho == 2) ? 0 : 2;
+    analisar_kernel(destino);
+}
+
+/**
+ * @brief Converte o lado do kernel no código de tamanho usado na extração da janela.
+ */
+static uint32_t codigo_tamanho_para_lado(int tamanho) {
+    switch (tamanho) {
+        case 2: return 0;
+        case 3: return 1;
+        default: return 3;
+    }
+}
+
+/**
+ * @brief Associa rotinas especializadas ao filtro, se ele for um dos embutidos.
+ *
+ * A entrada da tabela de despacho é escolhida pelo nome do filtro, e só é usada se os
+ * coeficientes forem exatamente os do kernel embutido (um filtro do arquivo com o mesmo
+ * nome e outros coeficientes continua no motor escolhido pela análise).
+ *
+ * @param filtro Filtro já analisado.
+ */
+static void associar_rotinas_especializadas(tipo_filtro_borda *filtro) {
+    size_t indice;
+    for (indice = 0; indice < sizeof(tabela_rotinas_especializadas) / sizeof(tabela_rotinas_especializadas[0]); indice++) {
+        const tipo_entrada_especializada *entrada = &tabela_rotinas_especializadas[indice];
+        if (strcmp(entrada->nome, filtro->nome) != 0) continue;
+        if (memcmp(entrada->kernel_gx, filtro->kernel_gx.coeficientes, MATRIX_SIZE) != 0) return;
+        if ((entrada->kernel_gy != NULL) != (filtro->possui_gy != 0)) return;
+        if (entrada->kernel_gy != NULL && memcmp(entrada->kernel_gy, filtro->kernel_gy.coeficientes, MATRIX_SIZE) != 0) return;
+
+        filtro->kernel_gx.rotina_especializada = entrada->rotina_gx;
+        filtro->kernel_gx.motor = MOTOR_ESPECIALIZADO;
+        if (entrada->kernel_gy != NULL) {
+            filtro->kernel_gy.rotina_especializada = entrada->rotina_gy;
+            filtro->kernel_gy.motor = MOTOR_ESPECIALIZADO;
+        }
+        return;
+    }
+}
+
+/**
+ * @brief Registra um filtro a partir de kernels já no layout 5x5 (usado para os filtros embutidos).
+ */
+static void registrar_filtro_5x5(const char *nome, int tamanho, const int8_t *kernel_gx, const int8_t *kernel_gy) {
+    tipo_filtro_borda *filtro = &filtros_registrados[total_filtros_registrados++];
+    memset(filtro, 0, sizeof(*filtro));
+    strncpy(filtro->nome, nome, sizeof(filtro->nome) - 1);
+    filtro->tamanho = tamanho;
+    filtro->codigo_tamanho = codigo_tamanho_para_lado(tamanho);
+
+    memcpy(filtro->kernel_gx.coeficientes, kernel_gx, MATRIX_SIZE);
+    filtro->kernel_gx.ancora_linha = filtro->kernel_gx.ancora_coluna = (tamanho == 2) ? 0 : 2;
+    analisar_kernel(&filtro->kernel_gx);
+
+    filtro->possui_gy = (kernel_gy != NULL);
+    if (kernel_gy != NULL) {
+        memcpy(filtro->kernel_gy.coeficientes, kernel_gy, MATRIX_SIZE);
+        filtro->kernel_gy.ancora_linha = filtro->kernel_gy.ancora_coluna = filtro->kernel_gx.ancora_linha;
+        analisar_kernel(&filtro->kernel_gy);
+    }
+    associar_rotinas_especializadas(filtro);
+}
+
+/**
+ * @brief Preenche o registro com os cinco filtros embutidos (declarados em hps_0.h).
+ *
+ * Usado quando o arquivo de filtros não existe, mantendo o comportamento original do menu.
+ */
+void registrar_filtros_padrao(void) {
+    total_filtros_registrados = 0;
+    registrar_filtro_5x5("sobel_3x3", 3, sobel_gx_3x3, sobel_gy_3x3);
+    registrar_filtro_5x5("sobel_5x5", 5, sobel_gx_5x5, sobel_gy_5x5);
+    registrar_filtro_5x5("prewitt_3x3", 3, prewitt_gx_3x3, prewitt_gy_3x3);
+    registrar_filtro_5x5("roberts_2x2", 2, roberts_gx_2x2, roberts_gy_2x2);
+    registrar_filtro_5x5("laplace_5x5", 5, laplace_5x5, NULL);
+}
+
+/**
+ * @brief Lê o próximo token do arquivo de filtros, ignorando espaços e comentários ('#' até o fim da linha).
+ *
+ * @param arquivo Arquivo aberto para leitura.
+ * @param token Buffer de destino.
+ * @param tamanho_token Tamanho do buffer de destino.
+ * @param linha_atual Contador de linhas (atualizado) para mensagens de erro.
+ * @return 1 se um token foi lido, 0 no fim do arquivo.
+ */
+static int ler_token_filtros(FILE *arquivo, char *token, size_t tamanho_token, int *linha_atual) {
+    int caractere;
+    size_t comprimento = 0;
+
+    // Pula espaços em branco e comentários.
+    while ((caractere = fgetc(arquivo)) != EOF) {
+        if (caractere == '#') {
+            while ((caractere = fgetc(arquivo)) != EOF && caractere != '\n');
+        }
+        if (caractere == '\n') (*linha_atual)++;
+        if (caractere == EOF) return 0;
+        if (caractere != ' ' && caractere != '\t' && caractere != '\r' && caractere != '\n') break;
+    }
+    if (caractere == EOF) return 0;
+
+    // Acumula os caracteres do token.
+    do {
+        if (comprimento + 1 < tamanho_token) token[comprimento++] = (char)caractere;
+        caractere = fgetc(arquivo);
+    } while (caractere != EOF && caractere != ' ' && caractere != '\t' && caractere != '\r' && caractere != '\n' && caractere != '#');
+    if (caractere != EOF) ungetc(caractere, arquivo);
+    token[comprimento] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Lê `quantidade` coeficientes inteiros do arquivo de filtros, validando a faixa de int8_t.
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro (mensagem já impressa).
+ */
+static int ler_coeficientes_filtro(FILE *arquivo, int *valores, int quantidade, int *linha_atual, const char *caminho_arquivo) {
+    char token[64];
+    int indice;
+    for (indice = 0; indice < quantidade; indice++) {
+        char *fim_numero;
+        if (!ler_token_filtros(arquivo, token, sizeof(token), linha_atual)) {
+            fprintf(stderr, "%s:%d: fim de arquivo inesperado (esperados %d coeficientes)\n", caminho_arquivo, *linha_atual, quantidade);
+            return -1;
+        }
+        long valor = strtol(token, &fim_numero, 10);
+        if (*fim_numero != '\0' || valor < -128 || valor > 127) {
+            fprintf(stderr, "%s:%d: coeficiente inválido '%s' (inteiro entre -128 e 127)\n", caminho_arquivo, *linha_atual, token);
+            return -1;
+        }
+        valores[indice] = (int)valor;
+    }
+    return 0;
+}
+
+/**
+ * @brief Carrega o registro de filtros a partir de um arquivo texto.
+ *
+ * Formato (tokens separados por espaço; '#' inicia comentário):
+ *
+ *     filtro <nome> <tamanho>     # tamanho: 2, 3 ou 5
+ *     gx                          # seguido de tamanho x tamanho coeficientes
+ *     <coeficientes>
+ *     gy                          # opcional; sem ele o filtro usa |Gx| (como o Laplace)
+ *     <coeficientes>
+ *
+ * Cada kernel é convertido para o layout 5x5 da FPGA e analisado (área útil, taps nulos,
+ * separabilidade e simetria) para escolher o motor de CPU mais barato.
+ * Em caso de erro, o registro anterior é preservado.
+ *
+ * @param caminho_arquivo Caminho do arquivo de filtros.
+ * @return Quantidade de filtros carregados, ou -1 se o arquivo não puder ser lido ou for inválido.
+ */
+int carregar_registro_filtros(const char *caminho_arquivo) {
+    static tipo_filtro_borda filtros_lidos[MAX_FILTROS_REGISTRADOS];
+    int possui_gx[MAX_FILTROS_REGISTRADOS] = {0};
+    int total_lidos = 0;
+    int linha_atual = 1;
+    int valores[MATRIX_SIZE];
+    char token[64];
+    tipo_filtro_borda *filtro_atual = NULL;
+
+    FILE *arquivo = fopen(caminho_arquivo, "r");
+    if (arquivo == NULL) return -1;
+
+    while (ler_token_filtros(arquivo, token, sizeof(token), &linha_atual)) {
+        if (strcmp(token, "filtro") == 0) {
+            // Início de um novo filtro: nome e tamanho.
+            char token_tamanho[16];
+            if (total_lidos == MAX_FILTROS_REGISTRADOS) {
+                fprintf(stderr, "%s:%d: limite de %d filtros excedido\n", caminho_arquivo, linha_atual, MAX_FILTROS_REGISTRADOS);
+                goto erro;
+            }
+            filtro_atual = &filtros_lidos[total_lidos++];
+            memset(filtro_atual, 0, sizeof(*filtro_atual));
+            if (!ler_token_filtros(arquivo, filtro_atual->nome, sizeof(filtro_atual->nome), &linha_atual) ||
+                !ler_token_filtros(arquivo, token_tamanho, sizeof(token_tamanho), &linha_atual)) {
+                fprintf(stderr, "%s:%d: esperado 'filtro <nome> <tamanho>'\n", caminho_arquivo, linha_atual);
+                goto erro;
+            }
+            filtro_atual->tamanho = atoi(token_tamanho);
+            if (filtro_atual->tamanho != 2 && filtro_atual->tamanho != 3 && filtro_atual->tamanho != 5) {
+                fprintf(stderr, "%s:%d: tamanho '%s' não suportado (use 2, 3 ou 5)\n", caminho_arquivo, linha_atual, token_tamanho);
+                goto erro;
+            }
+            filtro_atual->codigo_tamanho = codigo_tamanho_para_lado(filtro_atual->tamanho);
+        } else if (strcmp(token, "gx") == 0 || strcmp(token, "gy") == 0) {
+            // Bloco de coeficientes do filtro atual.
+            if (filtro_atual == NULL) {
+                fprintf(stderr, "%s:%d: '%s' fora de um bloco 'filtro'\n", caminho_arquivo, linha_atual, token);
+                goto erro;
+            }
+            int quantidade = filtro_atual->tamanho * filtro_atual->tamanho;
+            if (ler_coeficientes_filtro(arquivo, valores, quantidade, &linha_atual, caminho_arquivo) != 0) goto erro;
+            if (token[1] == 'x') {
+                montar_kernel(&filtro_atual->kernel_gx, valores, filtro_atual->tamanho);
+                possui_gx[total_lidos - 1] = 1;
+            } else {
+                montar_kernel(&filtro_atual->kernel_gy, valores, filtro_atual->tamanho);
+                filtro_atual->possui_gy = 1;
+            }
+        } else {
+            fprintf(stderr, "%s:%d: token inesperado '%s'\n", caminho_arquivo, linha_atual, token);
+            goto erro;
+        }
+    }
+    fclose(arquivo);
+
+    if (total_lidos == 0) {
+        fprintf(stderr, "%s: nenhum filtro definido\n", caminho_arquivo);
+        return -1;
+    }
+
+    // Todo filtro precisa de um kernel Gx; os idênticos aos embutidos usam as rotinas desenroladas.
+    int indice_filtro;
+    for (indice_filtro = 0; indice_filtro < total_lidos; indice_filtro++) {
+        if (!possui_gx[indice_filtro]) {
+            fprintf(stderr, "%s: filtro '%s' sem bloco 'gx'\n", caminho_arquivo, filtros_lidos[indice_filtro].nome);
+            return -1;
+        }
+        associar_rotinas_especializadas(&filtros_lidos[indice_filtro]);
+    }
+
+    // Publica o novo registro somente depois de validar o arquivo inteiro.
+    memcpy(filtros_registrados, filtros_lidos, (size_t)total_lidos * sizeof(tipo_filtro_borda));
+    total_filtros_registrados = total_lidos;
+    return total_lidos;
+
+erro:
+    fclose(arquivo);
+    return -1;
+}
+
+/**
+ * @brief Imprime a análise estrutural de um kernel em uma linha.
+ */
+static void imprimir_analise_kernel(const char *rotulo, const tipo_kernel_analisado *kernel) {
+    static const char *nomes_simetria[] = { "anti", "nao", "sim" };
+    printf("    %s: area util %dx%d, %d taps nao nulos, %d nulos, separavel: %s, simetria H/V: %s/%s -> motor %s\n",
+           rotulo,
+           kernel->linha_max - kernel->linha_min + 1, kernel->coluna_max - kernel->coluna_min + 1,
+           kernel->taps_nao_nulos, kernel->taps_nulos,
+           kernel->separavel ? "sim" : "nao",
+           nomes_simetria[kernel->simetria_horizontal + 1], nomes_simetria[kernel->simetria_vertical + 1],
+           nome_motor_kernel(kernel->motor));
+}
+
+/**
+ * @brief Imprime a análise de todos os filtros registrados.
+ */
+void imprimir_analise_filtros(void) {
+    int indice;
+    for (indice = 0; indice < total_filtros_registrados; indice++) {
+        const tipo_filtro_borda *filtro = &filtros_registrados[indice];
+        printf("  %s (%dx%d)\n", filtro->nome, filtro->tamanho, filtro->tamanho);
+        imprimir_analise_kernel("Gx", &filtro->kernel_gx);
+        if (filtro->possui_gy) imprimir_analise_kernel("Gy", &filtro->kernel_gy);
+    }
+}
+
+/* ====================================================== */
+/* ============= MOTORES DE CONVOLUÇÃO (CPU) ============ */
+/* ====================================================== */
+
+// Colunas por faixa do motor separável (anel de LADO_JANELA_MAX linhas de int32 na pilha).
+#define COLUNAS_FAIXA_SEPARAVEL 256
+
+/**
+ * @brief Lê um pixel do plano, retornando 0 fora dos limites (mesmo padding da extração de janela).
+ */
+static inline int pixel_ou_zero(const uint8_t *plano, int largura, int altura, int x, int y) {
+    if (x < 0 || x >= largura || y < 0 || y >= altura) return 0;
+    return plano[y * largura + x];
+}
+
+/**
+ * @brief Motor esparso/genérico: percorre a lista de taps do kernel.
+ *
+ * A lista contém apenas os taps não nulos; para kernels sem zeros na área útil (motor genérico)
+ * ela cobre a área inteira, então os dois motores compartilham esta rotina. Pixels cujo suporte
+ * inteiro está dentro da imagem usam acesso direto; os da borda usam padding zero.
+ * Com `semantica_fpga` nulo (modo bruto), a soma é só limitada a 16 bits (`saturar_resposta_bruta`).
+ */
+static void convolver_taps(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                           int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *saida, int semantica_fpga) {
+    int desloc_y_min = kernel->linha_min - kernel->ancora_linha, desloc_y_max = kernel->linha_max - kernel->ancora_linha;
+    int desloc_x_min = kernel->coluna_min - kernel->ancora_coluna, desloc_x_max = kernel->coluna_max - kernel->ancora_coluna;
+    int coord_y, coord_x, indice_tap;
+
+    for (coord_y = y_inicio; coord_y < y_fim; coord_y++) {
+        int linha_interna = (coord_y + desloc_y_min >= 0) && (coord_y + desloc_y_max < altura);
+        for (coord_x = x_inicio; coord_x < x_fim; coord_x++) {
+            int32_t soma = 0;
+            if (linha_interna && coord_x + desloc_x_min >= 0 && coord_x + desloc_x_max < largura) {
+                const uint8_t *centro = plano + coord_y * largura + coord_x;
+                for (indice_tap = 0; indice_tap < kernel->total_taps; indice_tap++) {
+                    const tipo_tap_kernel *tap = &kernel->taps[indice_tap];
+                    soma += tap->peso * centro[tap->desloc_y * largura + tap->desloc_x];
+                }
+            } else {
+                for (indice_tap = 0; indice_tap < kernel->total_taps; indice_tap++) {
+                    const tipo_tap_kernel *tap = &kernel->taps[indice_tap];
+                    soma += tap->peso * pixel_ou_zero(plano, largura, altura, coord_x + tap->desloc_x, coord_y + tap->desloc_y);
+                }
+            }
+            saida[coord_y * largura + coord_x] = semantica_fpga ? aplicar_semantica_fpga(soma) : saturar_resposta_bruta(soma);
+        }
+    }
+}
+
+/**
+ * @brief Motor simétrico: soma os pixels espelhados de cada grupo antes de multiplicar pelo peso.
+ */
+static void convolver_simetrico(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                                int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *saida) {
+    int desloc_y_min = kernel->linha_min - kernel->ancora_linha, desloc_y_max = kernel->linha_max - kernel->ancora_linha;
+    int desloc_x_min = kernel->coluna_min - kernel->ancora_coluna, desloc_x_max = kernel->coluna_max - kernel->ancora_coluna;
+    int coord_y, coord_x, indice_grupo, membro;
+
+    for (coord_y = y_inicio; coord_y < y_fim; coord_y++) {
+        int linha_interna = (coord_y + desloc_y_min >= 0) && (coord_y + desloc_y_max < altura);
+        for (coord_x = x_inicio; coord_x < x_fim; coord_x++) {
+            int32_t soma = 0;
+            int interno = linha_interna && coord_x + desloc_x_min >= 0 && coord_x + desloc_x_max < largura;
+            const uint8_t *centro = plano + coord_y * largura + coord_x;
+            for (indice_grupo = 0; indice_grupo < kernel->total_grupos; indice_grupo++) {
+                const tipo_grupo_simetrico *grupo = &kernel->grupos[indice_grupo];
+                int32_t soma_dobrada = 0;
+                for (membro = 0; membro < grupo->quantidade; membro++) {
+                    int valor = interno ? centro[grupo->desloc_y[membro] * largura + grupo->desloc_x[membro]]
+                                        : pixel_ou_zero(plano, largura, altura, coord_x + grupo->desloc_x[membro], coord_y + grupo->desloc_y[membro]);
+                    soma_dobrada += (grupo->sinal[membro] > 0) ? valor : -valor;
+                }
+                soma += grupo->peso * soma_dobrada;
+            }
+            saida[coord_y * largura + coord_x] = aplicar_semantica_fpga(soma);
+        }
+    }
+}
+
+/**
+ * @brief Motor separável: passada horizontal com o fator horizontal seguida de passada vertical.
+ *
+ * A região é percorrida em faixas de até `COLUNAS_FAIXA_SEPARAVEL` colunas. As linhas da passada
+ * horizontal ficam num anel de `LADO_JANELA_MAX` linhas na pilha: assim que a altura do kernel está
+ * preenchida, a passada vertical produz a linha de saída correspondente. Linhas fora da imagem valem
+ * zero, o que equivale ao padding zero da convolução 2D direta.
+ */
+static void convolver_separavel(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                                int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *saida) {
+    int32_t anel[LADO_JANELA_MAX][COLUNAS_FAIXA_SEPARAVEL];
+    int colunas_h[LADO_JANELA_MAX], pesos_h[LADO_JANELA_MAX], total_h = 0;
+    int linhas_v[LADO_JANELA_MAX], pesos_v[LADO_JANELA_MAX], total_v = 0;
+    int indice, coord_x, faixa_x;
+
+    // Somente os fatores não nulos, já convertidos em deslocamentos relativos à âncora.
+    // Os deslocamentos verticais são contados a partir da primeira linha da área útil.
+    for (indice = 0; indice < LADO_JANELA_MAX; indice++) {
+        if (kernel->fator_horizontal[indice] != 0) {
+            colunas_h[total_h] = indice - kernel->ancora_coluna;
+            pesos_h[total_h++] = kernel->fator_horizontal[indice];
+        }
+        if (kernel->fator_vertical[indice] != 0) {
+            linhas_v[total_v] = indice - kernel->linha_min;
+            pesos_v[total_v++] = kernel->fator_vertical[indice];
+        }
+    }
+
+    int altura_kernel = kernel->linha_max - kernel->linha_min + 1;
+    int primeira_linha = y_inicio + (kernel->linha_min - kernel->ancora_linha);
+    int total_linhas = (y_fim - y_inicio) + (altura_kernel - 1);
+    if (y_fim <= y_inicio || x_fim <= x_inicio) return;
+
+    for (faixa_x = x_inicio; faixa_x < x_fim; faixa_x += COLUNAS_FAIXA_SEPARAVEL) {
+        int fim_faixa = (faixa_x + COLUNAS_FAIXA_SEPARAVEL < x_fim) ? faixa_x + COLUNAS_FAIXA_SEPARAVEL : x_fim;
+        int total_colunas = fim_faixa - faixa_x;
+
+        for (indice = 0; indice < total_linhas; indice++) {
+            // --- Passada horizontal de uma linha para o anel ---
+            int linha_imagem = primeira_linha + indice;
+            int32_t *destino = anel[indice % altura_kernel];
+            if (linha_imagem < 0 || linha_imagem >= altura) {
+                memset(destino, 0, (size_t)total_colunas * sizeof(int32_t));
+            } else {
+                const uint8_t *linha_plano = plano + linha_imagem * largura;
+                for (coord_x = faixa_x; coord_x < fim_faixa; coord_x++) {
+                    int32_t soma = 0;
+                    int termo;
+                    for (termo = 0; termo < total_h; termo++) {
+                        int coluna = coord_x + colunas_h[termo];
+                        if (coluna >= 0 && coluna < largura) soma += pesos_h[termo] * linha_plano[coluna];
+                    }
+                    destino[coord_x - faixa_x] = soma;
+                }
+            }
+
+            // --- Passada vertical, quando as linhas da altura do kernel estão no anel ---
+            int primeira_anel = indice - (altura_kernel - 1);
+            if (primeira_anel < 0) continue;
+            tipo_resultado_conv *linha_saida = saida + (y_inicio + primeira_anel) * largura;
+            for (coord_x = faixa_x; coord_x < fim_faixa; coord_x++) {
+                int32_t soma = 0;
+                int termo;
+                for (termo = 0; termo < total_v; termo++) {
+                    soma += pesos_v[termo] * anel[(primeira_anel + linhas_v[termo]) % altura_kernel][coord_x - faixa_x];
+                }
+                linha_saida[coord_x] = aplicar_semantica_fpga(soma);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Convolui uma região retangular de um plano em escala de cinza usando o motor escolhido na análise.
+ *
+ * O resultado é idêntico ao obtido enviando cada janela à FPGA (ver `aplicar_semantica_fpga`).
+ *
+ * @param kernel Kernel analisado.
+ * @param plano Plano de pixels (largura x altura, sem padding entre linhas).
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param x_inicio Primeira coluna da região (inclusive).
+ * @param y_inicio Primeira linha da região (inclusive).
+ * @param x_fim Última coluna da região (exclusive).
+ * @param y_fim Última linha da região (exclusive).
+ * @param saida Buffer de saída com o mesmo layout do plano (largura x altura).
+ */
+void convolver_regiao_cpu(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                          int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *saida) {
+    switch (kernel->motor) {
+        case MOTOR_ESPECIALIZADO:
+            kernel->rotina_especializada(plano, largura, altura, x_inicio, y_inicio, x_fim, y_fim, saida);
+            break;
+        case MOTOR_SEPARAVEL:
+            convolver_separavel(kernel, plano, largura, altura, x_inicio, y_inicio, x_fim, y_fim, saida);
+            break;
+        case MOTOR_SIMETRICO:
+            convolver_simetrico(kernel, plano, largura, altura, x_inicio, y_inicio, x_fim, y_fim, saida);
+            break;
+        case MOTOR_ESPARSO:
+        case MOTOR_GENERICO:
+            convolver_taps(kernel, plano, largura, altura, x_inicio, y_inicio, x_fim, y_fim, saida, 1);
+            break;
+    }
+}
+
+/**
+ * @brief Convolui uma região como `convolver_regiao_cpu`, mas sem a semântica da FPGA (modo bruto).
+ *
+ * A soma é acumulada em 32 bits e só limitada a ±32767, em vez do acumulador de 16 bits e do 255
+ * de `convolution.v`. Usa a lista de taps (preenchida para qualquer kernel), pois o modo bruto só
+ * é usado fora do laço principal, na exportação. Os parâmetros são os de `convolver_regiao_cpu`.
+ */
+void convolver_regiao_cpu_bruto(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                                int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *saida) {
+    convolver_taps(kernel, plano, largura, altura, x_inicio, y_inicio, x_fim, y_fim, saida, 0);
+}
+
+/**
+ * @brief Maior |resposta| possível do kernel sobre pixels de 8 bits: soma dos |pesos| * 255.
+ *
+ * Acima de 32767, o modo bruto (`convolver_regiao_cpu_bruto`) limita algumas respostas.
+ */
+int32_t maior_resposta_bruta(const tipo_kernel_analisado *kernel) {
+    int32_t soma_pesos = 0;
+    int indice_tap;
+    for (indice_tap = 0; indice_tap < kernel->total_taps; indice_tap++) soma_pesos += abs(kernel->taps[indice_tap].peso);
+    return soma_pesos * 255;
+}
+
+/* ====================================================== */
+/* ========== PRÉ-PASSADA DE REGIÕES PLANAS ============= */
+/* ====================================================== */
+
+/**
+ * @brief Classifica os blocos LADO_BLOCO_PLANO x LADO_BLOCO_PLANO de um plano em planos ou ativos.
+ *
+ * Para cada bloco, calcula o mínimo e o máximo dos pixels do bloco mais um halo de
+ * HALO_BLOCO_PLANO pixels (o suporte de qualquer kernel 5x5). Se o halo sair da imagem, o
+ * padding zero entra na conta, como na extração de janela. Um bloco é plano quando
+ * (máximo - mínimo) <= limiar; com limiar 0, todas as janelas do bloco são idênticas e a
+ * resposta de qualquer kernel é a mesma em todo o bloco.
+ *
+ * @param plano Plano de pixels (largura x altura).
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param limiar Maior amplitude (máximo - mínimo) considerada plana.
+ * @param bloco_ativo Saída: 1 para blocos que precisam de convolução, 0 para blocos planos
+ *                    (ceil(largura / LADO_BLOCO_PLANO) x ceil(altura / LADO_BLOCO_PLANO) entradas).
+ * @param valor_bloco Saída: menor pixel de cada bloco (valor usado para preencher blocos planos).
+ * @return Quantidade de blocos planos.
+ */
+int classificar_blocos_planos(const uint8_t *plano, int largura, int altura, int limiar,
+                              uint8_t *bloco_ativo, uint8_t *valor_bloco) {
+    int blocos_x = (largura + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO;
+    int blocos_y = (altura + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO;
+    int bloco_x, bloco_y, coord_x, coord_y, total_planos = 0;
+
+    for (bloco_y = 0; bloco_y < blocos_y; bloco_y++) {
+        for (bloco_x = 0; bloco_x < blocos_x; bloco_x++) {
+            int x_inicio = bloco_x * LADO_BLOCO_PLANO - HALO_BLOCO_PLANO;
+            int y_inicio = bloco_y * LADO_BLOCO_PLANO - HALO_BLOCO_PLANO;
+            int x_fim = (bloco_x + 1) * LADO_BLOCO_PLANO + HALO_BLOCO_PLANO;
+            int y_fim = (bloco_y + 1) * LADO_BLOCO_PLANO + HALO_BLOCO_PLANO;
+            int minimo = 255, maximo = 0;
+
+            // O halo fora da imagem é padding zero.
+            if (x_inicio < 0 || y_inicio < 0 || x_fim > largura || y_fim > altura) minimo = 0;
+            if (x_inicio < 0) x_inicio = 0;
+            if (y_inicio < 0) y_inicio = 0;
+            if (x_fim > largura) x_fim = largura;
+            if (y_fim > altura) y_fim = altura;
+
+            for (coord_y = y_inicio; coord_y < y_fim && maximo - minimo <= limiar; coord_y++) {
+                const uint8_t *linha = plano + coord_y * largura;
+                for (coord_x = x_inicio; coord_x < x_fim; coord_x++) {
+                    if (linha[coord_x] < minimo) minimo = linha[coord_x];
+                    if (linha[coord_x] > maximo) maximo = linha[coord_x];
+                }
+            }
+
+            int indice_bloco = bloco_y * blocos_x + bloco_x;
+            bloco_ativo[indice_bloco] = (maximo - minimo > limiar);
+            valor_bloco[indice_bloco] = (uint8_t)minimo;
+            if (!bloco_ativo[indice_bloco]) total_planos++;
+        }
+    }
+    return total_planos;
+}
@@ -0,0 +1,140 @@
+#ifndef FILTROS_H
+#define FILTROS_H
+#include <stdint.h>
+#include "hps_0.h"
+
+/* Constantes do Registro de Filtros */
+#define LADO_JANELA_MAX        5    // Lado da janela 5x5 usada pela FPGA.
+#define MAX_FILTROS_REGISTRADOS 32  // Quantidade máxima de filtros carregados do arquivo.
+#define TAMANHO_NOME_FILTRO    32   // Tamanho máximo do nome de um filtro (incluindo '\0').
+#define ARQUIVO_FILTROS_PADRAO "filtros.cfg"
+
+/* Tipos de Pixel e Resultado */
+
+// Tipo dos pixels da imagem de entrada (0-255). Usado para a janela de pixels extraída da imagem.
+typedef uint8_t tipo_pixel_imagem;
+// Tipo dos resultados de convolução (com sinal, pode exceder 255).
+typedef int16_t tipo_resultado_conv;
+
+/* Motores de Convolução em CPU */
+typedef enum {
+    MOTOR_ESPECIALIZADO = 0, // Rotina desenrolada gerada em tempo de compilação (filtros_especializados.h).
+    MOTOR_SEPARAVEL,      // Kernel de posto 1: passada horizontal seguida de vertical.
+    MOTOR_SIMETRICO,      // Kernel (anti)simétrico: pixels espelhados somados antes da multiplicação.
+    MOTOR_ESPARSO,        // Apenas os taps não nulos da área útil.
+    MOTOR_GENERICO        // Todos os taps da área útil.
+} tipo_motor_kernel;
+
+// Um tap do kernel: deslocamento relativo ao pixel de saída e peso.
+typedef struct {
+    int8_t desloc_y;
+    int8_t desloc_x;
+    int8_t peso;
+} tipo_tap_kernel;
+
+// Grupo de taps espelhados que compartilham o mesmo |peso| (motor simétrico).
+// O resultado do grupo é peso * (soma de sinal[i] * pixel[i]).
+typedef struct {
+    int8_t peso;
+    uint8_t quantidade;
+    int8_t desloc_y[4];
+    int8_t desloc_x[4];
+    int8_t sinal[4];
+} tipo_grupo_simetrico;
+
+// Rotina de convolução de uma região retangular (mesma assinatura de `convolver_regiao_cpu`, sem o kernel).
+typedef void (*tipo_rotina_convolucao)(const uint8_t *plano, int largura, int altura,
+                                       int x_inicio, int y_inicio, int x_fim, int y_fim, int16_t *saida);
+
+// Kernel 5x5 com o resultado da análise estrutural feita no carregamento.
+typedef struct {
+    int8_t coeficientes[MATRIX_SIZE];   // Layout 5x5 com padding (formato esperado pela FPGA).
+    int ancora_linha, ancora_coluna;    // Posição do 5x5 que corresponde ao pixel de saída.
+    int linha_min, linha_max;           // Área útil real (bounding box dos taps não nulos).
+    int coluna_min, coluna_max;
+    int taps_nao_nulos;
+    int taps_nulos;                     // Zeros dentro da área útil.
+    int soma_coeficientes;
+    int separavel;                      // 1 se o kernel for de posto 1 com fatores inteiros.
+    int8_t fator_vertical[LADO_JANELA_MAX];   // Kernel = fator_vertical * fator_horizontal^T.
+    int8_t fator_horizontal[LADO_JANELA_MAX];
+    int simetria_horizontal;            // Espelho esquerda/direita: 1 simétrico, -1 antissimétrico, 0 nenhum.
+    int simetria_vertical;              // Espelho cima/baixo: 1 simétrico, -1 antissimétrico, 0 nenhum.
+    int total_taps;                     // Taps usados pelos motores esparso/genérico.
+    tipo_tap_kernel taps[MATRIX_SIZE];
+    int total_grupos;                   // Grupos usados pelo motor simétrico.
+    tipo_grupo_simetrico grupos[MATRIX_SIZE];
+    tipo_rotina_convolucao rotina_especializada; // Rotina desenrolada, se o kernel for um dos embutidos.
+    tipo_motor_kernel motor;            // Motor mais barato escolhido pela análise.
+} tipo_kernel_analisado;
+
+// Filtro de borda registrado: um kernel Gx e, opcionalmente, um kernel Gy.
+typedef struct {
+    char nome[TAMANHO_NOME_FILTRO];
+    int tamanho;                        // Lado do kernel original (2, 3 ou 5).
+    uint32_t codigo_tamanho;            // Código usado por extrair_janela_vizinhanca_linear (0, 1 ou 3).
+    int possui_gy;
+    tipo_kernel_analisado kernel_gx;
+    tipo_kernel_analisado kernel_gy;
+} tipo_filtro_borda;
+
+/* Registro Global */
+extern tipo_filtro_borda filtros_registrados[MAX_FILTROS_REGISTRADOS];
+extern int total_filtros_registrados;
+
+/* Funções do Registro */
+int carregar_registro_filtros(const char *caminho_arquivo);
+void registrar_filtros_padrao(void);
+void analisar_kernel(tipo_kernel_analisado *kernel);
+const char *nome_motor_kernel(tipo_motor_kernel motor);
+int motor_aplicavel_kernel(const tipo_kernel_analisado *kernel, tipo_motor_kernel motor);
+void imprimir_analise_filtros(void);
+
+/* Motores de Convolução em CPU */
+
+/**
+ * @brief Reproduz o resultado devolvido pela FPGA para uma soma de produtos.
+ *
+ * Em convolution.v o acumulador é `signed [15:0]` (estoura com wrap-around) e qualquer valor
+ * acima de 127 ou abaixo de -128 é substituído por 255. Aplicar a mesma regra aqui mantém
+ * os motores de CPU bit a bit compatíveis com o coprocessador. Definida no cabeçalho para
+ * ser expandida dentro dos laços internos dos motores.
+ *
+ * @param soma Soma exata dos produtos pixel * coeficiente.
+ * @return O valor que `calcular_convolucao_fpga` retornaria para a mesma janela.
+ */
+static inline tipo_resultado_conv aplicar_semantica_fpga(int32_t soma) {
+    int16_t acumulador = (int16_t)(uint16_t)soma; // Acumulador de 16 bits da FPGA.
+    if (acumulador > 127 || acumulador < -128) return 255;
+    return acumulador;
+}
+
+/**
+ * @brief Resposta do modo bruto: a soma exata, limitada a ±32767 em vez da semântica da FPGA.
+ *
+ * Usada onde os valores reais de Gx/Gy importam (exportação de gradientes). O limite é simétrico
+ * para que Gx² + Gy² caiba num int32.
+ *
+ * @param soma Soma exata dos produtos pixel * coeficiente.
+ * @return A soma, limitada à faixa [-32767, 32767].
+ */
+static inline tipo_resultado_conv saturar_resposta_bruta(int32_t soma) {
+    if (soma > INT16_MAX) return INT16_MAX;
+    if (soma < -INT16_MAX) return -INT16_MAX;
+    return (tipo_resultado_conv)soma;
+}
+
+void convolver_regiao_cpu(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                          int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *saida);
+void convolver_regiao_cpu_bruto(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                                int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *saida);
+int32_t maior_resposta_bruta(const tipo_kernel_analisado *kernel);
+
+/* Pré-passada de Regiões Planas */
+#define LADO_BLOCO_PLANO 16                     // Lado dos blocos classificados pela pré-passada.
+#define HALO_BLOCO_PLANO (LADO_JANELA_MAX / 2)  // Vizinhança que cobre o suporte de qualquer kernel 5x5.
+
+int classificar_blocos_planos(const uint8_t *plano, int largura, int altura, int limiar,
+                              uint8_t *bloco_ativo, uint8_t *valor_bloco);
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef FILTROS_ESPECIALIZADOS_H
+#define FILTROS_ESPECIALIZADOS_H
+/*
+ * Rotinas de convolução desenroladas para os kernels embutidos, geradas por macros em tempo de compilação.
+ *
+ * Cada kernel é descrito apenas pelos seus taps não nulos (deslocamento y, deslocamento x, peso),
+ * relativos à âncora usada por `extrair_janela_vizinhanca_linear`. A macro DEFINIR_ROTINA_ESPECIALIZADA
+ * expande a lista em uma função com um termo por tap: os pesos ±1, ±2, ±4 e ±16 viram somas e
+ * deslocamentos de bits, e os demais uma multiplicação por constante.
+ *
+ * Incluído somente por filtros.c.
+ */
+#include <stdint.h>
+
+/* Taps dos Kernels Embutidos: TAP(desloc_y, desloc_x, peso) */
+
+#define TAPS_SOBEL_GX_3X3(TAP) \
+    TAP(-1, -1, -1) TAP(-1, 1, 1) \
+    TAP( 0, -1, -2) TAP( 0, 1, 2) \
+    TAP( 1, -1, -1) TAP( 1, 1, 1)
+
+#define TAPS_SOBEL_GY_3X3(TAP) \
+    TAP(-1, -1, -1) TAP(-1, 0, -2) TAP(-1, 1, -1) \
+    TAP( 1, -1,  1) TAP( 1, 0,  2) TAP( 1, 1,  1)
+
+#define TAPS_SOBEL_GX_5X5(TAP) \
+    TAP(-2, -2,  2) TAP(-2, -1,  2) TAP(-2, 0,  4) TAP(-2, 1,  2) TAP(-2, 2,  2) \
+    TAP(-1, -2,  1) TAP(-1, -1,  1) TAP(-1, 0,  2) TAP(-1, 1,  1) TAP(-1, 2,  1) \
+    TAP( 1, -2, -1) TAP( 1, -1, -1) TAP( 1, 0, -2) TAP( 1, 1, -1) TAP( 1, 2, -1) \
+    TAP( 2, -2, -2) TAP( 2, -1, -2) TAP( 2, 0, -4) TAP( 2, 1, -2) TAP( 2, 2, -2)
+
+#define TAPS_SOBEL_GY_5X5(TAP) \
+    TAP(-2, -2, 2) TAP(-2, -1, 1) TAP(-2, 1, -1) TAP(-2, 2, -2) \
+    TAP(-1, -2, 2) TAP(-1, -1, 1) TAP(-1, 1, -1) TAP(-1, 2, -2) \
+    TAP( 0, -2, 4) TAP( 0, -1, 2) TAP( 0, 1, -2) TAP( 0, 2, -4) \
+    TAP( 1, -2, 2) TAP( 1, -1, 1) TAP( 1, 1, -1) TAP( 1, 2, -2) \
+    TAP( 2, -2, 2) TAP( 2, -1, 1) TAP( 2, 1, -1) TAP( 2, 2, -2)
+
+#define TAPS_PREWITT_GX_3X3(TAP) \
+    TAP(-1, -1, -1) TAP(-1, 1, 1) \
+    TAP( 0, -1, -1) TAP( 0, 1, 1) \
+    TAP( 1, -1, -1) TAP( 1, 1, 1)
+
+#define TAPS_PREWITT_GY_3X3(TAP) \
+    TAP(-1, -1, -1) TAP(-1, 0, -1) TAP(-1, 1, -1) \
+    TAP( 1, -1,  1) TAP( 1, 0,  1) TAP( 1, 1,  1)
+
+// Roberts é ancorado no canto superior esquerdo da janela 2x2.
+#define TAPS_ROBERTS_GX_2X2(TAP) \
+    TAP(0, 0, 1) TAP(1, 1, -1)
+
+#define TAPS_ROBERTS_GY_2X2(TAP) \
+    TAP(0, 1, 1) TAP(1, 0, -1)
+
+#define TAPS_LAPLACE_5X5(TAP) \
+    TAP(-2,  0, -1) \
+    TAP(-1, -1, -1) TAP(-1, 0, -2) TAP(-1, 1, -1) \
+    TAP( 0, -2, -1) TAP( 0, -1, -2) TAP( 0, 0, 16) TAP( 0, 1, -2) TAP( 0, 2, -1) \
+    TAP( 1, -1, -1) TAP( 1, 0, -2) TAP( 1, 1, -1) \
+    TAP( 2,  0, -1)
+
+/* Geração das Rotinas */
+
+// Produto de um pixel por um peso constante; potências de 2 viram deslocamentos (resolvido pelo compilador).
+#define TERMO_PESO_CONSTANTE(peso, valor) \
+    ((peso) ==   1 ?  (valor)        : (peso) ==  -1 ? -(valor)        : \
+     (peso) ==   2 ?  ((valor) << 1) : (peso) ==  -2 ? -((valor) << 1) : \
+     (peso) ==   4 ?  ((valor) << 2) : (peso) ==  -4 ? -((valor) << 2) : \
+     (peso) ==  16 ?  ((valor) << 4) : (peso) == -16 ? -((valor) << 4) : \
+     (peso) * (valor))
+
+// Termo de um tap para pixels cujo suporte está inteiro dentro da imagem (acesso direto).
+#define TAP_INTERNO(desloc_y, desloc_x, peso) \
+    soma += TERMO_PESO_CONSTANTE(peso, (int32_t)centro[(desloc_y) * largura + (desloc_x)]);
+
+// Termo de um tap para pixels de borda (padding zero fora da imagem).
+#define TAP_BORDA(desloc_y, desloc_x, peso) \
+    if (coord_x + (desloc_x) >= 0 && coord_x + (desloc_x) < largura && \
+        coord_y + (desloc_y) >= 0 && coord_y + (desloc_y) < altura) { \
+        soma += TERMO_PESO_CONSTANTE(peso, (int32_t)plano[(coord_y + (desloc_y)) * largura + coord_x + (desloc_x)]); \
+    }
+
+/*
+ * Define `nome` como uma rotina do tipo `tipo_rotina_convolucao` para o kernel descrito por TAPS.
+ * desloc_min/desloc_max delimitam o suporte do kernel (iguais nos dois eixos para os kernels embutidos,
+ * exceto Roberts, cujo suporte vai de 0 a 1). As colunas internas de cada linha formam um laço sem
+ * desvios, que o compilador pode vetorizar; as bordas usam TAP_BORDA.
+ */
+#define DEFINIR_ROTINA_ESPECIALIZADA(nome, TAPS, desloc_min, desloc_max) \
+static void nome(const uint8_t *plano, int largura, int altura, \
+                 int x_inicio, int y_inicio, int x_fim, int y_fim, int16_t *saida) { \
+    int coord_y, coord_x; \
+    int x_interno_inicio = x_inicio > -(desloc_min) ? x_inicio : -(desloc_min); \
+    int x_interno_fim = x_fim < largura - (desloc_max) ? x_fim : largura - (desloc_max); \
+    if (x_interno_inicio > x_fim) x_interno_inicio = x_fim; \
+    for (coord_y = y_inicio; coord_y < y_fim; coord_y++) { \
+        int linha_interna = (coord_y + (desloc_min) >= 0) && (coord_y + (desloc_max) < altura); \
+        int16_t *linha_saida = saida + coord_y * largura; \
+        coord_x = x_inicio; \
+        if (linha_interna) { \
+            for (; coord_x < x_interno_inicio; coord_x++) { \
+                int32_t soma = 0; \
+                TAPS(TAP_BORDA) \
+                linha_saida[coord_x] = aplicar_semantica_fpga(soma); \
+            } \
+            for (; coord_x < x_interno_fim; coord_x++) { \
+                const uint8_t *centro = plano + coord_y * largura + coord_x; \
+                int32_t soma = 0; \
+                TAPS(TAP_INTERNO) \
+                linha_saida[coord_x] = aplicar_semantica_fpga(soma); \
+            } \
+        } \
+        for (; coord_x < x_fim; coord_x++) { \
+            int32_t soma = 0; \
+            TAPS(TAP_BORDA) \
+            linha_saida[coord_x] = aplicar_semantica_fpga(soma); \
+        } \
+    } \
+}
+
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_sobel_gx_3x3, TAPS_SOBEL_GX_3X3, -1, 1)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_sobel_gy_3x3, TAPS_SOBEL_GY_3X3, -1, 1)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_sobel_gx_5x5, TAPS_SOBEL_GX_5X5, -2, 2)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_sobel_gy_5x5, TAPS_SOBEL_GY_5X5, -2, 2)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_prewitt_gx_3x3, TAPS_PREWITT_GX_3X3, -1, 1)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_prewitt_gy_3x3, TAPS_PREWITT_GY_3X3, -1, 1)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_roberts_gx_2x2, TAPS_ROBERTS_GX_2X2, 0, 1)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_roberts_gy_2x2, TAPS_ROBERTS_GY_2X2, 0, 1)
+DEFINIR_ROTINA_ESPECIALIZADA(convolver_laplace_5x5, TAPS_LAPLACE_5X5, -2, 2)
+
+/* Tabela de Despacho */
+
+// Associa um filtro embutido às suas rotinas especializadas e aos kernels de referência (hps_0.h).
+typedef struct {
+    const char *nome;
+    const int8_t *kernel_gx;
+    const int8_t *kernel_gy;            // NULL para filtros sem Gy.
+    tipo_rotina_convolucao rotina_gx;
+    tipo_rotina_convolucao rotina_gy;
+} tipo_entrada_especializada;
+
+static const tipo_entrada_especializada tabela_rotinas_especializadas[] = {
+    { "sobel_3x3",   sobel_gx_3x3,   sobel_gy_3x3,   convolver_sobel_gx_3x3,   convolver_sobel_gy_3x3 },
+    { "sobel_5x5",   sobel_gx_5x5,   sobel_gy_5x5,   convolver_sobel_gx_5x5,   convolver_sobel_gy_5x5 },
+    { "prewitt_3x3", prewitt_gx_3x3, prewitt_gy_3x3, convolver_prewitt_gx_3x3, convolver_prewitt_gy_3x3 },
+    { "roberts_2x2", roberts_gx_2x2, roberts_gy_2x2, convolver_roberts_gx_2x2, convolver_roberts_gy_2x2 },
+    { "laplace_5x5", laplace_5x5,    NULL,           convolver_laplace_5x5,    NULL },
+};
+
+#endif
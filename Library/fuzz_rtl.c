@@ -0,0 +1,319 @@
+#include <stdint.h>   // Para uint8_t e uint64_t.
+#include <stdio.h>    // Para o relatório e as divergências.
+#include <stdlib.h>   // Para strtoull e EXIT_*.
+#include <string.h>   // Para strcmp, memcpy e memset.
+#include "hps_0.h"
+#include "filtros.h"
+#include "imagem.h"
+#include "modelo_rtl.h"
+
+/*
+ * Fuzzing diferencial contra o modelo bit a bit de convolution.v (alvo `make fuzz`).
+ *
+ * --modo motores (padrão): planos e kernels aleatórios (densos, esparsos, separáveis e
+ * (anti)simétricos, além dos filtros embutidos); cada motor de CPU aplicável é forçado numa
+ * cópia do kernel e cada pixel de uma região sorteada é comparado com o que a FPGA devolveria
+ * (extrair_janela_plano + modelo), e os pixels fora da região devem ficar intactos.
+ *
+ * --modo fpga: janelas sorteadas por `sortear_janela_rtl` passam pelo driver (transfer_data_to_fpga
+ * e retrieve_fpga_results), e os 25 bytes lidos são comparados com os do modelo. Com o driver em C,
+ * PBL3_FPGA_DISPOSITIVO escolhe o alvo: a placa, a co-simulação do RTL (Coprocessor/sim) ou o emulador.
+ */
+
+#define ITERACOES_MOTORES_PADRAO 2000
+#define ITERACOES_FPGA_PADRAO    20000
+#define LADO_MAXIMO_PLANO        40      // Planos de 1x1 a 40x40: bordas e regiões pequenas com frequência.
+#define SENTINELA_SAIDA          0x5A5A  // Valor prévio da saída, que deve sobreviver fora da região.
+#define MAXIMO_DIVERGENCIAS_MOSTRADAS 5
+
+typedef enum { FAMILIA_DENSA = 0, FAMILIA_ESPARSA, FAMILIA_SEPARAVEL, FAMILIA_SIMETRICA, TOTAL_FAMILIAS_KERNEL } tipo_familia_kernel;
+static const char *nomes_familias[TOTAL_FAMILIAS_KERNEL] = { "denso", "esparso", "separavel", "simetrico" };
+static const char *nomes_sorteios[TOTAL_SORTEIOS_RTL] = { "uniforme", "pequeno", "extremos", "fronteira" };
+
+static uint8_t plano[LADO_MAXIMO_PLANO * LADO_MAXIMO_PLANO];
+static tipo_resultado_conv saida[LADO_MAXIMO_PLANO * LADO_MAXIMO_PLANO];
+static tipo_resultado_conv referencia[LADO_MAXIMO_PLANO * LADO_MAXIMO_PLANO];
+
+// Contagens do modo motores, por motor.
+static uint64_t kernels_por_motor[MOTOR_GENERICO + 1];
+static uint64_t pixels_por_motor[MOTOR_GENERICO + 1];
+static uint64_t pixels_saturados, pixels_em_faixa;
+static int total_divergencias;
+
+/**
+ * @brief Sorteio em [minimo, maximo].
+ */
+static int sortear_faixa(uint64_t *estado, int minimo, int maximo) {
+    return minimo + (int)(proximo_aleatorio_rtl(estado) % (uint64_t)(maximo - minimo + 1));
+}
+
+/**
+ * @brief Sorteia um plano: ruído uniforme, constante, só 0/255 ou valores pequenos.
+ */
+static void sortear_plano(uint64_t *estado, int largura, int altura) {
+    int tipo = sortear_faixa(estado, 0, 3), constante = sortear_faixa(estado, 0, 255), indice;
+    for (indice = 0; indice < largura * altura; indice++) {
+        uint64_t sorteio = proximo_aleatorio_rtl(estado);
+        switch (tipo) {
+            case 0:  plano[indice] = (uint8_t)sorteio; break;
+            case 1:  plano[indice] = (uint8_t)constante; break;
+            case 2:  plano[indice] = (sorteio & 1) ? 255 : 0; break;
+            default: plano[indice] = (uint8_t)(sorteio & 0x0f); break;
+        }
+    }
+}
+
+/**
+ * @brief Sorteia um kernel quadrado de uma família e o monta no layout 5x5 (mesmo posicionamento de
+ *        `montar_kernel`: 2x2 no canto com âncora no canto, 3x3 centralizado, 5x5 inteiro).
+ *
+ * @return O código de tamanho da janela (0, 1 ou 3).
+ */
+static uint32_t sortear_kernel(uint64_t *estado, tipo_familia_kernel familia, tipo_kernel_analisado *kernel) {
+    static const int lados[] = { 2, 3, 5 };
+    int tamanho = lados[sortear_faixa(estado, 0, 2)];
+    int amplitude = sortear_faixa(estado, 0, 1) ? 4 : 128; // Pesos pequenos (sem saturar sempre) ou quaisquer.
+    int valores[LADO_JANELA_MAX * LADO_JANELA_MAX];
+    int fator_v[LADO_JANELA_MAX], fator_h[LADO_JANELA_MAX];
+    int sinal_h = sortear_faixa(estado, 0, 1) ? 1 : -1, sinal_v = sortear_faixa(estado, 0, 2) - 1; // Vertical: -1, 0 (sem espelho) ou 1.
+    int deslocamento = (tamanho == 2) ? 0 : (LADO_JANELA_MAX - tamanho) / 2;
+    int linha, coluna;
+
+    for (linha = 0; linha < tamanho; linha++) {
+        fator_v[linha] = sortear_faixa(estado, -11, 11); // |fator_v * fator_h| <= 121 cabe em int8.
+        fator_h[linha] = sortear_faixa(estado, -11, 11);
+    }
+    for (linha = 0; linha < tamanho; linha++) {
+        for (coluna = 0; coluna < tamanho; coluna++) {
+            int valor = sortear_faixa(estado, -amplitude, amplitude - 1);
+            if (familia == FAMILIA_ESPARSA && sortear_faixa(estado, 0, 2) != 0) valor = 0;
+            if (familia == FAMILIA_SEPARAVEL) valor = fator_v[linha] * fator_h[coluna];
+            valores[linha * tamanho + coluna] = valor;
+        }
+    }
+    if (familia == FAMILIA_SIMETRICA) {
+        // O espelho de -128 não cabe em int8.
+        for (linha = 0; linha < tamanho * tamanho; linha++) if (valores[linha] < -127) valores[linha] = -127;
+        // Espelha a metade esquerda (e, se sorteado, a de cima) com o sinal da simetria; no eixo de
+        // uma antissimetria o peso é zero.
+        for (linha = 0; linha < tamanho; linha++) {
+            for (coluna = tamanho / 2; coluna < tamanho; coluna++) {
+                int espelho = tamanho - 1 - coluna;
+                valores[linha * tamanho + coluna] = (espelho == coluna) ? ((sinal_h < 0) ? 0 : valores[linha * tamanho + coluna])
+                                                                         : sinal_h * valores[linha * tamanho + espelho];
+            }
+        }
+        for (linha = tamanho / 2; linha < tamanho && sinal_v != 0; linha++) {
+            int espelho = tamanho - 1 - linha;
+            for (coluna = 0; coluna < tamanho; coluna++) {
+                valores[linha * tamanho + coluna] = (espelho == linha) ? ((sinal_v < 0) ? 0 : valores[linha * tamanho + coluna])
+                                                                       : sinal_v * valores[espelho * tamanho + coluna];
+            }
+        }
+    }
+
+    memset(kernel, 0, sizeof(*kernel));
+    for (linha = 0; linha < tamanho; linha++) {
+        for (coluna = 0; coluna < tamanho; coluna++) {
+            kernel->coeficientes[(linha + deslocamento) * LADO_JANELA_MAX + coluna + deslocamento] = (int8_t)valores[linha * tamanho + coluna];
+        }
+    }
+    kernel->ancora_linha = kernel->ancora_coluna = (tamanho == 2) ? 0 : 2;
+    analisar_kernel(kernel);
+    return (tamanho == 2) ? 0 : (tamanho == 3) ? 1 : 3;
+}
+
+/**
+ * @brief O que a FPGA devolveria para cada pixel do plano: a janela de `extrair_janela_plano`,
+ *        enviada com matrix_size 3 como em `calcular_convolucao_fpga`.
+ */
+static void calcular_referencia(const tipo_kernel_analisado *kernel, uint32_t codigo_tamanho, int largura, int altura) {
+    uint8_t resultado[MATRIX_SIZE];
+    int coord_x, coord_y;
+    for (coord_y = 0; coord_y < altura; coord_y++) {
+        for (coord_x = 0; coord_x < largura; coord_x++) {
+            extrair_janela_plano(plano, largura, altura, coord_x, coord_y, codigo_tamanho);
+            resultado_control_unit_rtl(janela_global_pixels, kernel->coeficientes, CODIGO_TAMANHO_HOST_RTL, resultado);
+            referencia[coord_y * largura + coord_x] = resposta_host_rtl(resultado);
+        }
+    }
+}
+
+/**
+ * @brief Roda cada motor aplicável numa região sorteada e compara com a referência.
+ *
+ * @return 0 se todos concordarem, -1 se algum divergir.
+ */
+static int comparar_motores(uint64_t *estado, const tipo_kernel_analisado *kernel, const char *descricao, int largura, int altura) {
+    int x_inicio = sortear_faixa(estado, 0, largura - 1), y_inicio = sortear_faixa(estado, 0, altura - 1);
+    int x_fim = sortear_faixa(estado, x_inicio + 1, largura), y_fim = sortear_faixa(estado, y_inicio + 1, altura);
+    int motor, coord_x, coord_y, resultado = 0;
+
+    for (motor = MOTOR_ESPECIALIZADO; motor <= MOTOR_GENERICO; motor++) {
+        tipo_kernel_analisado copia;
+        if (!motor_aplicavel_kernel(kernel, (tipo_motor_kernel)motor)) continue;
+        memcpy(&copia, kernel, sizeof(copia));
+        copia.motor = (tipo_motor_kernel)motor;
+        for (coord_x = 0; coord_x < largura * altura; coord_x++) saida[coord_x] = SENTINELA_SAIDA;
+        convolver_regiao_cpu(&copia, plano, largura, altura, x_inicio, y_inicio, x_fim, y_fim, saida);
+        kernels_por_motor[motor]++;
+
+        for (coord_y = 0; coord_y < altura; coord_y++) {
+            for (coord_x = 0; coord_x < largura; coord_x++) {
+                int dentro = coord_x >= x_inicio && coord_x < x_fim && coord_y >= y_inicio && coord_y < y_fim;
+                tipo_resultado_conv esperado = dentro ? referencia[coord_y * largura + coord_x] : SENTINELA_SAIDA;
+                tipo_resultado_conv obtido = saida[coord_y * largura + coord_x];
+                if (dentro) {
+                    pixels_por_motor[motor]++;
+                    if (esperado == 255) pixels_saturados++; else pixels_em_faixa++;
+                }
+                if (obtido == esperado) continue;
+                if (++total_divergencias <= MAXIMO_DIVERGENCIAS_MOSTRADAS) {
+                    printf("Divergência: kernel %s, motor %s, plano %dx%d, região [%d,%d)x[%d,%d), pixel (%d,%d): %d, esperado %d\n",
+                           descricao, nome_motor_kernel((tipo_motor_kernel)motor), largura, altura, x_inicio, x_fim, y_inicio, y_fim,
+                           coord_x, coord_y, obtido, esperado);
+                }
+                resultado = -1;
+            }
+        }
+    }
+    return resultado;
+}
+
+/**
+ * @brief Modo motores: cada iteração sorteia um plano, um kernel de cada família e um kernel embutido.
+ */
+static int fuzz_motores(uint64_t *estado, long iteracoes) {
+    long iteracao;
+    int familia, motor;
+
+    registrar_filtros_padrao();
+    for (iteracao = 0; iteracao < iteracoes; iteracao++) {
+        int largura = sortear_faixa(estado, 1, LADO_MAXIMO_PLANO), altura = sortear_faixa(estado, 1, LADO_MAXIMO_PLANO);
+        tipo_kernel_analisado kernel;
+        sortear_plano(estado, largura, altura);
+
+        for (familia = 0; familia < TOTAL_FAMILIAS_KERNEL; familia++) {
+            uint32_t codigo_tamanho = sortear_kernel(estado, (tipo_familia_kernel)familia, &kernel);
+            calcular_referencia(&kernel, codigo_tamanho, largura, altura);
+            comparar_motores(estado, &kernel, nomes_familias[familia], largura, altura);
+        }
+
+        const tipo_filtro_borda *filtro = &filtros_registrados[sortear_faixa(estado, 0, total_filtros_registrados - 1)];
+        const tipo_kernel_analisado *embutido = (filtro->possui_gy && sortear_faixa(estado, 0, 1)) ? &filtro->kernel_gy : &filtro->kernel_gx;
+        calcular_referencia(embutido, filtro->codigo_tamanho, largura, altura);
+        comparar_motores(estado, embutido, filtro->nome, largura, altura);
+    }
+
+    printf("Motores de CPU contra o modelo (%ld iterações):\n", iteracoes);
+    for (motor = MOTOR_ESPECIALIZADO; motor <= MOTOR_GENERICO; motor++) {
+        printf("  %-18s %8llu kernels %12llu pixels\n", nome_motor_kernel((tipo_motor_kernel)motor),
+               (unsigned long long)kernels_por_motor[motor], (unsigned long long)pixels_por_motor[motor]);
+    }
+    printf("  resultados: %llu em [-128, 127], %llu saturados em 255\n",
+           (unsigned long long)pixels_em_faixa, (unsigned long long)pixels_saturados);
+    return total_divergencias ? -1 : 0;
+}
+
+/**
+ * @brief Modo fpga: janelas sorteadas pelo driver, com os 25 bytes comparados com o modelo.
+ */
+static int fuzz_fpga(uint64_t *estado, long iteracoes) {
+    uint64_t janelas_por_sorteio[TOTAL_SORTEIOS_RTL] = { 0 };
+    uint64_t em_faixa = 0, saturadas = 0, com_volta = 0;
+    long iteracao;
+    int indice;
+
+    if (initiate_hardware() != HW_SUCCESS) {
+        fprintf(stderr, "Não foi possível iniciar o hardware.\n");
+        return -1;
+    }
+    for (iteracao = 0; iteracao < iteracoes; iteracao++) {
+        uint8_t pixels[MATRIX_SIZE], lido[MATRIX_SIZE], esperado[MATRIX_SIZE];
+        int8_t pesos[MATRIX_SIZE];
+        unsigned codigo_tamanho;
+        tipo_sorteio_rtl sorteio = sortear_janela_rtl(estado, pixels, pesos, &codigo_tamanho);
+        struct Params parametros = { .a = pixels, .b = pesos, .opcode = 7, .size = codigo_tamanho };
+
+        if (transfer_data_to_fpga(&parametros) != HW_SUCCESS || retrieve_fpga_results(lido) != HW_SUCCESS) {
+            fprintf(stderr, "Falha de comunicação com a FPGA na janela %ld.\n", iteracao);
+            terminate_hardware();
+            return -1;
+        }
+        resultado_control_unit_rtl(pixels, pesos, codigo_tamanho, esperado);
+
+        int32_t soma = soma_produtos_rtl(pixels, pesos, codigo_tamanho);
+        janelas_por_sorteio[sorteio]++;
+        if (soma != (int16_t)(uint16_t)soma) com_volta++;
+        if (convolucao_rtl(pixels, pesos, codigo_tamanho) == 255) saturadas++; else em_faixa++;
+
+        if (memcmp(lido, esperado, MATRIX_SIZE) == 0) continue;
+        if (++total_divergencias <= MAXIMO_DIVERGENCIAS_MOSTRADAS) {
+            printf("Divergência na janela %ld (%s, %ux%u, soma exata %d):\n  pixels:", iteracao, nomes_sorteios[sorteio],
+                   codigo_tamanho + 2, codigo_tamanho + 2, soma);
+            for (indice = 0; indice < MATRIX_SIZE; indice++) printf(" %u", pixels[indice]);
+            printf("\n  pesos:");
+            for (indice = 0; indice < MATRIX_SIZE; indice++) printf(" %d", pesos[indice]);
+            printf("\n  lido:");
+            for (indice = 0; indice < MATRIX_SIZE; indice++) printf(" %02x", lido[indice]);
+            printf("\n  esperado:");
+            for (indice = 0; indice < MATRIX_SIZE; indice++) printf(" %02x", esperado[indice]);
+            printf("\n");
+        }
+    }
+    terminate_hardware();
+
+    printf("FPGA contra o modelo (%ld janelas):\n", iteracoes);
+    for (indice = 0; indice < TOTAL_SORTEIOS_RTL; indice++) {
+        printf("  %-10s %10llu janelas\n", nomes_sorteios[indice], (unsigned long long)janelas_por_sorteio[indice]);
+    }
+    printf("  resultados: %llu em [-128, 127], %llu saturados em 255, %llu com estouro do acumulador de 16 bits\n",
+           (unsigned long long)em_faixa, (unsigned long long)saturadas, (unsigned long long)com_volta);
+    return total_divergencias ? -1 : 0;
+}
+
+static void imprimir_uso_fuzz(const char *programa) {
+    printf("Uso: %s [--modo motores|fpga] [--iteracoes N] [--semente N]\n", programa);
+    printf("  motores: motores de CPU contra o modelo de convolution.v (padrão, %d iterações)\n", ITERACOES_MOTORES_PADRAO);
+    printf("  fpga:    janelas enviadas pelo driver contra o modelo (%d janelas; PBL3_FPGA_DISPOSITIVO com DRIVER=c)\n", ITERACOES_FPGA_PADRAO);
+}
+
+int main(int argc, char *argv[]) {
+    const char *modo = "motores";
+    long iteracoes = 0;
+    uint64_t semente = 1;
+    int indice_argumento, resultado;
+
+    for (indice_argumento = 1; indice_argumento < argc; indice_argumento++) {
+        const char *argumento = argv[indice_argumento];
+        const char *valor = (indice_argumento + 1 < argc) ? argv[indice_argumento + 1] : NULL;
+
+        if (strcmp(argumento, "--ajuda") == 0) {
+            imprimir_uso_fuzz(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (strcmp(argumento, "--modo") == 0 && valor != NULL && (strcmp(valor, "motores") == 0 || strcmp(valor, "fpga") == 0)) {
+            modo = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--iteracoes") == 0 && valor != NULL && atol(valor) > 0) {
+            iteracoes = atol(valor);
+            indice_argumento++;
+        } else if (strcmp(argumento, "--semente") == 0 && valor != NULL) {
+            semente = strtoull(valor, NULL, 10);
+            indice_argumento++;
+        } else {
+            fprintf(stderr, "Argumento inválido: '%s'\n", argumento);
+            imprimir_uso_fuzz(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("Fuzzing diferencial (modo %s, semente %llu)\n", modo, (unsigned long long)semente);
+    if (strcmp(modo, "fpga") == 0) {
+        resultado = fuzz_fpga(&semente, iteracoes ? iteracoes : ITERACOES_FPGA_PADRAO);
+    } else {
+        resultado = fuzz_motores(&semente, iteracoes ? iteracoes : ITERACOES_MOTORES_PADRAO);
+    }
+    if (total_divergencias) printf("FALHOU: %d divergências\n", total_divergencias);
+    else if (resultado == 0) printf("PASSOU\n");
+    return (resultado == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
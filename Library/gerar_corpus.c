@@ -0,0 +1,287 @@
+#include <stdint.h>   // Para uint8_t e uint32_t.
+#include <stdio.h>    // Para mensagens e snprintf.
+#include <stdlib.h>   // Para malloc, free e atoi.
+#include <string.h>   // Para strcmp, strtok e strncpy.
+#include <math.h>     // Para sqrt (padrão de formas).
+#include <sys/stat.h> // Para criar o diretório do corpus (mkdir).
+#include <errno.h>    // Para distinguir um diretório já existente (EEXIST).
+#include "stb_image/stb_image_write.h" // Codificação PNG/JPEG/BMP (implementação em imagem.c).
+
+/*
+ * Gerador do corpus sintético usado pelo benchmark de ponta a ponta (`make corpus`).
+ *
+ * Cada imagem é função só do padrão, do tamanho e da semente, então o mesmo comando gera
+ * sempre os mesmos arquivos, em qualquer máquina: os resultados de `bench_corpus` podem ser
+ * comparados com uma baseline gravada antes.
+ */
+
+#define MAX_TAMANHOS_CORPUS 16
+#define QUALIDADE_JPEG_CORPUS 90
+
+// Tamanhos padrão: menor, igual e maior que o tamanho processado (320x240), até Full HD.
+static const int tamanhos_padrao[][2] = { { 160, 120 }, { 320, 240 }, { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+
+typedef enum { FORMATO_PNG = 0, FORMATO_JPEG, FORMATO_BMP, TOTAL_FORMATOS_CORPUS } tipo_formato_corpus;
+static const char *extensoes_formato[TOTAL_FORMATOS_CORPUS] = { "png", "jpg", "bmp" };
+
+// Gera o pixel (x, y) de um padrão em `rgb[3]`.
+typedef void (*tipo_rotina_padrao)(int x, int y, int largura, int altura, uint32_t semente, uint8_t rgb[3]);
+
+/**
+ * @brief Hash inteiro de 32 bits (mistura de um inteiro, estilo "lowbias32").
+ */
+static uint32_t misturar_hash(uint32_t valor) {
+    valor ^= valor >> 16;
+    valor *= 0x7feb352du;
+    valor ^= valor >> 15;
+    valor *= 0x846ca68bu;
+    valor ^= valor >> 16;
+    return valor;
+}
+
+/**
+ * @brief Valor pseudoaleatório (0-255) associado a um ponto da grade e à semente.
+ */
+static int valor_grade(int x, int y, uint32_t semente) {
+    return (int)(misturar_hash((uint32_t)x * 0x9E3779B1u ^ misturar_hash((uint32_t)y + semente)) >> 24);
+}
+
+/**
+ * @brief Ruído de valor suavizado: interpolação bilinear (com curva suave) entre pontos de uma grade.
+ *
+ * Só inteiros, com pesos em 8 bits de fração, para que a imagem não dependa da libm da máquina.
+ *
+ * @param passo Distância entre pontos da grade, em pixels.
+ * @return Valor entre 0 e 255.
+ */
+static int ruido_valor(int x, int y, int passo, uint32_t semente) {
+    int celula_x = x / passo, celula_y = y / passo;
+    int fracao_x = ((x % passo) << 8) / passo, fracao_y = ((y % passo) << 8) / passo;
+    // Curva suave 3t² - 2t³ em ponto fixo (8 bits de fração).
+    int peso_x = (fracao_x * fracao_x * (768 - 2 * fracao_x)) >> 16;
+    int peso_y = (fracao_y * fracao_y * (768 - 2 * fracao_y)) >> 16;
+    int v00 = valor_grade(celula_x, celula_y, semente), v10 = valor_grade(celula_x + 1, celula_y, semente);
+    int v01 = valor_grade(celula_x, celula_y + 1, semente), v11 = valor_grade(celula_x + 1, celula_y + 1, semente);
+    int topo = v00 + (((v10 - v00) * peso_x) >> 8);
+    int base = v01 + (((v11 - v01) * peso_x) >> 8);
+    return topo + (((base - topo) * peso_y) >> 8);
+}
+
+/**
+ * @brief Soma de oitavas de ruído de valor (fBm), com amplitude caindo pela metade a cada oitava.
+ */
+static int ruido_fractal(int x, int y, int passo_inicial, int oitavas, uint32_t semente) {
+    int soma = 0, peso_total = 0, peso = 128, oitava;
+    for (oitava = 0; oitava < oitavas && passo_inicial > 1; oitava++, passo_inicial /= 2, peso /= 2) {
+        soma += peso * ruido_valor(x, y, passo_inicial, semente + (uint32_t)oitava * 101u);
+        peso_total += peso;
+    }
+    return (peso_total > 0) ? soma / peso_total : 0;
+}
+
+static uint8_t limitar_byte(int valor) {
+    return (uint8_t)(valor < 0 ? 0 : valor > 255 ? 255 : valor);
+}
+
+/* ---------- Padrões ---------- */
+
+// Degradês lineares em direções diferentes por canal (bordas fracas, quase sem alta frequência).
+static void padrao_degrade(int x, int y, int largura, int altura, uint32_t semente, uint8_t rgb[3]) {
+    (void)semente;
+    rgb[0] = (uint8_t)(255 * x / (largura > 1 ? largura - 1 : 1));
+    rgb[1] = (uint8_t)(255 * y / (altura > 1 ? altura - 1 : 1));
+    rgb[2] = (uint8_t)(255 * (x + y) / (largura + altura > 2 ? largura + altura - 2 : 1));
+}
+
+// Tabuleiro de xadrez com casas de 1/16 da largura (bordas fortes, horizontais e verticais).
+static void padrao_xadrez(int x, int y, int largura, int altura, uint32_t semente, uint8_t rgb[3]) {
+    int lado = largura / 16 > 0 ? largura / 16 : 1;
+    int claro = ((x / lado) + (y / lado)) % 2 == 0;
+    (void)altura;
+    (void)semente;
+    rgb[0] = claro ? 230 : 25;
+    rgb[1] = claro ? 220 : 30;
+    rgb[2] = claro ? 210 : 40;
+}
+
+// Ruído branco por pixel (pior caso para a compressão e para a pré-passada de blocos planos).
+static void padrao_ruido(int x, int y, int largura, int altura, uint32_t semente, uint8_t rgb[3]) {
+    uint32_t valor = misturar_hash((uint32_t)(y * largura + x) ^ semente);
+    (void)altura;
+    rgb[0] = (uint8_t)valor;
+    rgb[1] = (uint8_t)(valor >> 8);
+    rgb[2] = (uint8_t)(valor >> 16);
+}
+
+// Textura fractal em tons de terra e vegetação (estatística próxima de uma foto de paisagem).
+static void padrao_textura(int x, int y, int largura, int altura, uint32_t semente, uint8_t rgb[3]) {
+    int passo = (largura > altura ? largura : altura) / 4;
+    int base = ruido_fractal(x, y, passo > 2 ? passo : 2, 6, semente);
+    int detalhe = ruido_fractal(x, y, 8, 3, semente ^ 0x5bd1e995u) - 128;
+    rgb[0] = limitar_byte(base * 3 / 4 + detalhe / 4 + 30);
+    rgb[1] = limitar_byte(base * 5 / 6 + detalhe / 4 + 20);
+    rgb[2] = limitar_byte(base / 2 + detalhe / 6 + 10);
+}
+
+// Formas (discos e retângulos com sombreamento) sobre a textura: bordas em todas as orientações.
+static void padrao_formas(int x, int y, int largura, int altura, uint32_t semente, uint8_t rgb[3]) {
+    int forma;
+    padrao_textura(x, y, largura, altura, semente, rgb);
+    for (forma = 0; forma < 8; forma++) {
+        uint32_t parametros = misturar_hash(semente * 31u + (uint32_t)forma);
+        int centro_x = (int)(parametros % (uint32_t)largura), centro_y = (int)((parametros >> 12) % (uint32_t)altura);
+        int raio = (largura < altura ? largura : altura) / 10 + (int)((parametros >> 24) % 16) * (largura / 160 + 1);
+        int delta_x = x - centro_x, delta_y = y - centro_y;
+        int dentro = (forma % 2 == 0) ? delta_x * delta_x + delta_y * delta_y < raio * raio
+                                      : abs(delta_x) < raio && abs(delta_y) < raio / 2;
+        if (dentro) {
+            // Sombreamento radial simples: mais claro no centro.
+            int sombra = 255 - (int)(96.0 * sqrt((double)(delta_x * delta_x + delta_y * delta_y)) / (raio > 0 ? raio : 1));
+            rgb[0] = limitar_byte(sombra * (int)((parametros >> 4) & 0xFF) / 255);
+            rgb[1] = limitar_byte(sombra * (int)((parametros >> 9) & 0xFF) / 255);
+            rgb[2] = limitar_byte(sombra * (int)((parametros >> 17) & 0xFF) / 255);
+        }
+    }
+}
+
+typedef struct {
+    const char *nome;
+    tipo_rotina_padrao rotina;
+} tipo_padrao_corpus;
+
+static const tipo_padrao_corpus padroes_corpus[] = {
+    { "degrade", padrao_degrade },
+    { "xadrez",  padrao_xadrez },
+    { "ruido",   padrao_ruido },
+    { "textura", padrao_textura },
+    { "formas",  padrao_formas },
+};
+#define TOTAL_PADROES_CORPUS ((int)(sizeof(padroes_corpus) / sizeof(padroes_corpus[0])))
+
+/**
+ * @brief Gera e grava uma imagem do corpus.
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro.
+ */
+static int gerar_imagem_corpus(const char *diretorio, const tipo_padrao_corpus *padrao, int largura, int altura,
+                               tipo_formato_corpus formato, uint32_t semente) {
+    char caminho[512];
+    uint8_t *pixels = malloc((size_t)largura * altura * 3);
+    int coord_x, coord_y, gravou;
+
+    if (pixels == NULL) {
+        fprintf(stderr, "Memória insuficiente para gerar %dx%d\n", largura, altura);
+        return -1;
+    }
+    for (coord_y = 0; coord_y < altura; coord_y++) {
+        for (coord_x = 0; coord_x < largura; coord_x++) {
+            padrao->rotina(coord_x, coord_y, largura, altura, semente, &pixels[((size_t)coord_y * largura + coord_x) * 3]);
+        }
+    }
+
+    snprintf(caminho, sizeof(caminho), "%s/%s_%dx%d.%s", diretorio, padrao->nome, largura, altura, extensoes_formato[formato]);
+    switch (formato) {
+        case FORMATO_JPEG: gravou = stbi_write_jpg(caminho, largura, altura, 3, pixels, QUALIDADE_JPEG_CORPUS); break;
+        case FORMATO_BMP:  gravou = stbi_write_bmp(caminho, largura, altura, 3, pixels); break;
+        default:           gravou = stbi_write_png(caminho, largura, altura, 3, pixels, largura * 3); break;
+    }
+    free(pixels);
+    if (!gravou) {
+        fprintf(stderr, "Erro ao gravar '%s'\n", caminho);
+        return -1;
+    }
+    printf("  %s\n", caminho);
+    return 0;
+}
+
+/**
+ * @brief Lê uma lista de tamanhos "LxA,LxA,...".
+ *
+ * @return Quantidade de tamanhos lidos, ou -1 se a lista for inválida.
+ */
+static int ler_lista_tamanhos(const char *texto, int tamanhos[][2]) {
+    char copia[256];
+    int total = 0;
+    strncpy(copia, texto, sizeof(copia) - 1);
+    copia[sizeof(copia) - 1] = '\0';
+    for (char *item = strtok(copia, ","); item != NULL; item = strtok(NULL, ",")) {
+        int largura, altura;
+        if (total == MAX_TAMANHOS_CORPUS || sscanf(item, "%dx%d", &largura, &altura) != 2 ||
+            largura < 1 || altura < 1 || largura > 65535 || altura > 65535) {
+            return -1;
+        }
+        tamanhos[total][0] = largura;
+        tamanhos[total][1] = altura;
+        total++;
+    }
+    return total;
+}
+
+static void imprimir_uso_corpus(const char *nome_programa) {
+    printf("Uso: %s [opções]\n", nome_programa);
+    printf("  --saida DIR          Diretório do corpus (padrão: corpus)\n");
+    printf("  --tamanhos LxA,...   Tamanhos gerados (padrão: 160x120,320x240,640x480,1280x720,1920x1080)\n");
+    printf("  --todos-formatos     Grava cada imagem em PNG, JPEG e BMP (padrão: um formato por imagem, em rodízio)\n");
+    printf("  --semente N          Semente dos padrões aleatórios (padrão: 1)\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *diretorio = "corpus";
+    int tamanhos[MAX_TAMANHOS_CORPUS][2];
+    int total_tamanhos = (int)(sizeof(tamanhos_padrao) / sizeof(tamanhos_padrao[0]));
+    int todos_formatos = 0, indice_argumento, indice_tamanho, indice_padrao, formato, total_imagens = 0;
+    uint32_t semente = 1;
+
+    memcpy(tamanhos, tamanhos_padrao, sizeof(tamanhos_padrao));
+    for (indice_argumento = 1; indice_argumento < argc; indice_argumento++) {
+        const char *argumento = argv[indice_argumento];
+        const char *valor = (indice_argumento + 1 < argc) ? argv[indice_argumento + 1] : NULL;
+
+        if (strcmp(argumento, "--ajuda") == 0) {
+            imprimir_uso_corpus(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (strcmp(argumento, "--saida") == 0 && valor != NULL) {
+            diretorio = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--tamanhos") == 0 && valor != NULL) {
+            total_tamanhos = ler_lista_tamanhos(valor, tamanhos);
+            if (total_tamanhos <= 0) {
+                fprintf(stderr, "Lista de tamanhos inválida: '%s' (ex.: 320x240,640x480)\n", valor);
+                return EXIT_FAILURE;
+            }
+            indice_argumento++;
+        } else if (strcmp(argumento, "--todos-formatos") == 0) {
+            todos_formatos = 1;
+        } else if (strcmp(argumento, "--semente") == 0 && valor != NULL) {
+            semente = (uint32_t)strtoul(valor, NULL, 10);
+            indice_argumento++;
+        } else {
+            fprintf(stderr, "Argumento inválido: '%s'\n", argumento);
+            imprimir_uso_corpus(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (mkdir(diretorio, 0777) == -1 && errno != EEXIST) {
+        perror("Erro ao criar diretório do corpus");
+        return EXIT_FAILURE;
+    }
+    printf("Gerando corpus sintético em '%s' (semente %u):\n", diretorio, semente);
+    for (indice_tamanho = 0; indice_tamanho < total_tamanhos; indice_tamanho++) {
+        for (indice_padrao = 0; indice_padrao < TOTAL_PADROES_CORPUS; indice_padrao++) {
+            // Cada padrão recebe sua própria semente, derivada da semente do corpus.
+            uint32_t semente_padrao = misturar_hash(semente * 977u + (uint32_t)indice_padrao);
+            for (formato = 0; formato < TOTAL_FORMATOS_CORPUS; formato++) {
+                // Rodízio: cada tamanho e cada padrão passam por todos os formatos ao longo do corpus.
+                if (!todos_formatos && formato != (indice_padrao + indice_tamanho) % TOTAL_FORMATOS_CORPUS) continue;
+                if (gerar_imagem_corpus(diretorio, &padroes_corpus[indice_padrao], tamanhos[indice_tamanho][0],
+                                        tamanhos[indice_tamanho][1], (tipo_formato_corpus)formato, semente_padrao) != 0) {
+                    return EXIT_FAILURE;
+                }
+                total_imagens++;
+            }
+        }
+    }
+    printf("%d imagens geradas.\n", total_imagens);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+#include <stdio.h>      // Para escrita do arquivo .hog (fopen, fwrite).
+#include <stdlib.h>     // Para malloc e free.
+#include <string.h>     // Para memset e memcpy.
+#include <math.h>       // Para sqrt/sqrtf (normalização dos blocos).
+#include "hog.h"
+#include "exportacao.h" // Para atan2_tabela e raiz_quadrada_inteira.
+#include "paralelo.h"   // Para dividir as linhas de células e de blocos entre as threads.
+
+// Largura de um bin em unidades de (ângulo de meia volta * HOG_BINS); meia volta = 32768.
+#define LARGURA_BIN_HOG 32768
+// Peso total de um voto dividido entre os dois bins vizinhos (ponto fixo Q8).
+#define PESO_VOTO_HOG 256
+
+// Dados compartilhados pelas faixas de `calcular_descritor_hog`.
+typedef struct {
+    const int16_t *gradiente_x;
+    const int16_t *gradiente_y;
+    int largura;
+    const tipo_dimensoes_hog *dimensoes;
+    uint64_t *histogramas;   // celulas_y * celulas_x * HOG_BINS, magnitude em Q8.
+    uint8_t *descritor;
+} tipo_contexto_hog;
+
+/**
+ * @brief Calcula as dimensões do descritor HOG de uma imagem.
+ *
+ * Só entram as células completas; sobras à direita e embaixo são ignoradas.
+ *
+ * @return 0 se a configuração couber na imagem, -1 caso contrário.
+ */
+int calcular_dimensoes_hog(int largura, int altura, int tamanho_celula, int celulas_bloco, tipo_dimensoes_hog *dimensoes) {
+    if (tamanho_celula < HOG_TAMANHO_CELULA_MIN || tamanho_celula > HOG_TAMANHO_CELULA_MAX ||
+        celulas_bloco < 1 || celulas_bloco > HOG_CELULAS_BLOCO_MAX) {
+        return -1;
+    }
+    dimensoes->tamanho_celula = tamanho_celula;
+    dimensoes->celulas_bloco = celulas_bloco;
+    dimensoes->celulas_x = largura / tamanho_celula;
+    dimensoes->celulas_y = altura / tamanho_celula;
+    dimensoes->blocos_x = dimensoes->celulas_x - celulas_bloco + 1;
+    dimensoes->blocos_y = dimensoes->celulas_y - celulas_bloco + 1;
+    if (dimensoes->blocos_x < 1 || dimensoes->blocos_y < 1) return -1;
+    dimensoes->tamanho_descritor = dimensoes->blocos_x * dimensoes->blocos_y * celulas_bloco * celulas_bloco * HOG_BINS;
+    return 0;
+}
+
+/**
+ * @brief Acumula os histogramas de uma faixa de linhas de células.
+ *
+ * Cada linha de células ocupa só celulas_x * HOG_BINS contadores, que ficam na cache enquanto as
+ * `tamanho_celula` linhas de pixels que a formam são varridas. O voto de cada pixel (magnitude
+ * inteira) é dividido entre os dois bins de orientação mais próximos, com pesos em ponto fixo.
+ * Com gradientes brutos, a magnitude vai até sqrt(2) * 32767 e uma célula de 32x32 soma até ~2^33
+ * em Q8, por isso os contadores são de 64 bits; Gx² + Gy² ainda cabe em uint32.
+ */
+static void acumular_faixa_celulas(int linha_celula_inicio, int linha_celula_fim, void *argumento) {
+    tipo_contexto_hog *contexto = (tipo_contexto_hog *)argumento;
+    const tipo_dimensoes_hog *dimensoes = contexto->dimensoes;
+    int tamanho_celula = dimensoes->tamanho_celula;
+    int largura_util = dimensoes->celulas_x * tamanho_celula;
+    int linha_celula, coord_x, coord_y;
+
+    for (linha_celula = linha_celula_inicio; linha_celula < linha_celula_fim; linha_celula++) {
+        uint64_t *histogramas_linha = contexto->histogramas + (size_t)linha_celula * dimensoes->celulas_x * HOG_BINS;
+        memset(histogramas_linha, 0, (size_t)dimensoes->celulas_x * HOG_BINS * sizeof(uint64_t));
+
+        for (coord_y = linha_celula * tamanho_celula; coord_y < (linha_celula + 1) * tamanho_celula; coord_y++) {
+            const int16_t *linha_gx = contexto->gradiente_x + coord_y * contexto->largura;
+            const int16_t *linha_gy = contexto->gradiente_y + coord_y * contexto->largura;
+            for (coord_x = 0; coord_x < largura_util; coord_x++) {
+                int32_t valor_gx = linha_gx[coord_x], valor_gy = linha_gy[coord_x];
+                if (valor_gx == 0 && valor_gy == 0) continue;
+                uint64_t magnitude = raiz_quadrada_inteira((uint32_t)(valor_gx * valor_gx) + (uint32_t)(valor_gy * valor_gy));
+
+                // Orientação sem sinal (meia volta) deslocada de meio bin: o voto vai para os centros vizinhos.
+                uint32_t meia_volta = atan2_tabela(valor_gy, valor_gx) & (LARGURA_BIN_HOG - 1);
+                uint32_t posicao = (meia_volta * HOG_BINS + LARGURA_BIN_HOG * HOG_BINS - LARGURA_BIN_HOG / 2) % (LARGURA_BIN_HOG * HOG_BINS);
+                uint32_t bin_inferior = posicao / LARGURA_BIN_HOG;
+                uint32_t bin_superior = (bin_inferior + 1 == HOG_BINS) ? 0 : bin_inferior + 1;
+                uint32_t peso_superior = (posicao % LARGURA_BIN_HOG) / (LARGURA_BIN_HOG / PESO_VOTO_HOG);
+
+                uint64_t *histograma = histogramas_linha + (coord_x / tamanho_celula) * HOG_BINS;
+                histograma[bin_inferior] += magnitude * (PESO_VOTO_HOG - peso_superior);
+                histograma[bin_superior] += magnitude * peso_superior;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Normaliza os blocos de uma faixa de linhas de blocos (L2-Hys) e quantiza para uint8.
+ */
+static void normalizar_faixa_blocos(int linha_bloco_inicio, int linha_bloco_fim, void *argumento) {
+    tipo_contexto_hog *contexto = (tipo_contexto_hog *)argumento;
+    const tipo_dimensoes_hog *dimensoes = contexto->dimensoes;
+    int celulas_bloco = dimensoes->celulas_bloco;
+    int valores_bloco = celulas_bloco * celulas_bloco * HOG_BINS;
+    float valores[HOG_CELULAS_BLOCO_MAX * HOG_CELULAS_BLOCO_MAX * HOG_BINS];
+    int bloco_x, bloco_y, celula_x, celula_y, indice;
+
+    for (bloco_y = linha_bloco_inicio; bloco_y < linha_bloco_fim; bloco_y++) {
+        for (bloco_x = 0; bloco_x < dimensoes->blocos_x; bloco_x++) {
+            double soma_quadrados = 0.0; // Os quadrados de contadores de até ~2^33 passam da precisão do float.
+            float escala;
+
+            // Junta os histogramas das células do bloco.
+            for (celula_y = 0; celula_y < celulas_bloco; celula_y++) {
+                for (celula_x = 0; celula_x < celulas_bloco; celula_x++) {
+                    const uint64_t *histograma = contexto->histogramas +
+                        ((size_t)(bloco_y + celula_y) * dimensoes->celulas_x + bloco_x + celula_x) * HOG_BINS;
+                    float *destino = valores + (celula_y * celulas_bloco + celula_x) * HOG_BINS;
+                    for (indice = 0; indice < HOG_BINS; indice++) {
+                        destino[indice] = (float)histograma[indice];
+                        soma_quadrados += (double)histograma[indice] * histograma[indice];
+                    }
+                }
+            }
+
+            // L2, corte em HOG_LIMITE_L2HYS e L2 de novo; o epsilon evita divisão por zero em blocos vazios.
+            escala = (float)(1.0 / sqrt(soma_quadrados + 1.0));
+            soma_quadrados = 0.0;
+            for (indice = 0; indice < valores_bloco; indice++) {
+                valores[indice] *= escala;
+                if (valores[indice] > HOG_LIMITE_L2HYS) valores[indice] = HOG_LIMITE_L2HYS;
+                soma_quadrados += valores[indice] * valores[indice];
+            }
+            escala = 255.0f / sqrtf((float)soma_quadrados + 1e-6f);
+
+            uint8_t *saida = contexto->descritor + ((size_t)bloco_y * dimensoes->blocos_x + bloco_x) * valores_bloco;
+            for (indice = 0; indice < valores_bloco; indice++) {
+                float valor = valores[indice] * escala + 0.5f;
+                saida[indice] = (uint8_t)(valor > 255.0f ? 255.0f : valor);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Calcula o descritor HOG a partir dos gradientes Gx/Gy.
+ *
+ * Gx/Gy devem ser os do modo bruto (`convolver_regiao_cpu_bruto`): nos valores da FPGA, um gradiente
+ * negativo forte vira +255 e vota no bin errado, e os pixels saturados nos dois eixos caem todos em 45°.
+ *
+ * Os histogramas das células são acumulados por faixas de linhas de células e, em seguida, os
+ * blocos são normalizados por faixas de linhas de blocos, ambos no grupo de threads.
+ *
+ * @param gradiente_x Resposta bruta do kernel Gx (largura x altura).
+ * @param gradiente_y Resposta bruta do kernel Gy (largura x altura).
+ * @param largura Largura da imagem.
+ * @param altura Altura da imagem.
+ * @param dimensoes Dimensões obtidas com `calcular_dimensoes_hog`.
+ * @param descritor Saída com `dimensoes->tamanho_descritor` bytes.
+ * @return 0 em caso de sucesso, -1 em caso de falta de memória.
+ */
+int calcular_descritor_hog(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                           const tipo_dimensoes_hog *dimensoes, uint8_t *descritor) {
+    tipo_contexto_hog contexto = { gradiente_x, gradiente_y, largura, dimensoes, NULL, descritor };
+    (void)altura; // As células já foram limitadas à altura em `calcular_dimensoes_hog`.
+
+    contexto.histogramas = malloc((size_t)dimensoes->celulas_x * dimensoes->celulas_y * HOG_BINS * sizeof(uint64_t));
+    if (contexto.histogramas == NULL) return -1;
+
+    executar_em_faixas(dimensoes->celulas_y, 1, acumular_faixa_celulas, &contexto);
+    executar_em_faixas(dimensoes->blocos_y, 1, normalizar_faixa_blocos, &contexto);
+
+    free(contexto.histogramas);
+    return 0;
+}
+
+/**
+ * @brief Grava um campo uint16 little-endian no cabeçalho.
+ */
+static void escrever_uint16_le(uint8_t *destino, int valor) {
+    destino[0] = (uint8_t)(valor & 0xFF);
+    destino[1] = (uint8_t)((valor >> 8) & 0xFF);
+}
+
+/**
+ * @brief Salva o descritor no formato binário .hog (ver hog.h).
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro.
+ */
+int salvar_descritor_hog(const char *caminho_arquivo, const tipo_dimensoes_hog *dimensoes, const uint8_t *descritor) {
+    uint8_t cabecalho[HOG_TAMANHO_CABECALHO];
+    int campos[] = { dimensoes->celulas_x, dimensoes->celulas_y, dimensoes->tamanho_celula, dimensoes->celulas_bloco,
+                     HOG_BINS, dimensoes->blocos_x, dimensoes->blocos_y };
+    size_t indice;
+
+    memcpy(cabecalho, HOG_MAGICO, 4);
+    for (indice = 0; indice < sizeof(campos) / sizeof(campos[0]); indice++) {
+        escrever_uint16_le(cabecalho + 4 + 2 * indice, campos[indice]);
+    }
+
+    FILE *arquivo = fopen(caminho_arquivo, "wb");
+    if (arquivo == NULL) {
+        perror("Erro ao criar arquivo HOG");
+        return -1;
+    }
+    int falhou = fwrite(cabecalho, 1, sizeof(cabecalho), arquivo) != sizeof(cabecalho) ||
+                 fwrite(descritor, 1, (size_t)dimensoes->tamanho_descritor, arquivo) != (size_t)dimensoes->tamanho_descritor;
+    if (fclose(arquivo) != 0 || falhou) {
+        fprintf(stderr, "Erro ao gravar '%s'\n", caminho_arquivo);
+        return -1;
+    }
+    printf("Descritor HOG salvo: %s (%d valores)\n", caminho_arquivo, dimensoes->tamanho_descritor);
+    return 0;
+}
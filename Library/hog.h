@@ -0,0 +1,34 @@
+#ifndef HOG_H
+#define HOG_H
+#include <stdint.h>
+
+/* Parâmetros do Descritor HOG */
+#define HOG_BINS                    9     // Orientações sem sinal (0° a 180°), 20° por bin.
+#define HOG_TAMANHO_CELULA_PADRAO   8     // Lado da célula, em pixels.
+#define HOG_CELULAS_BLOCO_PADRAO    2     // Lado do bloco de normalização, em células (passo de 1 célula).
+#define HOG_TAMANHO_CELULA_MIN      4
+#define HOG_TAMANHO_CELULA_MAX      32
+#define HOG_CELULAS_BLOCO_MAX       4
+#define HOG_LIMITE_L2HYS            0.2f  // Corte dos valores normalizados antes da segunda normalização.
+
+/* Formato do Arquivo .hog (little-endian) */
+// "HOG1", depois 7 campos uint16: celulas_x, celulas_y, tamanho_celula, celulas_bloco, bins,
+// blocos_x, blocos_y; em seguida blocos_x * blocos_y * celulas_bloco² * bins bytes (uint8, 0-255),
+// bloco a bloco em ordem de varredura, células do bloco em ordem de varredura, bins em sequência.
+#define HOG_MAGICO              "HOG1"
+#define HOG_TAMANHO_CABECALHO   18
+
+// Dimensões de um descritor para uma imagem e uma configuração de célula/bloco.
+typedef struct {
+    int tamanho_celula, celulas_bloco;
+    int celulas_x, celulas_y;
+    int blocos_x, blocos_y;
+    int tamanho_descritor;  // Bytes do vetor de características.
+} tipo_dimensoes_hog;
+
+int calcular_dimensoes_hog(int largura, int altura, int tamanho_celula, int celulas_bloco, tipo_dimensoes_hog *dimensoes);
+int calcular_descritor_hog(const int16_t *gradiente_x, const int16_t *gradiente_y, int largura, int altura,
+                           const tipo_dimensoes_hog *dimensoes, uint8_t *descritor);
+int salvar_descritor_hog(const char *caminho_arquivo, const tipo_dimensoes_hog *dimensoes, const uint8_t *descritor);
+
+#endif
@@ -0,0 +1,206 @@
+#include <stdio.h>      // Para escrita da lista de linhas (fopen, fprintf).
+#include <stdlib.h>     // Para malloc, calloc, free e qsort.
+#include <string.h>     // Para memcpy.
+#include <math.h>       // Para sin, cos e sqrt (só no preenchimento das tabelas).
+#include <pthread.h>    // Para pthread_once.
+#include "hough.h"
+#include "paralelo.h"   // Para votar e juntar os acumuladores em faixas.
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Tabelas de seno/cosseno em ponto fixo, preenchidas uma única vez.
+static int32_t tabela_cosseno[HOUGH_BINS_THETA];
+static int32_t tabela_seno[HOUGH_BINS_THETA];
+static pthread_once_t tabelas_preenchidas = PTHREAD_ONCE_INIT;
+
+// Dados compartilhados pelas faixas de `detectar_linhas_hough`.
+typedef struct {
+    const uint8_t *mapa_bordas;
+    int largura;
+    int linhas_por_faixa;
+    int maior_rho;              // Distância máxima à origem (diagonal da imagem, arredondada para cima).
+    int bins_rho;               // 2 * maior_rho + 1 (rho pode ser negativo).
+    int total_acumuladores;
+    uint16_t *acumuladores;     // Um acumulador HOUGH_BINS_THETA x bins_rho por faixa de linhas.
+    uint32_t *acumulador_final;
+} tipo_contexto_hough;
+
+/**
+ * @brief Preenche as tabelas de seno/cosseno (Q10) de cada bin de theta.
+ */
+static void preencher_tabelas_trigonometricas(void) {
+    int theta;
+    for (theta = 0; theta < HOUGH_BINS_THETA; theta++) {
+        double radianos = theta * M_PI / HOUGH_BINS_THETA;
+        tabela_cosseno[theta] = (int32_t)lround(cos(radianos) * (1 << HOUGH_BITS_TRIGONOMETRIA));
+        tabela_seno[theta] = (int32_t)lround(sin(radianos) * (1 << HOUGH_BITS_TRIGONOMETRIA));
+    }
+}
+
+/**
+ * @brief Vota as bordas de uma faixa de linhas no acumulador próprio da faixa.
+ *
+ * Cada faixa tem o seu acumulador, então não há escrita compartilhada entre threads.
+ */
+static void votar_faixa_hough(int linha_inicio, int linha_fim, void *argumento) {
+    tipo_contexto_hough *contexto = (tipo_contexto_hough *)argumento;
+    uint16_t *acumulador = contexto->acumuladores +
+        (size_t)(linha_inicio / contexto->linhas_por_faixa) * HOUGH_BINS_THETA * contexto->bins_rho;
+    // Desloca rho para não negativo antes do deslocamento de bits e arredonda para o bin mais próximo.
+    int32_t deslocamento = (contexto->maior_rho << HOUGH_BITS_TRIGONOMETRIA) + (1 << (HOUGH_BITS_TRIGONOMETRIA - 1));
+    int coord_x, coord_y, theta;
+
+    for (coord_y = linha_inicio; coord_y < linha_fim; coord_y++) {
+        const uint8_t *linha = contexto->mapa_bordas + coord_y * contexto->largura;
+        for (coord_x = 0; coord_x < contexto->largura; coord_x++) {
+            if (linha[coord_x] < HOUGH_LIMIAR_BORDA) continue;
+            uint16_t *coluna_theta = acumulador;
+            for (theta = 0; theta < HOUGH_BINS_THETA; theta++, coluna_theta += contexto->bins_rho) {
+                int32_t rho = coord_x * tabela_cosseno[theta] + coord_y * tabela_seno[theta] + deslocamento;
+                coluna_theta[rho >> HOUGH_BITS_TRIGONOMETRIA]++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Soma os acumuladores das faixas para um intervalo de bins de theta.
+ */
+static void juntar_acumuladores_hough(int theta_inicio, int theta_fim, void *argumento) {
+    tipo_contexto_hough *contexto = (tipo_contexto_hough *)argumento;
+    size_t tamanho_acumulador = (size_t)HOUGH_BINS_THETA * contexto->bins_rho;
+    size_t inicio = (size_t)theta_inicio * contexto->bins_rho, fim = (size_t)theta_fim * contexto->bins_rho, indice;
+    int faixa;
+
+    for (indice = inicio; indice < fim; indice++) contexto->acumulador_final[indice] = 0;
+    for (faixa = 0; faixa < contexto->total_acumuladores; faixa++) {
+        const uint16_t *acumulador = contexto->acumuladores + faixa * tamanho_acumulador;
+        for (indice = inicio; indice < fim; indice++) contexto->acumulador_final[indice] += acumulador[indice];
+    }
+}
+
+/**
+ * @brief Verifica se um bin é o máximo da vizinhança (rho, theta); empates ficam com o primeiro na varredura.
+ */
+static int eh_maximo_hough(const uint32_t *acumulador, int bins_rho, int theta, int indice_rho) {
+    uint32_t votos = acumulador[theta * bins_rho + indice_rho];
+    int desloc_theta, desloc_rho;
+    for (desloc_theta = -HOUGH_RAIO_SUPRESSAO; desloc_theta <= HOUGH_RAIO_SUPRESSAO; desloc_theta++) {
+        int vizinho_theta = theta + desloc_theta;
+        if (vizinho_theta < 0 || vizinho_theta >= HOUGH_BINS_THETA) continue;
+        for (desloc_rho = -HOUGH_RAIO_SUPRESSAO; desloc_rho <= HOUGH_RAIO_SUPRESSAO; desloc_rho++) {
+            int vizinho_rho = indice_rho + desloc_rho;
+            if (vizinho_rho < 0 || vizinho_rho >= bins_rho || (desloc_theta == 0 && desloc_rho == 0)) continue;
+            uint32_t vizinho = acumulador[vizinho_theta * bins_rho + vizinho_rho];
+            if (vizinho > votos) return 0;
+            if (vizinho == votos && (desloc_theta < 0 || (desloc_theta == 0 && desloc_rho < 0))) return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Ordena linhas por votos (decrescente), depois por theta e rho, para uma saída determinística.
+ */
+static int comparar_linhas_hough(const void *primeira, const void *segunda) {
+    const tipo_linha_hough *linha_a = (const tipo_linha_hough *)primeira, *linha_b = (const tipo_linha_hough *)segunda;
+    if (linha_a->votos != linha_b->votos) return linha_b->votos - linha_a->votos;
+    if (linha_a->theta_graus != linha_b->theta_graus) return linha_a->theta_graus - linha_b->theta_graus;
+    return linha_a->rho - linha_b->rho;
+}
+
+/**
+ * @brief Transformada de Hough de linhas sobre um mapa de bordas.
+ *
+ * Os pixels com valor >= HOUGH_LIMIAR_BORDA votam em todos os bins de theta, com rho calculado
+ * pelas tabelas de seno/cosseno em ponto fixo. As linhas da imagem são divididas em uma faixa por
+ * thread, cada uma com seu acumulador; os acumuladores são somados no fim (também em faixas de
+ * theta). Ficam os máximos locais com pelo menos HOUGH_VOTOS_MINIMOS votos.
+ *
+ * @param mapa_bordas Imagem de bordas (largura x altura), p. ex. a saída do filtro ou do Canny.
+ * @param largura Largura da imagem.
+ * @param altura Altura da imagem.
+ * @param linhas Saída com até `max_linhas` linhas, da mais votada para a menos votada.
+ * @param max_linhas Capacidade de `linhas`.
+ * @return Quantidade de linhas devolvidas, ou -1 em caso de falta de memória.
+ */
+int detectar_linhas_hough(const uint8_t *mapa_bordas, int largura, int altura,
+                          tipo_linha_hough *linhas, int max_linhas) {
+    tipo_contexto_hough contexto;
+    tipo_linha_hough *candidatas;
+    int total_candidatas = 0, theta, indice_rho;
+    int total_threads = total_threads_grupo();
+
+    pthread_once(&tabelas_preenchidas, preencher_tabelas_trigonometricas);
+
+    contexto.mapa_bordas = mapa_bordas;
+    contexto.largura = largura;
+    contexto.linhas_por_faixa = (altura + total_threads - 1) / total_threads;
+    contexto.total_acumuladores = (altura + contexto.linhas_por_faixa - 1) / contexto.linhas_por_faixa;
+    contexto.maior_rho = (int)ceil(sqrt((double)largura * largura + (double)altura * altura));
+    contexto.bins_rho = 2 * contexto.maior_rho + 1;
+
+    size_t tamanho_acumulador = (size_t)HOUGH_BINS_THETA * contexto.bins_rho;
+    contexto.acumuladores = calloc((size_t)contexto.total_acumuladores * tamanho_acumulador, sizeof(uint16_t));
+    contexto.acumulador_final = malloc(tamanho_acumulador * sizeof(uint32_t));
+    candidatas = malloc((size_t)max_linhas * sizeof(tipo_linha_hough));
+    if (contexto.acumuladores == NULL || contexto.acumulador_final == NULL || candidatas == NULL) {
+        free(contexto.acumuladores);
+        free(contexto.acumulador_final);
+        free(candidatas);
+        return -1;
+    }
+
+    executar_em_faixas(altura, contexto.linhas_por_faixa, votar_faixa_hough, &contexto);
+    executar_em_faixas(HOUGH_BINS_THETA, (HOUGH_BINS_THETA + total_threads - 1) / total_threads,
+                       juntar_acumuladores_hough, &contexto);
+
+    // Máximos locais; quando o vetor enche, substitui a candidata mais fraca (mantém as `max_linhas` melhores).
+    for (theta = 0; theta < HOUGH_BINS_THETA; theta++) {
+        for (indice_rho = 0; indice_rho < contexto.bins_rho; indice_rho++) {
+            uint32_t votos = contexto.acumulador_final[theta * contexto.bins_rho + indice_rho];
+            if (votos < HOUGH_VOTOS_MINIMOS || !eh_maximo_hough(contexto.acumulador_final, contexto.bins_rho, theta, indice_rho)) continue;
+            tipo_linha_hough linha = { indice_rho - contexto.maior_rho, theta * 180 / HOUGH_BINS_THETA, (int)votos };
+            if (total_candidatas < max_linhas) {
+                candidatas[total_candidatas++] = linha;
+            } else {
+                int mais_fraca = 0, indice;
+                for (indice = 1; indice < total_candidatas; indice++) {
+                    if (comparar_linhas_hough(&candidatas[indice], &candidatas[mais_fraca]) > 0) mais_fraca = indice;
+                }
+                if (comparar_linhas_hough(&linha, &candidatas[mais_fraca]) < 0) candidatas[mais_fraca] = linha;
+            }
+        }
+    }
+
+    qsort(candidatas, (size_t)total_candidatas, sizeof(tipo_linha_hough), comparar_linhas_hough);
+    memcpy(linhas, candidatas, (size_t)total_candidatas * sizeof(tipo_linha_hough));
+
+    free(contexto.acumuladores);
+    free(contexto.acumulador_final);
+    free(candidatas);
+    return total_candidatas;
+}
+
+/**
+ * @brief Salva a lista de linhas em texto: uma linha "rho theta votos" por linha detectada.
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro.
+ */
+int salvar_linhas_hough(const char *caminho_arquivo, const tipo_linha_hough *linhas, int total_linhas) {
+    int indice;
+    FILE *arquivo = fopen(caminho_arquivo, "w");
+    if (arquivo == NULL) {
+        perror("Erro ao criar arquivo de linhas");
+        return -1;
+    }
+    fprintf(arquivo, "# %d linhas (x*cos(theta) + y*sin(theta) = rho)\n# rho theta_graus votos\n", total_linhas);
+    for (indice = 0; indice < total_linhas; indice++) {
+        fprintf(arquivo, "%d %d %d\n", linhas[indice].rho, linhas[indice].theta_graus, linhas[indice].votos);
+    }
+    if (fclose(arquivo) != 0) return -1;
+    printf("Linhas de Hough salvas: %s (%d)\n", caminho_arquivo, total_linhas);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef HOUGH_H
+#define HOUGH_H
+#include <stdint.h>
+
+/* Parâmetros da Transformada de Hough */
+#define HOUGH_BINS_THETA        180   // Ângulos de 0° a 179°, 1° por bin; rho em passos de 1 pixel.
+#define HOUGH_BITS_TRIGONOMETRIA 10   // Seno/cosseno tabelados em ponto fixo Q10.
+#define HOUGH_LIMIAR_BORDA      128   // Pixels do mapa de bordas com valor >= limiar votam.
+#define HOUGH_VOTOS_MINIMOS     20    // Menor quantidade de votos de uma linha devolvida.
+#define HOUGH_RAIO_SUPRESSAO    2     // Vizinhança (rho, theta) da supressão de não máximos.
+#define HOUGH_LINHAS_PADRAO     10
+#define HOUGH_MAX_LINHAS        1000
+
+// Linha x·cos(theta) + y·sin(theta) = rho, com o número de pixels de borda que votaram nela.
+typedef struct {
+    int rho;
+    int theta_graus;
+    int votos;
+} tipo_linha_hough;
+
+int detectar_linhas_hough(const uint8_t *mapa_bordas, int largura, int altura,
+                          tipo_linha_hough *linhas, int max_linhas);
+int salvar_linhas_hough(const char *caminho_arquivo, const tipo_linha_hough *linhas, int total_linhas);
+
+#endif
@@ -20,6 +20,29 @@ extern int initiate_hardware(void);
 extern int terminate_hardware(void);
 extern int transfer_data_to_fpga(const struct Params* p);
 extern int retrieve_fpga_results(uint8_t* result);
+extern uint64_t ciclos_dispositivo_fpga(void);   // Ciclos da co-simulação do RTL (0 no hardware real).
+
+/* Perfil das Transações (lib.s) */
+// Agregados acumulados pelo lib.s com `perfil_fpga_ativo`; mesmo layout dos deslocamentos PERFIL_*.
+typedef struct {
+    uint64_t ciclos_pulsos;               // PMCCNTR: pulsos de reset e start, incluindo o delay_loop.
+    uint64_t ciclos_envio;                // PMCCNTR: os 25 handshakes de transfer_data_to_fpga.
+    uint64_t ciclos_recepcao;             // PMCCNTR: os 25 handshakes de retrieve_fpga_results.
+    uint64_t chamadas_envio;
+    uint64_t chamadas_recepcao;
+    uint64_t leituras_ack_alto_envio;     // Leituras de data_out até o ack subir (handshake_send).
+    uint64_t leituras_ack_baixo_envio;    // Leituras de data_out até o ack descer (handshake_send).
+    uint64_t handshakes_envio;
+    uint64_t leituras_ack_alto_recepcao;  // O mesmo para handshake_receive.
+    uint64_t leituras_ack_baixo_recepcao;
+    uint64_t handshakes_recepcao;
+    uint32_t max_leituras_handshake;      // Maior total de leituras de um único handshake.
+    uint32_t reservado;
+} tipo_perfil_fpga;
+
+extern tipo_perfil_fpga perfil_fpga;
+extern int perfil_fpga_ativo;
+extern int habilitar_perfil_fpga(void);   // Habilita o PMCCNTR; SIGILL se PMUSERENR.EN = 0.
 
 /* Kernels dos Filtros */
 
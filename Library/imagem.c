@@ -0,0 +1,370 @@
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image/stb_image.h"
+#include "stb_image/stb_image_write.h"
+#include <stdio.h>    // Para printf e perror.
+#include <stdlib.h>   // Para abs.
+#include <math.h>     // Para sqrt (magnitude do gradiente).
+#include <string.h>   // Para memset, strncpy e strrchr.
+#include <sys/stat.h> // Para criar o diretório de saída (mkdir).
+#include <errno.h>    // Para distinguir um diretório já existente (EEXIST).
+#include "imagem.h"
+
+// Vetor global para armazenar a janela de pixels (5x5) extraída da imagem em escala de cinza.
+// Usado como entrada para as operações de convolução na FPGA.
+// O tipo `tipo_pixel_imagem` (uint8_t) é usado para os elementos.
+tipo_pixel_imagem janela_global_pixels[TAMANHO_MATRIZ_LINEAR];
+
+/**
+ * @brief Redimensiona uma imagem RGB decodificada para LARGURA_PADRAO_IMG x ALTURA_PADRAO_IMG.
+ * 
+ * Se a imagem já tiver as dimensões corretas, ela é copiada diretamente. Caso contrário, um
+ * redimensionamento simples por vizinho mais próximo (nearest neighbor) é aplicado.
+ * 
+ * @param dados_imagem_bruta Pixels RGB intercalados (largura_original x altura_original x 3), como devolvidos por stbi_load.
+ * @param largura_original Largura da imagem decodificada.
+ * @param altura_original Altura da imagem decodificada.
+ * @param buffer_destino_rgb Matriz 3D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG x 3) onde a imagem RGB redimensionada será armazenada.
+ */
+void redimensionar_imagem_rgb(const unsigned char *dados_imagem_bruta, int largura_original, int altura_original,
+                              unsigned char buffer_destino_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3]) {
+    int coord_y, coord_x; // Variáveis de iteração para loops.
+
+    // Verifica se a imagem já possui as dimensões desejadas.
+    if (largura_original == LARGURA_PADRAO_IMG && altura_original == ALTURA_PADRAO_IMG) {
+        // Copia os dados pixel a pixel para a matriz de saída `buffer_destino_rgb`.
+        for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
+            for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
+                int indice_pixel_origem = (coord_y * LARGURA_PADRAO_IMG + coord_x) * 3; // Calcula o índice linear no buffer de entrada.
+                buffer_destino_rgb[coord_y][coord_x][0] = dados_imagem_bruta[indice_pixel_origem + 0]; // Copia componente R.
+                buffer_destino_rgb[coord_y][coord_x][1] = dados_imagem_bruta[indice_pixel_origem + 1]; // Copia componente G.
+                buffer_destino_rgb[coord_y][coord_x][2] = dados_imagem_bruta[indice_pixel_origem + 2]; // Copia componente B.
+            }
+        }
+        return;
+    }
+
+    // Itera sobre cada pixel da imagem de destino (LARGURA_PADRAO_IMG x ALTURA_PADRAO_IMG).
+    for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
+        for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
+            // Calcula as coordenadas correspondentes na imagem original usando interpolação por vizinho mais próximo.
+            int coord_x_origem = (coord_x * largura_original) / LARGURA_PADRAO_IMG;
+            int coord_y_origem = (coord_y * altura_original) / ALTURA_PADRAO_IMG;
+            
+            // Garante que as coordenadas calculadas não excedam os limites da imagem original.
+            if (coord_x_origem >= largura_original) coord_x_origem = largura_original - 1;
+            if (coord_y_origem >= altura_original) coord_y_origem = altura_original - 1;
+            
+            // Calcula o índice linear do pixel correspondente na imagem original.
+            int indice_pixel_origem = (coord_y_origem * largura_original + coord_x_origem) * 3;
+            // Copia os componentes RGB do pixel original para o pixel de destino.
+            buffer_destino_rgb[coord_y][coord_x][0] = dados_imagem_bruta[indice_pixel_origem + 0];
+            buffer_destino_rgb[coord_y][coord_x][1] = dados_imagem_bruta[indice_pixel_origem + 1];
+            buffer_destino_rgb[coord_y][coord_x][2] = dados_imagem_bruta[indice_pixel_origem + 2];
+        }
+    }
+}
+
+/**
+ * @brief Decodifica um arquivo de imagem em RGB intercalado (3 canais) com a stb_image.
+ *
+ * Imprime as dimensões originais e se a imagem será copiada ou redimensionada.
+ *
+ * @param nome_arquivo O caminho para o arquivo de imagem a ser carregado.
+ * @param largura_original, altura_original Recebem as dimensões da imagem decodificada.
+ * @return Pixels decodificados (liberar com `liberar_imagem_decodificada`), ou NULL em caso de erro.
+ */
+unsigned char *decodificar_imagem_rgb(const char *nome_arquivo, int *largura_original, int *altura_original) {
+    int canais_originais; // Canais do arquivo original (o alfa, se existir, é descartado).
+
+    // Força a carga de 3 canais (RGB), descartando o alfa se existir.
+    unsigned char *dados_imagem_bruta = stbi_load(nome_arquivo, largura_original, altura_original, &canais_originais, 3);
+
+    // Verifica se o carregamento falhou.
+    if (!dados_imagem_bruta) {
+        printf("Erro ao carregar a imagem: %s\n", nome_arquivo);
+        return NULL;
+    }
+
+    printf("Imagem carregada: %s (%dx%d pixels, %d canais)\n", nome_arquivo, *largura_original, *altura_original, canais_originais);
+    if (*largura_original == LARGURA_PADRAO_IMG && *altura_original == ALTURA_PADRAO_IMG) {
+        printf("Dimensões da imagem correspondem ao alvo. Copiando diretamente.\n");
+    } else {
+        printf("Redimensionando de %dx%d para %dx%d usando vizinho mais próximo...\n", *largura_original, *altura_original, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG);
+    }
+    return dados_imagem_bruta;
+}
+
+/**
+ * @brief Libera os pixels devolvidos por `decodificar_imagem_rgb`.
+ */
+void liberar_imagem_decodificada(unsigned char *dados_imagem_bruta) {
+    stbi_image_free(dados_imagem_bruta);
+}
+
+/**
+ * @brief Carrega uma imagem de um arquivo e a redimensiona para as dimensões LARGURA_PADRAO_IMG x ALTURA_PADRAO_IMG.
+ * 
+ * Utiliza `decodificar_imagem_rgb` para carregar a imagem e `redimensionar_imagem_rgb` para
+ * levá-la ao tamanho padrão.
+ * 
+ * @param nome_arquivo O caminho para o arquivo de imagem a ser carregado.
+ * @param buffer_destino_rgb Matriz 3D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG x 3) onde a imagem RGB redimensionada será armazenada.
+ * @return 0 em caso de sucesso, -1 se ocorrer erro ao carregar a imagem.
+ */
+int carregar_e_redimensionar_imagem(const char* nome_arquivo, unsigned char buffer_destino_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3]) {
+    int largura_original, altura_original; // Dimensões da imagem original.
+    unsigned char *dados_imagem_bruta = decodificar_imagem_rgb(nome_arquivo, &largura_original, &altura_original);
+
+    if (!dados_imagem_bruta) return -1; // Retorna erro.
+    redimensionar_imagem_rgb(dados_imagem_bruta, largura_original, altura_original, buffer_destino_rgb);
+    
+    // Libera a memória alocada por stbi_load para os dados da imagem original.
+    liberar_imagem_decodificada(dados_imagem_bruta);
+    return 0; // Retorna sucesso.
+}
+
+/**
+ * @brief Salva um plano em escala de cinza de dimensões arbitrárias em um arquivo PNG.
+ * 
+ * Utiliza a biblioteca stb_image_write. Tenta criar o diretório de saída
+ * se ele não existir.
+ * 
+ * @param nome_arquivo_saida O caminho completo (incluindo nome do arquivo) onde salvar a imagem PNG.
+ * @param dados_plano_cinza Plano (largura x altura, linhas contíguas) com os dados da imagem em escala de cinza.
+ * @param largura Largura do plano (em pixels).
+ * @param altura Altura do plano (em pixels).
+ */
+void salvar_plano_cinza_png(const char* nome_arquivo_saida, const unsigned char *dados_plano_cinza, int largura, int altura) {
+    // Extrai o caminho do diretório a partir do nome completo do arquivo.
+    char caminho_diretorio[256];
+    strncpy(caminho_diretorio, nome_arquivo_saida, sizeof(caminho_diretorio) - 1); // Copia o nome do arquivo para um buffer temporário.
+    caminho_diretorio[sizeof(caminho_diretorio) - 1] = '\0'; // Garante terminação nula.
+    
+    // Encontra a última barra ('/') no caminho.
+    char *ultima_barra = strrchr(caminho_diretorio, '/');
+    if (ultima_barra != NULL) {
+        // Se encontrou uma barra, termina a string ali para obter apenas o caminho do diretório.
+        *ultima_barra = '\0'; 
+        // Tenta criar o diretório. A flag 0777 define as permissões.
+        // Ignora o erro se o diretório já existir (errno == EEXIST).
+        if (mkdir(caminho_diretorio, 0777) == -1 && errno != EEXIST) {
+            perror("Erro ao criar diretório de saída");
+            // Não retorna erro aqui, tenta salvar mesmo assim, pode funcionar se o diretório base existir.
+        }
+    }
+
+    // Tenta salvar a imagem em escala de cinza como PNG usando stbi_write_png.
+    // Parâmetros: nome do arquivo, largura, altura, número de canais (1 para grayscale),
+    // ponteiro para os dados, e stride (número de bytes por linha, que é a largura).
+    if (!stbi_write_png(nome_arquivo_saida, largura, altura, 1, dados_plano_cinza, largura)) {
+        printf("Erro ao salvar PNG: %s\n", nome_arquivo_saida);
+    } else {
+        printf("PNG salvo com sucesso: %s\n", nome_arquivo_saida);
+    }
+}
+
+/**
+ * @brief Salva uma imagem em escala de cinza (tamanho padrão) em um arquivo PNG.
+ * 
+ * @param nome_arquivo_saida O caminho completo (incluindo nome do arquivo) onde salvar a imagem PNG.
+ * @param dados_imagem_cinza Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) contendo os dados da imagem em escala de cinza.
+ */
+void salvar_imagem_cinza_png(const char* nome_arquivo_saida, unsigned char dados_imagem_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]) {
+    salvar_plano_cinza_png(nome_arquivo_saida, &dados_imagem_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG);
+}
+
+/**
+ * @brief Converte uma imagem RGB para escala de cinza.
+ * 
+ * Utiliza a fórmula de luminância padrão (0.299*R + 0.587*G + 0.114*B).
+ * 
+ * @param buffer_entrada_rgb Matriz 3D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG x 3) contendo a imagem RGB de entrada.
+ * @param buffer_saida_cinza Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) onde a imagem em escala de cinza resultante será armazenada.
+ */
+void converter_rgb_para_cinza(unsigned char buffer_entrada_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3], unsigned char buffer_saida_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]) {
+    int coord_y, coord_x; // Variáveis de iteração.
+    // Itera sobre cada pixel da imagem.
+    for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
+        for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
+            // Obtém os componentes R, G, B do pixel atual.
+            unsigned char comp_r = buffer_entrada_rgb[coord_y][coord_x][0];
+            unsigned char comp_g = buffer_entrada_rgb[coord_y][coord_x][1];
+            unsigned char comp_b = buffer_entrada_rgb[coord_y][coord_x][2];
+            // Calcula o valor em escala de cinza usando a fórmula de luminância.
+            // O resultado é convertido para `unsigned char` (0-255).
+            buffer_saida_cinza[coord_y][coord_x] = (unsigned char)(0.299*comp_r + 0.587*comp_g + 0.114*comp_b);
+        }
+    }
+}
+
+/**
+ * @brief Extrai uma janela de pixels (vizinhaça) de um plano em escala de cinza de dimensões arbitrárias.
+ * 
+ * A janela extraída é sempre armazenada no buffer linear global `janela_global_pixels` de tamanho 5x5 (TAMANHO_MATRIZ_LINEAR).
+ * O tamanho real da janela a ser extraída (2x2, 3x3 ou 5x5) é determinado pelo `codigo_tamanho_kernel`.
+ * A janela é posicionada corretamente dentro do buffer 5x5, com padding de zeros se necessário.
+ * Trata o padding nas bordas da imagem atribuindo 0 aos pixels fora dos limites.
+ * 
+ * @param plano Plano de pixels em escala de cinza (largura x altura, linhas contíguas).
+ * @param largura Largura do plano (em pixels).
+ * @param altura Altura do plano (em pixels).
+ * @param centro_x Coordenada X do pixel central da janela na imagem.
+ * @param centro_y Coordenada Y do pixel central da janela na imagem.
+ * @param codigo_tamanho_kernel Código que indica o tamanho da janela a ser extraída:
+ *                  0: Roberts 2x2 (mapeado para canto superior esquerdo do 5x5)
+ *                  1: Sobel/Prewitt 3x3 (mapeado para centro do 5x5)
+ *                  3: Sobel/Laplace 5x5 (usa todo o 5x5)
+ */
+void extrair_janela_plano(const unsigned char *plano, int largura, int altura, int centro_x, int centro_y, uint32_t codigo_tamanho_kernel) {
+    int desloc_y, desloc_x, indice_janela; // Variáveis de iteração e índice.
+    int pixel_x_img, pixel_y_img; // Coordenadas do pixel na imagem original.
+    
+    // Zera completamente o buffer global `janela_global_pixels` (5x5) antes de preenchê-lo.
+    // Isso garante que áreas não preenchidas (padding) contenham zero.
+    memset(janela_global_pixels, 0, TAMANHO_MATRIZ_LINEAR * sizeof(tipo_pixel_imagem));
+    
+    // --- Caso Especial: Roberts 2x2 (codigo_tamanho_kernel == 0) ---
+    if (codigo_tamanho_kernel == 0) {
+        // Itera sobre a janela 2x2.
+        for (desloc_y = 0; desloc_y < 2; desloc_y++) { // Linhas da janela 2x2 (0 a 1)
+            for (desloc_x = 0; desloc_x < 2; desloc_x++) { // Colunas da janela 2x2 (0 a 1)
+                // Calcula as coordenadas do pixel correspondente na imagem original.
+                // O canto superior esquerdo da janela 2x2 corresponde ao pixel (centro_x, centro_y) da imagem.
+                pixel_x_img = centro_x + desloc_x;
+                pixel_y_img = centro_y + desloc_y;
+                
+                // Mapeia a posição (desloc_y, desloc_x) da janela 2x2 para o índice linear `indice_janela`
+                // dentro do buffer global 5x5 (`janela_global_pixels`).
+                // A janela 2x2 é colocada no canto superior esquerdo do buffer 5x5.
+                int linha_no_buffer_5x5 = desloc_y; // Linha 0 ou 1 no buffer 5x5.
+                int coluna_no_buffer_5x5 = desloc_x; // Coluna 0 ou 1 no buffer 5x5.
+                indice_janela = linha_no_buffer_5x5 * 5 + coluna_no_buffer_5x5; // Índice linear (0, 1, 5, 6).
+                
+                // Verifica se as coordenadas (pixel_x_img, pixel_y_img) estão dentro dos limites da imagem.
+                if (pixel_x_img >= 0 && pixel_x_img < largura && pixel_y_img >= 0 && pixel_y_img < altura) {
+                    // Se dentro dos limites, copia o valor do pixel da imagem para a janela.
+                    janela_global_pixels[indice_janela] = (tipo_pixel_imagem)plano[pixel_y_img * largura + pixel_x_img];
+                } else {
+                    // Se fora dos limites (borda da imagem), aplica padding com zero.
+                    // (Já foi feito pelo memset, mas explícito aqui por clareza).
+                    janela_global_pixels[indice_janela] = 0;
+                }
+            }
+        }
+    } 
+    // --- Caso Geral: Janelas 3x3 e 5x5 (codigo_tamanho_kernel == 1 ou 3) ---
+    else {
+        int tamanho_real_janela; // Tamanho da janela (3 ou 5).
+        // Determina o tamanho da janela com base no codigo_tamanho_kernel.
+        switch(codigo_tamanho_kernel) {
+            case 1: tamanho_real_janela = 3; break; // Sobel/Prewitt 3x3
+            case 3: tamanho_real_janela = 5; break; // Sobel 5x5/Laplace 5x5
+            default: tamanho_real_janela = 3; break; // Comportamento padrão (assume 3x3)
+        }
+        
+        // Calcula a metade do tamanho da janela para facilitar a iteração em torno do centro.
+        int metade_tamanho_janela = tamanho_real_janela / 2; // 1 para 3x3, 2 para 5x5.
+        
+        // Itera sobre a vizinhança definida pela janela (de -metade_tamanho_janela a +metade_tamanho_janela em relação ao centro).
+        for (desloc_y = -metade_tamanho_janela; desloc_y <= metade_tamanho_janela; desloc_y++) { // Deslocamento vertical relativo a centro_y.
+            for (desloc_x = -metade_tamanho_janela; desloc_x <= metade_tamanho_janela; desloc_x++) { // Deslocamento horizontal relativo a centro_x.
+                // Calcula as coordenadas absolutas (pixel_x_img, pixel_y_img) do pixel na imagem original.
+                pixel_x_img = centro_x + desloc_x;
+                pixel_y_img = centro_y + desloc_y;
+                
+                // Calcula a posição (linha, coluna) correspondente dentro do buffer 5x5 (`janela_global_pixels`).
+                // O centro da janela (desloc_y=0, desloc_x=0) corresponde ao centro do buffer 5x5 (linha 2, coluna 2).
+                int linha_no_buffer_5x5 = desloc_y + 2; // Mapeia -1..1 (3x3) ou -2..2 (5x5) para 1..3 ou 0..4.
+                int coluna_no_buffer_5x5 = desloc_x + 2; // Mapeia -1..1 (3x3) ou -2..2 (5x5) para 1..3 ou 0..4.
+                indice_janela = linha_no_buffer_5x5 * 5 + coluna_no_buffer_5x5; // Calcula o índice linear no buffer 5x5.
+                
+                // Verifica se as coordenadas (pixel_x_img, pixel_y_img) estão dentro dos limites da imagem.
+                if (pixel_x_img >= 0 && pixel_x_img < largura && pixel_y_img >= 0 && pixel_y_img < altura) {
+                    // Se dentro dos limites, copia o valor do pixel da imagem para a janela.
+                    janela_global_pixels[indice_janela] = (tipo_pixel_imagem)plano[pixel_y_img * largura + pixel_x_img];
+                } else {
+                    // Se fora dos limites (borda da imagem), aplica padding com zero.
+                    // (Já foi feito pelo memset).
+                    janela_global_pixels[indice_janela] = 0;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Extrai uma janela de pixels (vizinhaça) da imagem em escala de cinza no tamanho padrão.
+ * 
+ * Equivalente a `extrair_janela_plano` para uma matriz ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG.
+ * 
+ * @param imagem_cinza Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) da imagem em escala de cinza.
+ * @param centro_x Coordenada X do pixel central da janela na imagem.
+ * @param centro_y Coordenada Y do pixel central da janela na imagem.
+ * @param codigo_tamanho_kernel Código que indica o tamanho da janela a ser extraída (0, 1 ou 3).
+ */
+void extrair_janela_vizinhanca_linear(unsigned char imagem_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG], int centro_x, int centro_y, uint32_t codigo_tamanho_kernel) {
+    extrair_janela_plano(&imagem_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, centro_x, centro_y, codigo_tamanho_kernel);
+}
+
+/**
+ * @brief Satura um valor de resultado de convolução para a faixa válida de pixel (0 a 255).
+ * 
+ * Se o valor for menor que 0, retorna 0.
+ * Se o valor for maior que 255, retorna 255.
+ * Caso contrário, retorna o próprio valor convertido para `unsigned char`.
+ * 
+ * @param valor_entrada O valor `tipo_resultado_conv` (int16_t) a ser saturado.
+ * @return O valor saturado como `unsigned char`.
+ */
+unsigned char saturar_valor_pixel(tipo_resultado_conv valor_entrada) {
+    if (valor_entrada < 0) return 0;
+    if (valor_entrada > 255) return 255;
+    return (unsigned char)valor_entrada;
+}
+
+/**
+ * @brief Calcula a imagem de bordas a partir dos gradientes (fase de magnitude de `aplicar_filtro_plano`).
+ *
+ * Com Gy, a magnitude Euclidiana sqrt(Gx² + Gy²); sem Gy (filtros como Laplace), |Gx|. O valor é
+ * saturado para 0-255 e, se `histograma_magnitude` não for NULL, contado no histograma.
+ *
+ * @param buffer_gradiente_x Gx de cada pixel.
+ * @param buffer_gradiente_y Gy de cada pixel, ou NULL para filtros unidirecionais.
+ * @param total_pixels Quantidade de pixels dos buffers.
+ * @param buffer_resultado_final Saída de 8 bits (total_pixels posições).
+ * @param histograma_magnitude Histograma (256 bins) acumulado aqui, ou NULL.
+ */
+void calcular_magnitude_plano(const tipo_resultado_conv *buffer_gradiente_x, const tipo_resultado_conv *buffer_gradiente_y,
+                              int total_pixels, unsigned char *buffer_resultado_final, uint32_t *histograma_magnitude) {
+    int indice_pixel; // Variável de iteração.
+
+    // --- Caso: Filtro Unidirecional (Laplace) --- 
+    if (buffer_gradiente_y == NULL) {
+        // Itera sobre cada pixel.
+        for (indice_pixel = 0; indice_pixel < total_pixels; indice_pixel++) {
+            // Para filtros como Laplace, o resultado Gx já representa a resposta do filtro.
+            // Calcula o valor absoluto do resultado da convolução Gx.
+            tipo_resultado_conv valor_absoluto_gx = abs(buffer_gradiente_x[indice_pixel]);
+            // Satura o valor absoluto para a faixa 0-255 e armazena no buffer final.
+            buffer_resultado_final[indice_pixel] = saturar_valor_pixel(valor_absoluto_gx);
+            if (histograma_magnitude != NULL) histograma_magnitude[buffer_resultado_final[indice_pixel]]++;
+        }
+        return;
+    }
+
+    // Itera sobre cada pixel.
+    for (indice_pixel = 0; indice_pixel < total_pixels; indice_pixel++) {
+        // Obtém os resultados Gx e Gy dos buffers.
+        tipo_resultado_conv valor_gx = buffer_gradiente_x[indice_pixel];
+        tipo_resultado_conv valor_gy = buffer_gradiente_y[indice_pixel];
+        
+        // Calcula a magnitude Euclidiana: sqrt(Gx*Gx + Gy*Gy).
+        // Usa `double` para a conta intermediária para evitar overflow e perda de precisão.
+        tipo_resultado_conv magnitude_gradiente = (tipo_resultado_conv)sqrt((double)(valor_gx * valor_gx + valor_gy * valor_gy));
+        
+        // Satura o valor da magnitude para a faixa 0-255 e armazena no buffer final.
+        buffer_resultado_final[indice_pixel] = saturar_valor_pixel(magnitude_gradiente);
+        if (histograma_magnitude != NULL) histograma_magnitude[buffer_resultado_final[indice_pixel]]++;
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef IMAGEM_H
+#define IMAGEM_H
+#include <stdint.h>
+#include "filtros.h"
+
+/* Dimensões das Imagens Processadas */
+#define TAMANHO_MATRIZ_LINEAR 25  // Tamanho linear da matriz/janela usada nas operações (5x5 = 25).
+#define LARGURA_PADRAO_IMG 320    // Largura padrão das imagens processadas (em pixels).
+#define ALTURA_PADRAO_IMG 240     // Altura padrão das imagens processadas (em pixels).
+
+/* Janela Enviada à FPGA */
+extern tipo_pixel_imagem janela_global_pixels[TAMANHO_MATRIZ_LINEAR];
+
+/* Leitura e Gravação */
+void redimensionar_imagem_rgb(const unsigned char *dados_imagem_bruta, int largura_original, int altura_original,
+                              unsigned char buffer_destino_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3]);
+unsigned char *decodificar_imagem_rgb(const char *nome_arquivo, int *largura_original, int *altura_original);
+void liberar_imagem_decodificada(unsigned char *dados_imagem_bruta);
+int carregar_e_redimensionar_imagem(const char* nome_arquivo, unsigned char buffer_destino_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3]);
+void salvar_plano_cinza_png(const char* nome_arquivo_saida, const unsigned char *dados_plano_cinza, int largura, int altura);
+void salvar_imagem_cinza_png(const char* nome_arquivo_saida, unsigned char dados_imagem_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]);
+
+/* Etapas por Pixel */
+void converter_rgb_para_cinza(unsigned char buffer_entrada_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3], unsigned char buffer_saida_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]);
+void extrair_janela_plano(const unsigned char *plano, int largura, int altura, int centro_x, int centro_y, uint32_t codigo_tamanho_kernel);
+void extrair_janela_vizinhanca_linear(unsigned char imagem_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG], int centro_x, int centro_y, uint32_t codigo_tamanho_kernel);
+unsigned char saturar_valor_pixel(tipo_resultado_conv valor_entrada);
+void calcular_magnitude_plano(const tipo_resultado_conv *buffer_gradiente_x, const tipo_resultado_conv *buffer_gradiente_y,
+                              int total_pixels, unsigned char *buffer_resultado_final, uint32_t *histograma_magnitude);
+
+#endif
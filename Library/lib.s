@@ -1,5 +1,31 @@
 .equ DELAY_CYCLES, 10              @ Define um valor de delay entre sinais para sincronização
 
+@ Deslocamentos em perfil_fpga (mesmo layout de tipo_perfil_fpga em hps_0.h)
+.equ PERFIL_CICLOS_PULSOS, 0       @ PMCCNTR: pulsos de reset e start, incluindo o delay_loop
+.equ PERFIL_CICLOS_ENVIO, 8        @ PMCCNTR: os 25 handshake_send
+.equ PERFIL_CICLOS_RECEPCAO, 16    @ PMCCNTR: os 25 handshake_receive
+.equ PERFIL_CHAMADAS_ENVIO, 24
+.equ PERFIL_CHAMADAS_RECEPCAO, 32
+.equ PERFIL_BLOCO_ENVIO, 40        @ Leituras com ack alto, com ack baixo e handshakes do envio
+.equ PERFIL_BLOCO_RECEPCAO, 64     @ O mesmo para a recepção
+.equ PERFIL_MAX_LEITURAS, 88       @ Maior total de leituras de um único handshake (32 bits)
+.equ PERFIL_TAMANHO, 96
+
+@ Soma \valor (32 bits) ao contador de 64 bits em [\base, #\deslocamento]
+.macro SOMAR_64 base, deslocamento, valor, baixo, alto
+    LDR \baixo, [\base, #\deslocamento]
+    LDR \alto, [\base, #(\deslocamento + 4)]
+    ADDS \baixo, \baixo, \valor
+    ADC \alto, \alto, #0
+    STR \baixo, [\base, #\deslocamento]
+    STR \alto, [\base, #(\deslocamento + 4)]
+.endm
+
+@ Lê o contador de ciclos (PMCCNTR); só pode ser usado com perfil_fpga_ativo
+.macro LER_CICLOS destino
+    MRC p15, 0, \destino, c9, c13, 0
+.endm
+
 .section .data
 devmem_path: .asciz "/dev/mem"    @ Caminho do dispositivo para acessar memória física
 LW_BRIDGE_BASE: .word 0xff200     @ Endereço base da ponte LW (Lightweight Bridge)
@@ -14,6 +40,13 @@ data_out_ptr: .word 0             @ Ponteiro para a interface de saída da FPGA
 .global fd_mem 
 fd_mem: .space 4                  @ Espaço para armazenar o descritor de arquivo de /dev/mem
 
+.global perfil_fpga_ativo
+perfil_fpga_ativo: .word 0        @ 1: mede ciclos por fase e conta as leituras de cada handshake
+
+.global perfil_fpga
+.balign 8
+perfil_fpga: .space PERFIL_TAMANHO  @ Agregados do perfil (zerados pelo lado C)
+
 .section .text  
 
 .global initiate_hardware
@@ -119,6 +152,32 @@ skip_close:
     POP {r4-r7, lr}
     BX lr
 
+@ Ciclos simulados da co-simulação do RTL: sempre 0 no hardware real (uint64_t em r0:r1)
+.global ciclos_dispositivo_fpga
+.type ciclos_dispositivo_fpga, %function
+ciclos_dispositivo_fpga:
+    MOV r0, #0
+    MOV r1, #0
+    BX lr
+
+@ Habilita o PMCCNTR e liga o perfil das transações.
+@ Em modo usuário, exige PMUSERENR.EN = 1 (configurado pelo kernel); caso contrário, gera SIGILL.
+.global habilitar_perfil_fpga
+.type habilitar_perfil_fpga, %function
+habilitar_perfil_fpga:
+    MRC p15, 0, r0, c9, c12, 0          @ PMCR
+    ORR r0, r0, #1                      @ E = 1: habilita os contadores
+    BIC r0, r0, #8                      @ D = 0: PMCCNTR conta todo ciclo (não 1 a cada 64)
+    MCR p15, 0, r0, c9, c12, 0
+    MOV r0, #(1 << 31)                  @ Bit C do PMCNTENSET: habilita o PMCCNTR
+    MCR p15, 0, r0, c9, c12, 1
+
+    LDR r1, =perfil_fpga_ativo
+    MOV r0, #1
+    STR r0, [r1]
+    MOV r0, #0
+    BX lr
+
 @ Envia todos os dados à FPGA
 .global transfer_data_to_fpga
 .type transfer_data_to_fpga, %function
@@ -131,6 +190,12 @@ transfer_data_to_fpga:
     LDR r6, [r0, #8]                    @ opcode
     LDR r7, [r0, #12]                   @ parâmetro extra (flags)
 
+    @ Perfil: r3 = perfil_fpga_ativo (preservado pelos handshakes), r8 = PMCCNTR no início da fase
+    LDR r3, =perfil_fpga_ativo
+    LDR r3, [r3]
+    CMP r3, #0
+    MRCNE p15, 0, r8, c9, c13, 0
+
     @ Gera pulso de reset e start
     LDR r2, =data_in_ptr
     LDR r2, [r2]
@@ -150,6 +215,15 @@ transfer_data_to_fpga:
     MOV r0, #0
     STR r0, [r2]
 
+    CMP r3, #0                          @ Perfil: ciclos dos pulsos
+    BEQ perfil_pulsos_fim
+    LER_CICLOS r12
+    SUB r0, r12, r8
+    MOV r8, r12
+    LDR r1, =perfil_fpga
+    SOMAR_64 r1, PERFIL_CICLOS_PULSOS, r0, r2, r12
+perfil_pulsos_fim:
+
     MOV r9, #25                         @ Tamanho dos dados
     MOV r10, #0                         @ Índice
 
@@ -179,6 +253,15 @@ loop_send:
     B loop_send
 
 end_send:
+    CMP r3, #0                          @ Perfil: ciclos do envio e chamada concluída
+    BEQ perfil_envio_fim
+    LER_CICLOS r12
+    SUB r0, r12, r8
+    LDR r1, =perfil_fpga
+    SOMAR_64 r1, PERFIL_CICLOS_ENVIO, r0, r2, r12
+    MOV r0, #1
+    SOMAR_64 r1, PERFIL_CHAMADAS_ENVIO, r0, r2, r12
+perfil_envio_fim:
     MOV r0, #0
     POP {r4-r11, lr}
     BX lr
@@ -193,12 +276,18 @@ delay_loop:
 .global retrieve_fpga_results
 .type retrieve_fpga_results, %function
 retrieve_fpga_results:
-    PUSH {r4-r7, lr}
+    PUSH {r4-r8, lr}
 
     MOV r4, r0                          @ Ponteiro de destino
     MOV r6, #25                         @ Tamanho da saída
     MOV r7, #0                          @ Índice
 
+    @ Perfil: r5 = perfil_fpga_ativo, r8 = PMCCNTR no início da recepção
+    LDR r5, =perfil_fpga_ativo
+    LDR r5, [r5]
+    CMP r5, #0
+    MRCNE p15, 0, r8, c9, c13, 0
+
 .loop_recv:
     CMP r7, r6
     BGE .done
@@ -221,16 +310,27 @@ retrieve_fpga_results:
     MOV r0, #0
 
 .exit:
-    POP {r4-r7, lr}
+    CMP r5, #0                          @ Perfil: ciclos da recepção e chamada (com ou sem erro)
+    BEQ perfil_recepcao_fim
+    LER_CICLOS r12
+    SUB r1, r12, r8
+    LDR r2, =perfil_fpga
+    SOMAR_64 r2, PERFIL_CICLOS_RECEPCAO, r1, r3, r12
+    MOV r1, #1
+    SOMAR_64 r2, PERFIL_CHAMADAS_RECEPCAO, r1, r3, r12
+perfil_recepcao_fim:
+    POP {r4-r8, lr}
     BX lr
 
 @ void handshake_send(uint32_t value)
 handshake_send:
-    PUSH {r1-r4, lr}
+    PUSH {r1-r7, lr}
     LDR r1, =data_in_ptr
     LDR r1, [r1]
     LDR r2, =data_out_ptr
     LDR r2, [r2]
+    MOV r5, #0                          @ Leituras até o ack subir
+    MOV r6, #0                          @ Leituras até o ack descer
 
     @ Passo 1: Envia valor com bit 31 = 1 (ready)
     ORR r3, r0, #(1 << 31)
@@ -238,6 +338,7 @@ handshake_send:
 
 .wait_ack_high_send:
     LDR r4, [r2]
+    ADD r5, r5, #1
     TST r4, #(1 << 31)
     BEQ .wait_ack_high_send            @ Aguarda ack da FPGA
 
@@ -246,15 +347,19 @@ handshake_send:
 
 .wait_ack_low_send:
     LDR r4, [r2]
+    ADD r6, r6, #1
     TST r4, #(1 << 31)
     BNE .wait_ack_low_send             @ Aguarda fim do ack
 
-    POP {r1-r4, lr}
+    MOV r3, #PERFIL_BLOCO_ENVIO
+    BL acumular_leituras_handshake
+
+    POP {r1-r7, lr}
     BX lr
 
 @ int handshake_receive(uint8_t* value_out)
 handshake_receive:
-    PUSH {r2-r5, lr}
+    PUSH {r1-r8, lr}
     LDR r2, =data_in_ptr
     LDR r2, [r2]
     LDR r3, =data_out_ptr
@@ -265,26 +370,34 @@ handshake_receive:
     CMP r3, #0
     BEQ .handshake_error
 
+    MOV r5, #0                          @ Leituras até o ack subir
+    MOV r6, #0                          @ Leituras até o ack descer
+
     @ Envia ready para FPGA
     MOV r4, #(1 << 31)
     STR r4, [r2]
 
 .wait_ack_high_recei:
-    LDR r5, [r3]
-    TST r5, #(1 << 31)
+    LDR r8, [r3]
+    ADD r5, r5, #1
+    TST r8, #(1 << 31)
     BEQ .wait_ack_high_recei
 
-    AND r4, r5, #0xFF                   @ Extrai os dados (bits 0-7)
+    AND r4, r8, #0xFF                   @ Extrai os dados (bits 0-7)
     STRB r4, [r0]
 
     MOV r4, #0
     STR r4, [r2]
 
 .wait_ack_low_recei:
-    LDR r5, [r3]
-    TST r5, #(1 << 31)
+    LDR r8, [r3]
+    ADD r6, r6, #1
+    TST r8, #(1 << 31)
     BNE .wait_ack_low_recei
 
+    MOV r3, #PERFIL_BLOCO_RECEPCAO
+    BL acumular_leituras_handshake
+
     MOV r0, #0
     B .handshake_exit
 
@@ -292,6 +405,28 @@ handshake_receive:
     MOV r0, #1
 
 .handshake_exit:
-    POP {r2-r5, lr}
+    POP {r1-r8, lr}
+    BX lr
+
+@ Perfil: soma as leituras de um handshake (r5: ack alto, r6: ack baixo) ao bloco em
+@ perfil_fpga + r3 (leituras alto, leituras baixo, handshakes) e atualiza o máximo.
+@ Não faz nada sem perfil_fpga_ativo. Altera r1, r2, r4 e r7.
+acumular_leituras_handshake:
+    LDR r1, =perfil_fpga_ativo
+    LDR r1, [r1]
+    CMP r1, #0
+    BXEQ lr
+
+    LDR r1, =perfil_fpga
+    ADD r7, r5, r6                      @ Total deste handshake
+    LDR r2, [r1, #PERFIL_MAX_LEITURAS]
+    CMP r7, r2
+    STRHI r7, [r1, #PERFIL_MAX_LEITURAS]
+
+    ADD r1, r1, r3
+    SOMAR_64 r1, 0, r5, r2, r4
+    SOMAR_64 r1, 8, r6, r2, r4
+    MOV r7, #1
+    SOMAR_64 r1, 16, r7, r2, r4
     BX lr
 
@@ -1,347 +1,131 @@
-#define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "stb_image/stb_image.h"
-#include "stb_image/stb_image_write.h"
 #include <stdint.h>   // Para tipos inteiros de tamanho fixo (uint8_t, int16_t, etc.).
 #include <stdio.h>    // Para funções de entrada/saída padrão (printf, scanf, fopen, etc.).
 #include <stdlib.h>   // Para funções utilitárias gerais (malloc, free, exit, atoi, etc.).
-#include <math.h>     // Para funções matemáticas (sqrt).
 #include <string.h>   // Para funções de manipulação de strings (strcpy, strcmp, memset, etc.).
 #include <dirent.h>   // Para operações de diretório (opendir, readdir, closedir).
 #include <sys/stat.h> // Para obter informações sobre arquivos e criar diretórios (mkdir).
 #include <errno.h>    // Para lidar com códigos de erro do sistema (errno).
+#include <pthread.h>  // Para a thread de refinamento em segundo plano (modo progressivo).
+#include <stdatomic.h> // Para o sinal de cancelamento compartilhado com a thread de refinamento.
+#include <unistd.h>   // Para sysconf (quantidade de processadores).
 #include "hps_0.h"
+#include "filtros.h" // Registro de filtros, tipos de pixel/resultado e motores de convolução em CPU.
+#include "imagem.h"   // Leitura/gravação de imagens (stb_image), conversão para cinza, janelas e magnitude.
+#include "paralelo.h" // Grupo de threads que divide o trabalho de CPU em faixas de linhas.
+#include "canny.h"    // Detector de Canny sobre os gradientes Gx/Gy.
+#include "exportacao.h" // Exportação dos gradientes em .npy/raw.
+#include "cantos.h"   // Detector de cantos (Harris / Shi-Tomasi) sobre os gradientes.
+#include "hog.h"      // Descritor HOG (histogramas de gradientes orientados).
+#include "hough.h"    // Transformada de Hough de linhas sobre a imagem de bordas.
+#include "mascara.h"  // Máscaras de bordas de 1 bit por pixel (limiar de Otsu/percentil, RLE).
+#include "suavizacao.h" // Pré-suavização binomial e LoG fundido.
+#include "cor.h"        // Bordas coloridas (máximo por canal ou Di Zenzo).
+#include "estatisticas.h" // Tempos por etapa, contadores e memória em JSON (--stats).
+#include "rastro.h"       // Linha do tempo de etapas, imagens e threads em JSON do Chrome (--rastro).
+#include "contadores_hw.h" // Contadores de desempenho do processador por etapa (--contadores-hw).
+#include "metricas.h"     // Contadores e histogramas de latência em texto do Prometheus (--metricas).
+#include "perfil_fpga.h"  // Ciclos por fase e leituras por handshake medidos no lib.s (--perfil-fpga).
 
-// Define o tamanho linear da matriz/janela usada nas operações (5x5 = 25).
-#define TAMANHO_MATRIZ_LINEAR 25
-// Define a largura padrão das imagens processadas (em pixels).
-#define LARGURA_PADRAO_IMG 320
-// Define a altura padrão das imagens processadas (em pixels).
-#define ALTURA_PADRAO_IMG 240
-
-// --- Typedefs Globais ---
-
-// Define um tipo `tipo_pixel_imagem` como `uint8_t` (inteiro sem sinal de 8 bits) para representar os valores dos pixels da imagem de entrada (0-255).
-// Usado para a janela de pixels extraída da imagem.
-// Aumenta a clareza e facilita a modificação futura do tipo de pixel.
-typedef uint8_t tipo_pixel_imagem;
-// Define um tipo `tipo_resultado_conv` como `int16_t` (inteiro com sinal de 16 bits) para representar os resultados das operações de convolução.
-// O resultado pode ser negativo ou exceder 255, necessitando de maior alcance e sinal.
-typedef int16_t tipo_resultado_conv;
+// Dimensões da prévia do modo progressivo (imagem dizimada por 2 em cada eixo).
+#define LARGURA_PREVIA_IMG (LARGURA_PADRAO_IMG / 2)
+#define ALTURA_PREVIA_IMG (ALTURA_PADRAO_IMG / 2)
+// Limite de `--cantos-max` (tamanho do vetor de cantos de cada imagem).
+#define MAX_CANTOS_SUPORTADOS 10000
+// Quantidade máxima de níveis da pirâmide multiescala (nível 4: 20x15 pixels).
+#define MAX_NIVEIS_PIRAMIDE 5
 
 // --- Variáveis Globais ---
 
 // Matriz 2D global para armazenar a versão em escala de cinza da imagem carregada.
 // Dimensões definidas por ALTURA_PADRAO_IMG e LARGURA_PADRAO_IMG.
 unsigned char imagem_global_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG];
-// Vetor global para armazenar a janela de pixels (5x5) extraída da imagem em escala de cinza.
-// Usado como entrada para as operações de convolução na FPGA.
-// O tipo `tipo_pixel_imagem` (uint8_t) é usado para os elementos.
-tipo_pixel_imagem janela_global_pixels[TAMANHO_MATRIZ_LINEAR];
-
-/* ========== DEFINIÇÕES DOS KERNELS DOS FILTROS ========== */
-// Kernels pré-definidos para diferentes filtros de detecção de borda.
-// Todos são representados como matrizes lineares de `TAMANHO_MATRIZ_LINEAR` (25) elementos `int8_t`,
-// mesmo que o kernel original seja menor (e.g., 3x3 ou 2x2). Os elementos não utilizados
-// são preenchidos com zero para compatibilidade com a interface da FPGA que espera uma matriz 5x5.
-// **NOTA:** Os nomes dos kernels foram mantidos para possível compatibilidade externa ou convenção.
-
-// --- Kernel Sobel 3x3 --- 
-int8_t sobel_gx_3x3[TAMANHO_MATRIZ_LINEAR] = {
-     0,  0,  0,  0,  0,   // linha 0 (padding)
-     0, -1,  0,  1,  0,   // linha 1 (kernel original)
-     0, -2,  0,  2,  0,   // linha 2 (kernel original)
-     0, -1,  0,  1,  0,   // linha 3 (kernel original)
-     0,  0,  0,  0,  0    // linha 4 (padding)
-};
-int8_t sobel_gy_3x3[TAMANHO_MATRIZ_LINEAR] = {
-     0,  0,  0,  0,  0,   // linha 0 (padding)
-     0, -1, -2, -1,  0,   // linha 1 (kernel original)
-     0,  0,  0,  0,  0,   // linha 2 (kernel original)
-     0,  1,  2,  1,  0,   // linha 3 (kernel original)
-     0,  0,  0,  0,  0    // linha 4 (padding)
-};
-
-// --- Kernel Sobel 5x5 --- 
-int8_t sobel_gx_5x5[TAMANHO_MATRIZ_LINEAR] = {
-     2,  2,  4,  2,  2,   // linha 0
-     1,  1,  2,  1,  1,   // linha 1
-     0,  0,  0,  0,  0,   // linha 2
-    -1, -1, -2, -1, -1,   // linha 3
-    -2, -2, -4, -2, -2    // linha 4
-};
-int8_t sobel_gy_5x5[TAMANHO_MATRIZ_LINEAR] = {
-     2,  1,  0, -1, -2,   // linha 0
-     2,  1,  0, -1, -2,   // linha 1
-     4,  2,  0, -2, -4,   // linha 2
-     2,  1,  0, -1, -2,   // linha 3
-     2,  1,  0, -1, -2,   // linha 4
-};
+// Sinaliza à thread de refinamento (modo progressivo) que o operador passou para outra operação.
+atomic_int refinamento_cancelado;
+// Marca que o cálculo da imagem em refinamento parou no meio (só o caminho da FPGA para entre linhas).
+static atomic_int refinamento_interrompido;
 
-// --- Kernel Prewitt 3x3 --- 
-int8_t prewitt_gx_3x3[TAMANHO_MATRIZ_LINEAR] = {
-     0,  0,  0,  0,  0,   // linha 0 (padding)
-     0, -1,  0,  1,  0,   // linha 1 (kernel original)
-     0, -1,  0,  1,  0,   // linha 2 (kernel original)
-     0, -1,  0,  1,  0,   // linha 3 (kernel original)
-     0,  0,  0,  0,  0    // linha 4 (padding)
-};
-int8_t prewitt_gy_3x3[TAMANHO_MATRIZ_LINEAR] = {
-     0,  0,  0,  0,  0,   // linha 0 (padding)
-     0, -1, -1, -1,  0,   // linha 1 (kernel original)
-     0,  0,  0,  0,  0,   // linha 2 (kernel original)
-     0,  1,  1,  1,  0,   // linha 3 (kernel original)
-     0,  0,  0,  0,  0    // linha 4 (padding)
-};
+// Configuração da execução, preenchida a partir dos argumentos de linha de comando.
+typedef struct {
+    int usar_motor_cpu;           // 1: convolução nos motores de CPU (filtros.c); 0: coprocessador na FPGA.
+    const char *arquivo_filtros;  // Arquivo texto com o registro de filtros.
+    int modo_progressivo;         // 1: salva prévias em meia resolução e refina em segundo plano.
+    int limiar_bloco_plano;       // Amplitude máxima de um bloco plano na pré-passada; negativo desativa.
+    int niveis_piramide;          // Níveis da pirâmide multiescala (0: desativada).
+    int piramide_composta;        // 1: salva o máximo entre escalas; 0: um PNG por nível.
+    int total_threads;            // Threads do grupo usado pelos motores de CPU e pelo Canny (0: uma por processador).
+    int usar_canny;               // 1: substitui a magnitude pelo detector de Canny (filtros com Gy).
+    int canny_limiar_baixo;       // Limiares de magnitude da histerese do Canny.
+    int canny_limiar_alto;
+    tipo_formato_exportacao formato_exportacao; // Exporta Gx/Gy/magnitude/orientação em vez do PNG.
+    tipo_metodo_cantos metodo_cantos;           // Detector de cantos aplicado aos gradientes (ou desativado).
+    int max_cantos;                             // Quantidade máxima de cantos salvos por imagem.
+    int usar_hog;                               // Salva o descritor HOG de cada imagem.
+    int hog_tamanho_celula;                     // Lado da célula HOG, em pixels.
+    int hog_celulas_bloco;                      // Lado do bloco de normalização HOG, em células.
+    int max_linhas_hough;                       // Linhas de Hough salvas por imagem (0 = desativado).
+    tipo_limiar_mascara limiar_mascara;         // Grava uma máscara binária em vez do PNG (ou desativado).
+    int percentil_mascara;                      // Percentil usado com MASCARA_PERCENTIL.
+    tipo_formato_mascara formato_mascara;       // Máscara em bits empacotados ou RLE.
+    int lado_suavizacao;                        // Pré-suavização binomial (3 ou 5 taps; 0 = desativada).
+    int usar_log_fundido;                       // Suavização e kernel numa só varredura (LoG), quando possível.
+    tipo_combinacao_cor combinacao_cor;         // Filtra os três canais RGB e combina as respostas (ou desativado).
+    const char *diretorio_entrada;              // Diretório com as imagens de entrada.
+    const char *diretorio_saida;                // Diretório onde os resultados são gravados.
+    const char *arquivo_estatisticas;           // JSON Lines com as estatísticas de cada imagem e da execução (NULL: desativado).
+    const char *arquivo_rastro;                 // Linha do tempo em JSON do Chrome/Perfetto (NULL: desativado).
+    int usar_contadores_hw;                     // Acrescenta ciclos, instruções e falhas por etapa às estatísticas.
+    const char *arquivo_metricas;               // Arquivo .prom regravado periodicamente (NULL: desativado).
+    int intervalo_metricas;                     // Segundos entre as gravações do arquivo de métricas.
+    int usar_perfil_fpga;                       // Mede as fases das transações no lib.s e imprime o resumo no fim.
+} tipo_configuracao_execucao;
 
-// --- Kernel Roberts 2x2 --- 
-int8_t roberts_gx_2x2[TAMANHO_MATRIZ_LINEAR] = {
-     1,  0,  0,  0,  0,   // linha 0 (kernel original)
-     0, -1,  0,  0,  0,   // linha 1 (kernel original)
-     0,  0,  0,  0,  0,   // linha 2 (padding)
-     0,  0,  0,  0,  0,   // linha 3 (padding)
-     0,  0,  0,  0,  0    // linha 4 (padding)
+// Configuração global da execução (padrão: FPGA, registro em `ARQUIVO_FILTROS_PADRAO`, sem modo progressivo,
+// pré-passada exata: só blocos de valor constante são pulados, uma thread, magnitude do gradiente).
+// Campos omitidos valem zero (desativado).
+tipo_configuracao_execucao configuracao_execucao = {
+    .usar_motor_cpu = 0,
+    .arquivo_filtros = ARQUIVO_FILTROS_PADRAO,
+    .modo_progressivo = 0,
+    .limiar_bloco_plano = 0,
+    .niveis_piramide = 0,
+    .piramide_composta = 0,
+    .total_threads = 1,
+    .usar_canny = 0,
+    .canny_limiar_baixo = CANNY_LIMIAR_BAIXO_PADRAO,
+    .canny_limiar_alto = CANNY_LIMIAR_ALTO_PADRAO,
+    .formato_exportacao = EXPORTACAO_NENHUMA,
+    .metodo_cantos = CANTOS_DESATIVADO,
+    .max_cantos = MAX_CANTOS_PADRAO,
+    .usar_hog = 0,
+    .hog_tamanho_celula = HOG_TAMANHO_CELULA_PADRAO,
+    .hog_celulas_bloco = HOG_CELULAS_BLOCO_PADRAO,
+    .max_linhas_hough = 0,
+    .limiar_mascara = MASCARA_DESATIVADA,
+    .percentil_mascara = 0,
+    .formato_mascara = MASCARA_BITS,
+    .lado_suavizacao = 0,
+    .usar_log_fundido = 0,
+    .combinacao_cor = COR_DESATIVADA,
+    .diretorio_entrada = "input",
+    .diretorio_saida = "output",
+    .arquivo_estatisticas = NULL,
+    .arquivo_rastro = NULL,
+    .usar_contadores_hw = 0,
+    .arquivo_metricas = NULL,
+    .intervalo_metricas = METRICAS_INTERVALO_PADRAO,
+    .usar_perfil_fpga = 0,
 };
-int8_t roberts_gy_2x2[TAMANHO_MATRIZ_LINEAR] = {
-     0,  1,  0,  0,  0,   // linha 0 (kernel original)
-    -1,  0,  0,  0,  0,   // linha 1 (kernel original)
-     0,  0,  0,  0,  0,   // linha 2 (padding)
-     0,  0,  0,  0,  0,   // linha 3 (padding)
-     0,  0,  0,  0,  0    // linha 4 (padding)
-};
-
-// --- Kernel Laplaciano 5x5 --- 
-int8_t laplace_5x5[TAMANHO_MATRIZ_LINEAR] = {
-     0,  0, -1,  0,  0,   // linha 0
-     0, -1, -2, -1,  0,   // linha 1
-    -1, -2, 16, -2, -1,   // linha 2
-     0, -1, -2, -1,  0,   // linha 3
-     0,  0, -1,  0,  0    // linha 4
-};
-
-/**
- * @brief Carrega uma imagem de um arquivo e a redimensiona para as dimensões LARGURA_PADRAO_IMG x ALTURA_PADRAO_IMG.
- * 
- * Utiliza a biblioteca stb_image para carregar a imagem. Se a imagem já tiver as dimensões
- * corretas, ela é copiada diretamente. Caso contrário, um redimensionamento simples por 
- * vizinho mais próximo (nearest neighbor) é aplicado.
- * 
- * @param nome_arquivo O caminho para o arquivo de imagem a ser carregado.
- * @param buffer_destino_rgb Matriz 3D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG x 3) onde a imagem RGB redimensionada será armazenada.
- * @return 0 em caso de sucesso, -1 se ocorrer erro ao carregar a imagem.
- */
-int carregar_e_redimensionar_imagem(const char* nome_arquivo, unsigned char buffer_destino_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3]) {
-    int largura_original, altura_original, canais_originais; // Variáveis para armazenar dimensões e canais da imagem original.
-    int coord_y, coord_x; // Variáveis de iteração para loops.
-    
-    // Tenta carregar a imagem usando stbi_load.
-    // Força a carga de 3 canais (RGB), descartando o alfa se existir.
-    unsigned char* dados_imagem_bruta = stbi_load(nome_arquivo, &largura_original, &altura_original, &canais_originais, 3);
-    
-    // Verifica se o carregamento falhou.
-    if (!dados_imagem_bruta) {
-        printf("Erro ao carregar a imagem: %s\n", nome_arquivo);
-        return -1; // Retorna erro.
-    }
-    
-    printf("Imagem carregada: %s (%dx%d pixels, %d canais)\n", nome_arquivo, largura_original, altura_original, canais_originais);
-    
-    // Verifica se a imagem já possui as dimensões desejadas.
-    if (largura_original == LARGURA_PADRAO_IMG && altura_original == ALTURA_PADRAO_IMG) {
-        printf("Dimensões da imagem correspondem ao alvo. Copiando diretamente.\n");
-        // Copia os dados pixel a pixel para a matriz de saída `buffer_destino_rgb`.
-        for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
-            for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
-                int indice_pixel_origem = (coord_y * LARGURA_PADRAO_IMG + coord_x) * 3; // Calcula o índice linear no buffer de entrada.
-                buffer_destino_rgb[coord_y][coord_x][0] = dados_imagem_bruta[indice_pixel_origem + 0]; // Copia componente R.
-                buffer_destino_rgb[coord_y][coord_x][1] = dados_imagem_bruta[indice_pixel_origem + 1]; // Copia componente G.
-                buffer_destino_rgb[coord_y][coord_x][2] = dados_imagem_bruta[indice_pixel_origem + 2]; // Copia componente B.
-            }
-        }
-    } else {
-        // A imagem precisa ser redimensionada.
-        printf("Redimensionando de %dx%d para %dx%d usando vizinho mais próximo...\n", largura_original, altura_original, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG);
-        
-        // Itera sobre cada pixel da imagem de destino (LARGURA_PADRAO_IMG x ALTURA_PADRAO_IMG).
-        for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
-            for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
-                // Calcula as coordenadas correspondentes na imagem original usando interpolação por vizinho mais próximo.
-                int coord_x_origem = (coord_x * largura_original) / LARGURA_PADRAO_IMG;
-                int coord_y_origem = (coord_y * altura_original) / ALTURA_PADRAO_IMG;
-                
-                // Garante que as coordenadas calculadas não excedam os limites da imagem original.
-                if (coord_x_origem >= largura_original) coord_x_origem = largura_original - 1;
-                if (coord_y_origem >= altura_original) coord_y_origem = altura_original - 1;
-                
-                // Calcula o índice linear do pixel correspondente na imagem original.
-                int indice_pixel_origem = (coord_y_origem * largura_original + coord_x_origem) * 3;
-                // Copia os componentes RGB do pixel original para o pixel de destino.
-                buffer_destino_rgb[coord_y][coord_x][0] = dados_imagem_bruta[indice_pixel_origem + 0];
-                buffer_destino_rgb[coord_y][coord_x][1] = dados_imagem_bruta[indice_pixel_origem + 1];
-                buffer_destino_rgb[coord_y][coord_x][2] = dados_imagem_bruta[indice_pixel_origem + 2];
-            }
-        }
-    }
-    
-    // Libera a memória alocada por stbi_load para os dados da imagem original.
-    stbi_image_free(dados_imagem_bruta);
-    return 0; // Retorna sucesso.
-}
-
-/**
- * @brief Salva uma imagem em escala de cinza em um arquivo PNG.
- * 
- * Utiliza a biblioteca stb_image_write. Tenta criar o diretório de saída
- * se ele não existir.
- * 
- * @param nome_arquivo_saida O caminho completo (incluindo nome do arquivo) onde salvar a imagem PNG.
- * @param dados_imagem_cinza Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) contendo os dados da imagem em escala de cinza.
- */
-void salvar_imagem_cinza_png(const char* nome_arquivo_saida, unsigned char dados_imagem_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]) {
-    // Extrai o caminho do diretório a partir do nome completo do arquivo.
-    char caminho_diretorio[256];
-    strncpy(caminho_diretorio, nome_arquivo_saida, sizeof(caminho_diretorio) - 1); // Copia o nome do arquivo para um buffer temporário.
-    caminho_diretorio[sizeof(caminho_diretorio) - 1] = '\0'; // Garante terminação nula.
-    
-    // Encontra a última barra ('/') no caminho.
-    char *ultima_barra = strrchr(caminho_diretorio, '/');
-    if (ultima_barra != NULL) {
-        // Se encontrou uma barra, termina a string ali para obter apenas o caminho do diretório.
-        *ultima_barra = '\0'; 
-        // Tenta criar o diretório. A flag 0777 define as permissões.
-        // Ignora o erro se o diretório já existir (errno == EEXIST).
-        if (mkdir(caminho_diretorio, 0777) == -1 && errno != EEXIST) {
-            perror("Erro ao criar diretório de saída");
-            // Não retorna erro aqui, tenta salvar mesmo assim, pode funcionar se o diretório base existir.
-        }
-    }
 
-    // Tenta salvar a imagem em escala de cinza como PNG usando stbi_write_png.
-    // Parâmetros: nome do arquivo, largura, altura, número de canais (1 para grayscale),
-    // ponteiro para os dados, e stride (número de bytes por linha, que é a largura).
-    if (!stbi_write_png(nome_arquivo_saida, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, 1, dados_imagem_cinza, LARGURA_PADRAO_IMG)) {
-        printf("Erro ao salvar PNG: %s\n", nome_arquivo_saida);
-    } else {
-        printf("PNG salvo com sucesso: %s\n", nome_arquivo_saida);
-    }
-}
+// Quantidade máxima de blocos da pré-passada de regiões planas (imagem de tamanho padrão).
+#define MAX_BLOCOS_PLANOS (((LARGURA_PADRAO_IMG + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO) * \
+                           ((ALTURA_PADRAO_IMG + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO))
 
-/**
- * @brief Converte uma imagem RGB para escala de cinza.
- * 
- * Utiliza a fórmula de luminância padrão (0.299*R + 0.587*G + 0.114*B).
- * 
- * @param buffer_entrada_rgb Matriz 3D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG x 3) contendo a imagem RGB de entrada.
- * @param buffer_saida_cinza Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) onde a imagem em escala de cinza resultante será armazenada.
- */
-void converter_rgb_para_cinza(unsigned char buffer_entrada_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3], unsigned char buffer_saida_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]) {
-    int coord_y, coord_x; // Variáveis de iteração.
-    // Itera sobre cada pixel da imagem.
-    for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
-        for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
-            // Obtém os componentes R, G, B do pixel atual.
-            unsigned char comp_r = buffer_entrada_rgb[coord_y][coord_x][0];
-            unsigned char comp_g = buffer_entrada_rgb[coord_y][coord_x][1];
-            unsigned char comp_b = buffer_entrada_rgb[coord_y][coord_x][2];
-            // Calcula o valor em escala de cinza usando a fórmula de luminância.
-            // O resultado é convertido para `unsigned char` (0-255).
-            buffer_saida_cinza[coord_y][coord_x] = (unsigned char)(0.299*comp_r + 0.587*comp_g + 0.114*comp_b);
-        }
-    }
-}
-
-/**
- * @brief Extrai uma janela de pixels (vizinhaça) de uma imagem em escala de cinza.
- * 
- * A janela extraída é sempre armazenada no buffer linear global `janela_global_pixels` de tamanho 5x5 (TAMANHO_MATRIZ_LINEAR).
- * O tamanho real da janela a ser extraída (2x2, 3x3 ou 5x5) é determinado pelo `codigo_tamanho_kernel`.
- * A janela é posicionada corretamente dentro do buffer 5x5, com padding de zeros se necessário.
- * Trata o padding nas bordas da imagem atribuindo 0 aos pixels fora dos limites.
- * 
- * @param imagem_cinza Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) da imagem em escala de cinza.
- * @param centro_x Coordenada X do pixel central da janela na imagem.
- * @param centro_y Coordenada Y do pixel central da janela na imagem.
- * @param codigo_tamanho_kernel Código que indica o tamanho da janela a ser extraída:
- *                  0: Roberts 2x2 (mapeado para canto superior esquerdo do 5x5)
- *                  1: Sobel/Prewitt 3x3 (mapeado para centro do 5x5)
- *                  3: Sobel/Laplace 5x5 (usa todo o 5x5)
- */
-void extrair_janela_vizinhanca_linear(unsigned char imagem_cinza[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG], int centro_x, int centro_y, uint32_t codigo_tamanho_kernel) {
-    int desloc_y, desloc_x, indice_janela; // Variáveis de iteração e índice.
-    int pixel_x_img, pixel_y_img; // Coordenadas do pixel na imagem original.
-    
-    // Zera completamente o buffer global `janela_global_pixels` (5x5) antes de preenchê-lo.
-    // Isso garante que áreas não preenchidas (padding) contenham zero.
-    memset(janela_global_pixels, 0, TAMANHO_MATRIZ_LINEAR * sizeof(tipo_pixel_imagem));
-    
-    // --- Caso Especial: Roberts 2x2 (codigo_tamanho_kernel == 0) ---
-    if (codigo_tamanho_kernel == 0) {
-        // Itera sobre a janela 2x2.
-        for (desloc_y = 0; desloc_y < 2; desloc_y++) { // Linhas da janela 2x2 (0 a 1)
-            for (desloc_x = 0; desloc_x < 2; desloc_x++) { // Colunas da janela 2x2 (0 a 1)
-                // Calcula as coordenadas do pixel correspondente na imagem original.
-                // O canto superior esquerdo da janela 2x2 corresponde ao pixel (centro_x, centro_y) da imagem.
-                pixel_x_img = centro_x + desloc_x;
-                pixel_y_img = centro_y + desloc_y;
-                
-                // Mapeia a posição (desloc_y, desloc_x) da janela 2x2 para o índice linear `indice_janela`
-                // dentro do buffer global 5x5 (`janela_global_pixels`).
-                // A janela 2x2 é colocada no canto superior esquerdo do buffer 5x5.
-                int linha_no_buffer_5x5 = desloc_y; // Linha 0 ou 1 no buffer 5x5.
-                int coluna_no_buffer_5x5 = desloc_x; // Coluna 0 ou 1 no buffer 5x5.
-                indice_janela = linha_no_buffer_5x5 * 5 + coluna_no_buffer_5x5; // Índice linear (0, 1, 5, 6).
-                
-                // Verifica se as coordenadas (pixel_x_img, pixel_y_img) estão dentro dos limites da imagem.
-                if (pixel_x_img >= 0 && pixel_x_img < LARGURA_PADRAO_IMG && pixel_y_img >= 0 && pixel_y_img < ALTURA_PADRAO_IMG) {
-                    // Se dentro dos limites, copia o valor do pixel da imagem para a janela.
-                    janela_global_pixels[indice_janela] = (tipo_pixel_imagem)imagem_cinza[pixel_y_img][pixel_x_img];
-                } else {
-                    // Se fora dos limites (borda da imagem), aplica padding com zero.
-                    // (Já foi feito pelo memset, mas explícito aqui por clareza).
-                    janela_global_pixels[indice_janela] = 0;
-                }
-            }
-        }
-    } 
-    // --- Caso Geral: Janelas 3x3 e 5x5 (codigo_tamanho_kernel == 1 ou 3) ---
-    else {
-        int tamanho_real_janela; // Tamanho da janela (3 ou 5).
-        // Determina o tamanho da janela com base no codigo_tamanho_kernel.
-        switch(codigo_tamanho_kernel) {
-            case 1: tamanho_real_janela = 3; break; // Sobel/Prewitt 3x3
-            case 3: tamanho_real_janela = 5; break; // Sobel 5x5/Laplace 5x5
-            default: tamanho_real_janela = 3; break; // Comportamento padrão (assume 3x3)
-        }
-        
-        // Calcula a metade do tamanho da janela para facilitar a iteração em torno do centro.
-        int metade_tamanho_janela = tamanho_real_janela / 2; // 1 para 3x3, 2 para 5x5.
-        
-        // Itera sobre a vizinhança definida pela janela (de -metade_tamanho_janela a +metade_tamanho_janela em relação ao centro).
-        for (desloc_y = -metade_tamanho_janela; desloc_y <= metade_tamanho_janela; desloc_y++) { // Deslocamento vertical relativo a centro_y.
-            for (desloc_x = -metade_tamanho_janela; desloc_x <= metade_tamanho_janela; desloc_x++) { // Deslocamento horizontal relativo a centro_x.
-                // Calcula as coordenadas absolutas (pixel_x_img, pixel_y_img) do pixel na imagem original.
-                pixel_x_img = centro_x + desloc_x;
-                pixel_y_img = centro_y + desloc_y;
-                
-                // Calcula a posição (linha, coluna) correspondente dentro do buffer 5x5 (`janela_global_pixels`).
-                // O centro da janela (desloc_y=0, desloc_x=0) corresponde ao centro do buffer 5x5 (linha 2, coluna 2).
-                int linha_no_buffer_5x5 = desloc_y + 2; // Mapeia -1..1 (3x3) ou -2..2 (5x5) para 1..3 ou 0..4.
-                int coluna_no_buffer_5x5 = desloc_x + 2; // Mapeia -1..1 (3x3) ou -2..2 (5x5) para 1..3 ou 0..4.
-                indice_janela = linha_no_buffer_5x5 * 5 + coluna_no_buffer_5x5; // Calcula o índice linear no buffer 5x5.
-                
-                // Verifica se as coordenadas (pixel_x_img, pixel_y_img) estão dentro dos limites da imagem.
-                if (pixel_x_img >= 0 && pixel_x_img < LARGURA_PADRAO_IMG && pixel_y_img >= 0 && pixel_y_img < ALTURA_PADRAO_IMG) {
-                    // Se dentro dos limites, copia o valor do pixel da imagem para a janela.
-                    janela_global_pixels[indice_janela] = (tipo_pixel_imagem)imagem_cinza[pixel_y_img][pixel_x_img];
-                } else {
-                    // Se fora dos limites (borda da imagem), aplica padding com zero.
-                    // (Já foi feito pelo memset).
-                    janela_global_pixels[indice_janela] = 0;
-                }
-            }
-        }
-    }
-}
+// Mapa de blocos de um plano produzido pela pré-passada (ver `classificar_blocos_planos`).
+typedef struct {
+    int blocos_x, blocos_y;
+    uint8_t bloco_ativo[MAX_BLOCOS_PLANOS];   // 1: o bloco precisa de convolução.
+    uint8_t valor_bloco[MAX_BLOCOS_PLANOS];   // Valor dos pixels de um bloco plano.
+} tipo_mapa_blocos;
 
 /**
  * @brief Calcula a convolução entre uma janela de imagem e um kernel de filtro usando a FPGA.
@@ -360,7 +144,7 @@ void extrair_janela_vizinhanca_linear(unsigned char imagem_cinza[ALTURA_PADRAO_I
  *                  Se a FPGA espera o `codigo_tamanho_kernel` correto (0, 1, 3), deveria ser `params.size = codigo_tamanho_kernel;`.
  * @return O resultado da convolução como um valor `tipo_resultado_conv` (int16_t). Retorna 0 em caso de falha na comunicação com a FPGA.
  */
-int calcular_convolucao_fpga(tipo_pixel_imagem* ponteiro_janela_pixels, int8_t* ponteiro_kernel_filtro, uint32_t codigo_tamanho_kernel) {
+int calcular_convolucao_fpga(tipo_pixel_imagem* ponteiro_janela_pixels, const int8_t* ponteiro_kernel_filtro, uint32_t codigo_tamanho_kernel) {
     // Buffer temporário para receber o resultado bruto da FPGA (esperado como bytes).
     // Usa tipo_pixel_imagem (uint8_t) para compatibilidade com a assinatura de retrieve_fpga_results.
     tipo_pixel_imagem buffer_resultado_fpga[TAMANHO_MATRIZ_LINEAR]; 
@@ -378,14 +162,18 @@ int calcular_convolucao_fpga(tipo_pixel_imagem* ponteiro_janela_pixels, int8_t*
     // Envia os dados (ponteiros e parâmetros) para a FPGA usando a função externa.
     if (transfer_data_to_fpga(&parametros_fpga) != HW_SUCCESS) {
         fprintf(stderr, "Falha no envio de dados para a FPGA\n");
+        if (metricas_ativas) somar_metrica(METRICA_ERROS_FPGA, 1);
         return 0; // Retorna 0 em caso de erro.
     }
     
     // Recupera os resultados do processamento da FPGA usando a função externa.
     if (retrieve_fpga_results(buffer_resultado_fpga) != HW_SUCCESS) {
         fprintf(stderr, "Falha na leitura dos resultados da FPGA\n");
+        if (metricas_ativas) somar_metrica(METRICA_ERROS_FPGA, 1);
         return 0; // Retorna 0 em caso de erro.
     }
+    contar_estatistica(CONTADOR_TRANSACOES_FPGA, 1);
+    if (metricas_ativas) somar_metrica(METRICA_TRANSACOES_FPGA, 1);
     
     // Reconstrói o resultado final de 16 bits (tipo_resultado_conv) a partir dos dois primeiros bytes recebidos.
     // Assume que buffer_resultado_fpga[1] é o byte mais significativo (MSB) e buffer_resultado_fpga[0] é o menos significativo (LSB).
@@ -396,133 +184,826 @@ int calcular_convolucao_fpga(tipo_pixel_imagem* ponteiro_janela_pixels, int8_t*
 }
 
 /**
- * @brief Satura um valor de resultado de convolução para a faixa válida de pixel (0 a 255).
- * 
- * Se o valor for menor que 0, retorna 0.
- * Se o valor for maior que 255, retorna 255.
- * Caso contrário, retorna o próprio valor convertido para `unsigned char`.
- * 
- * @param valor_entrada O valor `tipo_resultado_conv` (int16_t) a ser saturado.
- * @return O valor saturado como `unsigned char`.
+ * @brief Calcula a resposta de um kernel para uma região retangular de um plano em escala de cinza.
+ *
+ * Com o motor de CPU selecionado, delega a `convolver_regiao_cpu`, que usa o motor escolhido
+ * pela análise do kernel (especializado, separável, simétrico, esparso ou genérico). Caso contrário,
+ * extrai cada janela e envia à FPGA, como no fluxo original. No caminho da FPGA, o cálculo é
+ * interrompido entre linhas se `refinamento_cancelado` for sinalizado.
+ *
+ * @param kernel Kernel analisado (layout 5x5 da FPGA + motor de CPU).
+ * @param codigo_tamanho_kernel Código de tamanho (0, 1 ou 3), passado para `extrair_janela_plano`.
+ * @param plano Plano de pixels em escala de cinza (largura x altura).
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param x_inicio, y_inicio Canto superior esquerdo da região (inclusive).
+ * @param x_fim, y_fim Canto inferior direito da região (exclusive).
+ * @param buffer_gradiente Buffer (largura x altura) onde a resposta (int16_t) de cada pixel será armazenada.
  */
-unsigned char saturar_valor_pixel(tipo_resultado_conv valor_entrada) {
-    if (valor_entrada < 0) return 0;
-    if (valor_entrada > 255) return 255;
-    return (unsigned char)valor_entrada;
+void calcular_gradiente_regiao(const tipo_kernel_analisado *kernel, uint32_t codigo_tamanho_kernel, const unsigned char *plano, int largura, int altura,
+                               int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *buffer_gradiente) {
+    int coord_x, coord_y; // Variáveis de iteração.
+
+    if (configuracao_execucao.usar_motor_cpu) {
+        convolver_regiao_cpu(kernel, plano, largura, altura, x_inicio, y_inicio, x_fim, y_fim, buffer_gradiente);
+        return;
+    }
+
+    // Com `--rastro`, cada região enviada à FPGA vira um evento: os intervalos entre eles são a FPGA ociosa.
+    uint64_t instante_regiao = rastro_ativo ? instante_rastro_ns() : 0;
+
+    // Itera sobre cada pixel da região.
+    for (coord_y = y_inicio; coord_y < y_fim; coord_y++) {
+        // Permite abandonar um refinamento em segundo plano sem esperar a imagem inteira.
+        if (atomic_load(&refinamento_cancelado)) {
+            atomic_store(&refinamento_interrompido, 1);
+            break;
+        }
+        for (coord_x = x_inicio; coord_x < x_fim; coord_x++) {
+            // Extrai a janela de pixels centrada em (coord_x, coord_y).
+            // O tamanho da janela é determinado por `codigo_tamanho_kernel`.
+            extrair_janela_plano(plano, largura, altura, coord_x, coord_y, codigo_tamanho_kernel);
+            // Calcula a convolução entre a janela (`janela_global_pixels` global) e o kernel usando a FPGA.
+            buffer_gradiente[coord_y * largura + coord_x] = calcular_convolucao_fpga(janela_global_pixels, kernel->coeficientes, codigo_tamanho_kernel);
+        }
+    }
+    if (rastro_ativo) registrar_evento_rastro("fpga", "fpga", instante_regiao, instante_rastro_ns());
 }
 
+// Dados compartilhados pelas faixas de `calcular_gradiente_plano`.
+typedef struct {
+    const tipo_kernel_analisado *kernel;
+    uint32_t codigo_tamanho_kernel;
+    const unsigned char *plano;
+    int largura, altura;
+    const tipo_mapa_blocos *mapa;
+    tipo_resultado_conv *buffer_gradiente;
+    int bruto;                               // 1: resposta exata na CPU (`convolver_regiao_cpu_bruto`), em qualquer motor.
+    atomic_uint_fast64_t janelas_calculadas; // Janelas enviadas ao motor (para `--stats`).
+} tipo_tarefa_gradiente;
+
 /**
- * @brief Aplica um filtro de detecção de borda (como Sobel, Prewitt, Roberts ou Laplace) a uma imagem em escala de cinza.
- * 
+ * @brief Calcula uma região de uma tarefa: no modo bruto, sempre na CPU; senão, no motor escolhido.
+ */
+static inline void calcular_regiao_tarefa(const tipo_tarefa_gradiente *tarefa, const unsigned char *plano, int altura_local,
+                                          int x_inicio, int y_inicio, int x_fim, int y_fim, tipo_resultado_conv *buffer_gradiente) {
+    if (tarefa->bruto) {
+        convolver_regiao_cpu_bruto(tarefa->kernel, plano, tarefa->largura, altura_local, x_inicio, y_inicio, x_fim, y_fim, buffer_gradiente);
+    } else {
+        calcular_gradiente_regiao(tarefa->kernel, tarefa->codigo_tamanho_kernel, plano, tarefa->largura, altura_local,
+                                  x_inicio, y_inicio, x_fim, y_fim, buffer_gradiente);
+    }
+}
+
+/**
+ * @brief Calcula o gradiente das linhas [y_inicio, y_fim) de uma faixa de blocos.
+ *
+ * Sem mapa, as linhas inteiras são uma região. Com o mapa da pré-passada, cada sequência de blocos
+ * ativos é enviada de uma vez ao motor (CPU ou FPGA; no modo bruto, sempre a CPU), e os blocos
+ * planos são preenchidos com a resposta do kernel a uma janela constante: para os kernels de borda
+ * (soma dos coeficientes igual a zero), zero.
+ *
+ * As linhas são contadas no plano da tarefa; `plano` e `buffer_gradiente` começam na linha
+ * `linha_base` e têm `altura_local` linhas. Com um trecho do plano que cubra o suporte do kernel,
+ * o resultado é o mesmo do plano inteiro (as bordas de fora continuam fora), o que permite calcular
+ * uma linha de halo num buffer local.
+ */
+static void calcular_gradiente_linhas(tipo_tarefa_gradiente *tarefa, int y_inicio, int y_fim, const unsigned char *plano,
+                                      int linha_base, int altura_local, tipo_resultado_conv *buffer_gradiente) {
+    const tipo_mapa_blocos *mapa = tarefa->mapa;
+    int largura = tarefa->largura;
+    int bloco_y = y_inicio / LADO_BLOCO_PLANO;
+    int bloco_x, coord_x, coord_y; // Variáveis de iteração.
+
+    if (mapa == NULL) {
+        calcular_regiao_tarefa(tarefa, plano, altura_local, 0, y_inicio - linha_base, largura, y_fim - linha_base, buffer_gradiente);
+        if (estatisticas_ativas) atomic_fetch_add(&tarefa->janelas_calculadas, (uint64_t)largura * (y_fim - y_inicio));
+        return;
+    }
+
+    bloco_x = 0;
+    while (bloco_x < mapa->blocos_x) {
+        int indice_bloco = bloco_y * mapa->blocos_x + bloco_x;
+        int x_inicio = bloco_x * LADO_BLOCO_PLANO;
+
+        if (mapa->bloco_ativo[indice_bloco]) {
+            // Agrupa os blocos ativos consecutivos em uma única região.
+            while (bloco_x < mapa->blocos_x && mapa->bloco_ativo[bloco_y * mapa->blocos_x + bloco_x]) bloco_x++;
+            int x_fim = (bloco_x * LADO_BLOCO_PLANO < largura) ? bloco_x * LADO_BLOCO_PLANO : largura;
+            calcular_regiao_tarefa(tarefa, plano, altura_local, x_inicio, y_inicio - linha_base, x_fim, y_fim - linha_base, buffer_gradiente);
+            if (estatisticas_ativas) atomic_fetch_add(&tarefa->janelas_calculadas, (uint64_t)(x_fim - x_inicio) * (y_fim - y_inicio));
+            continue;
+        }
+
+        // Bloco plano: todas as janelas valem `valor_bloco`, a resposta é constante.
+        int32_t soma_constante = (int32_t)mapa->valor_bloco[indice_bloco] * tarefa->kernel->soma_coeficientes;
+        tipo_resultado_conv resposta_constante = tarefa->bruto ? saturar_resposta_bruta(soma_constante) : aplicar_semantica_fpga(soma_constante);
+        int x_fim = (x_inicio + LADO_BLOCO_PLANO < largura) ? x_inicio + LADO_BLOCO_PLANO : largura;
+        for (coord_y = y_inicio; coord_y < y_fim; coord_y++) {
+            for (coord_x = x_inicio; coord_x < x_fim; coord_x++) {
+                buffer_gradiente[(coord_y - linha_base) * largura + coord_x] = resposta_constante;
+            }
+        }
+        bloco_x++;
+    }
+}
+
+/**
+ * @brief Calcula o gradiente das faixas de blocos [bloco_y_inicio, bloco_y_fim) (rotina de `executar_em_faixas`).
+ *
+ * Cada faixa tem LADO_BLOCO_PLANO linhas (ver `calcular_gradiente_linhas`).
+ */
+static void calcular_gradiente_faixa_blocos(int bloco_y_inicio, int bloco_y_fim, void *argumento) {
+    tipo_tarefa_gradiente *tarefa = (tipo_tarefa_gradiente *)argumento;
+    int bloco_y;
+
+    for (bloco_y = bloco_y_inicio; bloco_y < bloco_y_fim; bloco_y++) {
+        int y_inicio = bloco_y * LADO_BLOCO_PLANO;
+        int y_fim = (y_inicio + LADO_BLOCO_PLANO < tarefa->altura) ? y_inicio + LADO_BLOCO_PLANO : tarefa->altura;
+        calcular_gradiente_linhas(tarefa, y_inicio, y_fim, tarefa->plano, 0, tarefa->altura, tarefa->buffer_gradiente);
+    }
+}
+
+/**
+ * @brief Calcula a resposta de um kernel para todos os pixels de um plano, pulando os blocos planos.
+ *
+ * Com o motor de CPU, as faixas de blocos são divididas entre as threads do grupo (`--threads`).
+ * Na FPGA, que é um único dispositivo alimentado pela janela global `janela_global_pixels`,
+ * as faixas são processadas em sequência.
+ *
+ * @param kernel Kernel analisado (layout 5x5 da FPGA + motor de CPU).
+ * @param codigo_tamanho_kernel Código de tamanho (0, 1 ou 3), passado para `extrair_janela_plano`.
+ * @param plano Plano de pixels em escala de cinza (largura x altura).
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param mapa Resultado de `classificar_blocos_planos` para o plano, ou NULL para calcular tudo.
+ * @param buffer_gradiente Buffer (largura x altura) onde a resposta (int16_t) de cada pixel será armazenada.
+ */
+void calcular_gradiente_plano(const tipo_kernel_analisado *kernel, uint32_t codigo_tamanho_kernel, const unsigned char *plano, int largura, int altura,
+                              const tipo_mapa_blocos *mapa, tipo_resultado_conv *buffer_gradiente) {
+    tipo_tarefa_gradiente tarefa = { kernel, codigo_tamanho_kernel, plano, largura, altura, mapa, buffer_gradiente, 0, 0 };
+    int total_faixas_blocos = (altura + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO;
+
+    if (configuracao_execucao.usar_motor_cpu) {
+        executar_em_faixas(total_faixas_blocos, 1, calcular_gradiente_faixa_blocos, &tarefa);
+    } else {
+        calcular_gradiente_faixa_blocos(0, total_faixas_blocos, &tarefa);
+    }
+    contar_estatistica(CONTADOR_JANELAS, atomic_load(&tarefa.janelas_calculadas));
+}
+
+/**
+ * @brief Calcula a resposta de um kernel no modo bruto (sem a semântica da FPGA) para um plano inteiro.
+ *
+ * Sempre na CPU (`convolver_regiao_cpu_bruto`), em faixas de blocos divididas entre as threads do
+ * grupo, sem pular blocos planos. Não conta janelas nas estatísticas: os gradientes brutos alimentam
+ * as análises e a exportação, não a imagem de bordas.
+ */
+void calcular_gradiente_plano_bruto(const tipo_kernel_analisado *kernel, const unsigned char *plano, int largura, int altura,
+                                    tipo_resultado_conv *buffer_gradiente) {
+    tipo_tarefa_gradiente tarefa = { kernel, 0, plano, largura, altura, NULL, buffer_gradiente, 1, 0 };
+    executar_em_faixas((altura + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO, 1, calcular_gradiente_faixa_blocos, &tarefa);
+}
+
+// Faixas de blocos reservadas de cada vez no Canny fundido: as linhas de halo são recalculadas só
+// nas pontas de cada reserva.
+#define FAIXAS_BLOCOS_CANNY 2
+
+// Dados compartilhados pelas faixas de `calcular_canny_plano`.
+typedef struct {
+    tipo_tarefa_gradiente gradiente_x, gradiente_y;
+    int limiar_baixo, limiar_alto;
+    unsigned char *classe;
+} tipo_tarefa_canny;
+
+/**
+ * @brief Calcula Gx/Gy de uma linha vizinha a uma faixa num buffer local (halo do Canny).
+ *
+ * Usa só as linhas do plano ao alcance do kernel (HALO_BLOCO_PLANO acima e abaixo); o resultado é
+ * o mesmo que a faixa vizinha grava nos buffers da imagem, sem disputar esses buffers com ela.
+ */
+static void calcular_linha_halo_canny(tipo_tarefa_canny *tarefa, int linha, tipo_resultado_conv *linha_x, tipo_resultado_conv *linha_y) {
+    tipo_resultado_conv rascunho[(2 * HALO_BLOCO_PLANO + 1) * LARGURA_PADRAO_IMG];
+    int largura = tarefa->gradiente_x.largura;
+    int linha_base = (linha - HALO_BLOCO_PLANO > 0) ? linha - HALO_BLOCO_PLANO : 0;
+    int linha_limite = (linha + HALO_BLOCO_PLANO + 1 < tarefa->gradiente_x.altura) ? linha + HALO_BLOCO_PLANO + 1 : tarefa->gradiente_x.altura;
+    const unsigned char *trecho = tarefa->gradiente_x.plano + linha_base * largura;
+
+    calcular_gradiente_linhas(&tarefa->gradiente_x, linha, linha + 1, trecho, linha_base, linha_limite - linha_base, rascunho);
+    memcpy(linha_x, rascunho + (linha - linha_base) * largura, (size_t)largura * sizeof(tipo_resultado_conv));
+    calcular_gradiente_linhas(&tarefa->gradiente_y, linha, linha + 1, trecho, linha_base, linha_limite - linha_base, rascunho);
+    memcpy(linha_y, rascunho + (linha - linha_base) * largura, (size_t)largura * sizeof(tipo_resultado_conv));
+}
+
+/**
+ * @brief Supressão, limiares e histerese de uma faixa de blocos cujos Gx/Gy já estão nos buffers.
+ *
+ * @param halo_acima 1 se a linha logo acima pertence a uma faixa de outra reserva (calculada aqui num buffer local).
+ * @param halo_abaixo 1 se a linha logo abaixo pertence a uma faixa de outra reserva.
+ */
+static void classificar_faixa_blocos_canny(tipo_tarefa_canny *tarefa, int bloco_y, int halo_acima, int halo_abaixo) {
+    tipo_resultado_conv linhas_halo[4][LARGURA_PADRAO_IMG];
+    tipo_halo_canny halo = { NULL, NULL, NULL, NULL };
+    int largura = tarefa->gradiente_x.largura, altura = tarefa->gradiente_x.altura;
+    int y_inicio = bloco_y * LADO_BLOCO_PLANO;
+    int y_fim = (y_inicio + LADO_BLOCO_PLANO < altura) ? y_inicio + LADO_BLOCO_PLANO : altura;
+
+    if (halo_acima && y_inicio > 0) {
+        calcular_linha_halo_canny(tarefa, y_inicio - 1, linhas_halo[0], linhas_halo[1]);
+        halo.gradiente_x_acima = linhas_halo[0];
+        halo.gradiente_y_acima = linhas_halo[1];
+    }
+    if (halo_abaixo && y_fim < altura) {
+        calcular_linha_halo_canny(tarefa, y_fim, linhas_halo[2], linhas_halo[3]);
+        halo.gradiente_x_abaixo = linhas_halo[2];
+        halo.gradiente_y_abaixo = linhas_halo[3];
+    }
+    classificar_faixa_canny(tarefa->gradiente_x.buffer_gradiente, tarefa->gradiente_y.buffer_gradiente, largura, altura,
+                            y_inicio, y_fim, &halo, tarefa->limiar_baixo, tarefa->limiar_alto, tarefa->classe);
+}
+
+/**
+ * @brief Gx, Gy e Canny das faixas de blocos [bloco_y_inicio, bloco_y_fim) (rotina de `executar_em_faixas`).
+ *
+ * Cada faixa é classificada assim que a faixa seguinte tem Gx/Gy prontos, enquanto os gradientes
+ * ainda estão no cache. Só as pontas da reserva dependem de faixas de outras threads: a linha
+ * vizinha é recalculada num buffer local.
+ */
+static void calcular_canny_faixa_blocos(int bloco_y_inicio, int bloco_y_fim, void *argumento) {
+    tipo_tarefa_canny *tarefa = (tipo_tarefa_canny *)argumento;
+    int bloco_y;
+
+    for (bloco_y = bloco_y_inicio; bloco_y < bloco_y_fim; bloco_y++) {
+        calcular_gradiente_faixa_blocos(bloco_y, bloco_y + 1, &tarefa->gradiente_x);
+        calcular_gradiente_faixa_blocos(bloco_y, bloco_y + 1, &tarefa->gradiente_y);
+        if (bloco_y > bloco_y_inicio) classificar_faixa_blocos_canny(tarefa, bloco_y - 1, bloco_y - 1 == bloco_y_inicio, 0);
+    }
+    classificar_faixa_blocos_canny(tarefa, bloco_y_fim - 1, bloco_y_fim - 1 == bloco_y_inicio, 1);
+}
+
+/**
+ * @brief Canny de um plano numa só passada com os gradientes: Gx, Gy, supressão, limiares e
+ *        histerese faixa a faixa, e depois a ligação das bordas entre faixas.
+ *
+ * A direção e a magnitude precisam do sinal e da escala reais do gradiente, que a semântica da
+ * FPGA perde (255 fora de [-128, 127]). Por isso Gx/Gy são calculados no modo bruto, na CPU, com
+ * qualquer motor, e ficam nos buffers sem saturação. As faixas são divididas entre as threads do grupo.
+ *
+ * @param saida Imagem binária (0 ou 255), largura x altura.
+ */
+void calcular_canny_plano(const tipo_filtro_borda *filtro, const unsigned char *plano, int largura, int altura, const tipo_mapa_blocos *mapa,
+                          tipo_resultado_conv *buffer_gradiente_x, tipo_resultado_conv *buffer_gradiente_y, unsigned char *saida) {
+    tipo_tarefa_canny tarefa = {
+        { &filtro->kernel_gx, filtro->codigo_tamanho, plano, largura, altura, mapa, buffer_gradiente_x, 1, 0 },
+        { &filtro->kernel_gy, filtro->codigo_tamanho, plano, largura, altura, mapa, buffer_gradiente_y, 1, 0 },
+        configuracao_execucao.canny_limiar_baixo, configuracao_execucao.canny_limiar_alto, saida
+    };
+    int total_faixas_blocos = (altura + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO;
+
+    executar_em_faixas(total_faixas_blocos, FAIXAS_BLOCOS_CANNY, calcular_canny_faixa_blocos, &tarefa);
+    contar_estatistica(CONTADOR_JANELAS, atomic_load(&tarefa.gradiente_x.janelas_calculadas) + atomic_load(&tarefa.gradiente_y.janelas_calculadas));
+}
+
+/**
+ * @brief Aplica um filtro de borda a um plano em escala de cinza de dimensões arbitrárias.
+ *
  * A função opera em fases:
- * 1. Calcula o gradiente na direção X (Gx) para toda a imagem, armazenando em `buffer_gradiente_x`.
- * 2. Se um filtro Gy for fornecido (ponteiro_kernel_gy != NULL), calcula o gradiente na direção Y (Gy), armazenando em `buffer_gradiente_y`.
+ * 1. Calcula o gradiente na direção X (Gx) para todo o plano, armazenando em `buffer_gradiente_x`.
+ * 2. Se o filtro possuir kernel Gy, calcula o gradiente na direção Y (Gy), armazenando em `buffer_gradiente_y`.
  * 3. Se ambos Gx e Gy foram calculados, calcula a magnitude do gradiente (sqrt(Gx^2 + Gy^2)) para cada pixel.
- * 4. Se apenas Gx foi calculado (caso do Laplace, onde ponteiro_kernel_gy é NULL), usa o valor absoluto de Gx.
- * 5. Satura o resultado (magnitude ou |Gx|) para a faixa 0-255 e armazena na matriz `buffer_resultado_final`.
+ * 4. Se apenas Gx foi calculado (caso do Laplace, sem kernel Gy), usa o valor absoluto de Gx.
+ * 5. Satura o resultado (magnitude ou |Gx|) para a faixa 0-255 e armazena em `buffer_resultado_final`.
+ *
+ * Com `--canny`, as fases 1, 2, 3 e 5 são feitas juntas por `calcular_canny_plano`: cada faixa de
+ * blocos passa por supressão, limiares e histerese logo depois de ter Gx/Gy calculados (no modo
+ * bruto, na CPU, mesmo com a FPGA selecionada).
+ *
+ * Se `histograma_magnitude` não for NULL, o histograma (256 bins) do resultado saturado é
+ * acumulado na mesma passada da fase 5 (exceto com Canny, cuja saída já é binária).
+ *
+ * Antes da fase 1, se `configuracao_execucao.limiar_bloco_plano` não for negativo, a pré-passada
+ * `classificar_blocos_planos` marca os blocos planos, que não são enviados ao motor nas fases 1 e 2.
+ *
+ * Com `--suavizar`, o plano é suavizado antes de tudo (`suavizar_plano`). Com `--log`, num filtro
+ * sem Gy e no motor de CPU, a suavização e a fase 1 são feitas juntas por `aplicar_log_fundido`,
+ * sem plano suavizado intermediário; nos demais casos, `--log` equivale a `--suavizar 5`.
+ *
+ * Com `--stats`, a suavização, a pré-passada e a fase 1 contam como a etapa Gx; as fases 3 a 5, como
+ * a etapa de magnitude. Com `--canny`, as faixas (gradientes e Canny) contam como a etapa Gx e a
+ * ligação entre faixas, como a etapa de magnitude.
+ *
+ * @param filtro Filtro registrado (kernels Gx/Gy analisados e código de tamanho).
+ * @param plano Plano de pixels em escala de cinza (largura x altura).
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param buffer_gradiente_x Buffer intermediário (largura x altura) para Gx.
+ * @param buffer_gradiente_y Buffer intermediário (largura x altura) para Gy (não usado se o filtro não tiver Gy).
+ * @param buffer_resultado_final Buffer (largura x altura) onde a imagem resultante será armazenada.
+ * @param mapa Mapa de blocos preenchido pela pré-passada (ignorado se a pré-passada estiver desativada).
+ * @param histograma_magnitude Histograma (256 bins) do resultado, zerado e preenchido aqui; NULL se não for usado.
+ * @return Quantidade de blocos planos pulados, ou -1 se a pré-passada estiver desativada.
+ */
+int aplicar_filtro_plano(const tipo_filtro_borda *filtro, const unsigned char *plano, int largura, int altura,
+                         tipo_resultado_conv *buffer_gradiente_x, tipo_resultado_conv *buffer_gradiente_y, unsigned char *buffer_resultado_final,
+                         tipo_mapa_blocos *mapa, uint32_t *histograma_magnitude) {
+    int total_pixels = largura * altura;
+    int total_blocos_planos = -1;
+    int log_fundido = configuracao_execucao.usar_log_fundido && configuracao_execucao.usar_motor_cpu && !filtro->possui_gy;
+    static unsigned char plano_suavizado[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG]; // Comporta qualquer nível/prévia.
+    uint64_t instante_etapa = instante_estatistica_ns();
+
+    contar_estatistica(CONTADOR_PIXELS, (uint64_t)total_pixels);
+    if (histograma_magnitude != NULL) memset(histograma_magnitude, 0, BINS_HISTOGRAMA_MAGNITUDE * sizeof(uint32_t));
+
+    // --- Pré-suavização (exceto no LoG fundido, que suaviza bloco a bloco na fase 1) --- 
+    if (configuracao_execucao.lado_suavizacao > 0 && !log_fundido) {
+        suavizar_plano(plano, largura, altura, configuracao_execucao.lado_suavizacao, plano_suavizado);
+        plano = plano_suavizado;
+    }
+
+    // --- Pré-passada: Blocos Planos --- 
+    if (configuracao_execucao.limiar_bloco_plano >= 0 && !log_fundido) {
+        mapa->blocos_x = (largura + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO;
+        mapa->blocos_y = (altura + LADO_BLOCO_PLANO - 1) / LADO_BLOCO_PLANO;
+        total_blocos_planos = classificar_blocos_planos(plano, largura, altura, configuracao_execucao.limiar_bloco_plano,
+                                                        mapa->bloco_ativo, mapa->valor_bloco);
+    } else {
+        mapa = NULL;
+    }
+
+    // --- Alternativa: Canny junto com os gradientes, faixa a faixa --- 
+    if (configuracao_execucao.usar_canny && filtro->possui_gy) {
+        calcular_canny_plano(filtro, plano, largura, altura, mapa, buffer_gradiente_x, buffer_gradiente_y, buffer_resultado_final);
+        registrar_etapa_estatistica(ETAPA_GRADIENTE_X, instante_etapa);
+        instante_etapa = instante_estatistica_ns();
+        ligar_faixas_canny(buffer_resultado_final, largura, altura, LADO_BLOCO_PLANO);
+        registrar_etapa_estatistica(ETAPA_MAGNITUDE, instante_etapa);
+        return total_blocos_planos;
+    }
+
+    // --- Fase 1: Calcular Gradiente Gx --- 
+    if (!log_fundido ||
+        aplicar_log_fundido(&filtro->kernel_gx, plano, largura, altura, configuracao_execucao.lado_suavizacao, buffer_gradiente_x) != 0) {
+        if (log_fundido) { // Sem memória para os blocos: suaviza o plano inteiro e segue pelo caminho normal.
+            suavizar_plano(plano, largura, altura, configuracao_execucao.lado_suavizacao, plano_suavizado);
+            plano = plano_suavizado;
+        }
+        calcular_gradiente_plano(&filtro->kernel_gx, filtro->codigo_tamanho, plano, largura, altura, mapa, buffer_gradiente_x);
+    } else {
+        contar_estatistica(CONTADOR_JANELAS, (uint64_t)total_pixels); // LoG fundido: uma janela por pixel.
+    }
+    registrar_etapa_estatistica(ETAPA_GRADIENTE_X, instante_etapa);
+    
+    // --- Fase 2: Calcular Gradiente Gy (se aplicável) --- 
+    // Verifica se o filtro possui kernel Gy.
+    if (filtro->possui_gy) {
+        instante_etapa = instante_estatistica_ns();
+        calcular_gradiente_plano(&filtro->kernel_gy, filtro->codigo_tamanho, plano, largura, altura, mapa, buffer_gradiente_y);
+        registrar_etapa_estatistica(ETAPA_GRADIENTE_Y, instante_etapa);
+        instante_etapa = instante_estatistica_ns();
+
+        // --- Fase 3: Calcular Magnitude do Gradiente --- 
+        calcular_magnitude_plano(buffer_gradiente_x, buffer_gradiente_y, total_pixels, buffer_resultado_final, histograma_magnitude);
+    } 
+    // --- Caso: Filtro Unidirecional (Laplace): |Gx| --- 
+    else {
+        instante_etapa = instante_estatistica_ns();
+        calcular_magnitude_plano(buffer_gradiente_x, NULL, total_pixels, buffer_resultado_final, histograma_magnitude);
+    }
+    registrar_etapa_estatistica(ETAPA_MAGNITUDE, instante_etapa);
+    return total_blocos_planos;
+}
+
+/**
+ * @brief Aplica um filtro de detecção de borda (como Sobel, Prewitt, Roberts ou Laplace) à imagem `imagem_global_cinza`.
  * 
- * Utiliza buffers estáticos (`buffer_gradiente_x`, `buffer_gradiente_y`) para armazenar os resultados intermediários dos gradientes.
- * Chama `extrair_janela_vizinhanca_linear` para obter a vizinhança de cada pixel e `calcular_convolucao_fpga` para calcular a convolução na FPGA.
+ * Os gradientes Gx/Gy ficam nos buffers passados pelo chamador, para que as etapas seguintes
+ * (exportação, cantos, ...) os reaproveitem. As fases do filtro são delegadas a `aplicar_filtro_plano`.
  * 
- * @param ponteiro_kernel_gx Ponteiro para o kernel do filtro Gx (ou o único kernel, no caso do Laplace).
- * @param ponteiro_kernel_gy Ponteiro para o kernel do filtro Gy. NULL se o filtro for unidirecional (Laplace).
- * @param codigo_tamanho_kernel Código que indica o tamanho do kernel (0, 1 ou 3), passado para `extrair_janela_vizinhanca_linear`.
+ * @param filtro Filtro registrado (kernels Gx/Gy analisados e código de tamanho).
+ * @param buffer_gradiente_x Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) que recebe Gx.
+ * @param buffer_gradiente_y Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) que recebe Gy (se o filtro tiver Gy).
  * @param buffer_resultado_final Matriz 2D (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG) onde a imagem resultante do filtro de borda será armazenada.
+ * @param histograma_magnitude Histograma (256 bins) do resultado, ou NULL (ver `aplicar_filtro_plano`).
  */
-void aplicar_filtro_operacao(int8_t* ponteiro_kernel_gx, int8_t* ponteiro_kernel_gy, uint32_t codigo_tamanho_kernel, unsigned char buffer_resultado_final[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]) {
-    // Buffers estáticos para armazenar os resultados intermediários dos gradientes Gx e Gy.
-    // Usar `static` evita alocação na pilha, que poderia estourar para arrays grandes.
-    // O tipo `tipo_resultado_conv` (int16_t) é usado para armazenar os resultados da convolução.
-    static tipo_resultado_conv buffer_gradiente_x[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG];
-    static tipo_resultado_conv buffer_gradiente_y[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG];
+void aplicar_filtro_operacao(const tipo_filtro_borda *filtro,
+                             tipo_resultado_conv buffer_gradiente_x[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG],
+                             tipo_resultado_conv buffer_gradiente_y[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG],
+                             unsigned char buffer_resultado_final[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG],
+                             uint32_t *histograma_magnitude) {
+    static tipo_mapa_blocos mapa_blocos;
     
-    int coord_x, coord_y; // Variáveis de iteração.
-    
-    printf("Processando imagem com filtro de borda...\n");
+    printf("Processando imagem com filtro de borda (%s)...\n", configuracao_execucao.usar_motor_cpu ? "CPU" : "FPGA");
     
     // Inicializa os buffers intermediários com zero.
-    memset(buffer_gradiente_x, 0, sizeof(buffer_gradiente_x));
-    memset(buffer_gradiente_y, 0, sizeof(buffer_gradiente_y));
+    memset(buffer_gradiente_x, 0, sizeof(tipo_resultado_conv) * ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG);
+    memset(buffer_gradiente_y, 0, sizeof(tipo_resultado_conv) * ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG);
     
-    // --- Fase 1: Calcular Gradiente Gx --- 
-    // Itera sobre cada pixel da imagem.
-    for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
-        for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
-            // Extrai a janela de pixels centrada em (coord_x, coord_y) da imagem `imagem_global_cinza` global.
-            // O tamanho da janela é determinado por `codigo_tamanho_kernel`.
-            extrair_janela_vizinhanca_linear(imagem_global_cinza, coord_x, coord_y, codigo_tamanho_kernel);
-            // Calcula a convolução entre a janela (`janela_global_pixels` global) e o kernel `ponteiro_kernel_gx` usando a FPGA.
-            // O resultado (int16_t) é armazenado no buffer Gx.
-            buffer_gradiente_x[coord_y][coord_x] = calcular_convolucao_fpga(janela_global_pixels, ponteiro_kernel_gx, codigo_tamanho_kernel);
-        }
+    if (!filtro->possui_gy) {
+        printf("Processando filtro unidirecional (%s)... usando |Gx|%s\n", filtro->nome,
+               configuracao_execucao.usar_canny ? " (Canny exige Gx e Gy)" : "");
+    } else if (configuracao_execucao.usar_canny) {
+        printf("Aplicando Canny (limiares %d/%d) sobre Gx/Gy brutos de %s (CPU)...\n", configuracao_execucao.canny_limiar_baixo,
+               configuracao_execucao.canny_limiar_alto, filtro->nome);
+    }
+    int total_blocos_planos = aplicar_filtro_plano(filtro, &imagem_global_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                                                   &buffer_gradiente_x[0][0], &buffer_gradiente_y[0][0], &buffer_resultado_final[0][0], &mapa_blocos,
+                                                   histograma_magnitude);
+    if (total_blocos_planos >= 0) {
+        // Cada pixel de um bloco plano é uma janela a menos por kernel (Gx e, se houver, Gy).
+        printf("Pré-passada: %d de %d blocos planos pulados (~%d janelas a menos por kernel).\n",
+               total_blocos_planos, mapa_blocos.blocos_x * mapa_blocos.blocos_y, total_blocos_planos * LADO_BLOCO_PLANO * LADO_BLOCO_PLANO);
     }
     
-    // --- Fase 2: Calcular Gradiente Gy (se aplicável) --- 
-    // Verifica se um kernel Gy foi fornecido.
-    if (ponteiro_kernel_gy != NULL) {
-        // Itera sobre cada pixel da imagem.
-        for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
-            for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
-                // Extrai a janela novamente (poderia ser otimizado se a janela não mudasse entre Gx e Gy).
-                extrair_janela_vizinhanca_linear(imagem_global_cinza, coord_x, coord_y, codigo_tamanho_kernel);
-                // Calcula a convolução com o kernel `ponteiro_kernel_gy`.
-                buffer_gradiente_y[coord_y][coord_x] = calcular_convolucao_fpga(janela_global_pixels, ponteiro_kernel_gy, codigo_tamanho_kernel);
-            }
-        }
-        
-        // --- Fase 3: Calcular Magnitude do Gradiente --- 
-        // Itera sobre cada pixel.
-        for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
-            for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
-                // Obtém os resultados Gx e Gy dos buffers.
-                tipo_resultado_conv valor_gx = buffer_gradiente_x[coord_y][coord_x];
-                tipo_resultado_conv valor_gy = buffer_gradiente_y[coord_y][coord_x];
-                
-                // Calcula a magnitude Euclidiana: sqrt(Gx*Gx + Gy*Gy).
-                // Usa `double` para a conta intermediária para evitar overflow e perda de precisão.
-                tipo_resultado_conv magnitude_gradiente = (tipo_resultado_conv)sqrt((double)(valor_gx * valor_gx + valor_gy * valor_gy));
-                
-                // Satura o valor da magnitude para a faixa 0-255 e armazena no buffer final.
-                buffer_resultado_final[coord_y][coord_x] = saturar_valor_pixel(magnitude_gradiente);
-            }
-        }
-        
-    } 
-    // --- Caso: Filtro Unidirecional (Laplace) --- 
-    else {
-        printf("Processando filtro unidirecional (Laplace)... usando |Gx|\n");
-        // Itera sobre cada pixel.
-        for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
-            for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
-                // Para filtros como Laplace, o resultado Gx já representa a resposta do filtro.
-                // Calcula o valor absoluto do resultado da convolução Gx.
-                tipo_resultado_conv valor_absoluto_gx = abs(buffer_gradiente_x[coord_y][coord_x]);
-                // Satura o valor absoluto para a faixa 0-255 e armazena no buffer final.
-                buffer_resultado_final[coord_y][coord_x] = saturar_valor_pixel(valor_absoluto_gx);
-            }
+    printf("Aplicação do filtro concluída.\n");
+}
+
+/**
+ * @brief Aplica um filtro de borda aos três canais da imagem RGB e combina as respostas (`--cor`).
+ *
+ * Substitui `aplicar_filtro_operacao` quando o modo colorido está ativo: Gx/Gy combinados ficam
+ * nos mesmos buffers, para que Canny, exportação, cantos, HOG, Hough e máscara funcionem igual.
+ * A pré-suavização e a pré-passada de blocos planos valem só para o plano em cinza. Com `--canny`,
+ * os Gx/Gy combinados são os do modo bruto (`calcular_gradientes_cor_brutos`), como no cinza.
+ *
+ * @param filtro Filtro registrado.
+ * @param imagem_rgb Imagem RGB intercalada (ALTURA_PADRAO_IMG x LARGURA_PADRAO_IMG x 3).
+ * @param histograma_magnitude Histograma (256 bins) do resultado, ou NULL.
+ * @return 0 em caso de sucesso, -1 se faltar memória.
+ */
+int aplicar_filtro_cor_operacao(const tipo_filtro_borda *filtro, const unsigned char *imagem_rgb,
+                                tipo_resultado_conv buffer_gradiente_x[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG],
+                                tipo_resultado_conv buffer_gradiente_y[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG],
+                                unsigned char buffer_resultado_final[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG],
+                                uint32_t *histograma_magnitude) {
+    int indice_pixel;
+    int usar_canny = configuracao_execucao.usar_canny && filtro->possui_gy;
+    uint64_t instante_etapa = instante_estatistica_ns();
+
+    printf("Processando imagem colorida com filtro de borda (CPU, combinação %s)...\n",
+           nome_combinacao_cor(configuracao_execucao.combinacao_cor));
+    if ((usar_canny ? calcular_gradientes_cor_brutos(filtro, imagem_rgb, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                                                     configuracao_execucao.combinacao_cor, &buffer_gradiente_x[0][0], &buffer_gradiente_y[0][0])
+                    : aplicar_filtro_cor(filtro, imagem_rgb, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, configuracao_execucao.combinacao_cor,
+                                         &buffer_gradiente_x[0][0], &buffer_gradiente_y[0][0], &buffer_resultado_final[0][0])) != 0) {
+        fprintf(stderr, "Memória insuficiente para o filtro colorido\n");
+        return -1;
+    }
+    // Os três canais, os dois kernels e a combinação são feitos juntos: tudo conta como a etapa Gx.
+    registrar_etapa_estatistica(ETAPA_GRADIENTE_X, instante_etapa);
+    contar_estatistica(CONTADOR_PIXELS, LARGURA_PADRAO_IMG * ALTURA_PADRAO_IMG);
+    contar_estatistica(CONTADOR_JANELAS, 3ull * LARGURA_PADRAO_IMG * ALTURA_PADRAO_IMG * (filtro->possui_gy ? 2 : 1));
+    instante_etapa = instante_estatistica_ns();
+
+    // O Canny usa os Gx/Gy combinados no lugar da magnitude.
+    if (usar_canny) {
+        printf("Aplicando Canny (limiares %d/%d) sobre Gx/Gy brutos combinados de %s...\n", configuracao_execucao.canny_limiar_baixo,
+               configuracao_execucao.canny_limiar_alto, filtro->nome);
+        aplicar_canny(&buffer_gradiente_x[0][0], &buffer_gradiente_y[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                      configuracao_execucao.canny_limiar_baixo, configuracao_execucao.canny_limiar_alto, &buffer_resultado_final[0][0]);
+    }
+
+    if (histograma_magnitude != NULL) {
+        memset(histograma_magnitude, 0, BINS_HISTOGRAMA_MAGNITUDE * sizeof(uint32_t));
+        for (indice_pixel = 0; indice_pixel < ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG; indice_pixel++) {
+            histograma_magnitude[(&buffer_resultado_final[0][0])[indice_pixel]]++;
         }
     }
-    
+    registrar_etapa_estatistica(ETAPA_MAGNITUDE, instante_etapa);
+
     printf("Aplicação do filtro concluída.\n");
+    return 0;
+}
+
+/**
+ * @brief Reduz um plano em escala de cinza pela metade em cada eixo (média de blocos 2x2).
+ *
+ * Cada pixel de saída é a média arredondada dos quatro pixels correspondentes da origem,
+ * calculada só com inteiros. Usada para gerar as prévias do modo progressivo, que custam
+ * um quarto das convoluções da imagem completa.
+ *
+ * @param plano_origem Plano de entrada (largura x altura).
+ * @param largura Largura do plano de entrada (par).
+ * @param altura Altura do plano de entrada (par).
+ * @param plano_destino Plano de saída ((largura / 2) x (altura / 2)).
+ */
+void reduzir_plano_metade(const unsigned char *plano_origem, int largura, int altura, unsigned char *plano_destino) {
+    int coord_x, coord_y; // Coordenadas no plano de destino.
+    int largura_destino = largura / 2;
+
+    for (coord_y = 0; coord_y < altura / 2; coord_y++) {
+        const unsigned char *linha_superior = plano_origem + (2 * coord_y) * largura;
+        const unsigned char *linha_inferior = linha_superior + largura;
+        for (coord_x = 0; coord_x < largura_destino; coord_x++) {
+            unsigned int soma_bloco = linha_superior[2 * coord_x] + linha_superior[2 * coord_x + 1] +
+                                      linha_inferior[2 * coord_x] + linha_inferior[2 * coord_x + 1];
+            plano_destino[coord_y * largura_destino + coord_x] = (unsigned char)((soma_bloco + 2) >> 2);
+        }
+    }
 }
 
 /**
  * @brief Valida a seleção de operação (filtro) feita pelo usuário.
  * 
- * Verifica se a seleção está dentro do intervalo válido (1 a 6).
+ * Verifica se a seleção está dentro do intervalo válido (1 a `total_opcoes`).
  * 
  * @param opcao_escolhida A opção (número do filtro ou sair) selecionada pelo usuário.
- * @return 0 se a seleção for válida (1 a 6), -1 caso contrário.
+ * @param total_opcoes Número da última opção do menu (filtros registrados + Sair).
+ * @return 0 se a seleção for válida, -1 caso contrário.
  */
-int validar_opcao_usuario(uint32_t opcao_escolhida) {
-    // Verifica se a opção está fora do intervalo permitido (1 para Sobel 3x3 até 6 para Sair).
-    if (opcao_escolhida < 1 || opcao_escolhida > 6) {
-        fprintf(stderr, "Opção inválida: %u. Escolha um número entre 1 e 6.\n", opcao_escolhida);
+int validar_opcao_usuario(uint32_t opcao_escolhida, uint32_t total_opcoes) {
+    // Verifica se a opção está fora do intervalo permitido (1 para o primeiro filtro até a opção Sair).
+    if (opcao_escolhida < 1 || opcao_escolhida > total_opcoes) {
+        fprintf(stderr, "Opção inválida: %u. Escolha um número entre 1 e %u.\n", opcao_escolhida, total_opcoes);
         return -1; // Indica seleção inválida.
     }
     return 0; // Indica seleção válida.
 }
 
+/**
+ * @brief Imprime as opções de linha de comando aceitas pelo programa.
+ *
+ * @param nome_programa Nome do executável (argv[0]).
+ */
+void imprimir_uso(const char *nome_programa) {
+    printf("Uso: %s [opções]\n", nome_programa);
+    printf("  --motor fpga|cpu     Executa as convoluções na FPGA (padrão) ou nos motores de CPU\n");
+    printf("  --filtros ARQUIVO    Registro de filtros a carregar (padrão: %s)\n", ARQUIVO_FILTROS_PADRAO);
+    printf("  --entrada DIR        Diretório com as imagens de entrada (padrão: input)\n");
+    printf("  --saida DIR          Diretório dos resultados (padrão: output)\n");
+    printf("  --progressivo        Salva prévias em meia resolução e refina em segundo plano\n");
+    printf("  --limiar-plano N     Amplitude máxima de um bloco %dx%d pulado como plano (padrão: 0; -1 desativa)\n", LADO_BLOCO_PLANO, LADO_BLOCO_PLANO);
+    printf("  --piramide N         Aplica o filtro em N níveis (2 a %d) reduzidos por 2, um PNG por nível\n", MAX_NIVEIS_PIRAMIDE);
+    printf("  --piramide-composta N  Como --piramide, mas salva o máximo entre as escalas\n");
+    printf("  --threads N          Threads para os motores de CPU e o Canny (padrão: 1; 0 = uma por processador)\n");
+    printf("  --canny              Detector de Canny sobre Gx/Gy do filtro escolhido (saída `_canny`)\n");
+    printf("  --canny-limiares B,A Limiares baixo e alto da histerese (padrão: %d,%d)\n", CANNY_LIMIAR_BAIXO_PADRAO, CANNY_LIMIAR_ALTO_PADRAO);
+    printf("  --exportar-gradientes npy|raw  Salva Gx, Gy, magnitude e orientação em vez do PNG\n");
+    printf("  --cantos harris|shi-tomasi  Salva os cantos mais fortes de cada imagem (`_cantos.txt`)\n");
+    printf("  --cantos-max N       Quantidade máxima de cantos por imagem (padrão: %d)\n", MAX_CANTOS_PADRAO);
+    printf("  --hog                Salva o descritor HOG de cada imagem (`_hog.hog`)\n");
+    printf("  --hog-celulas C,B    Célula de CxC pixels e bloco de BxB células (padrão: %d,%d)\n",
+           HOG_TAMANHO_CELULA_PADRAO, HOG_CELULAS_BLOCO_PADRAO);
+    printf("  --hough [K]          Salva as K linhas de Hough mais votadas de cada imagem (padrão: %d)\n", HOUGH_LINHAS_PADRAO);
+    printf("  --mascara otsu|pNN   Salva a máscara binária de bordas (`.msk`) em vez do PNG, com limiar de\n");
+    printf("                       Otsu ou no percentil NN da magnitude (ex.: p90)\n");
+    printf("  --mascara-formato bits|rle  Máscara em 1 bit por pixel (padrão) ou em trechos por linha\n");
+    printf("  --suavizar 3|5       Suaviza a imagem (binomial 3x3 ou 5x5) antes de qualquer filtro\n");
+    printf("  --log                Laplaciano do Gaussiano: suavização 5x5 fundida ao kernel (filtros sem Gy, CPU)\n");
+    printf("  --cor max|dizenzo    Filtra os canais R, G e B e combina pelo canal de maior magnitude ou pelo\n");
+    printf("                       tensor de Di Zenzo (requer --motor cpu)\n");
+    printf("  --stats ARQUIVO      Grava tempos por etapa, contadores e memória de cada imagem e da execução\n");
+    printf("                       em JSON Lines (\"-\" = saída de erro)\n");
+    printf("  --contadores-hw      Com --stats, soma ciclos, instruções e falhas de L1D/LLC/desvio por etapa\n");
+    printf("                       (requer --threads 1)\n");
+    printf("  --metricas ARQUIVO   Regrava periodicamente contadores e histogramas de latência no formato texto do\n");
+    printf("                       Prometheus (coletor de arquivos texto do node_exporter)\n");
+    printf("  --metricas-intervalo S  Segundos entre as gravações das métricas (padrão: %d)\n", METRICAS_INTERVALO_PADRAO);
+    printf("  --perfil-fpga        Mede ciclos (PMCCNTR) por fase e leituras de espera por handshake no lib.s\n");
+    printf("  --rastro ARQUIVO     Grava a linha do tempo de etapas, imagens e threads em JSON do Chrome (Perfetto)\n");
+    printf("  --ajuda              Mostra esta mensagem\n");
+}
+
+/**
+ * @brief Interpreta os argumentos de linha de comando e preenche `configuracao_execucao`.
+ *
+ * @param argc Quantidade de argumentos.
+ * @param argv Vetor de argumentos.
+ * @return 0 para continuar a execução, 1 se a ajuda foi exibida, -1 em caso de argumento inválido.
+ */
+int interpretar_argumentos(int argc, char *argv[]) {
+    int indice_argumento;
+    for (indice_argumento = 1; indice_argumento < argc; indice_argumento++) {
+        const char *argumento = argv[indice_argumento];
+        // Opções que exigem um valor logo em seguida.
+        const char *valor = (indice_argumento + 1 < argc) ? argv[indice_argumento + 1] : NULL;
+
+        if (strcmp(argumento, "--ajuda") == 0 || strcmp(argumento, "-h") == 0) {
+            imprimir_uso(argv[0]);
+            return 1;
+        } else if (strcmp(argumento, "--motor") == 0 && valor != NULL) {
+            if (strcmp(valor, "cpu") == 0) configuracao_execucao.usar_motor_cpu = 1;
+            else if (strcmp(valor, "fpga") == 0) configuracao_execucao.usar_motor_cpu = 0;
+            else {
+                fprintf(stderr, "Motor desconhecido: '%s' (use fpga ou cpu)\n", valor);
+                return -1;
+            }
+            indice_argumento++;
+        } else if (strcmp(argumento, "--limiar-plano") == 0 && valor != NULL) {
+            char *fim_numero;
+            long limiar = strtol(valor, &fim_numero, 10);
+            if (*fim_numero != '\0' || limiar < -1 || limiar > 255) {
+                fprintf(stderr, "Limiar de bloco plano inválido: '%s' (use -1 a 255)\n", valor);
+                return -1;
+            }
+            configuracao_execucao.limiar_bloco_plano = (int)limiar;
+            indice_argumento++;
+        } else if ((strcmp(argumento, "--piramide") == 0 || strcmp(argumento, "--piramide-composta") == 0) && valor != NULL) {
+            int niveis = atoi(valor);
+            if (niveis < 2 || niveis > MAX_NIVEIS_PIRAMIDE) {
+                fprintf(stderr, "Quantidade de níveis inválida: '%s' (use 2 a %d)\n", valor, MAX_NIVEIS_PIRAMIDE);
+                return -1;
+            }
+            configuracao_execucao.niveis_piramide = niveis;
+            configuracao_execucao.piramide_composta = (strcmp(argumento, "--piramide-composta") == 0);
+            indice_argumento++;
+        } else if (strcmp(argumento, "--threads") == 0 && valor != NULL) {
+            int threads = atoi(valor);
+            if (threads < 0 || threads > MAX_THREADS_GRUPO) {
+                fprintf(stderr, "Quantidade de threads inválida: '%s' (use 0 a %d)\n", valor, MAX_THREADS_GRUPO);
+                return -1;
+            }
+            configuracao_execucao.total_threads = (threads == 0) ? (int)sysconf(_SC_NPROCESSORS_ONLN) : threads;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--canny") == 0) {
+            configuracao_execucao.usar_canny = 1;
+        } else if (strcmp(argumento, "--canny-limiares") == 0 && valor != NULL) {
+            int limiar_baixo, limiar_alto;
+            if (sscanf(valor, "%d,%d", &limiar_baixo, &limiar_alto) != 2 || limiar_baixo < 0 || limiar_alto < limiar_baixo) {
+                fprintf(stderr, "Limiares do Canny inválidos: '%s' (use BAIXO,ALTO com 0 <= BAIXO <= ALTO)\n", valor);
+                return -1;
+            }
+            configuracao_execucao.canny_limiar_baixo = limiar_baixo;
+            configuracao_execucao.canny_limiar_alto = limiar_alto;
+            configuracao_execucao.usar_canny = 1;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--exportar-gradientes") == 0 && valor != NULL) {
+            if (strcmp(valor, "npy") == 0) configuracao_execucao.formato_exportacao = EXPORTACAO_NPY;
+            else if (strcmp(valor, "raw") == 0) configuracao_execucao.formato_exportacao = EXPORTACAO_RAW;
+            else {
+                fprintf(stderr, "Formato de exportação desconhecido: '%s' (use npy ou raw)\n", valor);
+                return -1;
+            }
+            indice_argumento++;
+        } else if (strcmp(argumento, "--cantos") == 0 && valor != NULL) {
+            if (strcmp(valor, "harris") == 0) configuracao_execucao.metodo_cantos = CANTOS_HARRIS;
+            else if (strcmp(valor, "shi-tomasi") == 0) configuracao_execucao.metodo_cantos = CANTOS_SHI_TOMASI;
+            else {
+                fprintf(stderr, "Detector de cantos desconhecido: '%s' (use harris ou shi-tomasi)\n", valor);
+                return -1;
+            }
+            indice_argumento++;
+        } else if (strcmp(argumento, "--cantos-max") == 0 && valor != NULL) {
+            int max_cantos = atoi(valor);
+            if (max_cantos < 1 || max_cantos > MAX_CANTOS_SUPORTADOS) {
+                fprintf(stderr, "Quantidade de cantos inválida: '%s' (use 1 a %d)\n", valor, MAX_CANTOS_SUPORTADOS);
+                return -1;
+            }
+            configuracao_execucao.max_cantos = max_cantos;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--hog") == 0) {
+            configuracao_execucao.usar_hog = 1;
+        } else if (strcmp(argumento, "--hog-celulas") == 0 && valor != NULL) {
+            int tamanho_celula, celulas_bloco;
+            tipo_dimensoes_hog dimensoes_hog;
+            if (sscanf(valor, "%d,%d", &tamanho_celula, &celulas_bloco) != 2 ||
+                calcular_dimensoes_hog(LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, tamanho_celula, celulas_bloco, &dimensoes_hog) != 0) {
+                fprintf(stderr, "Configuração HOG inválida: '%s' (use C,B com C de %d a %d e B de 1 a %d)\n", valor,
+                        HOG_TAMANHO_CELULA_MIN, HOG_TAMANHO_CELULA_MAX, HOG_CELULAS_BLOCO_MAX);
+                return -1;
+            }
+            configuracao_execucao.usar_hog = 1;
+            configuracao_execucao.hog_tamanho_celula = tamanho_celula;
+            configuracao_execucao.hog_celulas_bloco = celulas_bloco;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--hough") == 0) {
+            configuracao_execucao.max_linhas_hough = HOUGH_LINHAS_PADRAO;
+            // O K é opcional: só é consumido se o próximo argumento for um número.
+            if (valor != NULL && valor[0] >= '0' && valor[0] <= '9') {
+                int max_linhas = atoi(valor);
+                if (max_linhas < 1 || max_linhas > HOUGH_MAX_LINHAS) {
+                    fprintf(stderr, "Quantidade de linhas inválida: '%s' (use 1 a %d)\n", valor, HOUGH_MAX_LINHAS);
+                    return -1;
+                }
+                configuracao_execucao.max_linhas_hough = max_linhas;
+                indice_argumento++;
+            }
+        } else if (strcmp(argumento, "--mascara") == 0 && valor != NULL) {
+            int percentil;
+            char sobra;
+            if (strcmp(valor, "otsu") == 0) {
+                configuracao_execucao.limiar_mascara = MASCARA_OTSU;
+            } else if (sscanf(valor, "p%d%c", &percentil, &sobra) == 1 && percentil >= 0 && percentil <= 100) {
+                configuracao_execucao.limiar_mascara = MASCARA_PERCENTIL;
+                configuracao_execucao.percentil_mascara = percentil;
+            } else {
+                fprintf(stderr, "Limiar de máscara desconhecido: '%s' (use otsu ou pNN, com NN de 0 a 100)\n", valor);
+                return -1;
+            }
+            indice_argumento++;
+        } else if (strcmp(argumento, "--mascara-formato") == 0 && valor != NULL) {
+            if (strcmp(valor, "bits") == 0) configuracao_execucao.formato_mascara = MASCARA_BITS;
+            else if (strcmp(valor, "rle") == 0) configuracao_execucao.formato_mascara = MASCARA_RLE;
+            else {
+                fprintf(stderr, "Formato de máscara desconhecido: '%s' (use bits ou rle)\n", valor);
+                return -1;
+            }
+            indice_argumento++;
+        } else if (strcmp(argumento, "--suavizar") == 0 && valor != NULL) {
+            int lado = atoi(valor);
+            if (!lado_suavizacao_valido(lado)) {
+                fprintf(stderr, "Suavização inválida: '%s' (use 3 ou 5)\n", valor);
+                return -1;
+            }
+            configuracao_execucao.lado_suavizacao = lado;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--log") == 0) {
+            configuracao_execucao.lado_suavizacao = LADO_SUAVIZACAO_LOG;
+            configuracao_execucao.usar_log_fundido = 1;
+        } else if (strcmp(argumento, "--cor") == 0 && valor != NULL) {
+            if (strcmp(valor, "max") == 0) configuracao_execucao.combinacao_cor = COR_MAXIMO_CANAL;
+            else if (strcmp(valor, "dizenzo") == 0) configuracao_execucao.combinacao_cor = COR_DI_ZENZO;
+            else {
+                fprintf(stderr, "Combinação de cor desconhecida: '%s' (use max ou dizenzo)\n", valor);
+                return -1;
+            }
+            indice_argumento++;
+        } else if (strcmp(argumento, "--progressivo") == 0) {
+            configuracao_execucao.modo_progressivo = 1;
+        } else if (strcmp(argumento, "--filtros") == 0 && valor != NULL) {
+            configuracao_execucao.arquivo_filtros = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--entrada") == 0 && valor != NULL) {
+            configuracao_execucao.diretorio_entrada = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--saida") == 0 && valor != NULL) {
+            configuracao_execucao.diretorio_saida = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--stats") == 0 && valor != NULL) {
+            configuracao_execucao.arquivo_estatisticas = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--contadores-hw") == 0) {
+            configuracao_execucao.usar_contadores_hw = 1;
+        } else if (strcmp(argumento, "--metricas") == 0 && valor != NULL) {
+            configuracao_execucao.arquivo_metricas = valor;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--metricas-intervalo") == 0 && valor != NULL) {
+            int intervalo = atoi(valor);
+            if (intervalo < 1 || intervalo > 3600) {
+                fprintf(stderr, "Intervalo de métricas inválido: '%s' (use 1 a 3600 segundos)\n", valor);
+                return -1;
+            }
+            configuracao_execucao.intervalo_metricas = intervalo;
+            indice_argumento++;
+        } else if (strcmp(argumento, "--perfil-fpga") == 0) {
+            configuracao_execucao.usar_perfil_fpga = 1;
+        } else if (strcmp(argumento, "--rastro") == 0 && valor != NULL) {
+            configuracao_execucao.arquivo_rastro = valor;
+            indice_argumento++;
+        } else {
+            fprintf(stderr, "Argumento inválido: '%s'\n", argumento);
+            imprimir_uso(argv[0]);
+            return -1;
+        }
+    }
+    if (configuracao_execucao.modo_progressivo && configuracao_execucao.niveis_piramide > 0) {
+        fprintf(stderr, "--progressivo e --piramide não podem ser usados juntos\n");
+        return -1;
+    }
+    if (configuracao_execucao.formato_exportacao != EXPORTACAO_NENHUMA &&
+        (configuracao_execucao.modo_progressivo || configuracao_execucao.niveis_piramide > 0)) {
+        fprintf(stderr, "--exportar-gradientes não pode ser usado com --progressivo ou --piramide\n");
+        return -1;
+    }
+    if (configuracao_execucao.limiar_mascara != MASCARA_DESATIVADA &&
+        (configuracao_execucao.modo_progressivo || configuracao_execucao.niveis_piramide > 0)) {
+        fprintf(stderr, "--mascara não pode ser usado com --progressivo ou --piramide\n");
+        return -1;
+    }
+    // As prévias, o refinamento e os níveis da pirâmide só gravam PNGs: as análises ficariam de fora sem aviso.
+    if ((configuracao_execucao.max_linhas_hough > 0 || configuracao_execucao.metodo_cantos != CANTOS_DESATIVADO ||
+         configuracao_execucao.usar_hog) &&
+        (configuracao_execucao.modo_progressivo || configuracao_execucao.niveis_piramide > 0)) {
+        fprintf(stderr, "--hough, --cantos e --hog não podem ser usados com --progressivo ou --piramide\n");
+        return -1;
+    }
+    if (configuracao_execucao.usar_contadores_hw && configuracao_execucao.arquivo_estatisticas == NULL) {
+        fprintf(stderr, "--contadores-hw requer --stats (os contadores são gravados nas estatísticas)\n");
+        return -1;
+    }
+    // Os contadores medem só a thread que processa a imagem: com o grupo, as faixas das threads
+    // auxiliares ficariam de fora e as etapas pareceriam mais baratas do que são.
+    if (configuracao_execucao.usar_contadores_hw && configuracao_execucao.total_threads > 1) {
+        fprintf(stderr, "--contadores-hw requer --threads 1 (os contadores medem só a thread que processa a imagem)\n");
+        return -1;
+    }
+    if (configuracao_execucao.usar_perfil_fpga && configuracao_execucao.usar_motor_cpu) {
+        fprintf(stderr, "--perfil-fpga requer o motor da FPGA\n");
+        return -1;
+    }
+    if (configuracao_execucao.combinacao_cor != COR_DESATIVADA) {
+        if (configuracao_execucao.modo_progressivo || configuracao_execucao.niveis_piramide > 0) {
+            fprintf(stderr, "--cor não pode ser usado com --progressivo ou --piramide\n");
+            return -1;
+        }
+        if (!configuracao_execucao.usar_motor_cpu) {
+            fprintf(stderr, "--cor requer --motor cpu (a FPGA recebe janelas de um só canal)\n");
+            return -1;
+        }
+    }
+    return 0;
+}
+
 /**
  * @brief Verifica se um nome de arquivo corresponde a um formato de imagem suportado.
  * 
@@ -547,193 +1028,738 @@ int verificar_arquivo_imagem_valido(const char *nome_arquivo) {
             strcasecmp(extensao, "bmp") == 0);
 }
 
+/* ============ PROCESSAMENTO DO DIRETÓRIO ============ */
+
+// Modos de processamento de uma imagem.
+typedef enum {
+    PROCESSAMENTO_COMPLETO = 0, // Resolução completa, com mensagens de progresso (fluxo padrão).
+    PROCESSAMENTO_PREVIA,       // Meia resolução, salva como `<nome>_<filtro>_previa.png`.
+    PROCESSAMENTO_REFINAMENTO,  // Resolução completa em segundo plano; abandonado se `refinamento_cancelado`.
+    PROCESSAMENTO_PIRAMIDE      // Todos os níveis da pirâmide (`_nivel<k>` ou composto `_piramide`).
+} tipo_modo_processamento;
+
+// Dados da tarefa executada pela thread de refinamento.
+typedef struct {
+    const tipo_filtro_borda *filtro;
+    const char *nome_diretorio_entrada;
+    const char *nome_diretorio_saida;
+} tipo_tarefa_refinamento;
+
+static pthread_t thread_refinamento;
+static int refinamento_em_andamento = 0;      // 1 enquanto existir uma thread de refinamento a aguardar.
+static tipo_tarefa_refinamento tarefa_refinamento;
+
+/**
+ * @brief Soma o tamanho de um arquivo recém-gravado às métricas (`--metricas`).
+ */
+static void contabilizar_arquivo_gravado(const char *caminho_arquivo) {
+    struct stat info_arquivo;
+    if (metricas_ativas && stat(caminho_arquivo, &info_arquivo) == 0) somar_metrica(METRICA_BYTES_GRAVADOS, (uint64_t)info_arquivo.st_size);
+}
+
+/**
+ * @brief Monta o caminho de saída `<diretório>/<imagem sem extensão>_<filtro>[_canny]<sufixo><extensão>`.
+ *
+ * O sufixo e a extensão entram no mesmo snprintf, então um caminho que não cabe no buffer é
+ * detectado aqui, em vez de ser cortado (ou estourado) depois.
+ *
+ * @param caminho_arquivo_saida Buffer de destino.
+ * @param tamanho_caminho Tamanho do buffer de destino.
+ * @param nome_diretorio_saida Diretório onde o resultado será salvo.
+ * @param nome_arquivo Nome da imagem de entrada (sem diretório).
+ * @param filtro Filtro aplicado (o nome entra no arquivo; `_canny` é acrescentado se o Canny foi usado).
+ * @param sufixo Sufixo do modo de processamento ou da análise ("" para a saída padrão).
+ * @param extensao Extensão do arquivo (".png", ".txt", ...), ou "" para um caminho base.
+ * @return 0 em caso de sucesso, -1 se o caminho não couber no buffer (nada deve ser gravado).
+ */
+int montar_caminho_saida(char *caminho_arquivo_saida, size_t tamanho_caminho, const char *nome_diretorio_saida,
+                         const char *nome_arquivo, const tipo_filtro_borda *filtro, const char *sufixo, const char *extensao) {
+    char nome_base_arquivo_saida[100]; // Buffer para armazenar a parte base do nome do arquivo de saída (sem extensão).
+
+    // Remove a extensão do nome do arquivo original.
+    strncpy(nome_base_arquivo_saida, nome_arquivo, sizeof(nome_base_arquivo_saida) - 1);
+    nome_base_arquivo_saida[sizeof(nome_base_arquivo_saida) - 1] = '\0';
+    char *posicao_ponto_saida = strrchr(nome_base_arquivo_saida, '.');
+    if (posicao_ponto_saida) {
+        *posicao_ponto_saida = '\0'; // Termina a string no ponto para remover a extensão.
+    }
+    // Monta o caminho completo do arquivo de saída no diretório `nome_diretorio_saida`.
+    int tamanho_montado = snprintf(caminho_arquivo_saida, tamanho_caminho, "%s/%s_%s%s%s%s", nome_diretorio_saida, nome_base_arquivo_saida,
+                                   filtro->nome, (configuracao_execucao.usar_canny && filtro->possui_gy) ? "_canny" : "", sufixo, extensao);
+    if (tamanho_montado < 0 || (size_t)tamanho_montado >= tamanho_caminho) {
+        fprintf(stderr, "Caminho de saída longo demais para '%s' (%s%s); o arquivo não será gravado\n", nome_arquivo, sufixo, extensao);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Acumula o resultado de um nível da pirâmide na imagem composta (máximo entre escalas).
+ *
+ * Cada pixel da imagem composta (tamanho padrão) recebe o maior valor entre o que já tinha e o
+ * pixel correspondente do nível (ampliação por vizinho mais próximo). O nível 0 só é copiado.
+ *
+ * @param resultado_nivel Resultado do filtro no nível (largura x altura).
+ * @param largura Largura do nível.
+ * @param altura Altura do nível.
+ * @param nivel Índice do nível (fator de redução 2^nivel).
+ * @param resultado_composto Imagem composta (LARGURA_PADRAO_IMG x ALTURA_PADRAO_IMG).
+ */
+void acumular_nivel_composto(const unsigned char *resultado_nivel, int largura, int altura, int nivel, unsigned char *resultado_composto) {
+    int coord_x, coord_y; // Coordenadas na imagem composta.
+
+    if (nivel == 0) {
+        memcpy(resultado_composto, resultado_nivel, (size_t)largura * altura);
+        return;
+    }
+    for (coord_y = 0; coord_y < ALTURA_PADRAO_IMG; coord_y++) {
+        int linha_nivel = coord_y >> nivel;
+        if (linha_nivel >= altura) linha_nivel = altura - 1; // Níveis de dimensão ímpar perdem a última linha.
+        const unsigned char *origem = resultado_nivel + linha_nivel * largura;
+        unsigned char *destino = resultado_composto + coord_y * LARGURA_PADRAO_IMG;
+        for (coord_x = 0; coord_x < LARGURA_PADRAO_IMG; coord_x++) {
+            int coluna_nivel = coord_x >> nivel;
+            if (coluna_nivel >= largura) coluna_nivel = largura - 1;
+            if (origem[coluna_nivel] > destino[coord_x]) destino[coord_x] = origem[coluna_nivel];
+        }
+    }
+}
+
+/**
+ * @brief Aplica um filtro a cada nível da pirâmide de `imagem_global_cinza` e salva os resultados.
+ *
+ * O nível 0 é a própria imagem em escala de cinza; cada nível seguinte é o anterior reduzido
+ * por `reduzir_plano_metade`. Conforme `configuracao_execucao.piramide_composta`, salva um PNG
+ * por nível (`_nivel<k>`, na resolução do nível) ou um único PNG com o máximo entre as escalas
+ * (`_piramide`, no tamanho padrão).
+ *
+ * @param filtro Filtro a aplicar.
+ * @param nome_diretorio_saida Diretório onde os resultados serão salvos.
+ * @param nome_arquivo Nome da imagem de entrada (sem diretório).
+ * @param buffer_gradiente_x Buffer intermediário para Gx (tamanho padrão).
+ * @param buffer_gradiente_y Buffer intermediário para Gy (tamanho padrão).
+ * @param mapa Mapa de blocos usado pela pré-passada de regiões planas.
+ */
+void processar_piramide(const tipo_filtro_borda *filtro, const char *nome_diretorio_saida, const char *nome_arquivo,
+                        tipo_resultado_conv *buffer_gradiente_x, tipo_resultado_conv *buffer_gradiente_y, tipo_mapa_blocos *mapa) {
+    // Os níveis 1 em diante somam menos de 1/3 do nível 0, então cabem em um plano do tamanho padrão.
+    static unsigned char planos_reduzidos[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+    static unsigned char resultado_nivel[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+    static unsigned char resultado_composto[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+    const unsigned char *plano_nivel = &imagem_global_cinza[0][0];
+    unsigned char *proximo_plano = planos_reduzidos;
+    int largura = LARGURA_PADRAO_IMG, altura = ALTURA_PADRAO_IMG;
+    char caminho_arquivo_saida[256];
+    char sufixo[32];
+    int nivel;
+
+    for (nivel = 0; nivel < configuracao_execucao.niveis_piramide; nivel++) {
+        if (nivel > 0) {
+            reduzir_plano_metade(plano_nivel, largura, altura, proximo_plano);
+            plano_nivel = proximo_plano;
+            largura /= 2;
+            altura /= 2;
+            proximo_plano += largura * altura;
+        }
+        aplicar_filtro_plano(filtro, plano_nivel, largura, altura, buffer_gradiente_x, buffer_gradiente_y, resultado_nivel, mapa, NULL);
+
+        if (configuracao_execucao.piramide_composta) {
+            acumular_nivel_composto(resultado_nivel, largura, altura, nivel, resultado_composto);
+        } else {
+            snprintf(sufixo, sizeof(sufixo), "_nivel%d", nivel);
+            if (montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                                     filtro, sufixo, ".png") != 0) {
+                continue;
+            }
+            uint64_t instante_salvar = instante_estatistica_ns();
+            salvar_plano_cinza_png(caminho_arquivo_saida, resultado_nivel, largura, altura);
+            registrar_etapa_estatistica(ETAPA_SALVAR, instante_salvar);
+            contabilizar_arquivo_gravado(caminho_arquivo_saida);
+        }
+    }
+
+    if (configuracao_execucao.piramide_composta &&
+        montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                             filtro, "_piramide", ".png") == 0) {
+        uint64_t instante_salvar = instante_estatistica_ns();
+        salvar_plano_cinza_png(caminho_arquivo_saida, resultado_composto, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG);
+        registrar_etapa_estatistica(ETAPA_SALVAR, instante_salvar);
+        contabilizar_arquivo_gravado(caminho_arquivo_saida);
+    }
+}
+
+/**
+ * @brief Executa as etapas de análise que reaproveitam o resultado do filtro de uma imagem (Hough, cantos, HOG).
+ *
+ * Cada etapa só roda se tiver sido pedida na linha de comando; as que usam Gx/Gy só rodam se o
+ * filtro tiver kernel Gy, e recebem os gradientes do modo bruto (`calcular_gradientes_brutos`).
+ *
+ * @param filtro Filtro aplicado.
+ * @param nome_diretorio_saida Diretório onde os resultados serão salvos.
+ * @param nome_arquivo Nome da imagem de entrada (sem diretório).
+ * @param gradiente_x_bruto Gx bruto da imagem (tamanho padrão).
+ * @param gradiente_y_bruto Gy bruto da imagem (tamanho padrão).
+ * @param buffer_resultado Imagem de bordas produzida pelo filtro (tamanho padrão).
+ */
+void analisar_resultado_imagem(const tipo_filtro_borda *filtro, const char *nome_diretorio_saida, const char *nome_arquivo,
+                               const tipo_resultado_conv *gradiente_x_bruto, const tipo_resultado_conv *gradiente_y_bruto,
+                               const unsigned char *buffer_resultado) {
+    static tipo_ponto_canto cantos_detectados[MAX_CANTOS_SUPORTADOS];
+    static tipo_linha_hough linhas_detectadas[HOUGH_MAX_LINHAS];
+    char caminho_arquivo_saida[256];
+
+    // --- Linhas de Hough (sobre o mapa de bordas, em memória) ---
+    if (configuracao_execucao.max_linhas_hough > 0) {
+        int total_linhas = detectar_linhas_hough(buffer_resultado, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                                                 linhas_detectadas, configuracao_execucao.max_linhas_hough);
+        if (total_linhas < 0) {
+            fprintf(stderr, "Memória insuficiente para a transformada de Hough de '%s'\n", nome_arquivo);
+        } else if (montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                                        filtro, "_hough", ".txt") == 0) {
+            salvar_linhas_hough(caminho_arquivo_saida, linhas_detectadas, total_linhas);
+        }
+    }
+
+    if (!filtro->possui_gy) return;
+
+    // --- Cantos (Harris / Shi-Tomasi) ---
+    if (configuracao_execucao.metodo_cantos != CANTOS_DESATIVADO) {
+        int total_cantos = detectar_cantos(gradiente_x_bruto, gradiente_y_bruto, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                                           configuracao_execucao.metodo_cantos, cantos_detectados, configuracao_execucao.max_cantos);
+        if (total_cantos < 0) {
+            fprintf(stderr, "Memória insuficiente para detectar cantos em '%s'\n", nome_arquivo);
+        } else if (montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                                        filtro, "_cantos", ".txt") == 0) {
+            salvar_cantos(caminho_arquivo_saida, configuracao_execucao.metodo_cantos, cantos_detectados, total_cantos);
+        }
+    }
+
+    // --- Descritor HOG ---
+    if (configuracao_execucao.usar_hog) {
+        tipo_dimensoes_hog dimensoes_hog;
+        calcular_dimensoes_hog(LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, configuracao_execucao.hog_tamanho_celula,
+                               configuracao_execucao.hog_celulas_bloco, &dimensoes_hog); // Já validado nos argumentos.
+        uint8_t *descritor_hog = malloc((size_t)dimensoes_hog.tamanho_descritor);
+        if (descritor_hog == NULL ||
+            calcular_descritor_hog(gradiente_x_bruto, gradiente_y_bruto, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                                   &dimensoes_hog, descritor_hog) != 0) {
+            fprintf(stderr, "Memória insuficiente para o descritor HOG de '%s'\n", nome_arquivo);
+        } else if (montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                                        filtro, "_hog", ".hog") == 0) {
+            salvar_descritor_hog(caminho_arquivo_saida, &dimensoes_hog, descritor_hog);
+        }
+        free(descritor_hog);
+    }
+}
+
+/**
+ * @brief Grava a máscara binária de bordas de uma imagem (`--mascara`).
+ *
+ * O limiar vem do histograma acumulado durante o cálculo da magnitude (Otsu ou percentil); com
+ * Canny, a imagem já é binária e o limiar é fixo.
+ *
+ * @param filtro Filtro aplicado.
+ * @param nome_diretorio_saida Diretório onde a máscara será salva.
+ * @param nome_arquivo Nome da imagem de entrada (sem diretório).
+ * @param buffer_resultado Imagem de bordas produzida pelo filtro (tamanho padrão).
+ * @param histograma_magnitude Histograma (256 bins) de `buffer_resultado`.
+ * @return 0 em caso de sucesso, -1 em caso de erro.
+ */
+int salvar_mascara_bordas(const tipo_filtro_borda *filtro, const char *nome_diretorio_saida, const char *nome_arquivo,
+                          const unsigned char *buffer_resultado, const uint32_t *histograma_magnitude) {
+    static uint64_t mascara_bordas[ALTURA_PADRAO_IMG * ((LARGURA_PADRAO_IMG + BITS_PALAVRA_MASCARA - 1) / BITS_PALAVRA_MASCARA)];
+    char caminho_arquivo_saida[256];
+    int limiar;
+
+    if (configuracao_execucao.usar_canny && filtro->possui_gy) {
+        limiar = 128; // Saída do Canny: 0 ou 255.
+    } else if (configuracao_execucao.limiar_mascara == MASCARA_OTSU) {
+        limiar = calcular_limiar_otsu(histograma_magnitude);
+    } else {
+        limiar = calcular_limiar_percentil(histograma_magnitude, configuracao_execucao.percentil_mascara);
+    }
+
+    if (montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                             filtro, "", ".msk") != 0) {
+        return -1;
+    }
+    empacotar_mascara(buffer_resultado, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, limiar, mascara_bordas);
+    long bytes_gravados = salvar_mascara(caminho_arquivo_saida, mascara_bordas, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                                         limiar, configuracao_execucao.formato_mascara);
+    if (bytes_gravados < 0) return -1;
+    if (metricas_ativas) somar_metrica(METRICA_BYTES_GRAVADOS, (uint64_t)bytes_gravados);
+
+    printf("Máscara salva: %s (limiar %d, %ld pixels de borda, %ld bytes)\n", caminho_arquivo_saida, limiar,
+           contar_pixels_mascara(mascara_bordas, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG), bytes_gravados);
+    return 0;
+}
+
+/**
+ * @brief Calcula Gx/Gy no modo bruto para a exportação e as análises que usam o gradiente (cantos, HOG).
+ *
+ * Os buffers do filtro guardam os valores devolvidos pela FPGA (255 sempre que a resposta sai de
+ * [-128, 127]), que não servem como gradiente. Por isso os kernels são refeitos na CPU sem essa
+ * saturação (`convolver_regiao_cpu_bruto`), em qualquer motor, sobre o mesmo plano do filtro: o
+ * cinza com a pré-suavização de `--suavizar`/`--log` ou, com `--cor`, os três canais combinados.
+ * Kernels cuja resposta pode passar de ±32767 são avisados uma vez por filtro.
+ *
+ * @param filtro Filtro aplicado.
+ * @param imagem_rgb Imagem RGB intercalada (tamanho padrão), usada com `--cor`.
+ * @param gradiente_x_bruto Buffer (tamanho padrão) que recebe Gx.
+ * @param gradiente_y_bruto Buffer (tamanho padrão) que recebe Gy (não usado se o filtro não tiver Gy).
+ * @return 0 em caso de sucesso, -1 se faltar memória.
+ */
+int calcular_gradientes_brutos(const tipo_filtro_borda *filtro, const unsigned char *imagem_rgb,
+                               tipo_resultado_conv *gradiente_x_bruto, tipo_resultado_conv *gradiente_y_bruto) {
+    static unsigned char plano_suavizado[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+    static const tipo_filtro_borda *filtro_avisado = NULL;
+    const unsigned char *plano = &imagem_global_cinza[0][0];
+
+    if (filtro != filtro_avisado &&
+        (maior_resposta_bruta(&filtro->kernel_gx) > INT16_MAX || (filtro->possui_gy && maior_resposta_bruta(&filtro->kernel_gy) > INT16_MAX))) {
+        fprintf(stderr, "Aviso: Gx/Gy de '%s' podem passar de 16 bits; os gradientes brutos são limitados a ±32767\n", filtro->nome);
+        filtro_avisado = filtro;
+    }
+
+    if (configuracao_execucao.combinacao_cor != COR_DESATIVADA) {
+        if (calcular_gradientes_cor_brutos(filtro, imagem_rgb, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, configuracao_execucao.combinacao_cor,
+                                           gradiente_x_bruto, gradiente_y_bruto) != 0) {
+            fprintf(stderr, "Memória insuficiente para os gradientes brutos\n");
+            return -1;
+        }
+        return 0;
+    }
+    if (configuracao_execucao.lado_suavizacao > 0) {
+        suavizar_plano(plano, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, configuracao_execucao.lado_suavizacao, plano_suavizado);
+        plano = plano_suavizado;
+    }
+    calcular_gradiente_plano_bruto(&filtro->kernel_gx, plano, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, gradiente_x_bruto);
+    if (filtro->possui_gy) calcular_gradiente_plano_bruto(&filtro->kernel_gy, plano, LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, gradiente_y_bruto);
+    return 0;
+}
+
+/**
+ * @brief Carrega uma imagem, aplica um filtro e salva o resultado no diretório de saída.
+ *
+ * Os buffers de trabalho são estáticos: só uma imagem é processada por vez, seja na thread
+ * principal ou na thread de refinamento (a thread principal espera a de refinamento terminar
+ * antes de processar outra operação).
+ *
+ * @param caminho_arquivo_entrada Caminho da imagem de entrada.
+ * @param nome_arquivo Nome da imagem (sem diretório), usado para montar o nome de saída.
+ * @param nome_diretorio_saida Diretório onde o resultado será salvo.
+ * @param filtro Filtro a aplicar.
+ * @param modo Resolução e forma de relatar o processamento.
+ * @return 0 em caso de sucesso, -1 em caso de erro ou cancelamento.
+ */
+static int executar_etapas_imagem(const char *caminho_arquivo_entrada, const char *nome_arquivo, const char *nome_diretorio_saida,
+                                  const tipo_filtro_borda *filtro, tipo_modo_processamento modo) {
+    char caminho_arquivo_saida[256];   // Buffer para construir o caminho completo do arquivo de saída.
+    // Buffers de trabalho (`static` para evitar estouro de pilha).
+    static unsigned char buffer_imagem_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3];
+    static unsigned char buffer_resultado_filtro[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG];
+    static tipo_resultado_conv buffer_gradiente_x[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG];
+    static tipo_resultado_conv buffer_gradiente_y[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG];
+    static tipo_resultado_conv gradiente_x_bruto[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+    static tipo_resultado_conv gradiente_y_bruto[ALTURA_PADRAO_IMG * LARGURA_PADRAO_IMG];
+    static unsigned char plano_previa[ALTURA_PREVIA_IMG * LARGURA_PREVIA_IMG];
+    static tipo_mapa_blocos mapa_blocos;
+    static uint32_t histograma_magnitude[BINS_HISTOGRAMA_MAGNITUDE];
+    int pular_png = 0; // A exportação e a máscara substituem o PNG.
+    int largura_original, altura_original;
+    uint64_t instante_etapa;
+
+    if (modo != PROCESSAMENTO_REFINAMENTO) {
+        printf("\nProcessando arquivo: %s\n", caminho_arquivo_entrada);
+    }
+
+    // 1. Carrega e redimensiona a imagem.
+    instante_etapa = instante_estatistica_ns();
+    unsigned char *dados_imagem_bruta = decodificar_imagem_rgb(caminho_arquivo_entrada, &largura_original, &altura_original);
+    if (dados_imagem_bruta == NULL) {
+        fprintf(stderr, "Erro ao carregar ou redimensionar a imagem '%s'. Pulando para a próxima.\n", caminho_arquivo_entrada);
+        return -1;
+    }
+    registrar_etapa_estatistica(ETAPA_CARREGAR, instante_etapa);
+    instante_etapa = instante_estatistica_ns();
+    redimensionar_imagem_rgb(dados_imagem_bruta, largura_original, altura_original, buffer_imagem_rgb);
+    liberar_imagem_decodificada(dados_imagem_bruta);
+    registrar_etapa_estatistica(ETAPA_REDIMENSIONAR, instante_etapa);
+
+    // 2. Converte a imagem RGB para escala de cinza.
+    // A imagem em escala de cinza é armazenada na variável global `imagem_global_cinza`.
+    instante_etapa = instante_estatistica_ns();
+    converter_rgb_para_cinza(buffer_imagem_rgb, imagem_global_cinza);
+    registrar_etapa_estatistica(ETAPA_CINZA, instante_etapa);
+
+    // 3. Aplica o filtro de borda selecionado, na resolução pedida pelo modo.
+    if (modo == PROCESSAMENTO_PREVIA) {
+        reduzir_plano_metade(&imagem_global_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, plano_previa);
+        aplicar_filtro_plano(filtro, plano_previa, LARGURA_PREVIA_IMG, ALTURA_PREVIA_IMG,
+                             &buffer_gradiente_x[0][0], &buffer_gradiente_y[0][0], &buffer_resultado_filtro[0][0], &mapa_blocos, NULL);
+    } else if (modo == PROCESSAMENTO_PIRAMIDE) {
+        // Todos os níveis reaproveitam a decodificação e a conversão para cinza feitas acima.
+        processar_piramide(filtro, nome_diretorio_saida, nome_arquivo, &buffer_gradiente_x[0][0], &buffer_gradiente_y[0][0], &mapa_blocos);
+        printf("Pirâmide de %d níveis de '%s' concluída.\n", configuracao_execucao.niveis_piramide, nome_arquivo);
+        return 0;
+    } else if (modo == PROCESSAMENTO_REFINAMENTO) {
+        atomic_store(&refinamento_interrompido, 0);
+        aplicar_filtro_plano(filtro, &imagem_global_cinza[0][0], LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG,
+                             &buffer_gradiente_x[0][0], &buffer_gradiente_y[0][0], &buffer_resultado_filtro[0][0], &mapa_blocos, NULL);
+        // Um resultado parcial (interrompido no meio da imagem) não é salvo; um completo é salvo
+        // mesmo que o cancelamento tenha chegado depois do cálculo.
+        if (atomic_load(&refinamento_interrompido)) return -1;
+    } else {
+        uint32_t *histograma = (configuracao_execucao.limiar_mascara != MASCARA_DESATIVADA) ? histograma_magnitude : NULL;
+        if (configuracao_execucao.combinacao_cor != COR_DESATIVADA) {
+            if (aplicar_filtro_cor_operacao(filtro, &buffer_imagem_rgb[0][0][0], buffer_gradiente_x, buffer_gradiente_y,
+                                            buffer_resultado_filtro, histograma) != 0) {
+                return -1;
+            }
+        } else {
+            // A função `aplicar_filtro_operacao` usa a `imagem_global_cinza` global.
+            aplicar_filtro_operacao(filtro, buffer_gradiente_x, buffer_gradiente_y, buffer_resultado_filtro, histograma);
+        }
+        // Gx/Gy sem a saturação da FPGA, calculados uma vez para a exportação, os cantos e o HOG.
+        int usar_gradientes_brutos = configuracao_execucao.formato_exportacao != EXPORTACAO_NENHUMA ||
+                                     (filtro->possui_gy && (configuracao_execucao.metodo_cantos != CANTOS_DESATIVADO || configuracao_execucao.usar_hog));
+        if (usar_gradientes_brutos && calcular_gradientes_brutos(filtro, &buffer_imagem_rgb[0][0][0], gradiente_x_bruto, gradiente_y_bruto) != 0) {
+            return -1;
+        }
+        // Etapas que reaproveitam os gradientes e a imagem de bordas (Hough, cantos, HOG).
+        analisar_resultado_imagem(filtro, nome_diretorio_saida, nome_arquivo, gradiente_x_bruto, gradiente_y_bruto, &buffer_resultado_filtro[0][0]);
+
+        instante_etapa = instante_estatistica_ns();
+        if (configuracao_execucao.formato_exportacao != EXPORTACAO_NENHUMA) {
+            // Exportação: grava os gradientes brutos, sem codificar PNG. Cada matriz recebe seu próprio sufixo.
+            if (montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                                     filtro, "", "") != 0 ||
+                exportar_gradientes(caminho_arquivo_saida, gradiente_x_bruto, filtro->possui_gy ? gradiente_y_bruto : NULL,
+                                    LARGURA_PADRAO_IMG, ALTURA_PADRAO_IMG, configuracao_execucao.formato_exportacao) != 0) {
+                return -1;
+            }
+            printf("Gradientes de '%s' exportados em '%s_*'.\n", nome_arquivo, caminho_arquivo_saida);
+            pular_png = 1;
+        }
+
+        if (configuracao_execucao.limiar_mascara != MASCARA_DESATIVADA) {
+            if (salvar_mascara_bordas(filtro, nome_diretorio_saida, nome_arquivo, &buffer_resultado_filtro[0][0], histograma_magnitude) != 0) {
+                return -1;
+            }
+            pular_png = 1;
+        }
+        registrar_etapa_estatistica(ETAPA_SALVAR, instante_etapa);
+        if (pular_png) return 0;
+    }
+
+    // 4. Constrói o nome do arquivo de saída.
+    if (montar_caminho_saida(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), nome_diretorio_saida, nome_arquivo,
+                             filtro, (modo == PROCESSAMENTO_PREVIA) ? "_previa" : "", ".png") != 0) {
+        return -1;
+    }
+
+    // 5. Salva a imagem resultante (em escala de cinza) como PNG.
+    instante_etapa = instante_estatistica_ns();
+    if (modo == PROCESSAMENTO_PREVIA) {
+        salvar_plano_cinza_png(caminho_arquivo_saida, &buffer_resultado_filtro[0][0], LARGURA_PREVIA_IMG, ALTURA_PREVIA_IMG);
+    } else {
+        salvar_imagem_cinza_png(caminho_arquivo_saida, buffer_resultado_filtro);
+    }
+    registrar_etapa_estatistica(ETAPA_SALVAR, instante_etapa);
+    contabilizar_arquivo_gravado(caminho_arquivo_saida);
+
+    if (modo != PROCESSAMENTO_REFINAMENTO) {
+        printf("Processamento de '%s' concluído. Resultado salvo em '%s'.\n", nome_arquivo, caminho_arquivo_saida);
+    }
+    return 0;
+}
+
+/**
+ * @brief Processa uma imagem (`executar_etapas_imagem`) e, com `--stats`, grava sua linha de estatísticas.
+ *
+ * Com `--metricas`, conta a imagem e sua latência no histograma do filtro. Na co-simulação do RTL
+ * (`Coprocessor/sim`), soma às estatísticas os ciclos de clock simulados durante a imagem.
+ *
+ * @return 0 em caso de sucesso, -1 em caso de erro ou cancelamento.
+ */
+int processar_arquivo_imagem(const char *caminho_arquivo_entrada, const char *nome_arquivo, const char *nome_diretorio_saida,
+                             const tipo_filtro_borda *filtro, tipo_modo_processamento modo) {
+    static const char *const nomes_modos[] = { "completo", "previa", "refinamento", "piramide" };
+    uint64_t instante_inicio = metricas_ativas ? instante_metrica_ns() : 0;
+    int usa_fpga = !configuracao_execucao.usar_motor_cpu;
+    uint64_t ciclos_inicio = usa_fpga ? ciclos_dispositivo_fpga() : 0;
+
+    iniciar_imagem_estatistica(nome_arquivo, filtro->nome, nomes_modos[modo]);
+    int resultado = executar_etapas_imagem(caminho_arquivo_entrada, nome_arquivo, nome_diretorio_saida, filtro, modo);
+    if (usa_fpga) contar_estatistica(CONTADOR_CICLOS_FPGA, ciclos_dispositivo_fpga() - ciclos_inicio);
+    concluir_imagem_estatistica(resultado == 0);
+    if (metricas_ativas) {
+        registrar_imagem_metrica((int)(filtro - filtros_registrados), resultado == 0, instante_metrica_ns() - instante_inicio);
+    }
+    return resultado;
+}
+
+/**
+ * @brief Aplica um filtro a todas as imagens suportadas de um diretório.
+ *
+ * No modo de refinamento, verifica `refinamento_cancelado` antes de cada imagem.
+ *
+ * @param nome_diretorio_entrada Diretório com as imagens de entrada.
+ * @param nome_diretorio_saida Diretório onde os resultados serão salvos.
+ * @param filtro Filtro a aplicar.
+ * @param modo Modo de processamento de cada imagem.
+ * @return Quantidade de imagens processadas com sucesso, ou -1 se o diretório não puder ser aberto.
+ */
+int processar_diretorio_entrada(const char *nome_diretorio_entrada, const char *nome_diretorio_saida,
+                                const tipo_filtro_borda *filtro, tipo_modo_processamento modo) {
+    char caminho_arquivo_entrada[256]; // Buffer para construir o caminho completo do arquivo de entrada.
+    DIR *ponteiro_diretorio;           // Ponteiro para a estrutura de diretório.
+    struct dirent *entrada_diretorio;  // Ponteiro para a entrada de diretório (arquivo ou subdiretório).
+    int total_processadas = 0;
+
+    ponteiro_diretorio = opendir(nome_diretorio_entrada);
+    if (ponteiro_diretorio == NULL) return -1;
+
+    // Lê a próxima entrada no diretório.
+    while ((entrada_diretorio = readdir(ponteiro_diretorio)) != NULL) {
+        if (modo == PROCESSAMENTO_REFINAMENTO && atomic_load(&refinamento_cancelado)) break;
+
+        // Ignora as entradas especiais "." (diretório atual) e ".." (diretório pai).
+        if (strcmp(entrada_diretorio->d_name, ".") == 0 || strcmp(entrada_diretorio->d_name, "..") == 0) {
+            continue;
+        }
+
+        // Constrói o caminho completo para o arquivo de entrada.
+        snprintf(caminho_arquivo_entrada, sizeof(caminho_arquivo_entrada), "%s/%s", nome_diretorio_entrada, entrada_diretorio->d_name);
+
+        // Verifica se a entrada é um arquivo regular (S_ISREG) com uma extensão de imagem suportada.
+        struct stat info_arquivo;
+        if (stat(caminho_arquivo_entrada, &info_arquivo) != 0 ||
+            !S_ISREG(info_arquivo.st_mode) || !verificar_arquivo_imagem_valido(entrada_diretorio->d_name)) {
+            continue; // Pula para a próxima entrada do diretório.
+        }
+
+        if (processar_arquivo_imagem(caminho_arquivo_entrada, entrada_diretorio->d_name, nome_diretorio_saida, filtro, modo) == 0) {
+            total_processadas++;
+            if (metricas_ativas) somar_metrica(METRICA_BYTES_LIDOS, (uint64_t)info_arquivo.st_size);
+        }
+    }
+
+    closedir(ponteiro_diretorio);
+    return total_processadas;
+}
+
+/**
+ * @brief Corpo da thread de refinamento: reprocessa o diretório em resolução completa.
+ *
+ * @param argumento Ponteiro para `tipo_tarefa_refinamento`.
+ * @return NULL.
+ */
+static void *executar_refinamento(void *argumento) {
+    const tipo_tarefa_refinamento *tarefa = (const tipo_tarefa_refinamento *)argumento;
+    if (rastro_ativo) nomear_thread_rastro("refinamento");
+    int total_refinadas = processar_diretorio_entrada(tarefa->nome_diretorio_entrada, tarefa->nome_diretorio_saida,
+                                                      tarefa->filtro, PROCESSAMENTO_REFINAMENTO);
+    if (!atomic_load(&refinamento_cancelado)) {
+        printf("\n[refinamento] %d imagem(ns) salvas em resolução completa com o filtro '%s'.\n", total_refinadas, tarefa->filtro->nome);
+    } else {
+        printf("\n[refinamento] Interrompido; %d imagem(ns) já salvas em resolução completa com o filtro '%s'.\n",
+               total_refinadas > 0 ? total_refinadas : 0, tarefa->filtro->nome);
+    }
+    fflush(stdout);
+    encerrar_contadores_hw_thread();
+    if (rastro_ativo) encerrar_rastro_thread(); // O próximo refinamento continua no mesmo buffer.
+    return NULL;
+}
+
+/**
+ * @brief Inicia o refinamento em resolução completa em segundo plano.
+ *
+ * Se a thread não puder ser criada, o refinamento é feito na thread principal.
+ */
+void iniciar_refinamento(const tipo_filtro_borda *filtro, const char *nome_diretorio_entrada, const char *nome_diretorio_saida) {
+    tarefa_refinamento.filtro = filtro;
+    tarefa_refinamento.nome_diretorio_entrada = nome_diretorio_entrada;
+    tarefa_refinamento.nome_diretorio_saida = nome_diretorio_saida;
+    atomic_store(&refinamento_cancelado, 0);
+
+    if (pthread_create(&thread_refinamento, NULL, executar_refinamento, &tarefa_refinamento) != 0) {
+        fprintf(stderr, "Não foi possível criar a thread de refinamento. Refinando agora.\n");
+        executar_refinamento(&tarefa_refinamento);
+        return;
+    }
+    refinamento_em_andamento = 1;
+    printf("Refinamento em resolução completa iniciado em segundo plano.\n");
+}
+
+/**
+ * @brief Interrompe o refinamento em andamento (se houver) e espera a thread terminar.
+ *
+ * Chamada antes de qualquer nova operação do operador: a thread de refinamento usa os mesmos
+ * buffers globais e, no modo FPGA, o mesmo coprocessador. O sinal de cancelamento é desfeito em
+ * seguida, para não interromper o processamento da próxima operação na thread principal.
+ */
+void interromper_refinamento(void) {
+    if (!refinamento_em_andamento) return;
+    atomic_store(&refinamento_cancelado, 1);
+    pthread_join(thread_refinamento, NULL);
+    atomic_store(&refinamento_cancelado, 0);
+    refinamento_em_andamento = 0;
+}
+
 /* ====================================================== */
 /* ================= FUNÇÃO PRINCIPAL =================== */
 /* ====================================================== */
 
-int main() {
+int main(int argc, char *argv[]) {
     // --- Variáveis Locais --- 
-    char caminho_arquivo_entrada[256]; // Buffer para construir o caminho completo do arquivo de entrada.
-    char caminho_arquivo_saida[256];   // Buffer para construir o caminho completo do arquivo de saída.
-    char nome_base_arquivo_saida[100]; // Buffer para armazenar a parte base do nome do arquivo de saída (sem extensão).
-    unsigned char buffer_imagem_rgb[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG][3]; // Buffer para armazenar a imagem RGB carregada e redimensionada.
-    // Buffer para armazenar o resultado final do filtro de borda (imagem em escala de cinza).
-    // `static` para evitar estouro de pilha.
-    static unsigned char buffer_resultado_filtro[ALTURA_PADRAO_IMG][LARGURA_PADRAO_IMG]; 
     uint32_t opcao_usuario;            // Armazena a opção de filtro selecionada pelo usuário.
-    // int coord_y_main, coord_x_main; // Variáveis de iteração (não usadas diretamente no main, removidas para limpeza).
     DIR *ponteiro_diretorio;           // Ponteiro para a estrutura de diretório.
-    struct dirent *entrada_diretorio;  // Ponteiro para a entrada de diretório (arquivo ou subdiretório).
-    const char *nome_diretorio_entrada = "input";   // Nome do diretório de entrada padrão.
-    const char *nome_diretorio_saida = "output"; // Nome do diretório de saída padrão.
+    const char *nome_diretorio_entrada;  // Nome do diretório de entrada (padrão: input).
+    const char *nome_diretorio_saida;    // Nome do diretório de saída (padrão: output).
 
     // --- Inicialização --- 
 
+    // Interpreta os argumentos de linha de comando (motor de convolução, arquivo de filtros).
+    int resultado_argumentos = interpretar_argumentos(argc, argv);
+    if (resultado_argumentos != 0) {
+        return (resultado_argumentos > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    nome_diretorio_entrada = configuracao_execucao.diretorio_entrada;
+    nome_diretorio_saida = configuracao_execucao.diretorio_saida;
+
+    // Carrega o registro de filtros. Sem o arquivo, usa os cinco filtros embutidos.
+    if (carregar_registro_filtros(configuracao_execucao.arquivo_filtros) < 0) {
+        printf("Arquivo de filtros '%s' indisponível ou inválido. Usando filtros embutidos.\n", configuracao_execucao.arquivo_filtros);
+        registrar_filtros_padrao();
+    }
+    printf("Filtros registrados (%d):\n", total_filtros_registrados);
+    imprimir_analise_filtros();
+
     // Tenta criar o diretório de saída. Ignora o erro se ele já existir.
     if (mkdir(nome_diretorio_saida, 0777) == -1 && errno != EEXIST) {
         perror("Erro ao criar diretório de saída");
         return EXIT_FAILURE; // Encerra se não puder criar o diretório.
     }
     
-    // Inicializa a comunicação com o hardware/FPGA.
+    // Inicializa a comunicação com o hardware/FPGA (apenas quando as convoluções forem feitas na FPGA).
     // `initiate_hardware` é definida externamente (hps_0.h / lib.s).
-    if (initiate_hardware() != HW_SUCCESS) { 
+    if (!configuracao_execucao.usar_motor_cpu && initiate_hardware() != HW_SUCCESS) { 
         fprintf(stderr, "Falha ao inicializar hardware (FPGA)\n");
         return EXIT_FAILURE; // Encerra se a inicialização falhar.
     }
+    if (configuracao_execucao.usar_perfil_fpga) iniciar_perfil_fpga();
     
     printf("\n========= PROCESSAMENTO DE IMAGENS COM FILTRO DE BORDA (FPGA + STB_IMAGE) =========\n");
     
     // Tenta abrir o diretório de entrada.
     ponteiro_diretorio = opendir(nome_diretorio_entrada);
     if (ponteiro_diretorio == NULL) {
-        perror("Erro ao abrir diretório de entrada 'input'");
-        fprintf(stderr, "Certifique-se de que o diretório 'input' existe no mesmo local do executável e contém as imagens.\n");
-        terminate_hardware(); // Libera recursos de hardware antes de sair.
+        fprintf(stderr, "Erro ao abrir diretório de entrada '%s': %s\n", nome_diretorio_entrada, strerror(errno));
+        fprintf(stderr, "Certifique-se de que o diretório '%s' existe e contém as imagens (ou use --entrada).\n", nome_diretorio_entrada);
+        if (!configuracao_execucao.usar_motor_cpu) terminate_hardware(); // Libera recursos de hardware antes de sair.
         return EXIT_FAILURE;
     }
 
+    closedir(ponteiro_diretorio); // Cada operação reabre o diretório (ver `processar_diretorio_entrada`).
+
+    // Métricas do Prometheus (`--metricas`): a primeira gravação já valida o caminho.
+    if (configuracao_execucao.arquivo_metricas != NULL &&
+        iniciar_metricas(configuracao_execucao.arquivo_metricas, configuracao_execucao.intervalo_metricas) != 0) {
+        fprintf(stderr, "Não foi possível gravar as métricas em '%s': %s\n", configuracao_execucao.arquivo_metricas, strerror(errno));
+    }
+
+    // Ativa o rastro (`--rastro`) antes de criar o grupo, para que as threads auxiliares se identifiquem.
+    if (configuracao_execucao.arquivo_rastro != NULL) {
+        if (iniciar_rastro(configuracao_execucao.arquivo_rastro) != 0) {
+            fprintf(stderr, "Não foi possível criar o arquivo de rastro '%s': %s\n", configuracao_execucao.arquivo_rastro, strerror(errno));
+        } else {
+            nomear_thread_rastro("principal");
+        }
+    }
+
+    // Cria o grupo de threads usado pelos motores de CPU e pelo Canny.
+    if (iniciar_grupo_threads(configuracao_execucao.total_threads) > 1) {
+        printf("Usando %d threads para o processamento em CPU.\n", total_threads_grupo());
+    }
+
+    // Abre o arquivo de estatísticas (`--stats`). Sem ele, a execução segue sem estatísticas.
+    if (configuracao_execucao.arquivo_estatisticas != NULL &&
+        iniciar_estatisticas(configuracao_execucao.arquivo_estatisticas, configuracao_execucao.usar_motor_cpu ? "cpu" : "fpga",
+                             total_threads_grupo()) != 0) {
+        fprintf(stderr, "Não foi possível criar o arquivo de estatísticas '%s': %s\n", configuracao_execucao.arquivo_estatisticas, strerror(errno));
+    } else if (configuracao_execucao.usar_contadores_hw) {
+        // Sem contadores disponíveis (VM, kernel sem PMU, perf_event_paranoid), as estatísticas seguem sem eles.
+        int total_eventos_hw = iniciar_contadores_hw();
+        if (total_eventos_hw > 0) printf("Contadores de desempenho ativos (%d de %d eventos).\n", total_eventos_hw, TOTAL_CONTADORES_HW);
+    }
+
     printf("Processando imagens encontradas no diretório '%s'...\n", nome_diretorio_entrada);
 
     // --- Loop Principal de Seleção de Filtro --- 
     // Permite ao usuário escolher um filtro e aplicá-lo a todas as imagens no diretório de entrada.
+    // A última opção do menu (após os filtros registrados) encerra o programa.
+    uint32_t opcao_sair = (uint32_t)total_filtros_registrados + 1;
     while (1) {
         opcao_usuario = 0; // Reseta a seleção.
         
-        // Exibe o menu de opções.
+        // Exibe o menu de opções, montado a partir do registro de filtros.
         printf("\n\n------------------------------------------\n");
         printf("Escolha o filtro de borda para aplicar a TODAS as imagens em '%s':\n", nome_diretorio_entrada);
-        printf("  1 - Sobel (3x3)\n");
-        printf("  2 - Sobel expandido (5x5)\n");
-        printf("  3 - Prewitt (3x3)\n");
-        printf("  4 - Roberts (2x2)\n");
-        printf("  5 - Laplace (5x5)\n");
-        printf("  6 - Sair\n");
+        for (int indice_filtro = 0; indice_filtro < total_filtros_registrados; indice_filtro++) {
+            printf("  %d - %s\n", indice_filtro + 1, filtros_registrados[indice_filtro].nome);
+        }
+        printf("  %u - Sair\n", opcao_sair);
         printf("------------------------------------------\n");
         printf("Opção: ");
         
         // Lê a seleção do usuário.
-        if (scanf("%u", &opcao_usuario) != 1) {
+        int resultado_leitura = scanf("%u", &opcao_usuario);
+        if (resultado_leitura == EOF) {
+            // Fim da entrada (stdin fechado ou redirecionado de um arquivo): equivale a Sair.
+            printf("\nFim da entrada. Encerrando o programa...\n");
+            break;
+        }
+        if (resultado_leitura != 1) {
+            int caractere;
             printf("Entrada inválida! Por favor, digite um número.\n");
-            // Limpa o buffer de entrada para evitar loops infinitos em caso de entrada não numérica.
-            while (getchar() != '\n'); 
+            // Limpa o buffer de entrada para evitar loops infinitos em caso de entrada não numérica
+            // (até o fim da linha ou da entrada).
+            while ((caractere = getchar()) != '\n' && caractere != EOF);
             continue; // Volta ao início do loop while.
         }
                 
-        // Valida a seleção (1 a 5).
-        if (validar_opcao_usuario(opcao_usuario) != 0) { 
+        // O operador passou para outra operação: abandona o refinamento anterior (modo progressivo).
+        interromper_refinamento();
+
+        // Valida a seleção (1 até a opção Sair).
+        if (validar_opcao_usuario(opcao_usuario, opcao_sair) != 0) { 
             continue; // Se inválida, volta ao início do loop while.
         }
 
-        // --- Configuração do Filtro Selecionado --- 
-        const char *nome_filtro_selecionado; // Nome do filtro para usar no nome do arquivo de saída.
-        int8_t *kernel_selecionado_gx = NULL; // Ponteiro para o kernel Gx selecionado.
-        int8_t *kernel_selecionado_gy = NULL; // Ponteiro para o kernel Gy selecionado (NULL para Laplace).
-        uint32_t codigo_tamanho_kernel_selecionado = 0; // Código de tamanho do kernel para passar às funções (0, 1 ou 3).
-
-        // Define os ponteiros e o código de tamanho com base na seleção do usuário.
-        switch (opcao_usuario) {
-            case 1: 
-                nome_filtro_selecionado = "sobel_3x3"; 
-                kernel_selecionado_gx = sobel_gx_3x3; 
-                kernel_selecionado_gy = sobel_gy_3x3; 
-                codigo_tamanho_kernel_selecionado = 1; // Código para 3x3
-                break;
-            case 2: 
-                nome_filtro_selecionado = "sobel_5x5"; 
-                kernel_selecionado_gx = sobel_gx_5x5; 
-                kernel_selecionado_gy = sobel_gy_5x5; 
-                codigo_tamanho_kernel_selecionado = 3; // Código para 5x5
-                break;
-            case 3: 
-                nome_filtro_selecionado = "prewitt_3x3"; 
-                kernel_selecionado_gx = prewitt_gx_3x3; 
-                kernel_selecionado_gy = prewitt_gy_3x3; 
-                codigo_tamanho_kernel_selecionado = 1; // Código para 3x3
-                break;
-            case 4: 
-                nome_filtro_selecionado = "roberts_2x2"; 
-                kernel_selecionado_gx = roberts_gx_2x2; 
-                kernel_selecionado_gy = roberts_gy_2x2; 
-                codigo_tamanho_kernel_selecionado = 0; // Código para 2x2
-                break;
-            case 5: 
-                nome_filtro_selecionado = "laplace_5x5"; 
-                kernel_selecionado_gx = laplace_5x5; 
-                kernel_selecionado_gy = NULL; // Laplace não tem Gy separado.
-                codigo_tamanho_kernel_selecionado = 3; // Código para 5x5
-                break;
-             case 6:
-                  printf("Encerrando o programa...\n");
-                  break;
-            // Não deve chegar aqui devido à validação anterior, mas é uma boa prática ter um default.
-            default: 
-                printf("Erro interno - seleção inválida (%u) após validação.\n", opcao_usuario);
-                continue; 
+        // Encerra o loop de seleção se o usuário escolheu Sair.
+        if (opcao_usuario == opcao_sair) {
+            printf("Encerrando o programa...\n");
+            break;
         }
 
-        printf("\nAplicando filtro '%s' a todas as imagens no diretório '%s'...\n", nome_filtro_selecionado, nome_diretorio_entrada);
-
-        // --- Loop de Processamento de Arquivos --- 
-        // Itera sobre todos os arquivos no diretório de entrada para aplicar o filtro selecionado.
-        
-        // Volta ao início do diretório para garantir que todos os arquivos sejam processados.
-        rewinddir(ponteiro_diretorio);
-
-        // Lê a próxima entrada no diretório.
-        while ((entrada_diretorio = readdir(ponteiro_diretorio)) != NULL) {
-            // Ignora as entradas especiais "." (diretório atual) e ".." (diretório pai).
-            if (strcmp(entrada_diretorio->d_name, ".") == 0 || strcmp(entrada_diretorio->d_name, "..") == 0) {
-                continue;
-            }
-
-            // Constrói o caminho completo para o arquivo de entrada.
-            snprintf(caminho_arquivo_entrada, sizeof(caminho_arquivo_entrada), "%s/%s", nome_diretorio_entrada, entrada_diretorio->d_name);
-
-            // Verifica se a entrada é um arquivo de imagem suportado.
-            struct stat info_arquivo;
-            stat(caminho_arquivo_entrada, &info_arquivo); // Obtém informações sobre o arquivo/diretório.
-            // Verifica se é um arquivo regular (S_ISREG) e se tem uma extensão de imagem suportada.
-            if (!S_ISREG(info_arquivo.st_mode) || !verificar_arquivo_imagem_valido(entrada_diretorio->d_name)) {
-                // printf("Ignorando '%s' (não é um arquivo de imagem suportado).\n", entrada_diretorio->d_name); // Comentado para reduzir output
-                continue; // Pula para a próxima entrada do diretório.
-            }
-
-            printf("\nProcessando arquivo: %s\n", caminho_arquivo_entrada);
-
-            // 1. Carrega e redimensiona a imagem.
-            if (carregar_e_redimensionar_imagem(caminho_arquivo_entrada, buffer_imagem_rgb) != 0) {
-                fprintf(stderr, "Erro ao carregar ou redimensionar a imagem '%s'. Pulando para a próxima.\n", caminho_arquivo_entrada);
-                continue; // Pula esta imagem se houver erro.
-            }
-
-            // 2. Converte a imagem RGB para escala de cinza.
-            // A imagem em escala de cinza é armazenada na variável global `imagem_global_cinza`.
-            converter_rgb_para_cinza(buffer_imagem_rgb, imagem_global_cinza);
-
-            // 3. Aplica o filtro de borda selecionado.
-            // A função `aplicar_filtro_operacao` usa a `imagem_global_cinza` global e armazena o resultado
-            // no buffer local `buffer_resultado_filtro`.
-            aplicar_filtro_operacao(kernel_selecionado_gx, kernel_selecionado_gy, codigo_tamanho_kernel_selecionado, buffer_resultado_filtro);
-
-            // 4. Constrói o nome do arquivo de saída.
-            // Remove a extensão do nome do arquivo original.
-            strncpy(nome_base_arquivo_saida, entrada_diretorio->d_name, sizeof(nome_base_arquivo_saida) - 1);
-            nome_base_arquivo_saida[sizeof(nome_base_arquivo_saida) - 1] = '\0';
-            char *posicao_ponto_saida = strrchr(nome_base_arquivo_saida, '.');
-            if (posicao_ponto_saida) {
-                *posicao_ponto_saida = '\0'; // Termina a string no ponto para remover a extensão.
-            }
-            // Monta o caminho completo do arquivo de saída no diretório `nome_diretorio_saida`.
-            snprintf(caminho_arquivo_saida, sizeof(caminho_arquivo_saida), "%s/%s_%s.png", 
-                     nome_diretorio_saida, nome_base_arquivo_saida, nome_filtro_selecionado);
+        // --- Configuração do Filtro Selecionado --- 
+        const tipo_filtro_borda *filtro_selecionado = &filtros_registrados[opcao_usuario - 1];
+        const char *nome_filtro_selecionado = filtro_selecionado->nome; // Nome do filtro para usar no nome do arquivo de saída.
 
-            // 5. Salva a imagem resultante (em escala de cinza) como PNG.
-            salvar_imagem_cinza_png(caminho_arquivo_saida, buffer_resultado_filtro);
-            
-            printf("Processamento de '%s' concluído. Resultado salvo em '%s'.\n", entrada_diretorio->d_name, caminho_arquivo_saida);
+        printf("\nAplicando filtro '%s' a todas as imagens no diretório '%s'...\n", nome_filtro_selecionado, nome_diretorio_entrada);
 
-        } // Fim do loop while (readdir)
+        // --- Processamento dos Arquivos --- 
+        if (configuracao_execucao.modo_progressivo) {
+            // Prévias em meia resolução primeiro; a resolução completa segue em segundo plano.
+            processar_diretorio_entrada(nome_diretorio_entrada, nome_diretorio_saida, filtro_selecionado, PROCESSAMENTO_PREVIA);
+            printf("\nPrévias do filtro '%s' concluídas.\n", nome_filtro_selecionado);
+            iniciar_refinamento(filtro_selecionado, nome_diretorio_entrada, nome_diretorio_saida);
+            continue;
+        }
+        processar_diretorio_entrada(nome_diretorio_entrada, nome_diretorio_saida, filtro_selecionado,
+                                    configuracao_execucao.niveis_piramide > 0 ? PROCESSAMENTO_PIRAMIDE : PROCESSAMENTO_COMPLETO);
         
         printf("\nProcessamento de todas as imagens para o filtro '%s' concluído.\n", nome_filtro_selecionado);
         // Volta para o menu de seleção de filtro.
@@ -742,11 +1768,19 @@ int main() {
 
     // --- Finalização ---
     
-    // Fecha o diretório de entrada.
-    closedir(ponteiro_diretorio);
+    // Garante que nenhum refinamento continue usando o hardware.
+    interromper_refinamento();
+    encerrar_estatisticas();
+    encerrar_metricas();
+    encerrar_contadores_hw_thread();
+    encerrar_grupo_threads();
+    if (configuracao_execucao.arquivo_rastro != NULL && gravar_rastro() != 0) {
+        fprintf(stderr, "Erro ao gravar o rastro em '%s'\n", configuracao_execucao.arquivo_rastro);
+    }
     
     // Libera/desliga recursos de hardware/FPGA (função externa).
-    terminate_hardware();
+    if (perfil_fpga_ativo) imprimir_perfil_fpga();
+    if (!configuracao_execucao.usar_motor_cpu) terminate_hardware();
     
     printf("\nPrograma finalizado com sucesso.\n");
     return EXIT_SUCCESS; // Retorna sucesso.
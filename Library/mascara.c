@@ -0,0 +1,190 @@
+#include <stdio.h>      // Para escrita do arquivo .msk (fopen, fwrite).
+#include <stdlib.h>     // Para malloc e free.
+#include <string.h>     // Para memcpy.
+#include "mascara.h"
+
+/**
+ * @brief Limiar de Otsu sobre um histograma de 256 bins.
+ *
+ * Escolhe o t que maximiza a variância entre as classes [0, t) e [t, 255]; os pixels com valor
+ * >= t formam a máscara. Somas inteiras de 64 bits; só a comparação das variâncias usa double.
+ *
+ * @return Limiar entre 1 e 255 (255 se o histograma tiver um único valor).
+ */
+int calcular_limiar_otsu(const uint32_t *histograma) {
+    uint64_t total = 0, soma_total = 0, peso_fundo = 0, soma_fundo = 0;
+    double melhor_variancia = -1.0;
+    int valor, melhor_limiar = 255;
+
+    for (valor = 0; valor < BINS_HISTOGRAMA_MAGNITUDE; valor++) {
+        total += histograma[valor];
+        soma_total += (uint64_t)valor * histograma[valor];
+    }
+    for (valor = 1; valor < BINS_HISTOGRAMA_MAGNITUDE; valor++) {
+        peso_fundo += histograma[valor - 1];
+        soma_fundo += (uint64_t)(valor - 1) * histograma[valor - 1];
+        uint64_t peso_borda = total - peso_fundo;
+        if (peso_fundo == 0 || peso_borda == 0) continue;
+
+        // Variância entre classes a menos de um fator constante: (mu_f - mu_b)^2 * w_f * w_b.
+        double media_fundo = (double)soma_fundo / peso_fundo;
+        double media_borda = (double)(soma_total - soma_fundo) / peso_borda;
+        double variancia = (media_borda - media_fundo) * (media_borda - media_fundo) * (double)peso_fundo * (double)peso_borda;
+        if (variancia > melhor_variancia) {
+            melhor_variancia = variancia;
+            melhor_limiar = valor;
+        }
+    }
+    return melhor_limiar;
+}
+
+/**
+ * @brief Limiar que deixa abaixo dele pelo menos `percentil`% dos pixels.
+ *
+ * @param percentil De 0 a 100; p. ex. 90 mantém na máscara os ~10% de maior magnitude.
+ * @return Limiar entre 1 e 255.
+ */
+int calcular_limiar_percentil(const uint32_t *histograma, int percentil) {
+    uint64_t total = 0, acumulado = 0;
+    int valor;
+
+    for (valor = 0; valor < BINS_HISTOGRAMA_MAGNITUDE; valor++) total += histograma[valor];
+    uint64_t alvo = (total * (uint64_t)percentil + 99) / 100;
+    for (valor = 0; valor < BINS_HISTOGRAMA_MAGNITUDE - 1; valor++) {
+        acumulado += histograma[valor];
+        if (acumulado >= alvo) break;
+    }
+    return (valor + 1 < BINS_HISTOGRAMA_MAGNITUDE) ? valor + 1 : BINS_HISTOGRAMA_MAGNITUDE - 1;
+}
+
+/**
+ * @brief Converte uma imagem de 8 bits em máscara de 1 bit por pixel (valor >= limiar).
+ *
+ * Cada linha ocupa `palavras_por_linha_mascara(largura)` palavras; os bits além da largura ficam em zero.
+ */
+void empacotar_mascara(const uint8_t *imagem, int largura, int altura, int limiar, uint64_t *mascara) {
+    int palavras_linha = palavras_por_linha_mascara(largura);
+    int coord_y, palavra, bit;
+
+    for (coord_y = 0; coord_y < altura; coord_y++) {
+        const uint8_t *linha = imagem + coord_y * largura;
+        for (palavra = 0; palavra < palavras_linha; palavra++) {
+            int inicio = palavra * BITS_PALAVRA_MASCARA;
+            int bits_validos = (largura - inicio < BITS_PALAVRA_MASCARA) ? largura - inicio : BITS_PALAVRA_MASCARA;
+            uint64_t valor = 0;
+            for (bit = 0; bit < bits_validos; bit++) {
+                valor |= (uint64_t)(linha[inicio + bit] >= limiar) << bit;
+            }
+            mascara[coord_y * palavras_linha + palavra] = valor;
+        }
+    }
+}
+
+/**
+ * @brief Conta os pixels ligados da máscara, 64 por vez.
+ */
+long contar_pixels_mascara(const uint64_t *mascara, int largura, int altura) {
+    long total = 0;
+    int indice, total_palavras = palavras_por_linha_mascara(largura) * altura;
+    for (indice = 0; indice < total_palavras; indice++) {
+        total += __builtin_popcountll(mascara[indice]);
+    }
+    return total;
+}
+
+/**
+ * @brief Grava um comprimento em varint (7 bits por byte, bit 7 indica continuação).
+ *
+ * @return Bytes escritos.
+ */
+static int escrever_varint(uint8_t *destino, uint32_t valor) {
+    int bytes = 0;
+    while (valor >= 0x80) {
+        destino[bytes++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[bytes++] = (uint8_t)valor;
+    return bytes;
+}
+
+/**
+ * @brief Codifica uma linha da máscara em trechos alternados (fundo, borda, ...).
+ *
+ * Os trechos são encontrados palavra a palavra: uma palavra toda igual à cor atual é pulada
+ * inteira, e dentro de uma palavra a próxima troca de cor sai de `__builtin_ctzll`.
+ *
+ * @return Bytes escritos em `destino`.
+ */
+static int codificar_linha_rle(const uint64_t *linha, int largura, uint8_t *destino) {
+    int bytes = 0, posicao = 0, inicio_trecho = 0;
+    uint64_t cor_atual = 0; // 0 = fundo, ~0 = borda.
+
+    while (posicao < largura) {
+        int palavra = posicao / BITS_PALAVRA_MASCARA, bit = posicao % BITS_PALAVRA_MASCARA;
+        // Bits que diferem da cor atual, a partir da posição corrente.
+        uint64_t diferencas = (linha[palavra] ^ cor_atual) >> bit;
+        if (diferencas == 0) {
+            posicao += BITS_PALAVRA_MASCARA - bit;
+            continue;
+        }
+        posicao += __builtin_ctzll(diferencas);
+        if (posicao >= largura) break;
+        bytes += escrever_varint(destino + bytes, (uint32_t)(posicao - inicio_trecho));
+        inicio_trecho = posicao;
+        cor_atual = ~cor_atual;
+    }
+    bytes += escrever_varint(destino + bytes, (uint32_t)(largura - inicio_trecho));
+    return bytes;
+}
+
+/**
+ * @brief Salva a máscara no formato .msk (ver mascara.h).
+ *
+ * @return Bytes gravados, ou -1 em caso de erro.
+ */
+long salvar_mascara(const char *caminho_arquivo, const uint64_t *mascara, int largura, int altura,
+                    int limiar, tipo_formato_mascara formato) {
+    int palavras_linha = palavras_por_linha_mascara(largura);
+    // Pior caso do RLE: um trecho por pixel, mais o trecho inicial, até 5 bytes cada.
+    size_t capacidade = (formato == MASCARA_RLE) ? (size_t)altura * (largura + 1) * 5
+                                                 : (size_t)altura * palavras_linha * sizeof(uint64_t);
+    uint8_t *dados = malloc(MASCARA_TAMANHO_CABECALHO + capacidade);
+    size_t tamanho = MASCARA_TAMANHO_CABECALHO;
+    int coord_y, indice, byte;
+
+    if (dados == NULL) {
+        fprintf(stderr, "Memória insuficiente para gravar '%s'\n", caminho_arquivo);
+        return -1;
+    }
+    memcpy(dados, MASCARA_MAGICO, 4);
+    dados[4] = (uint8_t)(largura & 0xFF);
+    dados[5] = (uint8_t)(largura >> 8);
+    dados[6] = (uint8_t)(altura & 0xFF);
+    dados[7] = (uint8_t)(altura >> 8);
+    dados[8] = (uint8_t)formato;
+    dados[9] = (uint8_t)limiar;
+
+    if (formato == MASCARA_RLE) {
+        for (coord_y = 0; coord_y < altura; coord_y++) {
+            tamanho += codificar_linha_rle(mascara + coord_y * palavras_linha, largura, dados + tamanho);
+        }
+    } else {
+        for (indice = 0; indice < altura * palavras_linha; indice++) {
+            for (byte = 0; byte < 8; byte++) dados[tamanho++] = (uint8_t)(mascara[indice] >> (8 * byte));
+        }
+    }
+
+    FILE *arquivo = fopen(caminho_arquivo, "wb");
+    if (arquivo == NULL) {
+        perror("Erro ao criar arquivo de máscara");
+        free(dados);
+        return -1;
+    }
+    int falhou = fwrite(dados, 1, tamanho, arquivo) != tamanho;
+    free(dados);
+    if (fclose(arquivo) != 0 || falhou) {
+        fprintf(stderr, "Erro ao gravar '%s'\n", caminho_arquivo);
+        return -1;
+    }
+    return (long)tamanho;
+}
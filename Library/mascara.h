@@ -0,0 +1,41 @@
+#ifndef MASCARA_H
+#define MASCARA_H
+#include <stdint.h>
+
+/* Máscaras Binárias de Bordas */
+#define BITS_PALAVRA_MASCARA 64   // Pixels por palavra; o pixel x de uma linha é o bit (x % 64) da palavra x / 64.
+#define BINS_HISTOGRAMA_MAGNITUDE 256
+
+// Como o limiar da máscara é escolhido a partir do histograma da magnitude.
+typedef enum {
+    MASCARA_DESATIVADA = 0,
+    MASCARA_OTSU,         // Limiar que maximiza a variância entre as classes.
+    MASCARA_PERCENTIL     // Mantém os pixels acima do percentil pedido.
+} tipo_limiar_mascara;
+
+// Como a máscara é gravada.
+typedef enum {
+    MASCARA_BITS = 0,     // 1 bit por pixel, linhas alinhadas a palavras de 64 bits.
+    MASCARA_RLE           // Por linha, comprimentos alternados (fundo, borda, fundo, ...) em varint.
+} tipo_formato_mascara;
+
+/* Formato do Arquivo .msk (little-endian) */
+// "MSK1", uint16 largura, uint16 altura, uint8 formato (0 = bits, 1 = RLE), uint8 limiar; depois:
+// - bits: altura * palavras_por_linha palavras uint64;
+// - RLE: para cada linha, comprimentos em varint (7 bits por byte, bit 7 = continua), começando
+//   por um trecho de fundo (possivelmente vazio) e alternando, somando `largura`.
+#define MASCARA_MAGICO            "MSK1"
+#define MASCARA_TAMANHO_CABECALHO 10
+
+static inline int palavras_por_linha_mascara(int largura) {
+    return (largura + BITS_PALAVRA_MASCARA - 1) / BITS_PALAVRA_MASCARA;
+}
+
+int calcular_limiar_otsu(const uint32_t *histograma);
+int calcular_limiar_percentil(const uint32_t *histograma, int percentil);
+void empacotar_mascara(const uint8_t *imagem, int largura, int altura, int limiar, uint64_t *mascara);
+long contar_pixels_mascara(const uint64_t *mascara, int largura, int altura);
+long salvar_mascara(const char *caminho_arquivo, const uint64_t *mascara, int largura, int altura,
+                    int limiar, tipo_formato_mascara formato);
+
+#endif
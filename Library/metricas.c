@@ -0,0 +1,214 @@
+#include <stdio.h>      // Para a gravação do arquivo (fopen, fprintf, rename).
+#include <time.h>       // Para clock_gettime e o horário da gravação.
+#include <errno.h>      // Para ETIMEDOUT.
+#include <pthread.h>    // Para a thread de gravação periódica.
+#include <stdatomic.h>  // Para os contadores sem trava.
+#include <unistd.h>     // Para fsync.
+#include "metricas.h"
+#include "filtros.h"    // Para os nomes dos filtros nos rótulos.
+
+int metricas_ativas = 0;
+
+// Limites superiores (em segundos) das faixas do histograma de latência por imagem.
+static const double limites_faixas_latencia[METRICAS_TOTAL_FAIXAS] = {
+    0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+
+static const struct { const char *nome; const char *ajuda; } descricoes_contadores[TOTAL_METRICAS] = {
+    { "pbl3_bytes_lidos_total", "Bytes dos arquivos de entrada processados." },
+    { "pbl3_bytes_gravados_total", "Bytes dos PNGs e mascaras gravados." },
+    { "pbl3_transacoes_fpga_total", "Janelas enviadas e lidas da FPGA." },
+    { "pbl3_erros_fpga_total", "Falhas de envio ou leitura na FPGA." },
+};
+
+// Histograma de um filtro. Cada observação incrementa só a sua faixa; as faixas acumuladas
+// que o Prometheus espera são somadas na gravação.
+typedef struct {
+    atomic_uint_fast64_t contagem_faixa[METRICAS_TOTAL_FAIXAS + 1]; // Última: acima do maior limite.
+    atomic_uint_fast64_t soma_ns;
+    atomic_uint_fast64_t imagens_sucesso;
+    atomic_uint_fast64_t imagens_falha;
+} tipo_histograma_filtro;
+
+static atomic_uint_fast64_t contadores_metricas[TOTAL_METRICAS];
+static tipo_histograma_filtro histogramas_filtros[MAX_FILTROS_REGISTRADOS];
+
+static const char *caminho_metricas = NULL;
+static int intervalo_metricas = METRICAS_INTERVALO_PADRAO;
+static time_t instante_inicio_metricas;
+static pthread_t thread_gravacao;
+static int thread_gravacao_ativa = 0;
+static pthread_mutex_t trava_gravacao = PTHREAD_MUTEX_INITIALIZER; // Também serializa as gravações.
+static pthread_cond_t condicao_encerrar = PTHREAD_COND_INITIALIZER;
+static int encerrando_metricas = 0;
+
+/**
+ * @brief Instante atual do relógio monotônico, em nanossegundos.
+ */
+uint64_t instante_metrica_ns(void) {
+    struct timespec instante;
+    clock_gettime(CLOCK_MONOTONIC, &instante);
+    return (uint64_t)instante.tv_sec * 1000000000ull + (uint64_t)instante.tv_nsec;
+}
+
+/**
+ * @brief Soma `quantidade` a um contador global.
+ */
+void somar_metrica(tipo_metrica_contador metrica, uint64_t quantidade) {
+    atomic_fetch_add_explicit(&contadores_metricas[metrica], quantidade, memory_order_relaxed);
+}
+
+/**
+ * @brief Conta uma imagem do filtro e, se processada com sucesso, sua latência no histograma.
+ *
+ * @param indice_filtro Posição do filtro em `filtros_registrados`.
+ * @param sucesso 1 se a imagem foi processada e salva.
+ * @param duracao_ns Tempo total da imagem (leitura até a gravação).
+ */
+void registrar_imagem_metrica(int indice_filtro, int sucesso, uint64_t duracao_ns) {
+    tipo_histograma_filtro *histograma;
+    int faixa = 0;
+
+    if (indice_filtro < 0 || indice_filtro >= MAX_FILTROS_REGISTRADOS) return;
+    histograma = &histogramas_filtros[indice_filtro];
+    if (!sucesso) {
+        atomic_fetch_add_explicit(&histograma->imagens_falha, 1, memory_order_relaxed);
+        return;
+    }
+
+    double duracao_segundos = duracao_ns / 1e9;
+    while (faixa < METRICAS_TOTAL_FAIXAS && duracao_segundos > limites_faixas_latencia[faixa]) faixa++;
+    atomic_fetch_add_explicit(&histograma->contagem_faixa[faixa], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histograma->soma_ns, duracao_ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histograma->imagens_sucesso, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Grava todas as métricas num arquivo temporário e o renomeia sobre o destino.
+ *
+ * O `rename` é atômico: o coletor de arquivos texto do node_exporter nunca lê um arquivo pela metade.
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não puder ser gravado.
+ */
+int gravar_metricas(void) {
+    char caminho_temporario[512];
+    int indice, faixa;
+
+    if (!metricas_ativas) return 0;
+    snprintf(caminho_temporario, sizeof(caminho_temporario), "%s.tmp", caminho_metricas);
+
+    pthread_mutex_lock(&trava_gravacao);
+    FILE *arquivo = fopen(caminho_temporario, "w");
+    if (arquivo == NULL) {
+        pthread_mutex_unlock(&trava_gravacao);
+        return -1;
+    }
+
+    for (indice = 0; indice < TOTAL_METRICAS; indice++) {
+        fprintf(arquivo, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", descricoes_contadores[indice].nome,
+                descricoes_contadores[indice].ajuda, descricoes_contadores[indice].nome, descricoes_contadores[indice].nome,
+                (unsigned long long)atomic_load_explicit(&contadores_metricas[indice], memory_order_relaxed));
+    }
+
+    fprintf(arquivo, "# HELP pbl3_imagens_total Imagens por filtro e resultado.\n# TYPE pbl3_imagens_total counter\n");
+    for (indice = 0; indice < total_filtros_registrados; indice++) {
+        const tipo_histograma_filtro *histograma = &histogramas_filtros[indice];
+        fprintf(arquivo, "pbl3_imagens_total{filtro=\"%s\",resultado=\"sucesso\"} %llu\n", filtros_registrados[indice].nome,
+                (unsigned long long)atomic_load_explicit(&histograma->imagens_sucesso, memory_order_relaxed));
+        fprintf(arquivo, "pbl3_imagens_total{filtro=\"%s\",resultado=\"falha\"} %llu\n", filtros_registrados[indice].nome,
+                (unsigned long long)atomic_load_explicit(&histograma->imagens_falha, memory_order_relaxed));
+    }
+
+    fprintf(arquivo, "# HELP pbl3_latencia_imagem_segundos Tempo de cada imagem processada, da leitura a gravacao.\n"
+                     "# TYPE pbl3_latencia_imagem_segundos histogram\n");
+    for (indice = 0; indice < total_filtros_registrados; indice++) {
+        const tipo_histograma_filtro *histograma = &histogramas_filtros[indice];
+        const char *nome_filtro = filtros_registrados[indice].nome;
+        uint64_t acumulado = 0;
+        for (faixa = 0; faixa < METRICAS_TOTAL_FAIXAS; faixa++) {
+            acumulado += atomic_load_explicit(&histograma->contagem_faixa[faixa], memory_order_relaxed);
+            fprintf(arquivo, "pbl3_latencia_imagem_segundos_bucket{filtro=\"%s\",le=\"%g\"} %llu\n", nome_filtro,
+                    limites_faixas_latencia[faixa], (unsigned long long)acumulado);
+        }
+        acumulado += atomic_load_explicit(&histograma->contagem_faixa[METRICAS_TOTAL_FAIXAS], memory_order_relaxed);
+        fprintf(arquivo, "pbl3_latencia_imagem_segundos_bucket{filtro=\"%s\",le=\"+Inf\"} %llu\n", nome_filtro, (unsigned long long)acumulado);
+        fprintf(arquivo, "pbl3_latencia_imagem_segundos_sum{filtro=\"%s\"} %.6f\n", nome_filtro,
+                atomic_load_explicit(&histograma->soma_ns, memory_order_relaxed) / 1e9);
+        fprintf(arquivo, "pbl3_latencia_imagem_segundos_count{filtro=\"%s\"} %llu\n", nome_filtro, (unsigned long long)acumulado);
+    }
+
+    fprintf(arquivo, "# HELP pbl3_inicio_segundos Horario de inicio do processo (Unix).\n# TYPE pbl3_inicio_segundos gauge\n"
+                     "pbl3_inicio_segundos %lld\n", (long long)instante_inicio_metricas);
+    fprintf(arquivo, "# HELP pbl3_gravacao_metricas_segundos Horario desta gravacao (Unix).\n# TYPE pbl3_gravacao_metricas_segundos gauge\n"
+                     "pbl3_gravacao_metricas_segundos %lld\n", (long long)time(NULL));
+
+    int resultado = (fflush(arquivo) == 0 && fsync(fileno(arquivo)) == 0) ? 0 : -1;
+    if (fclose(arquivo) != 0) resultado = -1;
+    if (resultado == 0 && rename(caminho_temporario, caminho_metricas) != 0) resultado = -1;
+    if (resultado != 0) remove(caminho_temporario);
+    pthread_mutex_unlock(&trava_gravacao);
+    return resultado;
+}
+
+/**
+ * @brief Corpo da thread de gravação: grava as métricas a cada `intervalo_metricas` segundos até o encerramento.
+ */
+static void *executar_gravacao_periodica(void *argumento) {
+    (void)argumento;
+    pthread_mutex_lock(&trava_gravacao);
+    while (!encerrando_metricas) {
+        struct timespec prazo;
+        clock_gettime(CLOCK_REALTIME, &prazo);
+        prazo.tv_sec += intervalo_metricas;
+        while (!encerrando_metricas && pthread_cond_timedwait(&condicao_encerrar, &trava_gravacao, &prazo) != ETIMEDOUT);
+        if (encerrando_metricas) break;
+        pthread_mutex_unlock(&trava_gravacao);
+        if (gravar_metricas() != 0) fprintf(stderr, "Erro ao gravar as métricas em '%s'\n", caminho_metricas);
+        pthread_mutex_lock(&trava_gravacao);
+    }
+    pthread_mutex_unlock(&trava_gravacao);
+    return NULL;
+}
+
+/**
+ * @brief Ativa as métricas, grava o arquivo pela primeira vez e inicia a gravação periódica.
+ *
+ * @param caminho_arquivo Destino (para o node_exporter, `<diretório do textfile collector>/<nome>.prom`).
+ * @param intervalo_segundos Intervalo entre as gravações (>= 1).
+ * @return 0 em caso de sucesso, -1 se o arquivo não puder ser gravado.
+ */
+int iniciar_metricas(const char *caminho_arquivo, int intervalo_segundos) {
+    caminho_metricas = caminho_arquivo;
+    intervalo_metricas = (intervalo_segundos > 0) ? intervalo_segundos : METRICAS_INTERVALO_PADRAO;
+    instante_inicio_metricas = time(NULL);
+    metricas_ativas = 1;
+    if (gravar_metricas() != 0) {
+        metricas_ativas = 0;
+        return -1;
+    }
+
+    encerrando_metricas = 0;
+    if (pthread_create(&thread_gravacao, NULL, executar_gravacao_periodica, NULL) != 0) {
+        fprintf(stderr, "Não foi possível criar a thread das métricas; o arquivo só será gravado no fim.\n");
+    } else {
+        thread_gravacao_ativa = 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Para a gravação periódica e grava os valores finais.
+ */
+void encerrar_metricas(void) {
+    if (!metricas_ativas) return;
+    if (thread_gravacao_ativa) {
+        pthread_mutex_lock(&trava_gravacao);
+        encerrando_metricas = 1;
+        pthread_cond_signal(&condicao_encerrar);
+        pthread_mutex_unlock(&trava_gravacao);
+        pthread_join(thread_gravacao, NULL);
+        thread_gravacao_ativa = 0;
+    }
+    if (gravar_metricas() != 0) fprintf(stderr, "Erro ao gravar as métricas em '%s'\n", caminho_metricas);
+    metricas_ativas = 0;
+}
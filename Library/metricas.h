@@ -0,0 +1,29 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+#include <stdint.h>
+
+/* Métricas no Formato Texto do Prometheus (--metricas) */
+#define METRICAS_INTERVALO_PADRAO 15   // Segundos entre as gravações periódicas do arquivo.
+#define METRICAS_TOTAL_FAIXAS 11       // Limites do histograma de latência (mais a faixa +Inf).
+
+// Contadores globais (sem rótulos).
+typedef enum {
+    METRICA_BYTES_LIDOS = 0,     // Tamanho dos arquivos de entrada processados.
+    METRICA_BYTES_GRAVADOS,      // Tamanho dos PNGs e máscaras gravados.
+    METRICA_TRANSACOES_FPGA,     // Pares transfer_data_to_fpga/retrieve_fpga_results concluídos.
+    METRICA_ERROS_FPGA,          // Falhas de envio ou leitura na FPGA.
+    TOTAL_METRICAS
+} tipo_metrica_contador;
+
+// 1 quando `--metricas` está ativo; as rotinas abaixo só devem ser chamadas com ele ligado.
+extern int metricas_ativas;
+
+int iniciar_metricas(const char *caminho_arquivo, int intervalo_segundos);
+void encerrar_metricas(void);
+int gravar_metricas(void);
+
+uint64_t instante_metrica_ns(void);
+void somar_metrica(tipo_metrica_contador metrica, uint64_t quantidade);
+void registrar_imagem_metrica(int indice_filtro, int sucesso, uint64_t duracao_ns);
+
+#endif
@@ -0,0 +1,157 @@
+#include <string.h>     // Para memset.
+#include "modelo_rtl.h"
+
+// Somas exatas miradas pela estratégia SORTEIO_RTL_FRONTEIRA (antes das voltas de 2^16).
+static const int32_t alvos_fronteira[] = { -129, -128, -127, -1, 0, 126, 127, 128, 255 };
+#define TOTAL_ALVOS_FRONTEIRA (sizeof(alvos_fronteira) / sizeof(alvos_fronteira[0]))
+#define MAXIMO_VOLTAS_FRONTEIRA 3   // Voltas de 2^16 somadas ao alvo: -3 a 3 (uma janela 5x5 chega a ~816 mil).
+
+/**
+ * @brief Soma exata (sem o estouro de 16 bits) dos produtos pixel * peso no canto superior esquerdo
+ *        de lado `codigo_tamanho + 2`, como os laços de `image_convolution`.
+ *
+ * @param codigo_tamanho matrix_size (0: 2x2, 1: 3x3, 2: 4x4, 3: 5x5).
+ */
+int32_t soma_produtos_rtl(const uint8_t pixels[25], const int8_t kernel[25], unsigned codigo_tamanho) {
+    unsigned lado = (codigo_tamanho & 3) + 2, linha, coluna;
+    int32_t soma = 0;
+
+    for (linha = 0; linha < lado; linha++) {
+        for (coluna = 0; coluna < lado; coluna++) soma += (int32_t)pixels[linha * 5 + coluna] * kernel[linha * 5 + coluna];
+    }
+    return soma;
+}
+
+/**
+ * @brief Convolução de convolution.v: acumulador `signed [15:0]` sobre o canto superior esquerdo
+ *        de lado `codigo_tamanho + 2` e saturação de qualquer valor fora de [-128, 127] para 255.
+ *
+ * As posições fora do lado são ignoradas, como em `is_valid_coord`.
+ *
+ * @param codigo_tamanho matrix_size (0: 2x2, 1: 3x3, 2: 4x4, 3: 5x5).
+ * @return conv_result, os 16 bits menos significativos de result_out.
+ */
+uint16_t convolucao_rtl(const uint8_t pixels[25], const int8_t kernel[25], unsigned codigo_tamanho) {
+    unsigned lado = (codigo_tamanho & 3) + 2, linha, coluna;
+    uint16_t soma = 0; // Aritmética módulo 2^16, como o reg de 16 bits.
+
+    for (linha = 0; linha < lado; linha++) {
+        for (coluna = 0; coluna < lado; coluna++) {
+            unsigned indice = linha * 5 + coluna;
+            soma = (uint16_t)(soma + (uint16_t)((int)pixels[indice] * kernel[indice]));
+        }
+    }
+    if ((int16_t)soma > 127 || (int16_t)soma < -128) return 255;
+    return soma;
+}
+
+/**
+ * @brief Os 25 bytes que o control_unit devolve numa transação de convolução (`matrix_result`).
+ *
+ * result_out = {184'b0, conv_result}: o byte 0 é a parte baixa, o byte 1 a parte alta (0x00 para
+ * 0..127 e 255, 0xFF para -128..-1) e os demais são zero.
+ */
+void resultado_control_unit_rtl(const uint8_t pixels[25], const int8_t kernel[25], unsigned codigo_tamanho, uint8_t resultado[25]) {
+    uint16_t valor = convolucao_rtl(pixels, kernel, codigo_tamanho);
+    memset(resultado, 0, 25);
+    resultado[0] = (uint8_t)valor;
+    resultado[1] = (uint8_t)(valor >> 8);
+}
+
+/**
+ * @brief O valor que `calcular_convolucao_fpga` devolve para os bytes lidos: (byte 1 << 8) | byte 0, com sinal.
+ *
+ * A saturação para 0-255 e a magnitude vêm depois e são as mesmas para a FPGA e os motores de CPU.
+ */
+int16_t resposta_host_rtl(const uint8_t resultado[25]) {
+    return (int16_t)(((unsigned)resultado[1] << 8) | resultado[0]);
+}
+
+/**
+ * @brief Próximo valor do gerador xorshift64* (estado 0 é trocado por uma constante).
+ */
+uint64_t proximo_aleatorio_rtl(uint64_t *estado) {
+    uint64_t valor = *estado ? *estado : 0x9E3779B97F4A7C15ull;
+    valor ^= valor >> 12;
+    valor ^= valor << 25;
+    valor ^= valor >> 27;
+    *estado = valor;
+    return valor * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * @brief Preenche a área útil para que a soma exata dê `alvo`.
+ *
+ * Cada posição recebe um peso sorteado (não nulo) e o pixel que mais aproxima a soma do alvo sem
+ * ultrapassá-lo; a última recebe peso ±1 e o pixel que fecha a diferença.
+ *
+ * @return 1 se a soma exata ficou igual ao alvo, 0 se o resto não coube num pixel.
+ */
+static int montar_soma_alvo(uint64_t *estado, uint8_t pixels[25], int8_t kernel[25], unsigned lado, int32_t alvo) {
+    unsigned linha, coluna, posicao = 0;
+    int32_t parcial = 0;
+
+    for (linha = 0; linha < lado; linha++) {
+        for (coluna = 0; coluna < lado; coluna++) {
+            unsigned indice = linha * 5 + coluna;
+            int32_t resto = alvo - parcial, pixel;
+            if (++posicao == lado * lado) {
+                kernel[indice] = (int8_t)((resto < 0) ? -1 : 1);
+                pixel = (resto < 0) ? -resto : resto;
+                pixels[indice] = (uint8_t)((pixel > 255) ? 255 : pixel);
+                return pixel <= 255;
+            }
+            int peso = (int8_t)proximo_aleatorio_rtl(estado);
+            if (peso == 0) peso = 1;
+            pixel = resto / peso; // Trunca em direção a zero: |pixel * peso| <= |resto|.
+            if (pixel < 0) pixel = 0;
+            if (pixel > 255) pixel = 255;
+            kernel[indice] = (int8_t)peso;
+            pixels[indice] = (uint8_t)pixel;
+            parcial += pixel * peso;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Sorteia uma janela (pixels, pesos e matrix_size) para comparar o RTL com o modelo.
+ *
+ * As 25 posições recebem valores, inclusive as que ficam fora do lado: o RTL deve ignorá-las.
+ *
+ * @param estado Estado do gerador (`proximo_aleatorio_rtl`).
+ * @return A estratégia usada, para a contagem de cobertura dos harnesses.
+ */
+tipo_sorteio_rtl sortear_janela_rtl(uint64_t *estado, uint8_t pixels[25], int8_t kernel[25], unsigned *codigo_tamanho) {
+    static const int8_t pesos_extremos[] = { -128, -1, 0, 1, 127 };
+    tipo_sorteio_rtl estrategia = (tipo_sorteio_rtl)(proximo_aleatorio_rtl(estado) % TOTAL_SORTEIOS_RTL);
+    unsigned indice;
+
+    *codigo_tamanho = (unsigned)(proximo_aleatorio_rtl(estado) & 3);
+    for (indice = 0; indice < 25; indice++) {
+        uint64_t sorteio = proximo_aleatorio_rtl(estado);
+        switch (estrategia) {
+            case SORTEIO_RTL_PEQUENO:
+                pixels[indice] = (uint8_t)(sorteio & 0x1f);
+                kernel[indice] = (int8_t)((int)((sorteio >> 8) % 5) - 2);
+                break;
+            case SORTEIO_RTL_EXTREMOS:
+                pixels[indice] = (sorteio & 1) ? 255 : 0;
+                kernel[indice] = pesos_extremos[(sorteio >> 8) % 5];
+                break;
+            default:
+                pixels[indice] = (uint8_t)sorteio;
+                kernel[indice] = (int8_t)(sorteio >> 8);
+                break;
+        }
+    }
+
+    if (estrategia == SORTEIO_RTL_FRONTEIRA) {
+        unsigned lado = *codigo_tamanho + 2;
+        int32_t base = alvos_fronteira[proximo_aleatorio_rtl(estado) % TOTAL_ALVOS_FRONTEIRA];
+        int32_t voltas = (int32_t)(proximo_aleatorio_rtl(estado) % (2 * MAXIMO_VOLTAS_FRONTEIRA + 1)) - MAXIMO_VOLTAS_FRONTEIRA;
+        // Sem alcance para as voltas (janelas pequenas), mira o alvo sem elas.
+        if (!montar_soma_alvo(estado, pixels, kernel, lado, base + voltas * 65536)) montar_soma_alvo(estado, pixels, kernel, lado, base);
+    }
+    return estrategia;
+}
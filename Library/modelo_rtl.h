@@ -0,0 +1,27 @@
+#ifndef MODELO_RTL_H
+#define MODELO_RTL_H
+#include <stdint.h>
+
+/* Modelo de Referência Bit a Bit de convolution.v e control_unit.v */
+// Compilado também como C++ pelos harnesses do Verilator (Coprocessor/sim).
+#define CODIGO_TAMANHO_HOST_RTL 3    // matrix_size enviado por calcular_convolucao_fpga (sempre 5x5).
+
+int32_t soma_produtos_rtl(const uint8_t pixels[25], const int8_t kernel[25], unsigned codigo_tamanho);
+uint16_t convolucao_rtl(const uint8_t pixels[25], const int8_t kernel[25], unsigned codigo_tamanho);
+void resultado_control_unit_rtl(const uint8_t pixels[25], const int8_t kernel[25], unsigned codigo_tamanho, uint8_t resultado[25]);
+int16_t resposta_host_rtl(const uint8_t resultado[25]);
+
+/* Gerador de Janelas para o Fuzzing Diferencial */
+// Estratégias sorteadas por `sortear_janela_rtl`.
+typedef enum {
+    SORTEIO_RTL_UNIFORME = 0,   // Bytes quaisquer: quase sempre saturado em 255.
+    SORTEIO_RTL_PEQUENO,        // Pixels e pesos pequenos: soma em [-128, 127], inclusive negativa.
+    SORTEIO_RTL_EXTREMOS,       // Pixels 0/255 e pesos -128/-1/0/1/127.
+    SORTEIO_RTL_FRONTEIRA,      // Soma exata mirada em -129..-127, 126..128 etc., com ou sem voltas de 2^16.
+    TOTAL_SORTEIOS_RTL
+} tipo_sorteio_rtl;
+
+uint64_t proximo_aleatorio_rtl(uint64_t *estado);
+tipo_sorteio_rtl sortear_janela_rtl(uint64_t *estado, uint8_t pixels[25], int8_t kernel[25], unsigned *codigo_tamanho);
+
+#endif
@@ -0,0 +1,175 @@
+#include <stdio.h>      // Para mensagens de erro (fprintf).
+#include <pthread.h>    // Para as threads do grupo, mutex e variáveis de condição.
+#include <stdatomic.h>  // Para a distribuição das faixas entre as threads sem trava.
+#include <stdint.h>     // Para intptr_t (número da thread auxiliar).
+#include "paralelo.h"
+#include "rastro.h"     // Eventos de faixa e de espera na linha do tempo (--rastro).
+
+// --- Estado do Grupo de Threads ---
+
+// Threads auxiliares; a thread que chama `executar_em_faixas` também processa faixas.
+static pthread_t threads_auxiliares[MAX_THREADS_GRUPO - 1];
+static int total_threads = 1;           // Threads que processam faixas, incluindo a que chama.
+
+static pthread_mutex_t trava_grupo = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t condicao_tarefa = PTHREAD_COND_INITIALIZER; // Nova tarefa ou encerramento.
+static pthread_cond_t condicao_fim = PTHREAD_COND_INITIALIZER;    // Última thread auxiliar terminou.
+
+// Tarefa corrente, publicada sob `trava_grupo` e identificada por `geracao_tarefa`.
+static struct {
+    tipo_rotina_faixa rotina;
+    void *contexto;
+    int total_itens;
+    int itens_por_faixa;
+    int total_faixas;
+    atomic_int proxima_faixa;           // Próxima faixa ainda não reservada.
+} tarefa_corrente;
+static unsigned geracao_tarefa = 0;
+static int threads_ocupadas = 0;        // Threads auxiliares ainda trabalhando na tarefa corrente.
+static int encerrando_grupo = 0;
+
+/**
+ * @brief Reserva e processa faixas da tarefa corrente até que não reste nenhuma.
+ *
+ * Com `--rastro`, cada faixa vira um evento na linha do tempo da thread que a processou.
+ */
+static void consumir_faixas(void) {
+    int faixa;
+    while ((faixa = atomic_fetch_add(&tarefa_corrente.proxima_faixa, 1)) < tarefa_corrente.total_faixas) {
+        int inicio = faixa * tarefa_corrente.itens_por_faixa;
+        int fim = inicio + tarefa_corrente.itens_por_faixa;
+        if (fim > tarefa_corrente.total_itens) fim = tarefa_corrente.total_itens;
+        if (!rastro_ativo) {
+            tarefa_corrente.rotina(inicio, fim, tarefa_corrente.contexto);
+            continue;
+        }
+        uint64_t instante_inicio = instante_rastro_ns();
+        tarefa_corrente.rotina(inicio, fim, tarefa_corrente.contexto);
+        registrar_evento_rastro("faixa", "faixa", instante_inicio, instante_rastro_ns());
+    }
+}
+
+/**
+ * @brief Laço das threads auxiliares: espera uma tarefa nova, processa faixas e avisa o fim.
+ */
+static void *executar_thread_auxiliar(void *argumento) {
+    unsigned geracao_vista = 0;
+
+    if (rastro_ativo) {
+        char nome_thread[RASTRO_TAMANHO_NOME];
+        snprintf(nome_thread, sizeof(nome_thread), "trabalhador %d", (int)(intptr_t)argumento);
+        nomear_thread_rastro(nome_thread);
+    }
+
+    pthread_mutex_lock(&trava_grupo);
+    while (1) {
+        while (geracao_tarefa == geracao_vista && !encerrando_grupo) {
+            pthread_cond_wait(&condicao_tarefa, &trava_grupo);
+        }
+        if (encerrando_grupo) break;
+        geracao_vista = geracao_tarefa;
+        pthread_mutex_unlock(&trava_grupo);
+
+        consumir_faixas();
+
+        pthread_mutex_lock(&trava_grupo);
+        if (--threads_ocupadas == 0) pthread_cond_signal(&condicao_fim);
+    }
+    pthread_mutex_unlock(&trava_grupo);
+    if (rastro_ativo) encerrar_rastro_thread();
+    return NULL;
+}
+
+/**
+ * @brief Cria as threads auxiliares do grupo.
+ *
+ * @param total_threads_pedidas Threads que processarão faixas, incluindo a que chama
+ *                              (1 mantém tudo na thread que chama).
+ * @return Quantidade de threads efetivamente disponível.
+ */
+int iniciar_grupo_threads(int total_threads_pedidas) {
+    int indice;
+    if (total_threads_pedidas < 1) total_threads_pedidas = 1;
+    if (total_threads_pedidas > MAX_THREADS_GRUPO) total_threads_pedidas = MAX_THREADS_GRUPO;
+
+    encerrando_grupo = 0;
+    total_threads = 1;
+    for (indice = 0; indice < total_threads_pedidas - 1; indice++) {
+        if (pthread_create(&threads_auxiliares[indice], NULL, executar_thread_auxiliar, (void *)(intptr_t)(indice + 2)) != 0) {
+            fprintf(stderr, "Não foi possível criar a thread %d do grupo; usando %d thread(s).\n", indice + 2, total_threads);
+            break;
+        }
+        total_threads++;
+    }
+    return total_threads;
+}
+
+/**
+ * @brief Encerra e aguarda as threads auxiliares.
+ */
+void encerrar_grupo_threads(void) {
+    int indice;
+    pthread_mutex_lock(&trava_grupo);
+    encerrando_grupo = 1;
+    pthread_cond_broadcast(&condicao_tarefa);
+    pthread_mutex_unlock(&trava_grupo);
+    for (indice = 0; indice < total_threads - 1; indice++) {
+        pthread_join(threads_auxiliares[indice], NULL);
+    }
+    total_threads = 1;
+}
+
+/**
+ * @brief Retorna a quantidade de threads que processam faixas (incluindo a que chama).
+ */
+int total_threads_grupo(void) {
+    return total_threads;
+}
+
+/**
+ * @brief Divide [0, total_itens) em faixas e as processa em paralelo no grupo de threads.
+ *
+ * As faixas são reservadas dinamicamente, então faixas mais caras não atrasam as demais.
+ * Retorna só depois que todas as faixas foram processadas. Não é reentrante: a rotina
+ * não pode chamar `executar_em_faixas`, e apenas uma thread pode usar o grupo por vez.
+ * Com `--rastro`, o tempo que a thread que chama passa esperando as auxiliares vira um evento
+ * "espera" (faixas desbalanceadas aparecem ali).
+ *
+ * @param total_itens Quantidade de itens (por exemplo, linhas da imagem).
+ * @param itens_por_faixa Itens em cada faixa (a última pode ser menor).
+ * @param rotina Rotina aplicada a cada faixa.
+ * @param contexto Ponteiro repassado à rotina.
+ */
+void executar_em_faixas(int total_itens, int itens_por_faixa, tipo_rotina_faixa rotina, void *contexto) {
+    if (total_itens <= 0) return;
+    if (itens_por_faixa < 1) itens_por_faixa = 1;
+    int total_faixas = (total_itens + itens_por_faixa - 1) / itens_por_faixa;
+
+    // Sem threads auxiliares (ou com uma única faixa), processa tudo de uma vez.
+    if (total_threads <= 1 || total_faixas <= 1) {
+        rotina(0, total_itens, contexto);
+        return;
+    }
+
+    pthread_mutex_lock(&trava_grupo);
+    tarefa_corrente.rotina = rotina;
+    tarefa_corrente.contexto = contexto;
+    tarefa_corrente.total_itens = total_itens;
+    tarefa_corrente.itens_por_faixa = itens_por_faixa;
+    tarefa_corrente.total_faixas = total_faixas;
+    atomic_store(&tarefa_corrente.proxima_faixa, 0);
+    threads_ocupadas = total_threads - 1;
+    geracao_tarefa++;
+    pthread_cond_broadcast(&condicao_tarefa);
+    pthread_mutex_unlock(&trava_grupo);
+
+    consumir_faixas();
+
+    uint64_t instante_espera = rastro_ativo ? instante_rastro_ns() : 0;
+    pthread_mutex_lock(&trava_grupo);
+    while (threads_ocupadas > 0) {
+        pthread_cond_wait(&condicao_fim, &trava_grupo);
+    }
+    pthread_mutex_unlock(&trava_grupo);
+    if (rastro_ativo) registrar_evento_rastro("espera", "sincronizacao", instante_espera, instante_rastro_ns());
+}
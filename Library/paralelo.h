@@ -0,0 +1,15 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+/* Grupo de Threads para Processamento em Faixas */
+#define MAX_THREADS_GRUPO 16  // Quantidade máxima de threads (incluindo a thread que chama).
+
+// Rotina aplicada a uma faixa [inicio, fim) de itens (linhas, faixas de blocos, ...).
+typedef void (*tipo_rotina_faixa)(int inicio, int fim, void *contexto);
+
+int iniciar_grupo_threads(int total_threads);
+void encerrar_grupo_threads(void);
+int total_threads_grupo(void);
+void executar_em_faixas(int total_itens, int itens_por_faixa, tipo_rotina_faixa rotina, void *contexto);
+
+#endif
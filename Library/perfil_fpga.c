@@ -0,0 +1,87 @@
+#include <stdio.h>      // Para o relatório (printf) e os avisos.
+#include <string.h>     // Para memset.
+#include <signal.h>     // Para capturar o SIGILL do acesso ao PMCCNTR negado.
+#include <setjmp.h>     // Para voltar do tratador de SIGILL.
+#include <stddef.h>     // Para offsetof.
+#include "hps_0.h"
+#include "perfil_fpga.h"
+
+// O lib.s acessa `perfil_fpga` por deslocamentos fixos (PERFIL_*).
+_Static_assert(offsetof(tipo_perfil_fpga, leituras_ack_alto_envio) == 40, "PERFIL_BLOCO_ENVIO do lib.s");
+_Static_assert(offsetof(tipo_perfil_fpga, leituras_ack_alto_recepcao) == 64, "PERFIL_BLOCO_RECEPCAO do lib.s");
+_Static_assert(offsetof(tipo_perfil_fpga, max_leituras_handshake) == 88, "PERFIL_MAX_LEITURAS do lib.s");
+_Static_assert(sizeof(tipo_perfil_fpga) == 96, "PERFIL_TAMANHO do lib.s");
+
+static sigjmp_buf retorno_sigill;
+
+static void tratar_sigill(int sinal) {
+    (void)sinal;
+    siglongjmp(retorno_sigill, 1);
+}
+
+/**
+ * @brief Zera os agregados e habilita o perfil do lib.s (`habilitar_perfil_fpga`).
+ *
+ * O PMCCNTR só é acessível em modo usuário se o kernel tiver ligado PMUSERENR.EN (por exemplo,
+ * com um módulo que escreva 1 nesse registrador em cada núcleo). Sem isso, a instrução gera
+ * SIGILL, que é capturado aqui: o programa segue sem perfil.
+ *
+ * @return 0 se o perfil foi habilitado, -1 caso contrário.
+ */
+int iniciar_perfil_fpga(void) {
+    struct sigaction tratamento, tratamento_anterior;
+    int resultado = -1;
+
+    memset(&perfil_fpga, 0, sizeof(perfil_fpga));
+    memset(&tratamento, 0, sizeof(tratamento));
+    tratamento.sa_handler = tratar_sigill;
+    sigemptyset(&tratamento.sa_mask);
+    sigaction(SIGILL, &tratamento, &tratamento_anterior);
+
+    if (sigsetjmp(retorno_sigill, 1) == 0) {
+        resultado = habilitar_perfil_fpga();
+    } else {
+        perfil_fpga_ativo = 0;
+        fprintf(stderr, "PMCCNTR inacessível em modo usuário (PMUSERENR.EN = 0); seguindo sem perfil da FPGA.\n");
+    }
+    sigaction(SIGILL, &tratamento_anterior, NULL);
+    return (resultado == 0) ? 0 : -1;
+}
+
+/**
+ * @brief Média de `total` por `quantidade` (0 se não houver ocorrências).
+ */
+static double media_perfil(uint64_t total, uint64_t quantidade) {
+    return quantidade ? (double)total / quantidade : 0.0;
+}
+
+/**
+ * @brief Imprime os agregados do perfil: ciclos por fase e leituras de espera por handshake.
+ *
+ * Muitas leituras com o ack alto apontam para a latência da FPGA (sincronizador de hps_ready e
+ * a convolução); ciclos por leitura altos apontam para a latência da ponte.
+ */
+void imprimir_perfil_fpga(void) {
+    const tipo_perfil_fpga *perfil = &perfil_fpga;
+    uint64_t leituras_envio = perfil->leituras_ack_alto_envio + perfil->leituras_ack_baixo_envio;
+    uint64_t leituras_recepcao = perfil->leituras_ack_alto_recepcao + perfil->leituras_ack_baixo_recepcao;
+
+    printf("\n========= PERFIL DAS TRANSAÇÕES COM A FPGA =========\n");
+    printf("Transações: %llu envios, %llu recepções\n",
+           (unsigned long long)perfil->chamadas_envio, (unsigned long long)perfil->chamadas_recepcao);
+    printf("Ciclos por transação:  pulsos %.1f | envio %.1f | recepção %.1f\n",
+           media_perfil(perfil->ciclos_pulsos, perfil->chamadas_envio),
+           media_perfil(perfil->ciclos_envio, perfil->chamadas_envio),
+           media_perfil(perfil->ciclos_recepcao, perfil->chamadas_recepcao));
+    printf("Ciclos por handshake:  envio %.1f | recepção %.1f\n",
+           media_perfil(perfil->ciclos_envio, perfil->handshakes_envio),
+           media_perfil(perfil->ciclos_recepcao, perfil->handshakes_recepcao));
+    printf("Leituras por handshake (ack alto / ack baixo):  envio %.2f / %.2f | recepção %.2f / %.2f\n",
+           media_perfil(perfil->leituras_ack_alto_envio, perfil->handshakes_envio),
+           media_perfil(perfil->leituras_ack_baixo_envio, perfil->handshakes_envio),
+           media_perfil(perfil->leituras_ack_alto_recepcao, perfil->handshakes_recepcao),
+           media_perfil(perfil->leituras_ack_baixo_recepcao, perfil->handshakes_recepcao));
+    printf("Ciclos por leitura de data_out:  envio %.1f | recepção %.1f\n",
+           media_perfil(perfil->ciclos_envio, leituras_envio), media_perfil(perfil->ciclos_recepcao, leituras_recepcao));
+    printf("Maior handshake: %u leituras\n", perfil->max_leituras_handshake);
+}
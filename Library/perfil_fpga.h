@@ -0,0 +1,9 @@
+#ifndef PERFIL_FPGA_H
+#define PERFIL_FPGA_H
+
+/* Perfil das Transações com a FPGA (--perfil-fpga) */
+// Os agregados ficam em `perfil_fpga` (hps_0.h), preenchidos pelo lib.s.
+int iniciar_perfil_fpga(void);
+void imprimir_perfil_fpga(void);
+
+#endif
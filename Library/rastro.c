@@ -0,0 +1,236 @@
+#include <stdio.h>      // Para a gravação do JSON (fopen, fprintf).
+#include <stdlib.h>     // Para calloc, realloc e free.
+#include <string.h>     // Para strncpy.
+#include <time.h>       // Para clock_gettime (CLOCK_MONOTONIC).
+#include <unistd.h>     // Para getpid.
+#include <pthread.h>    // Para o mutex do registro dos buffers.
+#include "rastro.h"
+
+int rastro_ativo = 0;
+
+// Evento completo ("ph":"X" no formato Chrome): início e duração numa só entrada.
+typedef struct {
+    char nome[RASTRO_TAMANHO_NOME];
+    const char *categoria;
+    uint64_t instante_inicio_ns;
+    uint64_t duracao_ns;
+} tipo_evento_rastro;
+
+// Buffer de uma thread. Só a thread dona escreve nele; a gravação acontece depois que as
+// demais threads terminaram (ver `gravar_rastro`), então os eventos não precisam de trava.
+// Quando a thread termina (`encerrar_rastro_thread`), o buffer fica livre e a próxima thread
+// nova continua nele, na mesma linha do tempo: as threads de refinamento, que se sucedem,
+// não esgotam RASTRO_MAX_THREADS.
+typedef struct {
+    int identificador;
+    int livre;                      // 1 depois que a thread dona terminou (protegido por `mutex_registro`).
+    char nome_thread[RASTRO_TAMANHO_NOME];
+    int total_eventos;
+    int capacidade_eventos;         // Cresce por duplicação, até RASTRO_EVENTOS_POR_THREAD.
+    uint64_t eventos_descartados;
+    tipo_evento_rastro *eventos;
+} tipo_buffer_rastro;
+
+static _Thread_local tipo_buffer_rastro *buffer_thread = NULL;
+static pthread_mutex_t mutex_registro = PTHREAD_MUTEX_INITIALIZER;
+static tipo_buffer_rastro *buffers_registrados[RASTRO_MAX_THREADS];
+static int total_buffers_registrados;
+static uint64_t threads_sem_buffer; // Threads além de RASTRO_MAX_THREADS (ou sem memória).
+static const char *caminho_rastro = NULL;
+static uint64_t instante_inicio_rastro_ns;
+
+/**
+ * @brief Instante atual do relógio monotônico, em nanossegundos.
+ */
+uint64_t instante_rastro_ns(void) {
+    struct timespec instante;
+    clock_gettime(CLOCK_MONOTONIC, &instante);
+    return (uint64_t)instante.tv_sec * 1000000000ull + (uint64_t)instante.tv_nsec;
+}
+
+/**
+ * @brief Buffer da thread atual, obtido no primeiro evento dela.
+ *
+ * Reaproveita o buffer de uma thread que já terminou; se não houver, registra um novo. O mutex
+ * só é tomado uma vez por thread.
+ *
+ * @return O buffer, ou NULL se não houver posição ou memória (os eventos da thread são ignorados).
+ */
+static tipo_buffer_rastro *obter_buffer_thread(void) {
+    int indice;
+    if (buffer_thread != NULL) return buffer_thread;
+
+    pthread_mutex_lock(&mutex_registro);
+    for (indice = 0; indice < total_buffers_registrados; indice++) {
+        if (buffers_registrados[indice]->livre) {
+            buffer_thread = buffers_registrados[indice];
+            buffer_thread->livre = 0;
+            break;
+        }
+    }
+    if (buffer_thread == NULL) {
+        tipo_buffer_rastro *buffer = NULL;
+        if (total_buffers_registrados < RASTRO_MAX_THREADS) buffer = calloc(1, sizeof(*buffer));
+        if (buffer == NULL) {
+            threads_sem_buffer++;
+        } else {
+            buffers_registrados[total_buffers_registrados++] = buffer;
+            buffer->identificador = total_buffers_registrados;
+            buffer_thread = buffer;
+        }
+    }
+    pthread_mutex_unlock(&mutex_registro);
+    return buffer_thread;
+}
+
+/**
+ * @brief Libera o buffer da thread atual para a próxima thread nova; chamada pela thread ao terminar.
+ *
+ * Os eventos ficam no buffer até `gravar_rastro`.
+ */
+void encerrar_rastro_thread(void) {
+    if (buffer_thread == NULL) return;
+    pthread_mutex_lock(&mutex_registro);
+    buffer_thread->livre = 1;
+    pthread_mutex_unlock(&mutex_registro);
+    buffer_thread = NULL;
+}
+
+/**
+ * @brief Garante espaço para mais um evento, dobrando o vetor de eventos até RASTRO_EVENTOS_POR_THREAD.
+ *
+ * @return 1 se há espaço; 0 se o buffer está cheio ou faltou memória.
+ */
+static int reservar_evento_rastro(tipo_buffer_rastro *buffer) {
+    if (buffer->total_eventos < buffer->capacidade_eventos) return 1;
+    if (buffer->capacidade_eventos == RASTRO_EVENTOS_POR_THREAD) return 0;
+
+    int nova_capacidade = buffer->capacidade_eventos ? buffer->capacidade_eventos * 2 : RASTRO_EVENTOS_INICIAIS;
+    if (nova_capacidade > RASTRO_EVENTOS_POR_THREAD) nova_capacidade = RASTRO_EVENTOS_POR_THREAD;
+    tipo_evento_rastro *eventos = realloc(buffer->eventos, (size_t)nova_capacidade * sizeof(*eventos));
+    if (eventos == NULL) return 0;
+    buffer->eventos = eventos;
+    buffer->capacidade_eventos = nova_capacidade;
+    return 1;
+}
+
+/**
+ * @brief Ativa o rastro; os eventos são gravados em `caminho_arquivo` por `gravar_rastro`.
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não puder ser criado.
+ */
+int iniciar_rastro(const char *caminho_arquivo) {
+    FILE *arquivo = fopen(caminho_arquivo, "w"); // Falha cedo, antes de processar as imagens.
+    if (arquivo == NULL) return -1;
+    fclose(arquivo);
+    caminho_rastro = caminho_arquivo;
+    instante_inicio_rastro_ns = instante_rastro_ns();
+    rastro_ativo = 1;
+    return 0;
+}
+
+/**
+ * @brief Dá nome à thread atual na linha do tempo (ex.: "principal", "trabalhador 2").
+ */
+void nomear_thread_rastro(const char *nome) {
+    tipo_buffer_rastro *buffer = obter_buffer_thread();
+    if (buffer == NULL) return;
+    strncpy(buffer->nome_thread, nome, RASTRO_TAMANHO_NOME - 1);
+}
+
+/**
+ * @brief Registra um intervalo [instante_inicio_ns, instante_fim_ns) no buffer da thread atual.
+ *
+ * @param nome Nome do evento (copiado; truncado em RASTRO_TAMANHO_NOME - 1 caracteres).
+ * @param categoria Categoria (string estática: "etapa", "imagem", "faixa", ...).
+ */
+void registrar_evento_rastro(const char *nome, const char *categoria, uint64_t instante_inicio_ns, uint64_t instante_fim_ns) {
+    tipo_buffer_rastro *buffer = obter_buffer_thread();
+    if (buffer == NULL) return;
+    if (!reservar_evento_rastro(buffer)) {
+        buffer->eventos_descartados++;
+        return;
+    }
+    tipo_evento_rastro *evento = &buffer->eventos[buffer->total_eventos++];
+    strncpy(evento->nome, nome, RASTRO_TAMANHO_NOME - 1);
+    evento->nome[RASTRO_TAMANHO_NOME - 1] = '\0';
+    evento->categoria = categoria;
+    evento->instante_inicio_ns = instante_inicio_ns;
+    evento->duracao_ns = instante_fim_ns - instante_inicio_ns;
+}
+
+/**
+ * @brief Grava uma string JSON (entre aspas), escapando aspas, barras e caracteres de controle.
+ *
+ * Também usada pelas linhas de `--stats` (estatisticas.c).
+ */
+void escrever_string_json(FILE *arquivo, const char *texto) {
+    fputc('"', arquivo);
+    for (; *texto != '\0'; texto++) {
+        unsigned char caractere = (unsigned char)*texto;
+        if (caractere == '"' || caractere == '\\') fprintf(arquivo, "\\%c", caractere);
+        else if (caractere < 0x20) fprintf(arquivo, "\\u%04x", caractere);
+        else fputc(caractere, arquivo);
+    }
+    fputc('"', arquivo);
+}
+
+/**
+ * @brief Grava todos os eventos em JSON do Chrome (`{"traceEvents":[...]}`) e desativa o rastro.
+ *
+ * Deve ser chamada depois que as outras threads terminaram (grupo encerrado, refinamento
+ * interrompido). Os instantes ficam em microssegundos desde `iniciar_rastro`; o arquivo abre
+ * no Perfetto (ui.perfetto.dev) ou em chrome://tracing.
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não puder ser gravado.
+ */
+int gravar_rastro(void) {
+    int total_buffers, indice_buffer, indice_evento;
+    int primeiro = 1;
+    uint64_t total_descartados = 0;
+    int pid = (int)getpid();
+
+    if (!rastro_ativo) return 0;
+    rastro_ativo = 0;
+
+    FILE *arquivo = fopen(caminho_rastro, "w");
+    if (arquivo == NULL) return -1;
+
+    total_buffers = total_buffers_registrados;
+
+    fprintf(arquivo, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (indice_buffer = 0; indice_buffer < total_buffers; indice_buffer++) {
+        tipo_buffer_rastro *buffer = buffers_registrados[indice_buffer];
+
+        if (buffer->nome_thread[0] != '\0') {
+            fprintf(arquivo, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                    primeiro ? "" : ",\n", pid, buffer->identificador);
+            escrever_string_json(arquivo, buffer->nome_thread);
+            fprintf(arquivo, "}}");
+            primeiro = 0;
+        }
+        for (indice_evento = 0; indice_evento < buffer->total_eventos; indice_evento++) {
+            const tipo_evento_rastro *evento = &buffer->eventos[indice_evento];
+            fprintf(arquivo, "%s{\"ph\":\"X\",\"name\":", primeiro ? "" : ",\n");
+            escrever_string_json(arquivo, evento->nome);
+            fprintf(arquivo, ",\"cat\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", evento->categoria, pid, buffer->identificador,
+                    (evento->instante_inicio_ns - instante_inicio_rastro_ns) / 1e3, evento->duracao_ns / 1e3);
+            primeiro = 0;
+        }
+        total_descartados += buffer->eventos_descartados;
+        free(buffer->eventos);
+        free(buffer);
+        buffers_registrados[indice_buffer] = NULL;
+    }
+    fprintf(arquivo, "\n],\"otherData\":{\"eventos_descartados\":%llu,\"threads_sem_buffer\":%llu}}\n",
+            (unsigned long long)total_descartados, (unsigned long long)threads_sem_buffer);
+    total_buffers_registrados = 0;
+    buffer_thread = NULL;
+
+    if (fclose(arquivo) != 0) return -1;
+    if (total_descartados > 0) {
+        fprintf(stderr, "Rastro: %llu eventos descartados (buffer de %d eventos por thread cheio).\n",
+                (unsigned long long)total_descartados, RASTRO_EVENTOS_POR_THREAD);
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef RASTRO_H
+#define RASTRO_H
+#include <stdint.h>
+#include <stdio.h>   // Para FILE (escrever_string_json).
+
+/* Linha do Tempo em Formato Chrome Trace (--rastro) */
+#define RASTRO_EVENTOS_POR_THREAD 65536  // Capacidade máxima do buffer de cada thread; o excedente é descartado e contado.
+#define RASTRO_EVENTOS_INICIAIS 1024     // Capacidade inicial; o buffer dobra conforme enche.
+#define RASTRO_MAX_THREADS 64            // Buffers simultâneos; o de uma thread encerrada é reaproveitado.
+#define RASTRO_TAMANHO_NOME 48           // Nomes maiores (ex.: arquivos) são truncados.
+
+// 1 quando `--rastro` está ativo; as rotinas abaixo só devem ser chamadas com ele ligado.
+extern int rastro_ativo;
+
+int iniciar_rastro(const char *caminho_arquivo);
+int gravar_rastro(void);
+
+uint64_t instante_rastro_ns(void);
+void nomear_thread_rastro(const char *nome);
+void encerrar_rastro_thread(void);
+void registrar_evento_rastro(const char *nome, const char *categoria, uint64_t instante_inicio_ns, uint64_t instante_fim_ns);
+
+// Grava `texto` como string JSON escapada (compartilhada com estatisticas.c).
+void escrever_string_json(FILE *arquivo, const char *texto);
+
+#endif
@@ -0,0 +1,178 @@
+#include <stdlib.h>     // Para malloc e free.
+#include <stdatomic.h>  // Para o indicador de falha compartilhado entre as faixas.
+#include "suavizacao.h"
+#include "paralelo.h"   // Para dividir as linhas de saída em faixas.
+
+// Halo de linhas que um bloco do LoG fundido precisa acima e abaixo (suporte de qualquer kernel 5x5).
+#define HALO_LOG_FUNDIDO (LADO_JANELA_MAX / 2)
+
+// Coeficientes binomiais por lado (linhas do triângulo de Pascal); somam 2^(lado-1).
+static const uint16_t pesos_binomiais_3[3] = { 1, 2, 1 };
+static const uint16_t pesos_binomiais_5[5] = { 1, 4, 6, 4, 1 };
+
+// Dados compartilhados pelas faixas de `suavizar_plano`.
+typedef struct {
+    const uint8_t *plano;
+    int largura, altura, lado;
+    uint8_t *saida;
+} tipo_contexto_suavizacao;
+
+// Dados compartilhados pelas faixas de `aplicar_log_fundido`.
+typedef struct {
+    const tipo_kernel_analisado *kernel;
+    const uint8_t *plano;
+    int largura, altura, lado;
+    tipo_resultado_conv *saida;
+    atomic_int falhou;  // Alguma faixa não conseguiu alocar o seu bloco.
+} tipo_contexto_log;
+
+/**
+ * @brief Indica se existe kernel binomial com esse lado (3 ou 5).
+ */
+int lado_suavizacao_valido(int lado) {
+    return lado == 3 || lado == 5;
+}
+
+/**
+ * @brief Suaviza as linhas [y_inicio, y_fim) de um plano com um kernel binomial separável.
+ *
+ * Para cada linha de saída, a passada vertical soma as `lado` linhas de origem numa linha de
+ * 16 bits (no máximo 255 * 16) e a passada horizontal soma essa linha em 32 bits; o resultado é
+ * arredondado e dividido pela soma dos pesos com um deslocamento, como nos kernels de ponto fixo.
+ * As bordas repetem o pixel mais próximo, para não escurecer o quadro.
+ *
+ * @param plano Plano de origem (largura x altura).
+ * @param lado 3 ou 5.
+ * @param y_inicio Primeira linha a suavizar (inclusive).
+ * @param y_fim Última linha a suavizar (exclusive).
+ * @param destino Saída com (y_fim - y_inicio) linhas de `largura` pixels.
+ * @param linha_vertical Buffer de trabalho com `largura` posições.
+ */
+static void suavizar_linhas(const uint8_t *plano, int largura, int altura, int lado, int y_inicio, int y_fim,
+                            uint8_t *destino, uint16_t *linha_vertical) {
+    const uint16_t *pesos = (lado == 3) ? pesos_binomiais_3 : pesos_binomiais_5;
+    int raio = lado / 2, deslocamento = 2 * (lado - 1); // Soma dos pesos 2D = 4^(lado-1).
+    uint32_t arredondamento = 1u << (deslocamento - 1);
+    int coord_x, coord_y, termo;
+
+    for (coord_y = y_inicio; coord_y < y_fim; coord_y++) {
+        // Passada vertical: uma linha de somas de 16 bits.
+        for (coord_x = 0; coord_x < largura; coord_x++) linha_vertical[coord_x] = 0;
+        for (termo = 0; termo < lado; termo++) {
+            int linha_origem = coord_y + termo - raio;
+            if (linha_origem < 0) linha_origem = 0;
+            if (linha_origem >= altura) linha_origem = altura - 1;
+            const uint8_t *origem = plano + linha_origem * largura;
+            for (coord_x = 0; coord_x < largura; coord_x++) linha_vertical[coord_x] += pesos[termo] * origem[coord_x];
+        }
+
+        // Passada horizontal sobre a linha vertical, com as bordas repetidas.
+        uint8_t *saida_linha = destino + (coord_y - y_inicio) * largura;
+        for (coord_x = 0; coord_x < largura; coord_x++) {
+            uint32_t soma = 0;
+            for (termo = 0; termo < lado; termo++) {
+                int coluna_origem = coord_x + termo - raio;
+                if (coluna_origem < 0) coluna_origem = 0;
+                if (coluna_origem >= largura) coluna_origem = largura - 1;
+                soma += pesos[termo] * linha_vertical[coluna_origem];
+            }
+            saida_linha[coord_x] = (uint8_t)((soma + arredondamento) >> deslocamento);
+        }
+    }
+}
+
+/**
+ * @brief Suaviza uma faixa de linhas de saída (rotina de `executar_em_faixas`).
+ */
+static void suavizar_faixa(int linha_inicio, int linha_fim, void *argumento) {
+    tipo_contexto_suavizacao *contexto = (tipo_contexto_suavizacao *)argumento;
+    uint16_t *linha_vertical = malloc((size_t)contexto->largura * sizeof(uint16_t));
+    int linha;
+
+    if (linha_vertical == NULL) {
+        // Sem memória para o buffer de trabalho: mantém a faixa sem suavização.
+        for (linha = linha_inicio * contexto->largura; linha < linha_fim * contexto->largura; linha++) {
+            contexto->saida[linha] = contexto->plano[linha];
+        }
+        return;
+    }
+    suavizar_linhas(contexto->plano, contexto->largura, contexto->altura, contexto->lado, linha_inicio, linha_fim,
+                    contexto->saida + linha_inicio * contexto->largura, linha_vertical);
+    free(linha_vertical);
+}
+
+/**
+ * @brief Suaviza um plano inteiro com um kernel binomial separável de lado 3 ou 5.
+ *
+ * As linhas de saída são divididas em faixas no grupo de threads. `saida` não pode ser `plano`.
+ *
+ * @param plano Plano de origem (largura x altura).
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param lado 3 ([1 2 1]) ou 5 ([1 4 6 4 1]).
+ * @param saida Plano suavizado (largura x altura).
+ */
+void suavizar_plano(const uint8_t *plano, int largura, int altura, int lado, uint8_t *saida) {
+    tipo_contexto_suavizacao contexto = { plano, largura, altura, lado, saida };
+    executar_em_faixas(altura, LINHAS_FAIXA_SUAVIZACAO, suavizar_faixa, &contexto);
+}
+
+/**
+ * @brief Suaviza e convolui uma faixa de linhas, bloco a bloco (rotina de `executar_em_faixas`).
+ *
+ * Cada bloco suavizado cobre LINHAS_FAIXA_SUAVIZACAO linhas de saída mais HALO_LOG_FUNDIDO acima
+ * e abaixo (limitadas ao plano) e é usado como um plano pequeno por `convolver_regiao_cpu`: as
+ * linhas do halo dão aos kernels os mesmos vizinhos que teriam no plano suavizado inteiro, e
+ * fora do plano o preenchimento continua sendo zero.
+ */
+static void aplicar_log_faixa(int linha_inicio, int linha_fim, void *argumento) {
+    tipo_contexto_log *contexto = (tipo_contexto_log *)argumento;
+    int largura = contexto->largura;
+    int inicio_bloco;
+
+    uint8_t *bloco = malloc((size_t)(LINHAS_FAIXA_SUAVIZACAO + 2 * HALO_LOG_FUNDIDO) * largura);
+    uint16_t *linha_vertical = malloc((size_t)largura * sizeof(uint16_t));
+    if (bloco == NULL || linha_vertical == NULL) {
+        atomic_store(&contexto->falhou, 1);
+        free(bloco);
+        free(linha_vertical);
+        return;
+    }
+
+    for (inicio_bloco = linha_inicio; inicio_bloco < linha_fim; inicio_bloco += LINHAS_FAIXA_SUAVIZACAO) {
+        int fim_saida = (inicio_bloco + LINHAS_FAIXA_SUAVIZACAO < linha_fim) ? inicio_bloco + LINHAS_FAIXA_SUAVIZACAO : linha_fim;
+        int topo_bloco = (inicio_bloco - HALO_LOG_FUNDIDO < 0) ? 0 : inicio_bloco - HALO_LOG_FUNDIDO;
+        int fim_bloco = (fim_saida + HALO_LOG_FUNDIDO > contexto->altura) ? contexto->altura : fim_saida + HALO_LOG_FUNDIDO;
+
+        suavizar_linhas(contexto->plano, largura, contexto->altura, contexto->lado, topo_bloco, fim_bloco, bloco, linha_vertical);
+        // A saída é deslocada para que a linha 0 do bloco corresponda à linha `topo_bloco` do plano.
+        convolver_regiao_cpu(contexto->kernel, bloco, largura, fim_bloco - topo_bloco, 0, inicio_bloco - topo_bloco, largura,
+                             fim_saida - topo_bloco, contexto->saida + (size_t)topo_bloco * largura);
+    }
+
+    free(bloco);
+    free(linha_vertical);
+}
+
+/**
+ * @brief Laplaciano do Gaussiano fundido: suavização binomial e kernel numa só varredura por blocos.
+ *
+ * Cada faixa de LINHAS_FAIXA_SUAVIZACAO linhas suaviza só o seu bloco (com halo) e aplica o
+ * kernel sobre ele, sem plano suavizado intermediário do tamanho do quadro. O resultado é
+ * idêntico a `suavizar_plano` seguido de `convolver_regiao_cpu` no plano inteiro, inclusive na
+ * semântica de 16 bits da FPGA.
+ *
+ * @param kernel Kernel analisado (normalmente o Laplaciano).
+ * @param plano Plano de origem (largura x altura).
+ * @param largura Largura do plano.
+ * @param altura Altura do plano.
+ * @param lado Lado da suavização binomial (3 ou 5).
+ * @param saida Resposta do kernel (largura x altura).
+ * @return 0 em caso de sucesso, -1 se algum bloco não pôde ser alocado.
+ */
+int aplicar_log_fundido(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                        int lado, tipo_resultado_conv *saida) {
+    tipo_contexto_log contexto = { kernel, plano, largura, altura, lado, saida, 0 };
+    executar_em_faixas(altura, LINHAS_FAIXA_SUAVIZACAO, aplicar_log_faixa, &contexto);
+    return atomic_load(&contexto.falhou) ? -1 : 0;
+}
@@ -0,0 +1,16 @@
+#ifndef SUAVIZACAO_H
+#define SUAVIZACAO_H
+#include <stdint.h>
+#include "filtros.h"
+
+/* Suavização Binomial Separável */
+#define LADO_SUAVIZACAO_MAX   5    // Taps do maior kernel binomial ([1 4 6 4 1]).
+#define LADO_SUAVIZACAO_LOG   5    // Suavização usada pelo modo LoG.
+#define LINHAS_FAIXA_SUAVIZACAO 32 // Linhas de saída por faixa (e por bloco do LoG fundido).
+
+int lado_suavizacao_valido(int lado);
+void suavizar_plano(const uint8_t *plano, int largura, int altura, int lado, uint8_t *saida);
+int aplicar_log_fundido(const tipo_kernel_analisado *kernel, const uint8_t *plano, int largura, int altura,
+                        int lado, tipo_resultado_conv *saida);
+
+#endif